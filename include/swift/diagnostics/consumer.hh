@@ -34,6 +34,9 @@
 #include "swift/diagnostics/diagnostics.hh"
 #include "swift/diagnostics/engine.hh"
 
+#include <string>
+#include <vector>
+
 namespace swift {
 namespace diagnostics {
 class diagnostic_info;
@@ -83,6 +86,42 @@ public:
   void handle_diagnostic(diagnostic::level level,
                          const diagnostic_info &info) override;
 };
+
+/// Holds back the diagnostics reported through an engine (e.g. while parsing
+/// tentatively) until they are either replayed through it or discarded.
+class buffering_consumer : public consumer {
+  struct held_diagnostic {
+    diagnostic::id id;
+    swift::range range;
+    signed char arguments;
+    engine::argument_type argument_types[engine::maximum_arguments];
+    std::string argument_strings[engine::maximum_arguments];
+    std::u32string argument_u32strings[engine::maximum_arguments];
+    intptr_t argument_values[engine::maximum_arguments];
+  };
+
+  std::vector<held_diagnostic> diagnostics_;
+  unsigned held_errors_;
+
+public:
+  buffering_consumer() : held_errors_(0) {}
+  virtual ~buffering_consumer() = default;
+
+  bool empty() const {
+    return diagnostics_.empty();
+  }
+
+  void reset() override;
+
+  void handle_diagnostic(diagnostic::level level,
+                         const diagnostic_info &info) override;
+
+  /// Reports the held diagnostics through \p engine, in order.
+  void replay(engine &engine);
+  /// Drops the held diagnostics, removing them from the error count of \p
+  /// engine.
+  void discard(engine &engine);
+};
 }
 }
 
@@ -46,13 +46,22 @@ public:
     invalid = ~0,
 
     err_additional_case_blocks_cannot_appear_after_default,
+    err_arithmetic_operation_results_in_an_overflow,
+    err_attributes_are_not_allowed_on_syntax,
     err_cannot_create_variadic_tuple,
     err_cannot_declare_a_custom_prefix_name_operator,
     err_cannot_declare_a_custom_postfix_name_operator,
+    err_cannot_find_a_consistent_type_for_the_expression,
+    err_constant_used_before_being_initialized,
     err_declaration_is_only_valid_at_file_scope,
     err_declaration_attribute_on_type,
+    err_declaration_modifiers_are_not_allowed_on_syntax,
+    err_division_by_zero,
+    err_expected_a_digit_in_floating_point_exponent,
     err_expected_an_attribute_name,
     err_expected_argument_list,
+    err_expected_associativity,
+    err_expected_declaration,
     err_expected_dictionary_value_type,
     err_expected_element_type,
     err_expected_expression,
@@ -63,6 +72,7 @@ public:
     err_expected_expression_in,
     err_expected_expression_or_binding_in,
     err_expected_filename,
+    err_expected_hexadecimal_code_in_braces_after_unicode_escape,
     err_expected_identifier_after_syntax,
     err_expected_identifier,
     err_expected_identifier_in,
@@ -75,6 +85,7 @@ public:
     err_expected_parameter_name,
     err_expected_parameter_type_following,
     err_expected_pattern,
+    err_expected_precedence_level,
     err_expected_starting_line_number,
     err_expected_token,
     err_expected_token_after_syntax,
@@ -86,22 +97,35 @@ public:
     err_expected_token_to_syntax,
     err_expected_token_type,
     err_expected_type,
+    err_expected_type_after_syntax,
     err_expected_type_for_function_result,
     err_expected_type_in,
     err_expected_typed_expression_for,
     err_expected_value_in,
     err_expressions_not_allowed_at_the_top_level,
+    err_extraneous_token_at_top_level,
+    err_hexadecimal_floating_point_literal_must_end_with_an_exponent,
     err_initializer_cannot_be_referenced_without_arguments,
+    err_integer_literal_overflows_when_stored_into,
     err_invalid_character_in_source_file,
+    err_invalid_escape_sequence_in_literal,
+    err_invalid_unicode_scalar,
+    err_labels_are_only_valid_on_loop_and_switch_statements,
     err_migration_new_array_syntax,
+    err_name_references_itself,
+    err_nesting_exceeds_maximum_depth_of,
+    err_non_associative_operator_is_adjacent_to_operator_of_same_precedence,
+    err_operator_is_not_a_known_binary_operator,
     err_operator_must_be_declared_as_prefix_postfix_or_infix,
     err_operators_must_have_one_or_two_arguments,
     err_parameter_may_not_have_multiple_specifiers,
     err_raw_value_for_enum_case_must_be_a_literal,
     err_return_invalid_outside_of_a_func,
+    err_switch_must_be_exhaustive_consider_adding_a_default_clause,
     err_syntax_is_not_allowed_outside_of_an_enum,
     err_syntax_should_have_at_least_one_executable_statement,
     err_target_unknown_triple,
+    err_the_compiler_is_unable_to_type_check_this_expression_in_reasonable_time,
     err_the_line_number_needs_to_be_greater_than_zero,
     err_token_cannot_appear_nested_inside_another_pattern,
     err_token_modifier_is_not_required_or_allowed_on_func_declarations,
@@ -112,10 +136,23 @@ public:
     err_unexpected_configuration_block_terminator,
     err_unexpected_token_separator,
     err_unknown_attribute,
+    err_unsupported_feature,
+    err_unterminated_block_comment,
+    err_unterminated_string_literal,
+    err_variable_used_before_being_initialized,
 
+    warn_case_is_already_handled_by_previous_patterns,
+    warn_default_will_never_be_executed,
     warn_extraneous_token_in,
+    warn_immutable_value_was_never_used,
+    warn_initialization_of_immutable_value_was_never_used,
+    warn_initialization_of_variable_was_never_used,
     warn_parameter_name_can_be_expression_more_succinctly_as,
+    warn_variable_was_never_mutated,
+    warn_variable_was_never_used,
+    warn_variable_was_written_to_but_never_read,
 
+    note_missing_case,
     note_to_match_this_opening_token,
 
     warn_unsupported_feature,
@@ -38,6 +38,7 @@
 
 namespace swift {
 namespace diagnostics {
+class buffering_consumer;
 class builder;
 class consumer;
 class diagnostic;
@@ -45,6 +46,7 @@ class options;
 
 class engine {
   friend class builder;
+  friend class buffering_consumer;
   friend class diagnostic_info;
 
   engine(const engine &) = delete;
@@ -53,6 +55,9 @@ class engine {
   options *options_;
   consumer *consumer_;
 
+  unsigned errors_;
+  bool suppressed_;
+
   enum class argument_type {
     string,
     u32string,
@@ -102,6 +107,19 @@ public:
   }
   void consumer(diagnostics::consumer *consumer);
 
+  /// While suppressed, diagnostics are neither reported nor counted.
+  void suppress(bool value) {
+    suppressed_ = value;
+  }
+  bool suppressed() const {
+    return suppressed_;
+  }
+
+  /// The number of errors reported through this engine.
+  unsigned error_count() const {
+    return errors_;
+  }
+
   inline builder report(swift::range range, diagnostic::id id);
   inline builder report(diagnostic::id id);
 };
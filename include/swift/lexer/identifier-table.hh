@@ -41,6 +41,8 @@ class identifier_info {
 
   token::type token_type_;
   u32string_map_entry<identifier_info *> *entry_;
+  /// The innermost binding of the identifier during semantic analysis.
+  void *binding_ = nullptr;
 
   static_assert(sizeof(token_type_) == sizeof(char32_t),
                 "token::type not the same size as char32_t");
@@ -59,6 +61,13 @@ public:
   token::type token_type() const {
     return token_type_;
   }
+
+  void *binding() const {
+    return binding_;
+  }
+  void binding(void *binding) {
+    binding_ = binding;
+  }
 };
 
 class identifier_table {
@@ -83,12 +92,20 @@ public:
     void *memory = hashtable_.allocator().Allocate<identifier_info>();
     new (memory) identifier_info(token_type);
     reinterpret_cast<identifier_info *>(memory)->entry_ = &entry;
-    return *reinterpret_cast<identifier_info *>(memory);
+    entry.second = reinterpret_cast<identifier_info *>(memory);
+    return *entry.second;
   }
   identifier_info &get(std::u32string_view name) {
     return get(name, token::type::identifier);
   }
 
+  /// The identifier \p name if it has been interned, or null; unlike `get`,
+  /// the table is not modified.
+  identifier_info *find(std::u32string_view name) const {
+    const auto entry = hashtable_.find(name);
+    return entry == hashtable_.end() ? nullptr : entry->second;
+  }
+
   iterator begin() const {
     return hashtable_.begin();
   }
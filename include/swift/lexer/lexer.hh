@@ -36,6 +36,7 @@
 #include "swift/lexer/token.hh"
 
 #include <deque>
+#include <vector>
 
 namespace swift {
 class lexer {
@@ -47,8 +48,26 @@ class lexer {
 
   unsigned line_, column_;
 
+  // the offsets at which the lines of the buffer start
+  std::vector<uint32_t> lines_;
+
+  location previous_end_;
+
+  // NOTE(compnerd) while a checkpoint is outstanding, consumed tokens are
+  // retained at the front of the lookahead so that the lexer can be rewound
+  // without lexing them again; head_ is the index of the current token.
   std::deque<token> lookahead_;
-  identifier_table identifiers_;
+  size_t head_;
+  unsigned checkpoints_;
+  // indices of the retained tokens whose lexing reported an error
+  std::vector<size_t> diagnosed_;
+
+  // the table in which identifiers are interned, if any
+  identifier_table *identifiers_ = nullptr;
+
+#if defined(SWIFT_PARSER_PROFILING)
+  size_t consumed_ = 0;
+#endif
 
   template <token::type Type>
   token consume();
@@ -60,22 +79,82 @@ class lexer {
   bool match() const;
 
   location position() const {
-    return { line_, column_ };
+    return {
+        line_, column_, static_cast<unsigned>(cursor_ - buffer_start_)
+    };
   }
 
   token lex();
+  void fill();
+
+  void index(size_t offset, size_t length, std::vector<uint32_t> &lines) const;
+  void reset();
 
 public:
   lexer(diagnostics::engine &engine, const char32_t *buffer, size_t length)
       : diagnostics_engine_(engine), buffer_start_(buffer),
         buffer_end_(buffer + length), cursor_(buffer_start_), line_(1),
-        column_(0) {}
+        column_(0), lines_{0}, head_(0), checkpoints_(0) {
+    index(0, length, lines_);
+  }
+
+  /// A position in the token stream to which the lexer can be rewound.
+  class checkpoint {
+    friend class lexer;
+
+    size_t head_;
+    size_t lexed_;
+    location previous_end_;
+
+    checkpoint(size_t head, size_t lexed, location previous_end)
+        : head_(head), lexed_(lexed), previous_end_(previous_end) {}
+  };
+
+  /// Marks the current position in the token stream.  Each checkpoint must be
+  /// either rewound to or released, innermost first.
+  checkpoint mark();
+  /// Returns to \p checkpoint, releasing it.  Tokens whose lexing reported an
+  /// error after the checkpoint are lexed again, as the diagnostics reported
+  /// since are expected to be discarded.
+  void rewind(const checkpoint &checkpoint);
+  void release(const checkpoint &checkpoint);
+
+#if defined(SWIFT_PARSER_PROFILING)
+  /// The number of tokens consumed, including those consumed speculatively.
+  size_t consumed() const {
+    return consumed_;
+  }
+#endif
 
   token head();
   token peek();
   token next();
 
+  /// the end of the most recently consumed token
+  location previous_end() const {
+    return previous_end_;
+  }
+
+  /// Interns the identifiers which are lexed from now on in \p identifiers,
+  /// which the tokens then refer to.
+  void intern(identifier_table &identifiers) {
+    identifiers_ = &identifiers;
+  }
+
   void set_buffer(const char32_t *buffer, size_t length);
+  /// Replaces the buffer with an edited copy of it, in which the \p removed
+  /// characters at \p offset were replaced with \p inserted characters.  The
+  /// lines are indexed only around the edit.
+  void set_buffer(const char32_t *buffer, size_t length, size_t offset,
+                  size_t removed, size_t inserted);
+
+  /// Repositions the lexer at \p position, which must be the start of a token
+  /// in the current buffer, discarding any lookahead.
+  void seek(location position, location previous_end = location());
+
+  /// Computes the location of the character at \p offset in the current
+  /// buffer by scanning from the start of its line.
+  location locate(size_t offset) const;
 };
 }
 
@@ -37,15 +37,18 @@ namespace swift {
 class location {
   const unsigned line_;
   const unsigned column_;
+  const unsigned offset_;
 
 public:
-  constexpr location() : line_(0), column_(0) {}
+  constexpr location() : line_(0), column_(0), offset_(0) {}
 
-  location(unsigned line, unsigned column) : line_(line), column_(column) {}
+  location(unsigned line, unsigned column, unsigned offset = 0)
+      : line_(line), column_(column), offset_(offset) {}
 
   location& operator=(const location& rhs) {
     *const_cast<unsigned*>(&line_) = rhs.line_;
     *const_cast<unsigned*>(&column_) = rhs.column_;
+    *const_cast<unsigned*>(&offset_) = rhs.offset_;
     return *this;
   }
 
@@ -59,6 +62,10 @@ public:
   unsigned column() const {
     return column_;
   }
+  /// offset (in characters) from the start of the buffer
+  unsigned offset() const {
+    return offset_;
+  }
 
   bool valid() const {
     return static_cast<bool>(*this);
@@ -37,6 +37,8 @@
 #include "swift/lexer/location.hh"
 
 namespace swift {
+class identifier_info;
+
 class token {
 public:
   enum class type {
@@ -68,6 +70,7 @@ private:
   std::u32string_view value_;
   literal_type literal_type_;
   operator_type operator_type_;
+  identifier_info *identifier_ = nullptr;
 
 public:
   static const char32_t *canonical_spelling(token::type token_type);
@@ -93,10 +96,11 @@ public:
   }
 
   // identifier
-  token(std::u32string_view value, location begin, location end)
+  token(std::u32string_view value, location begin, location end,
+        identifier_info *identifier = nullptr)
       : type_(token::type::identifier), location_(begin, end), value_(value),
         literal_type_(literal_type::invalid),
-        operator_type_(operator_type::invalid) {}
+        operator_type_(operator_type::invalid), identifier_(identifier) {}
 
   // literal
   token(enum literal_type literal_type, std::u32string_view value,
@@ -137,6 +141,10 @@ public:
   std::u32string_view value() const {
     return value_;
   }
+  /// The interned identifier, if the lexer interned it.
+  identifier_info *identifier() const {
+    return identifier_;
+  }
 
   template <type Type>
   constexpr bool is() const {
@@ -0,0 +1,108 @@
+/**
+ * Copyright © 2014 Saleem Abdulrasool <compnerd@compnerd.org>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+
+#ifndef swift_parser_document_hh
+#define swift_parser_document_hh
+
+#include <cstdint>
+#include <ext/string_view>
+#include <string>
+#include <vector>
+
+namespace swift {
+class lexer;
+class parser;
+
+namespace ast {
+class statement;
+}
+
+namespace parse {
+/// A replacement of the `length` characters at `offset` with `text`.
+struct edit {
+  uint32_t offset;
+  uint32_t length;
+  std::u32string_view text;
+};
+
+/// A parsed source buffer which is kept up to date with edits.
+///
+/// An edit within the body of a function only causes that body to be
+/// reparsed (on request, as with delayed function bodies); any other edit
+/// reparses the top-level statements which it touches, stopping as soon as the
+/// parser reaches the start of an unaffected statement.  The remaining nodes
+/// are reused.  Only the statement containing an edit is adjusted for it; the
+/// statements after it are moved when they are next accessed.  The lexer and
+/// the parser are used for all subsequent parsing and must outlive the
+/// document.
+class document {
+  swift::lexer &lexer_;
+  swift::parser &parser_;
+  std::u32string source_;
+  std::vector<ast::statement *> statements_;
+  // the distance which each statement is yet to be moved by, as a Fenwick tree
+  // of the differences between adjacent statements
+  std::vector<int32_t> shifts_;
+  // whether any statement is yet to be moved
+  bool unsettled_ = false;
+
+  int32_t shift(size_t index) const;
+  void move(size_t index, int32_t delta);
+  void reindex(const std::vector<int32_t> &shifts);
+
+  uint32_t start(size_t index) const;
+  uint32_t end(size_t index) const;
+  void settle(size_t index);
+
+public:
+  document(swift::lexer &lexer, swift::parser &parser, std::u32string source);
+
+  const std::u32string &source() const {
+    return source_;
+  }
+
+  size_t size() const {
+    return statements_.size();
+  }
+  /// The statement at \p index, moved for any preceding edits.
+  ast::statement *statement(size_t index) {
+    settle(index);
+    return statements_[index];
+  }
+  /// The top-level statements, which are first moved for any edits since they
+  /// were last accessed.
+  const std::vector<ast::statement *> &statements();
+
+  /// Applies \p edit to the source and updates the top-level statements.
+  void apply(const edit &edit);
+};
+}
+}
+
+#endif
@@ -0,0 +1,104 @@
+/**
+ * Copyright © 2014 Saleem Abdulrasool <compnerd@compnerd.org>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+
+#ifndef swift_parser_parse_cache_hh
+#define swift_parser_parse_cache_hh
+
+#include <chrono>
+#include <cstdint>
+#include <ext/string_view>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace swift {
+class lexer;
+class parser;
+
+namespace ast {
+class context;
+class reader;
+class statement;
+class writer;
+}
+
+namespace compiler {
+struct target_options;
+}
+
+namespace parse {
+/// A content addressed, on-disk cache of serialised ASTs.
+///
+/// Entries are keyed on a hash of the source, the compiler build, the target
+/// options, and the parser settings.  As the key is only 64 bits, each entry
+/// also records the source length and an MD5 digest of the same inputs which
+/// are compared on lookup.  Entries are published atomically (by renaming a
+/// private temporary into place) so that parallel jobs may share a cache
+/// directory.
+class cache {
+public:
+  struct identity {
+    std::string key;
+    uint32_t length;
+    uint8_t digest[16];
+  };
+
+private:
+  std::string directory_;
+  std::string salt_;
+
+  std::string path(const std::string &key) const;
+
+public:
+  cache(std::string directory, const compiler::target_options &options);
+
+  identity identify(const swift::parser &parser,
+                    std::u32string_view source) const;
+
+  std::unique_ptr<ast::reader> lookup(ast::context &context,
+                                      const identity &identity,
+                                      swift::parser &parser) const;
+  bool store(const identity &identity, const ast::writer &writer) const;
+
+  /// Returns the top-level statements of \p source, loading them from the
+  /// cache if possible and otherwise parsing (and caching) them.  Loaded
+  /// statements are replayed through the semantic analyzer of \p parser, and
+  /// their skipped function bodies are parsed by \p parser on request.
+  std::vector<ast::statement *> parse(swift::parser &parser, swift::lexer &lexer,
+                                      ast::context &context,
+                                      std::u32string_view source) const;
+
+  /// Removes entries older than \p maximum_age, and then the least recently
+  /// used entries until the cache is no larger than \p maximum_size bytes.
+  void prune(uint64_t maximum_size, std::chrono::seconds maximum_age) const;
+};
+}
+}
+
+#endif
@@ -31,8 +31,10 @@
 #define swift_parser_parser_hh
 
 #include "swift/diagnostics/engine.hh"
+#include "swift/parser/profile.hh"
 #include "swift/parser/result.hh"
 #include "swift/semantic/analyzer.hh"
+#include "swift/syntax/function-declaration.hh"
 
 #include <array>
 #include <vector>
@@ -65,16 +67,47 @@ struct set<Type, Types...> {
   }
 };
 
-class parser {
+class parser : public ast::function_body_parser {
   lexer &lexer_;
   semantic::analyzer &semantic_analyzer_;
   diagnostics::engine &diagnostics_engine_;
+  bool delay_function_bodies_ = false;
+
+  // NOTE(compnerd) the expression, statement, type, and pattern productions are
+  // mutually recursive; their nesting is bounded so that generated or
+  // adversarial input cannot exhaust the stack.
+  unsigned depth_ = 0;
+  unsigned maximum_depth_ = 256;
+  bool unwinding_ = false;
+  // the offset of the delimiter closing the group skipped for its nesting
+  uint32_t unwinding_until_ = 0;
+
+  class nesting;
+  bool exceeds_maximum_depth();
+  void end_unwinding();
+
+#if defined(SWIFT_PARSER_PROFILING)
+  parse::profile profile_;
+#endif
 
   void consume_until(token::type);
 
   template <swift::token::type... Types>
   void consume_until(const set<Types...> &);
 
+  void synchronise();
+  void recover(location start);
+
+  template <typename Node>
+  parse::result<Node> &locate(parse::result<Node> &node, location start);
+
+  /// Runs \p production from a checkpoint of the token stream, holding back
+  /// its diagnostics.  The tokens and diagnostics are committed only if the
+  /// production succeeds without error; otherwise the lexer is rewound and a
+  /// null result is returned.
+  template <typename Production>
+  auto tentatively(Production &&production) -> decltype(production());
+
   parse::result<ast::statement> parse_statements();
   parse::result<ast::statement> parse_statement();
 
@@ -91,6 +124,7 @@ class parser {
   parse::result<ast::expression> parse_self_expression();
   parse::result<ast::expression> parse_superclass_expression();
   parse::result<ast::expression> parse_closure_expression();
+  parse::result<ast::pattern> parse_closure_signature();
   parse::result<ast::expression> parse_parenthesized_expression();
   parse::result<ast::expression> parse_implicit_member_expression();
   parse::result<ast::expression> parse_wildcard_expression();
@@ -158,6 +192,7 @@ class parser {
   parse::result<ast::declaration> parse_operator_declaration();
 
   parse::result<ast::statement> parse_code_block();
+  bool skip_code_block();
 
   bool parse_declaration_modifiers();
   bool parse_declaration_modifier();
@@ -204,20 +239,71 @@ class parser {
 
   diagnostics::builder
   diagnose(location location, diagnostics::diagnostic::id id) {
+    end_unwinding();
     return diagnostics_engine_.report(location, id);
   }
 
   diagnostics::builder diagnose(range range, diagnostics::diagnostic::id id) {
+    end_unwinding();
     return diagnostics_engine_.report(range, id);
   }
 
 public:
   parser(lexer &lexer, semantic::analyzer &semantic_analyzer,
-         diagnostics::engine &engine)
-      : lexer_(lexer), semantic_analyzer_(semantic_analyzer),
-        diagnostics_engine_(engine) {}
+         diagnostics::engine &engine);
 
   parse::result<ast::statement> parse_top_level_declaration();
+
+  /// Bounds the nesting of expressions, statements, types, and patterns.
+  /// Nesting beyond \p depth is diagnosed once and the nested group skipped.
+  void maximum_nesting_depth(unsigned depth) {
+    maximum_depth_ = depth;
+  }
+  unsigned maximum_nesting_depth() const {
+    return maximum_depth_;
+  }
+
+  /// Parse the source as a script (main file), whose top-level code forms the
+  /// entry point of the program, rather than as a library.
+  void script_mode(bool value) {
+    semantic_analyzer_.script_mode(value);
+  }
+  bool script_mode() const {
+    return semantic_analyzer_.script_mode();
+  }
+
+  /// Skip the bodies of function declarations, parsing them only when the
+  /// body is requested.  The lexer, its buffer, and the parser must outlive
+  /// any such request.
+  void delay_function_bodies(bool value) {
+    delay_function_bodies_ = value;
+  }
+  bool delay_function_bodies() const {
+    return delay_function_bodies_;
+  }
+
+#if defined(SWIFT_PARSER_PROFILING)
+  const parse::profile &profile() const {
+    return profile_;
+  }
+#endif
+
+  ast::statement *
+  parse_function_body(const ast::function_declaration &function) override;
+
+  /// Discards the body of \p function so that it is parsed from the current
+  /// buffer on request, provided that the body still ends at the offset \p end.
+  bool reparse_function_body(ast::function_declaration &function, uint32_t end);
+
+  /// Analyses \p statement, which was loaded (see parse::cache) rather than
+  /// parsed from the current buffer, as though it had just been parsed.
+  void replay(ast::statement *statement) {
+    semantic_analyzer_.replay(statement, lexer_);
+  }
+
+  /// Removes \p declaration, which has been replaced by reparsing, from its
+  /// declaration context and from the names in scope.
+  void forget(ast::declaration *declaration);
 };
 }
 
@@ -0,0 +1,112 @@
+/**
+ * Copyright © 2014 Saleem Abdulrasool <compnerd@compnerd.org>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+
+
+#ifndef swift_parser_profile_hh
+#define swift_parser_profile_hh
+
+// NOTE(compnerd) the instrumentation is only built when configured with
+// SWIFT_PARSER_PROFILING; otherwise PROFILE_PRODUCTION expands to nothing and
+// the parser carries no profiling state.
+#if defined(SWIFT_PARSER_PROFILING)
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+namespace swift {
+class lexer;
+
+namespace parse {
+/// Accumulates the invocations, tokens consumed, and time spent per parser
+/// production.  A profile is per-parser; profiles of parsers which ran
+/// concurrently are combined with `merge`.
+class profile {
+  using clock = std::chrono::steady_clock;
+
+  struct production {
+    uint64_t invocations = 0;
+    uint64_t tokens = 0;
+    clock::duration time = clock::duration::zero();
+    unsigned active = 0;
+  };
+
+  std::vector<production> productions_;
+
+  production &entry(unsigned id) {
+    if (id >= productions_.size())
+      productions_.resize(id + 1);
+    return productions_[id];
+  }
+
+public:
+  /// Returns the identifier for the production named \p name.  This is
+  /// expected to be called once per production (the result is cached in a
+  /// function local static by PROFILE_PRODUCTION).
+  static unsigned intern(const char *name);
+
+  /// Times a single invocation of a production.  Recursive invocations are
+  /// counted, but their tokens and time are attributed to the outermost
+  /// invocation only so that the cumulative figures are not inflated.
+  class scope {
+    profile &profile_;
+    const lexer &lexer_;
+    unsigned id_;
+    size_t tokens_;
+    clock::time_point start_;
+
+  public:
+    scope(profile &profile, unsigned id, const lexer &lexer);
+    ~scope();
+
+    scope(const scope &) = delete;
+    scope &operator=(const scope &) = delete;
+  };
+
+  void merge(const profile &other);
+
+  /// Prints the productions, most expensive first.
+  void print(std::ostream &os) const;
+};
+}
+}
+
+#define PROFILE_PRODUCTION()                                                   \
+  static const unsigned production_profile_id =                                \
+      ::swift::parse::profile::intern(__func__);                               \
+  ::swift::parse::profile::scope production_profile(profile_,                  \
+                                                    production_profile_id,     \
+                                                    lexer_)
+#else
+#define PROFILE_PRODUCTION() do { } while (0)
+#endif
+
+#endif
@@ -32,18 +32,34 @@
 
 #include "swift/diagnostics/engine.hh"
 #include "swift/lexer/token.hh"
+#include "swift/semantic/constant_evaluator.hh"
+#include "swift/semantic/evaluator.hh"
 #include "swift/semantic/scope.hh"
+#include "swift/semantic/symbol_table.hh"
+#include "swift/semantic/type_checker.hh"
+#include "swift/syntax/operator-declaration.hh"
 #include "swift/syntax/switch-statement.hh"
 
+#include <llvm/ADT/ArrayRef.h>
+#include <llvm/ADT/DenseMap.h>
+
+#include <functional>
+#include <memory>
+#include <optional>
 #include <vector>
 #include <ext/string_view>
 
 namespace swift {
+class identifier_info;
+class lexer;
+class thread_pool;
+
 namespace ast {
 class context;
 class declaration;
 class declaration_context;
 class expression;
+class function_declaration;
 class pattern;
 class statement;
 class type;
@@ -56,6 +72,42 @@ class analyzer {
   ast::context &ast_context_;
   diagnostics::engine &diagnostics_engine_;
   ast::declaration_context *declaration_context_;
+  symbol_table symbols_;
+  semantic::evaluator evaluator_;
+  std::optional<semantic::type_checker> type_checker_;
+  std::optional<semantic::constant_evaluator> constant_evaluator_;
+  bool script_mode_ = false;
+
+  struct infix_operator {
+    uint8_t precedence;
+    enum ast::operator_declaration::associativity associativity;
+  };
+
+  // the infix operators known when folding sequences, keyed on interned name
+  llvm::DenseMap<const identifier_info *, infix_operator> infix_operators_;
+
+  // the functions whose bodies were skipped while parsing, which are analysed
+  // once the declarations that they may reference are known, and the state of
+  // the analysis of each of the bodies which is underway
+  struct function_body;
+  std::vector<ast::function_declaration *> deferred_functions_;
+  std::vector<std::unique_ptr<function_body>> function_bodies_;
+
+  void declare_infix_operator(std::u32string_view name, uint8_t precedence,
+                              enum ast::operator_declaration::associativity);
+  infix_operator lookup_infix_operator(const ast::expression *op,
+                                       range range);
+  ast::expression *fold_binary_expression(ast::expression *op,
+                                          ast::expression *lhs,
+                                          ast::expression *rhs);
+  ast::expression *
+  fold_sequence_expression(const std::vector<ast::expression *> &expressions,
+                           const std::vector<range> &operators);
+
+  void bind(const ast::pattern *pattern, ast::declaration *declaration);
+  void bind(std::u32string_view name, ast::declaration *declaration);
+  void bind(ast::declaration *declaration);
+  void unbind(const ast::pattern *pattern, const ast::declaration *declaration);
 
   analyzer(const analyzer &) = delete;
   analyzer &operator=(const analyzer &) = delete;
@@ -94,7 +146,36 @@ public:
     }
   };
 
+  class lexical_scope_raii {
+    symbol_table &symbols_;
+    bool active_;
+
+  public:
+    explicit lexical_scope_raii(analyzer &semantic_analyzer)
+        : symbols_(semantic_analyzer.symbols_), active_(true) {
+      symbols_.push_scope();
+    }
+
+    ~lexical_scope_raii() {
+      reset();
+    }
+
+    void reset() {
+      if (active_)
+        symbols_.pop_scope();
+      active_ = false;
+    }
+
+    lexical_scope_raii(const lexical_scope_raii &) = delete;
+    lexical_scope_raii &operator=(const lexical_scope_raii &) = delete;
+  };
+
+  /// Parses the body of \p function, which was skipped, with \p analyzer.
+  using body_parser = std::function<ast::statement *(
+      const ast::function_declaration &function, analyzer &analyzer)>;
+
   analyzer(ast::context &ast_context);
+  ~analyzer();
 
   const scope &current_scope() const noexcept {
     return scope_;
@@ -107,14 +188,98 @@ public:
     return ast_context_;
   }
 
+  /// The semantic properties of the declarations analysed, evaluated on
+  /// demand.
+  semantic::evaluator &evaluator() {
+    return evaluator_;
+  }
+
+  /// Treat the source as a script (main file), accepting top-level code, rather
+  /// than as a library.
+  void script_mode(bool value) {
+    script_mode_ = value;
+  }
+  bool script_mode() const {
+    return script_mode_;
+  }
+
+  /// Infers the types of the expressions analysed from here on, within
+  /// \p limits.
+  void type_check(const semantic::type_checker::limits &limits) {
+    type_checker_.emplace(ast_context_, diagnostics_engine_, evaluator_,
+                          limits);
+    constant_evaluator_.emplace(ast_context_, diagnostics_engine_,
+                                &*type_checker_);
+  }
+
+  /// The values of the constant expressions analysed, if type checking.
+  const semantic::constant_evaluator *constants() const {
+    return constant_evaluator_ ? &*constant_evaluator_ : nullptr;
+  }
+
+  /// Binds the names of the parameters in \p parameter_clause in the current
+  /// lexical scope, ahead of the body of the function.
+  void bind_parameters(const ast::pattern *parameter_clause);
+
+  /// Infers the type of the expression statement \p expression, folding it if
+  /// it is constant.
+  void check_expression(const ast::expression *expression, range range);
+
+  /// Infers the type of \p initializer, if any, which initializes the names
+  /// bound by \p pattern.
+  void check_initializer(const ast::pattern *pattern,
+                         const ast::expression *initializer, range range);
+
+  /// Checks the uses of the local variables of the function body \p body once
+  /// it is complete, locating its statements through \p lexer.
+  void check_function_body(const ast::statement *body, const lexer &lexer);
+
+  /// Checks that the cases of \p statement, spanning \p range, are exhaustive
+  /// and that none is redundant, where \p items are the ranges of the case
+  /// items in order.
+  void check_switch(ast::switch_statement *statement, range range,
+                    llvm::ArrayRef<swift::range> items);
+
+  /// Defers the analysis of the body of \p function, which was skipped while
+  /// parsing, until `analyze_function_bodies`.
+  void defer(ast::function_declaration *function) {
+    deferred_functions_.push_back(function);
+  }
+
+  /// Analyses \p statement, a top-level statement which was loaded from a
+  /// serialised AST rather than parsed, as the parser would have: the names
+  /// which it declares are bound, its operators declared, its initializers
+  /// checked, and its skipped function bodies deferred.  The statements are
+  /// located through \p lexer.
+  void replay(ast::statement *statement, const lexer &lexer);
+
+  /// Analyses the deferred function bodies in parallel on \p pool, each with
+  /// an analyzer, context, and diagnostics of its own, as parsed by
+  /// \p parse_body.  The declarations enclosing the functions are only read,
+  /// and their types are formed in the context of this analyzer.  Once the
+  /// tasks are complete, `complete_function_bodies` must be called before the
+  /// bodies or their diagnostics are used.
+  void analyze_function_bodies(thread_pool &pool, const body_parser &parse_body);
+
+  /// Reports the diagnostics of the analysed function bodies in the order in
+  /// which the functions were declared, and keeps the nodes of the bodies.
+  void complete_function_bodies();
+
+  /// Removes the bindings introduced by \p declaration.
+  void unbind(const ast::declaration *declaration);
+
   /* expression constructors */
   ast::expression *prefix_unary_expression(ast::expression *prefix_operator,
                                            ast::expression *subexpression);
 
   ast::expression *in_out_expression(ast::expression *subexpression);
 
+  /// Folds the alternating operands and binary operators of \p expressions
+  /// into a tree according to the precedence of the operators, whose source
+  /// ranges are \p operators.
   ast::expression *
-  sequence_expression(const std::vector<ast::expression *> &expressions);
+  sequence_expression(const std::vector<ast::expression *> &expressions,
+                      const std::vector<range> &operators);
 
   ast::expression *postfix_unary_expression(ast::expression *subexpression,
                                             ast::expression *postfix_operator);
@@ -126,11 +291,11 @@ public:
                                           ast::expression *if_true,
                                           ast::expression *if_false);
 
-  ast::expression *is_subtype_expression();
+  ast::expression *is_subtype_expression(ast::type *type);
 
-  ast::expression *checked_cast_expression();
+  ast::expression *checked_cast_expression(ast::type *type);
 
-  ast::expression *conditional_checked_cast_expression();
+  ast::expression *conditional_checked_cast_expression(ast::type *type);
 
   ast::expression *
   function_call(ast::expression *function, ast::expression *arguments);
@@ -150,7 +315,7 @@ public:
 
   ast::expression *optional_chaining_expression();
 
-  ast::expression *declaration_reference_expression(std::u32string_view value);
+  ast::expression *declaration_reference_expression(const swift::token &name);
 
   ast::expression *boolean_literal_expression(const token &token);
 
@@ -170,7 +335,8 @@ public:
 
   ast::expression *superclass_expression();
 
-  ast::expression *closure_expression(ast::statement *statements);
+  ast::expression *closure_expression(ast::pattern *parameters,
+                                      ast::statement *statements);
 
   ast::expression *
   parenthesized_expression(const std::vector<ast::expression *> &elements);
@@ -191,7 +357,8 @@ public:
   variable_declaration(ast::pattern *name, ast::expression *initializer);
 
   ast::declaration *
-  typealias_declaration(std::u32string_view alias, std::u32string_view type);
+  typealias_declaration(std::u32string_view alias,
+                        std::u32string_view type_name, ast::type *type);
 
   ast::declaration *
   function_declaration(std::u32string_view functionname,
@@ -281,6 +448,8 @@ public:
 
   /* auxiliary constructors */
   ast::declaration *enumeration_element_declaration(std::u32string_view name);
+  ast::declaration *top_level_declaration(range code_range,
+                                          std::vector<ast::statement *> &code);
 
   /* pattern constructors */
   ast::pattern *pattern_any();
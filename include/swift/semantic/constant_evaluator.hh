@@ -0,0 +1,165 @@
+/**
+ * Copyright © 2014 Saleem Abdulrasool <compnerd@compnerd.org>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+
+
+#ifndef swift_semantic_constant_evaluator_hh
+#define swift_semantic_constant_evaluator_hh
+
+#include "swift/lexer/location.hh"
+#include "swift/semantic/type.hh"
+
+#include <llvm/ADT/APFloat.h>
+#include <llvm/ADT/APSInt.h>
+#include <llvm/ADT/DenseMap.h>
+
+#include <deque>
+#include <ext/string_view>
+
+namespace swift {
+namespace ast {
+class binary_expression;
+class context;
+class declaration_reference_expression;
+class expression;
+class integer_literal_expression;
+class prefix_unary_expression;
+}
+
+namespace diagnostics {
+class engine;
+}
+
+namespace semantic {
+class type_checker;
+
+/// The value of an expression which is known at compile time.
+class constant {
+public:
+  enum class kind { integer, floating_point, boolean };
+
+private:
+  enum kind kind_;
+  llvm::APSInt integer_;
+  llvm::APFloat floating_point_;
+  bool boolean_;
+
+public:
+  explicit constant(llvm::APSInt value)
+      : kind_(kind::integer), integer_(std::move(value)),
+        floating_point_(0.0), boolean_(false) {}
+  explicit constant(llvm::APFloat value)
+      : kind_(kind::floating_point), floating_point_(std::move(value)),
+        boolean_(false) {}
+  explicit constant(bool value)
+      : kind_(kind::boolean), floating_point_(0.0), boolean_(value) {}
+
+  enum kind kind() const {
+    return kind_;
+  }
+
+  const llvm::APSInt &integer() const {
+    assert(kind_ == kind::integer && "constant is not an integer");
+    return integer_;
+  }
+  const llvm::APFloat &floating_point() const {
+    assert(kind_ == kind::floating_point &&
+           "constant is not a floating point value");
+    return floating_point_;
+  }
+  bool boolean() const {
+    assert(kind_ == kind::boolean && "constant is not a boolean");
+    return boolean_;
+  }
+};
+
+/// Folds the expressions over literals (and the constants initialised by them)
+/// into their values.
+///
+/// The expressions are evaluated over the tree of operators once folded and
+/// typed, and so an integer is evaluated at the width of the type inferred for
+/// it.  The values are recorded in a side table rather than in the tree so that
+/// the tree remains as it was spelt.  Only the builtin operators are evaluated;
+/// an operator implemented by a function is not constant.
+class constant_evaluator {
+  ast::context &ast_context_;
+  diagnostics::engine &diagnostics_engine_;
+  const type_checker *type_checker_;
+
+  std::deque<constant> constants_;
+  // the value of each expression evaluated, or null if it is not constant
+  llvm::DenseMap<const ast::expression *, const constant *> values_;
+
+  constant_evaluator(const constant_evaluator &) = delete;
+  constant_evaluator &operator=(const constant_evaluator &) = delete;
+
+  const constant *intern(constant value);
+  const builtin_type *type_of(const ast::expression *expression,
+                              builtin_type::kind fallback) const;
+
+  // a null range evaluates the expression without diagnosing it
+  const constant *evaluate(const ast::expression *expression,
+                           const range *range);
+  const constant *
+  evaluate_integer_literal(const ast::integer_literal_expression *literal,
+                           bool negative, const range *range);
+  const constant *
+  evaluate_prefix(const ast::prefix_unary_expression *expression,
+                  const range *range);
+  const constant *evaluate_binary(const ast::binary_expression *expression,
+                                  const range *range);
+  const constant *
+  evaluate_reference(const ast::declaration_reference_expression *reference);
+
+  const constant *evaluate_integer(std::u32string_view op,
+                                   const llvm::APSInt &lhs,
+                                   const llvm::APSInt &rhs,
+                                   const range *range);
+  const constant *evaluate_floating_point(std::u32string_view op,
+                                          const llvm::APFloat &lhs,
+                                          const llvm::APFloat &rhs);
+  const constant *evaluate_boolean(std::u32string_view op, bool lhs, bool rhs);
+
+public:
+  /// Evaluates expressions at the types inferred by \p type_checker, or at the
+  /// default literal types if it is null.
+  constant_evaluator(ast::context &ast_context,
+                     diagnostics::engine &diagnostics_engine,
+                     const type_checker *type_checker);
+
+  /// Evaluates \p expression, diagnosing at \p range an operation which
+  /// overflows or divides by zero.  Returns null if it is not constant.
+  const constant *fold(const ast::expression *expression, range range);
+
+  /// The value of \p expression if it has been folded and is constant.
+  const constant *value(const ast::expression *expression) const;
+};
+}
+}
+
+#endif
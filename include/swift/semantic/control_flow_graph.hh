@@ -0,0 +1,110 @@
+/**
+ * Copyright © 2014 Saleem Abdulrasool <compnerd@compnerd.org>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+
+
+#ifndef swift_semantic_control_flow_graph_hh
+#define swift_semantic_control_flow_graph_hh
+
+#include <llvm/ADT/ArrayRef.h>
+
+#include <cstdint>
+
+namespace swift {
+namespace ast {
+class context;
+class statement;
+}
+
+namespace semantic {
+/// The control flow graph of the body of a function.
+///
+/// The statements of the body are partitioned into basic blocks, each executed
+/// in order from first to last, joined by the edges along which control may
+/// flow.  The condition of a branch is the last statement of the block which
+/// it terminates, and a control transfer statement is the last statement of
+/// its block.  The body of a `defer` statement is laid out along every path
+/// which leaves its scope.
+///
+/// The blocks are numbered in the order in which they are laid out (which is
+/// the order of the source, outside of loops), and their statements, successors
+/// and predecessors are stored consecutively in arrays allocated from the AST
+/// context and indexed by block number, so that an analysis visits each block
+/// and edge in turn without chasing pointers.
+class control_flow_graph {
+  unsigned size_;
+  // block `n` spans [offsets[n], offsets[n + 1]) of the corresponding array
+  const uint32_t *statement_offsets_;
+  const ast::statement *const *statements_;
+  const ast::statement *const *terminators_;
+  const uint32_t *successor_offsets_;
+  const unsigned *successors_;
+  const uint32_t *predecessor_offsets_;
+  const unsigned *predecessors_;
+
+public:
+  /// The block at which control enters the function.
+  static constexpr unsigned entry = 0;
+  /// The block to which control is transferred when leaving the function,
+  /// whether returning, throwing or reaching the end of the body.  It has no
+  /// statements.
+  static constexpr unsigned exit = 1;
+
+  /// Builds the graph of the function body \p body in \p context.
+  control_flow_graph(ast::context &context, const ast::statement *body);
+
+  /// The number of blocks in the graph.
+  unsigned size() const {
+    return size_;
+  }
+
+  llvm::ArrayRef<const ast::statement *> statements(unsigned block) const {
+    return llvm::makeArrayRef(statements_ + statement_offsets_[block],
+                              statements_ + statement_offsets_[block + 1]);
+  }
+
+  /// The statement which transfers control out of \p block, or null if
+  /// control simply continues to its successor.
+  const ast::statement *terminator(unsigned block) const {
+    return terminators_[block];
+  }
+
+  llvm::ArrayRef<unsigned> successors(unsigned block) const {
+    return llvm::makeArrayRef(successors_ + successor_offsets_[block],
+                              successors_ + successor_offsets_[block + 1]);
+  }
+
+  llvm::ArrayRef<unsigned> predecessors(unsigned block) const {
+    return llvm::makeArrayRef(predecessors_ + predecessor_offsets_[block],
+                              predecessors_ + predecessor_offsets_[block + 1]);
+  }
+};
+}
+}
+
+#endif
@@ -0,0 +1,92 @@
+/**
+ * Copyright © 2014 Saleem Abdulrasool <compnerd@compnerd.org>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+
+
+#ifndef swift_semantic_dataflow_hh
+#define swift_semantic_dataflow_hh
+
+#include <llvm/ADT/BitVector.h>
+#include <llvm/ADT/SmallVector.h>
+
+#include <vector>
+
+namespace swift::semantic {
+class control_flow_graph;
+
+/// Solves a dataflow problem over the blocks of a control flow graph, whose
+/// facts are sets of ordinals (e.g. of the local variables of a function)
+/// represented as bit vectors.
+///
+/// The effect of each block is summarised by the facts which it generates and
+/// those which it kills.  These are listed sparsely, as a block touches few of
+/// the facts.  The blocks are taken from a worklist in layout order (which
+/// places the header of a loop before its body), and a block is only revisited
+/// once the facts flowing into it change.  A function with thousands of facts
+/// and hundreds of branches is thus solved in a few passes over the graph.
+class dataflow {
+public:
+  enum class direction { forward, backward };
+
+  /// Whether a fact flowing into a block must hold along all of the paths
+  /// into it, or along any of them.
+  enum class meet { all_paths, any_path };
+
+  /// The effect of a block: the facts flowing out of it are those flowing into
+  /// it, less those killed, and with those generated.  A fact should be listed
+  /// at most once, by the last effect of the block upon it.
+  struct transfer {
+    llvm::SmallVector<unsigned, 4> generated;
+    llvm::SmallVector<unsigned, 4> killed;
+  };
+
+private:
+  const control_flow_graph &graph_;
+  unsigned facts_;
+  enum direction direction_;
+  enum meet meet_;
+  std::vector<transfer> transfers_;
+
+public:
+  dataflow(const control_flow_graph &graph, unsigned facts,
+           enum direction direction, enum meet meet);
+
+  transfer &effect(unsigned block) {
+    return transfers_[block];
+  }
+
+  /// Solves the problem given the \p boundary facts, which hold upon entering
+  /// the function (or leaving it, for a backward problem).  Returns the facts
+  /// which flow into each block, in the direction of the problem.  A block
+  /// which is unreachable is assumed to admit every fact which must hold along
+  /// all paths.
+  std::vector<llvm::BitVector> solve(const llvm::BitVector &boundary) const;
+};
+}
+
+#endif
@@ -0,0 +1,139 @@
+/**
+ * Copyright © 2014 Saleem Abdulrasool <compnerd@compnerd.org>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+
+
+#ifndef swift_semantic_evaluator_hh
+#define swift_semantic_evaluator_hh
+
+#include "swift/semantic/type.hh"
+
+#include <llvm/ADT/ArrayRef.h>
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/ADT/SmallVector.h>
+
+#include <vector>
+#include <ext/string_view>
+
+namespace swift {
+namespace ast {
+class context;
+class declaration;
+class declaration_context;
+class function_declaration;
+class type;
+class type_identifier;
+}
+
+namespace diagnostics {
+class engine;
+}
+
+namespace semantic {
+/// Evaluates the semantic properties of declarations on demand.
+///
+/// Each property is a request keyed on its inputs, whose result is memoised so
+/// that only what is needed is computed, and then only once.  The requests made
+/// while evaluating a request are recorded so that invalidating a result also
+/// invalidates the results derived from it.  A request which depends upon
+/// itself (e.g. a typealias naming itself) is diagnosed and evaluates to null
+/// rather than recursing without bound.
+class evaluator {
+  enum class request_kind : uint8_t { interface_type, members, resolved_type };
+
+  struct request {
+    request_kind kind;
+    const void *subject;
+  };
+
+  struct request_info {
+    static request getEmptyKey();
+    static request getTombstoneKey();
+    static unsigned getHashValue(const request &request);
+    static bool isEqual(const request &lhs, const request &rhs);
+  };
+
+  // the result of a request whose evaluation is underway is incomplete
+  struct result {
+    const void *value = nullptr;
+    size_t size = 0;
+    bool complete = false;
+  };
+
+  ast::context &ast_context_;
+  diagnostics::engine &diagnostics_engine_;
+
+  llvm::DenseMap<request, result, request_info> results_;
+  // the requests which made each request while they were being evaluated
+  llvm::DenseMap<request, llvm::SmallVector<request, 2>, request_info>
+      dependents_;
+  // the requests being evaluated, innermost last
+  std::vector<request> active_;
+
+  evaluator(const evaluator &) = delete;
+  evaluator &operator=(const evaluator &) = delete;
+
+  template <typename Compute>
+  result evaluate(const request &key, std::u32string_view name,
+                  Compute compute);
+  void invalidate(const request &key);
+
+  const ast::declaration *lookup(std::u32string_view name);
+  const type *signature_type(const ast::function_declaration *function);
+
+public:
+  evaluator(ast::context &ast_context, diagnostics::engine &diagnostics_engine);
+
+  /// The type of a reference to \p declaration, or null if it is not known
+  /// without inference or is not yet modelled (e.g. a nominal type).
+  const type *interface_type(const ast::declaration *declaration);
+
+  /// The declarations which are members of \p context, in declaration order.
+  llvm::ArrayRef<const ast::declaration *>
+  members(const ast::declaration_context *context);
+
+  /// The type named by \p identifier.  The first component of the name is
+  /// resolved in the lexical scope being analysed, and so the identifier must
+  /// be resolved where it is spelt (or once the file scope is complete).
+  const type *resolved_type(const ast::type_identifier *identifier);
+
+  /// The type spelt by \p type, resolving the names within it.
+  const type *resolve(const ast::type *type);
+
+  /// Forgets the interface type of \p declaration, e.g. once it is reparsed,
+  /// along with the results derived from it.
+  void invalidate_interface_type(const ast::declaration *declaration);
+
+  /// Forgets the members of \p context, e.g. once a declaration is added to or
+  /// removed from it, along with the results derived from them.
+  void invalidate_members(const ast::declaration_context *context);
+};
+}
+}
+
+#endif
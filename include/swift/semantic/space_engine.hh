@@ -0,0 +1,93 @@
+/**
+ * Copyright © 2014 Saleem Abdulrasool <compnerd@compnerd.org>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+
+
+#ifndef swift_semantic_space_engine_hh
+#define swift_semantic_space_engine_hh
+
+#include "swift/lexer/location.hh"
+
+#include <llvm/ADT/ArrayRef.h>
+
+namespace swift {
+namespace ast {
+class declaration_context;
+class switch_statement;
+}
+
+namespace diagnostics {
+class engine;
+}
+
+namespace semantic {
+class evaluator;
+class type_checker;
+
+/// Checks that the cases of a switch statement cover every value of its
+/// subject, and that each case matches some value which no earlier case does.
+///
+/// The values which a pattern matches are described as a space: everything of
+/// a type, a constructor (an enumeration element, a boolean, or a tuple) over
+/// the spaces of its components, a range of integers, or a union of spaces.
+/// The values which are not matched by a switch are what remains of the space
+/// of the subject once the space of each case is subtracted from it in turn.
+/// A space is only decomposed into its constructors when a pattern tells them
+/// apart, and a tuple is subtracted one component at a time, so that the
+/// spaces stay proportional to the patterns rather than to the product of the
+/// types of the components.  The spaces are uniqued and the differences are
+/// memoised, which keeps the repeated subtractions of large switches linear in
+/// practice.
+///
+/// A case with a guard may not match, and so does not cover anything.  A
+/// pattern which is not understood (e.g. an expression pattern which is not a
+/// literal) may cover anything, and so the switch is then taken to be
+/// exhaustive.
+class space_engine {
+  diagnostics::engine &diagnostics_engine_;
+  semantic::evaluator &evaluator_;
+  const type_checker &type_checker_;
+  const ast::declaration_context *declaration_context_;
+
+public:
+  /// Resolves the enumerations which are referenced implicitly (e.g. `.north`)
+  /// among the members of \p declaration_context and its parents.
+  space_engine(diagnostics::engine &diagnostics_engine,
+               semantic::evaluator &evaluator, const type_checker &type_checker,
+               const ast::declaration_context *declaration_context);
+
+  /// Checks \p statement, spanning \p range, where \p items are the ranges of
+  /// its case items in order (with a `default` case as a single item).
+  /// Returns whether every value of the subject is matched by some case.
+  bool check(const ast::switch_statement *statement, range range,
+             llvm::ArrayRef<swift::range> items);
+};
+}
+}
+
+#endif
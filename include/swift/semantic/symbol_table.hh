@@ -0,0 +1,96 @@
+/**
+ * Copyright © 2014 Saleem Abdulrasool <compnerd@compnerd.org>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+
+
+#ifndef swift_semantic_symbol_table_hh
+#define swift_semantic_symbol_table_hh
+
+#include <deque>
+#include <vector>
+
+namespace swift {
+class identifier_info;
+
+namespace ast {
+class declaration;
+class pattern_named;
+}
+
+namespace semantic {
+/// The names bound in the lexical scopes being analysed.
+///
+/// In the manner of clang's IdentifierResolver, each identifier refers to its
+/// innermost binding, which in turn refers to the binding that it shadows.  A
+/// name is thus resolved in constant time irrespective of the number of names
+/// in scope, and a scope is pushed in constant time and popped in time linear
+/// in the names bound within it.
+class symbol_table {
+public:
+  struct binding {
+    identifier_info *name;
+    /// The declaration introducing the name, if any (parameters are bound
+    /// before their function is declared).
+    ast::declaration *declaration;
+    /// The named pattern introducing the name, for values.
+    const ast::pattern_named *pattern;
+    binding *shadowed;
+  };
+
+private:
+  // NOTE(compnerd) a deque so that the bindings do not move as others are added
+  std::deque<binding> bindings_;
+  std::vector<size_t> scopes_;
+
+public:
+  symbol_table() = default;
+  ~symbol_table();
+
+  symbol_table(const symbol_table &) = delete;
+  symbol_table &operator=(const symbol_table &) = delete;
+
+  void push_scope() {
+    scopes_.push_back(bindings_.size());
+  }
+  void pop_scope();
+
+  /// Binds \p name in the innermost scope, shadowing any outer binding.
+  void bind(identifier_info &name, ast::declaration *declaration,
+            const ast::pattern_named *pattern);
+
+  /// Removes the bindings of \p name to \p declaration (e.g. when it is
+  /// replaced by reparsing), in time linear in the bindings of \p name.
+  void unbind(identifier_info &name, const ast::declaration *declaration);
+
+  /// The innermost binding of \p name, or null if it is not bound.
+  static const binding *lookup(const identifier_info &name);
+};
+}
+}
+
+#endif
@@ -30,6 +30,9 @@
 #ifndef swift_semantic_type_hh
 #define swift_semantic_type_hh
 
+#include <llvm/ADT/ArrayRef.h>
+#include <llvm/ADT/FoldingSet.h>
+
 #include <cstddef>
 
 namespace swift {
@@ -89,6 +92,11 @@ public:
 
 enum class typeclass {
   builtin,
+  tuple,
+  function,
+  array,
+  dictionary,
+  metatype,
 };
 
 class type {
@@ -122,6 +130,7 @@ protected:
   union {
     type_info type_info;
     builtin_type_info builtin_type_info;
+    function_type_info function_type_info;
   };
 
   type(typeclass typeclass, qualified_type canonical_type)
@@ -219,6 +228,134 @@ public:
 
   bool is_floating_point() const;
 };
+
+// NOTE(compnerd) the structural types are uniqued by the ast::context; the
+// `Profile` members are named for llvm::FoldingSet.
+
+class tuple_type : public type, public llvm::FoldingSetNode {
+  friend class ast::context;
+
+  llvm::ArrayRef<const type *> elements_;
+
+  tuple_type(llvm::ArrayRef<const type *> elements)
+      : type(typeclass::tuple, qualified_type()), elements_(elements) {}
+
+public:
+  llvm::ArrayRef<const type *> elements() const {
+    return elements_;
+  }
+
+  static void profile(llvm::FoldingSetNodeID &id,
+                      llvm::ArrayRef<const type *> elements) {
+    id.AddInteger(elements.size());
+    for (const auto *element : elements)
+      id.AddPointer(element);
+  }
+  void Profile(llvm::FoldingSetNodeID &id) const {
+    profile(id, elements_);
+  }
+};
+
+class function_type : public type, public llvm::FoldingSetNode {
+  friend class ast::context;
+
+  const type *parameter_type_;
+  const type *result_type_;
+
+  function_type(const type *parameter_type, const type *result_type)
+      : type(typeclass::function, qualified_type()),
+        parameter_type_(parameter_type), result_type_(result_type) {
+    function_type_info.call_info = 0;
+  }
+
+public:
+  const type *parameter_type() const {
+    return parameter_type_;
+  }
+  const type *result_type() const {
+    return result_type_;
+  }
+
+  static void profile(llvm::FoldingSetNodeID &id, const type *parameter_type,
+                      const type *result_type) {
+    id.AddPointer(parameter_type);
+    id.AddPointer(result_type);
+  }
+  void Profile(llvm::FoldingSetNodeID &id) const {
+    profile(id, parameter_type_, result_type_);
+  }
+};
+
+class array_type : public type, public llvm::FoldingSetNode {
+  friend class ast::context;
+
+  const type *element_type_;
+
+  array_type(const type *element_type)
+      : type(typeclass::array, qualified_type()), element_type_(element_type) {}
+
+public:
+  const type *element_type() const {
+    return element_type_;
+  }
+
+  static void profile(llvm::FoldingSetNodeID &id, const type *element_type) {
+    id.AddPointer(element_type);
+  }
+  void Profile(llvm::FoldingSetNodeID &id) const {
+    profile(id, element_type_);
+  }
+};
+
+class dictionary_type : public type, public llvm::FoldingSetNode {
+  friend class ast::context;
+
+  const type *key_type_;
+  const type *value_type_;
+
+  dictionary_type(const type *key_type, const type *value_type)
+      : type(typeclass::dictionary, qualified_type()), key_type_(key_type),
+        value_type_(value_type) {}
+
+public:
+  const type *key_type() const {
+    return key_type_;
+  }
+  const type *value_type() const {
+    return value_type_;
+  }
+
+  static void profile(llvm::FoldingSetNodeID &id, const type *key_type,
+                      const type *value_type) {
+    id.AddPointer(key_type);
+    id.AddPointer(value_type);
+  }
+  void Profile(llvm::FoldingSetNodeID &id) const {
+    profile(id, key_type_, value_type_);
+  }
+};
+
+class metatype_type : public type, public llvm::FoldingSetNode {
+  friend class ast::context;
+
+  const type *instance_type_;
+
+  metatype_type(const type *instance_type)
+      : type(typeclass::metatype, qualified_type()),
+        instance_type_(instance_type) {}
+
+public:
+  const type *instance_type() const {
+    return instance_type_;
+  }
+
+  static void profile(llvm::FoldingSetNodeID &id, const type *instance_type) {
+    id.AddPointer(instance_type);
+  }
+  void Profile(llvm::FoldingSetNodeID &id) const {
+    profile(id, instance_type_);
+  }
+};
 }
 }
 
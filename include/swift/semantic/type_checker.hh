@@ -0,0 +1,211 @@
+/**
+ * Copyright © 2014 Saleem Abdulrasool <compnerd@compnerd.org>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+
+
+#ifndef swift_semantic_type_checker_hh
+#define swift_semantic_type_checker_hh
+
+#include "swift/lexer/location.hh"
+#include "swift/semantic/type.hh"
+
+#include <llvm/ADT/ArrayRef.h>
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/ADT/SmallVector.h>
+
+#include <vector>
+
+namespace swift {
+class identifier_info;
+
+namespace ast {
+class context;
+class declaration;
+class declaration_reference_expression;
+class expression;
+class pattern;
+class pattern_named;
+}
+
+namespace diagnostics {
+class engine;
+}
+
+namespace semantic {
+class evaluator;
+
+/// Infers the types of expressions.
+///
+/// Each expression is given a type variable; the variables are related by
+/// constraints which are solved by unification, with the variables merged in
+/// a union-find forest.  An overloaded operator is a disjunction over its
+/// candidate types, which the solver explores depth first, most constrained
+/// first, pruning the candidates which are inconsistent with what is already
+/// known.  The search is bounded so that a pathological expression is
+/// diagnosed rather than checked in exponential time.
+class type_checker {
+public:
+  struct limits {
+    /// The work which may be done to solve an expression: each partial
+    /// solution explored, constraint propagated and candidate tested.
+    unsigned solver_steps = 1000000;
+    /// The bytes which the constraint system of an expression may occupy.
+    size_t memory = 64 * 1024 * 1024;
+  };
+
+private:
+  enum class literal { boolean, floating_point, integer, string };
+
+  struct variable {
+    unsigned parent;
+    unsigned rank;
+    // the next variable of its class; the members of a class form a cycle
+    unsigned sibling;
+    const type *binding;
+  };
+
+  // `target` is a type of class `constructor` composed of the `count`
+  // variables in `operands_` beginning at `operands`
+  struct construction {
+    unsigned target;
+    typeclass constructor;
+    unsigned operands;
+    unsigned count;
+  };
+
+  struct literal_constraint {
+    unsigned variable;
+    literal kind;
+  };
+
+  struct disjunction {
+    unsigned variable;
+    llvm::ArrayRef<const type *> choices;
+  };
+
+  // the constructions and literal constraints of which a variable is the
+  // subject, so that those upon a class are found without a scan
+  struct constraints {
+    llvm::SmallVector<unsigned, 1> constructions;
+    llvm::SmallVector<unsigned, 1> literals;
+  };
+
+  // the state of a variable before it was updated, restored on backtracking
+  struct trail_entry {
+    unsigned index;
+    variable state;
+  };
+
+  ast::context &ast_context_;
+  diagnostics::engine &diagnostics_engine_;
+  semantic::evaluator &evaluator_;
+  limits limits_;
+  // the checker of the declarations enclosing those checked by this one
+  const type_checker *enclosing_ = nullptr;
+
+  // the candidate types of the builtin operators, keyed on interned name
+  llvm::DenseMap<const identifier_info *, std::vector<const type *>>
+      infix_overloads_;
+  llvm::DenseMap<const identifier_info *, std::vector<const type *>>
+      prefix_overloads_;
+
+  // the constraint system of the expression being checked
+  std::vector<variable> variables_;
+  std::vector<construction> constructions_;
+  std::vector<unsigned> operands_;
+  std::vector<literal_constraint> literals_;
+  std::vector<constraints> constraints_;
+  std::vector<disjunction> disjunctions_;
+  std::vector<trail_entry> trail_;
+  std::vector<std::pair<const ast::expression *, unsigned>> expressions_;
+  bool inconsistent_ = false;
+  bool exhausted_ = false;
+  unsigned steps_ = 0;
+
+  llvm::DenseMap<const ast::expression *, const type *> types_;
+  llvm::DenseMap<const ast::pattern_named *, const type *> bindings_;
+
+  type_checker(const type_checker &) = delete;
+  type_checker &operator=(const type_checker &) = delete;
+
+  /* constraint generation */
+  unsigned fresh(const type *binding = nullptr);
+  void construct(unsigned target, typeclass constructor,
+                 llvm::ArrayRef<unsigned> operands);
+  void constrain(unsigned variable, literal kind);
+  unsigned apply(unsigned function, llvm::ArrayRef<unsigned> arguments);
+  unsigned reference(const ast::expression *expression,
+                     const llvm::DenseMap<const identifier_info *,
+                                          std::vector<const type *>> *overloads);
+  unsigned generate(const ast::expression *expression);
+
+  /* solution */
+  unsigned find(unsigned index) const;
+  void update(unsigned index, const variable &state);
+  bool unify(unsigned lhs, unsigned rhs);
+  bool bind(unsigned index, const type *type);
+  void rewind(size_t mark);
+
+  bool admits(literal kind, const type *type) const;
+  const type *default_type(literal kind) const;
+  bool spend(unsigned work = 1);
+  bool viable(const type *choice, unsigned index, unsigned depth = 0);
+
+  bool propagate();
+  bool solve();
+  size_t footprint() const;
+
+public:
+  type_checker(ast::context &ast_context,
+               diagnostics::engine &diagnostics_engine,
+               semantic::evaluator &evaluator, const limits &limits);
+  /// A checker for the body of a function declared in the scope checked by
+  /// \p enclosing, whose declarations remain visible to it.  The enclosing
+  /// checker is only read, and so may be shared between such checkers.
+  type_checker(ast::context &ast_context,
+               diagnostics::engine &diagnostics_engine,
+               semantic::evaluator &evaluator, const type_checker &enclosing);
+
+  /// Infers the type of \p expression, spanning \p range, which must be
+  /// \p contextual_type if given.  Returns null and diagnoses the expression
+  /// if it cannot be typed consistently; a type which is not constrained
+  /// enough to be inferred is also null, but is not diagnosed.
+  const type *check(const ast::expression *expression, range range,
+                    const type *contextual_type = nullptr);
+
+  /// Records the types of the names bound by \p pattern, taken from its type
+  /// annotations or else from \p type.
+  void declare(const ast::pattern *pattern, const type *type);
+
+  const type *type_of(const ast::expression *expression) const;
+  const type *type_of(const ast::pattern_named *binding) const;
+};
+}
+}
+
+#endif
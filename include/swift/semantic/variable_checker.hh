@@ -0,0 +1,81 @@
+/**
+ * Copyright © 2014 Saleem Abdulrasool <compnerd@compnerd.org>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+
+
+#ifndef swift_semantic_variable_checker_hh
+#define swift_semantic_variable_checker_hh
+
+namespace swift {
+class lexer;
+
+namespace ast {
+class context;
+}
+
+namespace diagnostics {
+class engine;
+}
+
+namespace semantic {
+class control_flow_graph;
+
+/// Checks the local variables and constants declared by a function body.
+///
+/// A name which may be read before it is initialised along some path through
+/// the body is diagnosed as an error.  This is the definite initialisation
+/// problem, solved over the control flow graph of the body.  A name which is
+/// never used, or a variable which is never mutated (and so could be a
+/// constant), is diagnosed as a warning.
+///
+/// A closure must only capture initialised names, as it may run once formed.
+/// A nested function may run whenever it is called, which is not tracked, and
+/// so it is taken to read and write the names which it references.
+///
+/// The names which each closure captures (the locals and parameters declared
+/// outside of it) are recorded in the closure, along with whether each may be
+/// written once declared.  A name which is not can be captured by value.
+class variable_checker {
+  ast::context &ast_context_;
+  diagnostics::engine &diagnostics_engine_;
+  const lexer &lexer_;
+
+public:
+  /// Diagnoses through \p diagnostics_engine, locating the statements of the
+  /// body in the buffer of \p lexer, and allocates the capture lists in
+  /// \p ast_context.
+  variable_checker(ast::context &ast_context,
+                   diagnostics::engine &diagnostics_engine,
+                   const lexer &lexer);
+
+  void check(const control_flow_graph &graph);
+};
+}
+}
+
+#endif
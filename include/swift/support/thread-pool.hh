@@ -0,0 +1,87 @@
+/**
+ * Copyright © 2014 Saleem Abdulrasool <compnerd@compnerd.org>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+
+#ifndef swift_support_thread_pool_hh
+#define swift_support_thread_pool_hh
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace swift {
+/// A fixed set of threads which run submitted tasks.
+///
+/// Each thread owns a queue of tasks which it services from the back; once its
+/// own queue is empty, it steals from the front of the queues of the others so
+/// that uneven tasks (e.g. source files of very different sizes) are balanced
+/// across the threads.
+class thread_pool {
+  struct queue {
+    std::mutex lock;
+    std::deque<std::function<void()>> tasks;
+  };
+
+  std::vector<std::unique_ptr<queue>> queues_;
+  std::vector<std::thread> threads_;
+
+  std::mutex lock_;
+  std::condition_variable available_;
+  std::condition_variable idle_;
+  size_t queued_;    // tasks queued but not yet claimed by a thread
+  size_t pending_;   // tasks submitted but not yet complete
+  size_t next_;      // the queue to which the next task is submitted
+  bool stopping_;
+
+  thread_pool(const thread_pool &) = delete;
+  thread_pool &operator=(const thread_pool &) = delete;
+
+  bool pop(size_t index, std::function<void()> &task);
+  void run(size_t index);
+
+public:
+  explicit thread_pool(unsigned threads = std::thread::hardware_concurrency());
+  ~thread_pool();
+
+  unsigned size() const {
+    return threads_.size();
+  }
+
+  void async(std::function<void()> task);
+
+  /// Blocks until every submitted task has completed.
+  void wait();
+};
+}
+
+#endif
+
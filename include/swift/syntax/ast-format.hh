@@ -0,0 +1,117 @@
+/**
+ * Copyright © 2014 Saleem Abdulrasool <compnerd@compnerd.org>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+
+#ifndef swift_syntax_ast_format_hh
+#define swift_syntax_ast_format_hh
+
+#include "swift/syntax/statement.hh"
+
+#include <cstdint>
+
+namespace swift::ast::format {
+// The serialised AST is a single, word aligned, host-endian image:
+//
+//   header
+//   records         node records in post-order
+//   sources         { start, end } source offsets, indexed by record index
+//   strings         { offset, length } descriptors followed by UTF-32 data
+//   roots           offsets of the top-level records
+//
+// The header also identifies the source which the records were built from by
+// its length and digest, so that a consumer can verify that an image matches
+// the source it was looked up for.
+//
+// A record is a record_header followed by `operands` 32-bit words.  Operands
+// which refer to other records hold the (negative) distance in words from the
+// referring record to the referenced record, or 0 for a null reference.
+// Operands which refer to strings hold an index into the string table.
+
+static constexpr uint32_t magic = 0x54534153;  // 'SAST'
+static constexpr uint16_t version = 6;
+
+enum class record_kind : uint8_t {
+#define NODE(Id, Parent) Id,
+#include "swift/syntax/syntax.def"
+
+  pattern_any = 0x80,
+  pattern_named,
+  pattern_tuple,
+  pattern_typed,
+  pattern_var,
+  pattern_expression,
+
+  type_array = 0xc0,
+  type_composite,
+  type_dictionary,
+  type_function,
+  type_identifier,
+  type_inout,
+  type_metatype,
+  type_tuple,
+};
+
+struct header {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t reserved;
+  uint32_t records_offset;
+  uint32_t records_size;
+  uint32_t sources_offset;
+  uint32_t record_count;
+  uint32_t strings_offset;
+  uint32_t string_count;
+  uint32_t roots_offset;
+  uint32_t root_count;
+  uint32_t source_length;
+  uint8_t source_digest[16];
+};
+
+struct record_header {
+  record_kind kind;
+  uint8_t flags;
+  uint16_t operands;
+  uint32_t index;
+};
+
+struct source_range {
+  uint32_t start;
+  uint32_t end;
+};
+
+struct string_descriptor {
+  uint32_t offset;
+  uint32_t length;
+};
+
+static_assert(sizeof(header) % sizeof(uint32_t) == 0, "header must be aligned");
+static_assert(sizeof(record_header) == 2 * sizeof(uint32_t),
+              "record header must be two words");
+}
+
+#endif
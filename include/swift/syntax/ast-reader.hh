@@ -0,0 +1,141 @@
+/**
+ * Copyright © 2014 Saleem Abdulrasool <compnerd@compnerd.org>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+
+#ifndef swift_syntax_ast_reader_hh
+#define swift_syntax_ast_reader_hh
+
+#include "swift/syntax/ast-format.hh"
+
+#include <llvm/ADT/StringRef.h>
+#include <llvm/Support/MemoryBuffer.h>
+
+#include <ext/string_view>
+#include <memory>
+#include <vector>
+
+namespace swift {
+namespace ast {
+class context;
+class declaration;
+class declaration_context;
+class expression;
+class function_body_parser;
+class pattern;
+class statement;
+class type;
+
+/// Maps a serialised AST (see ast-format.hh) and materialises the top-level
+/// statements into an AST context on demand.
+class reader {
+  struct record {
+    uint32_t position;
+    const format::record_header *header;
+    const uint32_t *operands;
+  };
+
+  ast::context &context_;
+  std::unique_ptr<llvm::MemoryBuffer> buffer_;
+  ast::function_body_parser *body_parser_;
+
+  const format::header *header_;
+  const uint32_t *records_;
+  const format::source_range *sources_;
+  const format::string_descriptor *strings_;
+  const char32_t *characters_;
+  uint32_t character_count_;
+  const uint32_t *roots_;
+
+  std::vector<ast::statement *> statements_;
+  std::vector<const char32_t *> string_cache_;
+  // the context of the declarations being read
+  ast::declaration_context *declaration_context_;
+  bool corrupt_;
+
+  reader(ast::context &context, std::unique_ptr<llvm::MemoryBuffer> buffer,
+         ast::function_body_parser *body_parser)
+      : context_(context), buffer_(std::move(buffer)),
+        body_parser_(body_parser), declaration_context_(nullptr),
+        corrupt_(false) {}
+
+  bool validate();
+
+  std::nullptr_t corrupt() {
+    corrupt_ = true;
+    return nullptr;
+  }
+
+  bool fetch(uint32_t position, record &record);
+  bool expect(const record &record, unsigned operands);
+  bool resolve(const record &record, unsigned operand, uint32_t &position);
+
+  std::u32string_view string_operand(const record &record, unsigned operand);
+
+  ast::statement *statement_operand(const record &record, unsigned operand);
+  ast::statement *statement_operand(const record &record, unsigned operand,
+                                    ast::declaration_context *within);
+  ast::expression *expression_operand(const record &record, unsigned operand);
+  ast::declaration *declaration_operand(const record &record,
+                                        unsigned operand);
+  ast::declaration *declaration_operand(const record &record, unsigned operand,
+                                        ast::declaration_context *within);
+  ast::pattern *pattern_operand(const record &record, unsigned operand);
+  ast::type *type_operand(const record &record, unsigned operand);
+
+  ast::statement *create_statement(const record &record);
+  ast::statement *read_statement(uint32_t position);
+  ast::pattern *read_pattern(uint32_t position);
+  ast::type *read_type(uint32_t position);
+
+public:
+  /// Maps \p path, returning null if it is not a valid serialised AST.  The
+  /// function bodies which were skipped when the image was written remain
+  /// skipped, and are parsed by \p body_parser on request.
+  static std::unique_ptr<reader>
+  open(ast::context &context, llvm::StringRef path,
+       ast::function_body_parser *body_parser = nullptr);
+
+  unsigned size() const {
+    return header_->root_count;
+  }
+
+  /// The length and digest of the source which the image was built from.
+  uint32_t source_length() const {
+    return header_->source_length;
+  }
+  const uint8_t (&source_digest() const)[16] {
+    return header_->source_digest;
+  }
+
+  /// Materialises (once) the top-level statement at \p index.
+  ast::statement *statement(unsigned index);
+};
+}
+}
+
+#endif
@@ -0,0 +1,98 @@
+/**
+ * Copyright © 2014 Saleem Abdulrasool <compnerd@compnerd.org>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+
+#ifndef swift_syntax_ast_writer_hh
+#define swift_syntax_ast_writer_hh
+
+#include "swift/syntax/ast-format.hh"
+
+#include <llvm/ADT/ArrayRef.h>
+
+#include <ext/string_view>
+#include <iosfwd>
+#include <map>
+#include <vector>
+
+namespace swift {
+namespace ast {
+class expression;
+class pattern;
+class statement;
+class type;
+
+/// Serialises top-level statements into the binary AST format described in
+/// ast-format.hh.
+class writer {
+  std::vector<uint32_t> records_;
+  std::vector<format::source_range> sources_;
+  std::vector<uint32_t> roots_;
+
+  uint32_t source_length_;
+  uint8_t source_digest_[16];
+
+  std::map<std::u32string_view, uint32_t> string_indices_;
+  std::vector<std::u32string_view> strings_;
+
+  bool failed_;
+
+  uint32_t intern(std::u32string_view string);
+  uint32_t reference(uint32_t record) const;
+
+  uint32_t emit(format::record_kind kind, uint8_t flags,
+                format::source_range range, llvm::ArrayRef<uint32_t> operands);
+  uint32_t emit(const ast::statement *statement,
+                llvm::ArrayRef<uint32_t> operands);
+  uint32_t emit(format::record_kind kind, llvm::ArrayRef<uint32_t> operands);
+
+  uint32_t write(const ast::statement *statement);
+  uint32_t write(const ast::pattern *pattern);
+  uint32_t write(const ast::type *type);
+
+public:
+  writer() : source_length_(0), source_digest_(), failed_(false) {}
+
+  /// Records the length and digest of the source which the statements were
+  /// parsed from.
+  void set_source(uint32_t length, const uint8_t (&digest)[16]);
+
+  /// Appends \p statement as a top-level entry.  Returns false (leaving the
+  /// writer unchanged) if the tree cannot be encoded, e.g. a node has more
+  /// operands than a record can hold.
+  bool add(const ast::statement *statement);
+
+  unsigned size() const {
+    return roots_.size();
+  }
+
+  void emit(std::ostream &os) const;
+};
+}
+}
+
+#endif
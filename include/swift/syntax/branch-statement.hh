@@ -41,16 +41,14 @@ public:
     switch_statement,
   };
 
-private:
-  branch_statement::type type_;
-
 protected:
   branch_statement(branch_statement::type type)
-      : statement(statement::type::branch_statement), type_(type) {}
+      : statement(to_kind<node_kind::first_branch_statement>(type)) {}
 
 public:
   branch_statement::type type() const {
-    return type_;
+    return from_kind<node_kind::first_branch_statement,
+                     enum branch_statement::type>();
   }
 };
 }
@@ -37,8 +37,9 @@ class checked_cast_expression : public type_casting_expression {
   bool resolved_;
 
 public:
-  checked_cast_expression()
-      : ast::type_casting_expression(type_casting_expression::type::checked_cast_expression),
+  checked_cast_expression(ast::type *cast_type)
+      : ast::type_casting_expression(type_casting_expression::type::checked_cast_expression,
+                                     cast_type),
         resolved_(false) {}
 
   bool resolved() const {
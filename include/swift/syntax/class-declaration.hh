@@ -55,6 +55,9 @@ public:
   const ast::statement *body() const {
     return body_;
   }
+  void set_body(statement *body) {
+    body_ = body;
+  }
 };
 }
 
@@ -31,21 +31,61 @@
 #define swift_syntax_closure_expression_hh
 
 #include "swift/syntax/expression.hh"
+#include "swift/syntax/pattern-named.hh"
+
+#include <llvm/ADT/ArrayRef.h>
+#include <llvm/ADT/PointerIntPair.h>
 
 namespace swift::ast {
+class pattern;
 class statement;
 
+/// A name declared outside of a closure which the closure references.
+class capture {
+  llvm::PointerIntPair<const pattern_named *, 1, bool> binding_;
+
+public:
+  capture() = default;
+  capture(const pattern_named *binding, bool mutated)
+      : binding_(binding, mutated) {}
+
+  const pattern_named *binding() const {
+    return binding_.getPointer();
+  }
+  /// Whether the name may be written once it is declared, by the closure or
+  /// otherwise.  A name which is not may be captured by value rather than by
+  /// reference.
+  bool mutated() const {
+    return binding_.getInt();
+  }
+};
+
 class closure_expression : public expression {
+  ast::pattern *parameters_;
   ast::statement *body_;
+  llvm::ArrayRef<capture> captures_;
 
 public:
-  closure_expression(ast::statement *body)
+  closure_expression(ast::pattern *parameters, ast::statement *body)
       : expression(expression::type::closure_expression),
-        body_(body) {}
+        parameters_(parameters), body_(body) {}
 
+  /// The parameter clause of the signature, or null if the closure has none.
+  const ast::pattern *parameters() const {
+    return parameters_;
+  }
   const ast::statement *body() const {
     return body_;
   }
+
+  /// The names which the closure captures, in the order in which they are
+  /// first referenced, once the enclosing function body is checked.
+  llvm::ArrayRef<capture> captures() const {
+    return captures_;
+  }
+  void set_captures(llvm::ArrayRef<capture> captures) {
+    captures_ = captures;
+  }
 };
 }
 
@@ -40,16 +40,14 @@ public:
     line_control_statement,
   };
 
-private:
-  compiler_control_statement::type type_;
-
 protected:
   compiler_control_statement(compiler_control_statement::type type)
-      : statement(statement::type::compiler_control_statement), type_(type) {}
+      : statement(to_kind<node_kind::first_compiler_control_statement>(type)) {}
 
 public:
   compiler_control_statement::type type() const {
-    return type_;
+    return from_kind<node_kind::first_compiler_control_statement,
+                     enum compiler_control_statement::type>();
   }
 };
 }
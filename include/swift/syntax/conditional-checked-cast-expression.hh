@@ -35,8 +35,9 @@
 namespace swift::ast {
 class conditional_checked_cast_expression : public type_casting_expression {
 public:
-  conditional_checked_cast_expression()
-      : ast::type_casting_expression(type_casting_expression::type::conditional_checked_cast_expression) {
+  conditional_checked_cast_expression(ast::type *cast_type)
+      : ast::type_casting_expression(type_casting_expression::type::conditional_checked_cast_expression,
+                                     cast_type) {
   }
 };
 }
@@ -30,8 +30,17 @@
 #ifndef swift_syntax_context_hh
 #define swift_syntax_context_hh
 
+#include "swift/lexer/identifier-table.hh"
+#include "swift/semantic/type.hh"
+
 #include <llvm/Support/Allocator.h>
 
+#include <iosfwd>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
 namespace swift {
 namespace ast {
 class context;
@@ -53,8 +62,10 @@ inline void operator delete[](void *, const swift::ast::context &, size_t);
 namespace swift {
 namespace ast {
 class source_file;
+class type;
 
 class context {
+  friend class statement;
   friend void * ::operator new(size_t, const context &, size_t);
   friend void * ::operator new[](size_t, const context &, size_t);
   friend void ::operator delete(void *, const swift::ast::context &, size_t);
@@ -65,20 +76,125 @@ class context {
   diagnostics::engine &diagnostics_engine_;
   const compiler::target_info *target_info_;
 
+  swift::identifier_table identifiers_;
+
   ast::source_file *source_file_;
 
+  // the types are uniqued so that they may be compared by identity; a context
+  // may instead form its types in those of another so that the types of the
+  // two are comparable, which requires the table to be locked as it may then
+  // be shared between threads
+  context *types_;
+  mutable std::shared_mutex types_mutex_;
+  const semantic::builtin_type *
+      builtin_types_[static_cast<unsigned>(semantic::builtin_type::kind::tuple) +
+                     1];
+  llvm::FoldingSet<semantic::tuple_type> tuple_types_;
+  llvm::FoldingSet<semantic::function_type> function_types_;
+  llvm::FoldingSet<semantic::array_type> array_types_;
+  llvm::FoldingSet<semantic::dictionary_type> dictionary_types_;
+  llvm::FoldingSet<semantic::metatype_type> metatype_types_;
+
+  // contexts whose nodes are referenced by this context, e.g. those which were
+  // used to parse other source files in parallel
+  std::vector<std::unique_ptr<context>> adopted_contexts_;
+  std::vector<ast::source_file *> source_files_;
+
+  // the context which adopts (or is to adopt) this context, if any
+  const context *adopter_;
+
+  // the number of nodes of each kind allocated from the context, which are only
+  // counted once accounting is enabled
+  bool statistics_;
+  mutable std::vector<unsigned> node_counts_;
+
+  struct statistics;
+  void accumulate(statistics &totals) const;
+
+  template <typename Type, typename Create>
+  const Type *unique(llvm::FoldingSet<Type> &types,
+                     const llvm::FoldingSetNodeID &id, Create create);
+
 public:
-  context(diagnostics::engine &engine);
+  context(diagnostics::engine &engine, const std::string &name = "main");
+  ~context();
 
   ast::source_file *source_file() const {
     return source_file_;
   }
 
+  /// All of the source files of the module, beginning with the primary.
+  const std::vector<ast::source_file *> &source_files() const {
+    return source_files_;
+  }
+
+  /// Takes ownership of \p context, its allocations, and its source files so
+  /// that they live as long as this context.
+  void adopt(std::unique_ptr<context> context);
+
+  /// Notes that \p context is to adopt this context once its nodes are built,
+  /// so that they may be declared in the declaration contexts of the former.
+  void adopt_into(const context &context) {
+    adopter_ = &context;
+  }
+
+  /// Whether the nodes of this context live as long as those of \p context,
+  /// that is, whether it is \p context or is adopted by it.
+  bool is_within(const context &context) const;
+
   diagnostics::engine &diagnostics_engine() const {
     return diagnostics_engine_;
   }
 
+  swift::identifier_table &identifiers() {
+    return identifiers_;
+  }
+
   void initialise_builtin_types(const compiler::target_info &target);
+
+  /// Forms the types of this context in those of \p context, which must
+  /// outlive it, so that they are shared with the other contexts doing so.
+  void use_types_of(context &context) {
+    types_ = context.types_;
+  }
+
+  /* type constructors */
+  const semantic::builtin_type *
+  builtin_type(semantic::builtin_type::kind kind) const {
+    return types_->builtin_types_[static_cast<unsigned>(kind)];
+  }
+  const semantic::tuple_type *
+  tuple_type(llvm::ArrayRef<const semantic::type *> elements);
+  const semantic::function_type *
+  function_type(const semantic::type *parameter_type,
+                const semantic::type *result_type);
+  const semantic::array_type *array_type(const semantic::type *element_type);
+  const semantic::dictionary_type *
+  dictionary_type(const semantic::type *key_type,
+                  const semantic::type *value_type);
+  const semantic::metatype_type *
+  metatype_type(const semantic::type *instance_type);
+
+  /// The type spelt by \p type, or null if it names a type which is not yet
+  /// modelled (e.g. a nominal type).
+  const semantic::type *semantic_type(const ast::type *type);
+
+  /// Allocates the storage for a node, which is counted once constructed if
+  /// nodes are accounted.
+  void *allocate_node(size_t size, size_t alignment) const;
+
+  /// Accounts for the nodes allocated from the context hereafter, reported by
+  /// `print_statistics`.
+  void enable_statistics();
+  bool statistics_enabled() const {
+    return statistics_;
+  }
+
+  /// The bytes allocated for nodes, including those of adopted contexts.
+  size_t bytes_allocated() const;
+
+  /// Reports the memory held by the context and the nodes allocated from it.
+  void print_statistics(std::ostream &os) const;
 };
 }
 }
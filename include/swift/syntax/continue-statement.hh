@@ -48,6 +48,10 @@ public:
       : ast::control_transfer_statement(control_transfer_statement::type::continue_statement),
         label_(label) {}
 
+  std::u32string_view label() const {
+    return label_;
+  }
+
 private:
   void *operator new(size_t) noexcept {
     swift_unreachable("statement cannot be allocated with 'new'");
@@ -43,17 +43,15 @@ public:
     throw_statement,
   };
 
-private:
-  control_transfer_statement::type type_;
-
 protected:
   control_transfer_statement(control_transfer_statement::type type)
-      : ast::statement(statement::type::control_transfer_statement),
-        type_(type) {}
+      : ast::statement(
+            to_kind<node_kind::first_control_transfer_statement>(type)) {}
 
 public:
   control_transfer_statement::type type() const {
-    return type_;
+    return from_kind<node_kind::first_control_transfer_statement,
+                     enum control_transfer_statement::type>();
   }
 };
 }
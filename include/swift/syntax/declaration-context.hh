@@ -32,7 +32,16 @@
 
 #include "swift/syntax/declaration.hh"
 
+#include <llvm/ADT/ArrayRef.h>
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/ADT/SmallVector.h>
+
+#include <ext/string_view>
+#include <iterator>
+
 namespace swift {
+class identifier_info;
+
 namespace ast {
 class declaration_context {
 public:
@@ -51,15 +60,59 @@ public:
     subscript_declaration,
   };
 
+  class iterator {
+    ast::declaration *declaration_;
+
+  public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef ast::declaration *value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef ast::declaration *const *pointer;
+    typedef ast::declaration *reference;
+
+    explicit iterator(ast::declaration *declaration)
+        : declaration_(declaration) {}
+
+    ast::declaration *operator*() const {
+      return declaration_;
+    }
+
+    iterator &operator++() {
+      declaration_ = declaration_->next_;
+      return *this;
+    }
+    iterator operator++(int) {
+      iterator iterator(*this);
+      ++*this;
+      return iterator;
+    }
+
+    bool operator==(const iterator &rhs) const {
+      return declaration_ == rhs.declaration_;
+    }
+    bool operator!=(const iterator &rhs) const {
+      return declaration_ != rhs.declaration_;
+    }
+  };
+
 private:
   declaration_context::type type_;
 
-protected:
-  mutable declaration *first_declaration_;
-  mutable declaration *last_declaration_;
+  ast::declaration *first_declaration_;
+  ast::declaration *last_declaration_;
 
+  // NOTE(compnerd) the lookup table is extended with the declarations added
+  // since it was last indexed on each lookup, which modifies it; a context
+  // which is shared between threads must be indexed before it is shared.
+  mutable llvm::DenseMap<const identifier_info *,
+                         llvm::SmallVector<ast::declaration *, 1>>
+      lookup_table_;
+  mutable ast::declaration *last_indexed_declaration_;
+
+protected:
   declaration_context(declaration_context::type type)
-      : type_(type), first_declaration_(nullptr), last_declaration_(nullptr) {}
+      : type_(type), first_declaration_(nullptr), last_declaration_(nullptr),
+        last_indexed_declaration_(nullptr) {}
 
 public:
   virtual ~declaration_context();
@@ -72,9 +125,16 @@ public:
     return declaration::from_declaration_context(this);
   }
 
+  const ast::declaration *declaration() const {
+    return declaration::from_declaration_context(this);
+  }
+
   declaration_context *parent() {
     return declaration()->declaration_context();
   }
+  const declaration_context *parent() const {
+    return declaration()->declaration_context();
+  }
 
   bool is_source_file() const noexcept {
     return type_ == declaration_context::type::source_file;
@@ -82,13 +142,23 @@ public:
 
   ast::context &ast_context();
   void add_declaration(ast::declaration *declaration);
+  /// Unlinks \p declaration (e.g. when it is replaced by reparsing).
+  void remove_declaration(ast::declaration *declaration);
 
-  const ast::declaration **begin() const noexcept {
-    return const_cast<const ast::declaration **>(&first_declaration_);
+  iterator begin() const noexcept {
+    return iterator(first_declaration_);
   }
-  const ast::declaration **end() const noexcept {
-    return const_cast<const ast::declaration **>(&last_declaration_);
+  iterator end() const noexcept {
+    return iterator(nullptr);
   }
+
+  /// Indexes the declarations added since the lookup table was last extended.
+  void index() const;
+
+  /// The declarations of this context named \p name, in declaration order.
+  /// The identifier must be that interned by the AST context of this context.
+  llvm::ArrayRef<ast::declaration *> lookup(const identifier_info &name) const;
+  llvm::ArrayRef<ast::declaration *> lookup(std::u32string_view name) const;
 };
 }
 }
@@ -35,17 +35,34 @@
 #include <ext/string_view>
 
 namespace swift::ast {
+class declaration;
+class pattern_named;
+
 class declaration_reference_expression : public expression {
-  bool resolved_;
+  declaration *declaration_;
+  const pattern_named *binding_;
   std::u32string_view name_;
 
 public:
   declaration_reference_expression(std::u32string_view name)
       : expression(expression::type::declaration_reference_expression),
-        resolved_(false), name_(name) {}
+        declaration_(nullptr), binding_(nullptr), name_(name) {}
+
+  void resolve(declaration *declaration, const pattern_named *binding) {
+    declaration_ = declaration;
+    binding_ = binding;
+  }
 
   bool resolved() const {
-    return resolved_;
+    return declaration_ or binding_;
+  }
+  /// The declaration that the name refers to, if known.
+  declaration *declaration() const {
+    return declaration_;
+  }
+  /// The named pattern that binds the name, for values.
+  const pattern_named *binding() const {
+    return binding_;
   }
   std::u32string_view name() const {
     return name_;
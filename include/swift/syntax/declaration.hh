@@ -63,29 +63,30 @@ public:
     extension_declaration,
     subscript_declaration,
     operator_declaration,
+    enumeration_element_declaration,
   };
 
 private:
   declaration_context *declaration_context_;
-  type type_;
   declaration *next_;
 
 protected:
-  declaration(declaration::type type, ast::declaration_context *context)
-      : statement(statement::type::declaration), declaration_context_(context),
-        type_(type), next_(nullptr) {}
+  declaration(declaration::type type, ast::declaration_context *context);
 
 public:
   void *operator new(size_t size, const ast::context &context,
                      ast::declaration_context *parent, size_t extra = 0);
 
   declaration::type type() const {
-    return type_;
+    return from_kind<node_kind::first_declaration, enum declaration::type>();
   }
 
   declaration_context *declaration_context() {
     return declaration_context_;
   }
+  const ast::declaration_context *declaration_context() const {
+    return declaration_context_;
+  }
 
   ast::context &ast_context();
   ast::source_file *source_file();
@@ -47,6 +47,8 @@ class do_statement : public ast::statement {
   std::vector<catch_clause> catch_clauses_;
 
 public:
+  void *operator new(size_t size, const ast::context &context,
+                     unsigned alignment = 8);
 
   do_statement(ast::statement *body,
                std::vector<catch_clause> &catch_clauses)
@@ -60,6 +62,14 @@ public:
   catch_clauses() const noexcept {
     return { std::begin(catch_clauses_), std::end(catch_clauses_) };
   }
+
+private:
+  void *operator new(size_t) noexcept {
+    swift_unreachable("statement cannot be allocated with 'new'");
+  }
+  void operator delete(void *) noexcept {
+    swift_unreachable("statement cannot be unallocated with 'delete'");
+  }
 };
 }
 
@@ -59,6 +59,9 @@ public:
     return std::vector<const ast::declaration *>(members_.begin(),
                                                  members_.end());
   }
+  void set_members(const std::vector<ast::declaration *> &members) {
+    members_ = members;
+  }
 };
 }
 
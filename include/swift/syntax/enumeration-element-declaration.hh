@@ -30,13 +30,11 @@
 #ifndef swift_syntax_enumeration_element_declaration_hh
 #define swift_syntax_enumeration_element_declaration_hh
 
-#include "swift/lexer/location.hh"
 #include "swift/syntax/declaration.hh"
 
 #include <ext/string_view>
 
-namespace swift {
-namespace ast {
+namespace swift::ast {
 class declaration_context;
 
 class enumeration_element_declaration : public declaration {
@@ -45,13 +43,12 @@ class enumeration_element_declaration : public declaration {
 public:
   enumeration_element_declaration(ast::declaration_context *declaration_context,
                                   std::u32string_view name)
-      : declaration(declaration::type::enumeration, declaration_context),
+      : ast::declaration(declaration::type::enumeration_element_declaration,
+                         declaration_context),
         name_(name) {}
 
-  void dump() const override;
+  const std::u32string_view &name() const { return name_; }
 };
 }
-}
 
 #endif
-
@@ -47,13 +47,12 @@ public:
 
     /* binary expression */
     sequence_expression,
+    binary_expression,
     assignment_expression,
     conditional_expression,
-    type_casting_expression,
 
     /* primary expressions */
     declaration_reference_expression,
-    literal_expression,
     // self_expression,
     superclass_expression,
     closure_expression,
@@ -72,20 +71,34 @@ public:
     subscript_expression,
     forced_value_expression,
     optional_chaining_expression,
+
+    /* abstract expressions */
+    type_casting_expression,
+    literal_expression,
   };
 
-private:
-  enum type type_;
+protected:
+  explicit expression(node_kind kind) : statement(kind) {
+    assert(kind >= node_kind::first_expression &&
+           kind <= node_kind::last_expression && "invalid expression kind");
+  }
 
 public:
   void *operator new(size_t size, const ast::context &context,
                      unsigned alignment = 8);
 
   expression(expression::type type)
-      : statement(statement::type::expression), type_(type) {}
+      : expression(to_kind<node_kind::first_expression>(type)) {
+    assert(type < expression::type::type_casting_expression &&
+           "abstract expressions must be constructed with a node kind");
+  }
 
   expression::type type() const {
-    return type_;
+    if (kind() < node_kind::first_type_casting_expression)
+      return from_kind<node_kind::first_expression, enum expression::type>();
+    if (kind() <= node_kind::last_type_casting_expression)
+      return expression::type::type_casting_expression;
+    return expression::type::literal_expression;
   }
 
 protected:
@@ -62,6 +62,9 @@ public:
   const ast::statement *body() const {
     return body_;
   }
+  void set_body(ast::statement *body) {
+    body_ = body;
+  }
 };
 }
 
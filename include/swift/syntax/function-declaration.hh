@@ -30,22 +30,65 @@
 #ifndef swift_syntax_function_hh
 #define swift_syntax_function_hh
 
+#include "swift/lexer/location.hh"
 #include "swift/syntax/declaration.hh"
 #include "swift/syntax/declaration-context.hh"
 
+#include <llvm/ADT/SmallPtrSet.h>
+
 #include <ext/string_view>
 #include <vector>
 
 namespace swift::ast {
+class function_declaration;
 class pattern;
 class type;
 
+/// Parses the body of a function declaration whose body was skipped when the
+/// declaration was parsed.
+///
+/// The functions whose bodies are left to the parser are detached from it when
+/// it is destroyed; their bodies remain unparsed, and read as null, until they
+/// are parsed by another parser and installed.  The functions must outlive the
+/// parser.
+class function_body_parser {
+  friend class function_declaration;
+
+  // the functions whose bodies have been left to this parser
+  llvm::SmallPtrSet<function_declaration *, 16> functions_;
+
+public:
+  function_body_parser() = default;
+  virtual ~function_body_parser();
+
+  function_body_parser(const function_body_parser &) = delete;
+  function_body_parser &operator=(const function_body_parser &) = delete;
+
+  virtual ast::statement *
+  parse_function_body(const function_declaration &function) = 0;
+};
+
 class function_declaration : public declaration, public declaration_context {
+  friend class function_body_parser;
+
   std::u32string_view name_;
   std::vector<ast::pattern *> parameter_clauses_;
   ast::type *result_type_;
   ast::statement *body_;
 
+  // the location of the opening brace of the body, whether the body has yet to
+  // be parsed, and the parser of that body, if it is still alive
+  function_body_parser *body_parser_ = nullptr;
+  location body_location_;
+  bool unparsed_ = false;
+
+  void parse_body() {
+    function_body_parser *parser = body_parser_;
+    body_parser_ = nullptr;
+    body_ = parser->parse_function_body(*this);
+    unparsed_ = false;
+  }
+
 public:
   function_declaration(ast::declaration_context *declaration_context,
                        std::u32string_view name,
@@ -71,10 +114,45 @@ public:
   const ast::type *result_type() const {
     return result_type_;
   }
+  /// The body of the function, which is parsed on first access if it was
+  /// skipped when the declaration was parsed.
   const ast::statement *body() const {
+    if (body_parser_)
+      const_cast<function_declaration *>(this)->parse_body();
     return body_;
   }
+
+  bool has_unparsed_body() const {
+    return unparsed_;
+  }
+  location body_location() const {
+    return body_location_;
+  }
+  void set_body_location(location start) {
+    body_location_ = start;
+  }
+  void set_unparsed_body(function_body_parser *parser, location start) {
+    // NOTE(compnerd) the functions are not removed from the parser once their
+    // bodies are parsed, as that may happen concurrently
+    if (parser)
+      parser->functions_.insert(this);
+    body_parser_ = parser;
+    body_location_ = start;
+    unparsed_ = true;
+  }
+  /// Installs \p body, parsed out of band, as the body of the function.
+  void set_body(ast::statement *body) {
+    body_parser_ = nullptr;
+    unparsed_ = false;
+    body_ = body;
+  }
 };
+
+inline function_body_parser::~function_body_parser() {
+  for (auto *function : functions_)
+    if (function->body_parser_ == this)
+      function->body_parser_ = nullptr;
+}
 }
 
 #endif
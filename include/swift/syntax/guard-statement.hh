@@ -44,18 +44,29 @@ class guard_statement : public branch_statement {
   ast::statement *body_;
 
 public:
+  void *operator new(size_t size, const ast::context &context,
+                     unsigned alignment = 8);
+
   guard_statement(std::vector<ast::statement *> &condition_clause,
                   ast::statement *body)
       : branch_statement(branch_statement::type::guard_statement),
         condition_clause_(condition_clause), body_(body) {}
 
-  iterator_range<std::vector<const ast::statement *>::const_iterator>
+  iterator_range<std::vector<ast::statement *>::const_iterator>
   condition_clause() const noexcept {
     return { condition_clause_.begin(), condition_clause_.end() };
   }
   const ast::statement *body() const {
     return body_;
   }
+
+private:
+  void *operator new(size_t) noexcept {
+    swift_unreachable("statement cannot be allocated with 'new'");
+  }
+  void operator delete(void *) noexcept {
+    swift_unreachable("statement cannot be unallocated with 'delete'");
+  }
 };
 }
 
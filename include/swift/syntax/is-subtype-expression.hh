@@ -35,8 +35,9 @@
 namespace swift::ast {
 class is_subtype_expression : public type_casting_expression {
 public:
-  is_subtype_expression()
-      : ast::type_casting_expression(type_casting_expression::type::is_subtype_expression) {
+  is_subtype_expression(ast::type *cast_type)
+      : ast::type_casting_expression(type_casting_expression::type::is_subtype_expression,
+                                     cast_type) {
   }
 };
 }
@@ -47,16 +47,14 @@ public:
     magic_literal,
   };
 
-private:
-  literal_expression::type type_;
-
 protected:
   explicit literal_expression(literal_expression::type type)
-      : expression(expression::type::literal_expression), type_(type) {}
+      : expression(to_kind<node_kind::first_literal_expression>(type)) {}
 
 public:
   literal_expression::type type() const {
-    return type_;
+    return from_kind<node_kind::first_literal_expression,
+                     enum literal_expression::type>();
   }
 };
 }
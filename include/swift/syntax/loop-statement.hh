@@ -42,16 +42,14 @@ public:
     repeat_while_statement,
   };
 
-private:
-  loop_statement::type type_;
-
 protected:
   loop_statement(loop_statement::type type)
-      : ast::statement(statement::type::loop_statement), type_(type) {}
+      : ast::statement(to_kind<node_kind::first_loop_statement>(type)) {}
 
 public:
   loop_statement::type type() const {
-    return type_;
+    return from_kind<node_kind::first_loop_statement,
+                     enum loop_statement::type>();
   }
 };
 }
@@ -80,6 +80,7 @@ public:
   void visit(const prefix_unary_expression &) override;
   void visit(const in_out_expression &) override;
   void visit(const sequence_expression &) override;
+  void visit(const binary_expression &) override;
   void visit(const postfix_unary_expression &) override;
   void visit(const function_call_expression &) override;
   void visit(const initializer_expression &) override;
@@ -125,6 +126,7 @@ public:
   void visit(const extension_declaration &) override;
   void visit(const subscript_declaration &) override;
   void visit(const operator_declaration &) override;
+  void visit(const enumeration_element_declaration &) override;
 
   void visit(const for_statement &) override;
   void visit(const for_in_statement &) override;
@@ -57,6 +57,9 @@ public:
   const ast::statement *members() const {
     return members_;
   }
+  void set_members(ast::statement *members) {
+    members_ = members;
+  }
 };
 }
 
@@ -33,35 +33,135 @@
 #include "swift/support/error-handling.hh"
 #include "swift/syntax/visitable.hh"
 
+#include <cassert>
+#include <cstdint>
 #include <cstdlib>
 
 namespace swift::ast {
+class context;
+
+/// The kind of a concrete AST node, covering the entire statement hierarchy.
+enum class node_kind : uint8_t {
+#define NODE(Id, Parent) Id,
+#include "swift/syntax/syntax.def"
+#define ABSTRACT_NODE(Id, Parent, First, Last)                                 \
+  first_##Id = First, last_##Id = Last,
+#include "swift/syntax/syntax.def"
+};
+
 class statement : public ast::visitable<statement> {
 public:
   enum class type {
+    labelled_statement,
+    defer_statement,
+    do_statement,
+    statements,
+
+    /* abstract statements */
     expression,
     declaration,
     loop_statement,
     branch_statement,
-    labelled_statement,
     control_transfer_statement,
-    defer_statement,
-    do_statement,
     compiler_control_statement,
-    statements,
+  };
+
+  enum flag : uint8_t {
+    implicit = 1 << 0,
+    invalid = 1 << 1,
   };
 
 private:
-  enum type type_;
+  // NOTE(compnerd) this is the entire header of every node; it is kept packed
+  // (and the hierarchy free of virtual functions) to keep the nodes small.
+  node_kind kind_;
+  uint8_t flags_;
+  uint32_t start_;
+  uint32_t end_;
+
+  // NOTE(compnerd) the kind of a node is not known when its storage is
+  // allocated, nor its context once it is constructed; the context which last
+  // allocated a node on this thread is noted if it accounts for its nodes
+  friend class context;
+  static thread_local const context *accounting_;
+  static void record(node_kind kind);
 
 protected:
-  explicit statement(statement::type type) : type_(type) {}
+  explicit statement(node_kind kind)
+      : kind_(kind), flags_(0), start_(0), end_(0) {
+    if (accounting_)
+      record(kind);
+  }
+
+  explicit statement(statement::type type)
+      : statement(static_cast<node_kind>(type)) {
+    assert(type < statement::type::expression &&
+           "abstract statements must be constructed with a node kind");
+  }
+
+  /// Maps a per-level type to the node kind at the same offset from `First`.
+  template <node_kind First, typename Type>
+  static constexpr node_kind to_kind(Type type) {
+    return static_cast<node_kind>(static_cast<unsigned>(First) +
+                                  static_cast<unsigned>(type));
+  }
+
+  /// Maps the node kind to the per-level type at the same offset from `First`.
+  template <node_kind First, typename Type>
+  Type from_kind() const {
+    return static_cast<Type>(static_cast<unsigned>(kind_) -
+                             static_cast<unsigned>(First));
+  }
 
 public:
-  virtual ~statement() = 0;
+  node_kind kind() const {
+    return kind_;
+  }
 
   enum type type() const {
-    return type_;
+    if (kind_ < node_kind::first_expression)
+      return static_cast<enum type>(kind_);
+    if (kind_ <= node_kind::last_expression)
+      return type::expression;
+    if (kind_ <= node_kind::last_declaration)
+      return type::declaration;
+    if (kind_ <= node_kind::last_loop_statement)
+      return type::loop_statement;
+    if (kind_ <= node_kind::last_branch_statement)
+      return type::branch_statement;
+    if (kind_ <= node_kind::last_control_transfer_statement)
+      return type::control_transfer_statement;
+    return type::compiler_control_statement;
+  }
+
+  bool is_implicit() const {
+    return flags_ & flag::implicit;
+  }
+  void set_implicit(bool implicit = true) {
+    flags_ = implicit ? flags_ | flag::implicit : flags_ & ~flag::implicit;
+  }
+
+  bool is_invalid() const {
+    return flags_ & flag::invalid;
+  }
+  void set_invalid(bool invalid = true) {
+    flags_ = invalid ? flags_ | flag::invalid : flags_ & ~flag::invalid;
+  }
+
+  /// Offsets (in characters) of the node's extent within the source buffer.
+  uint32_t start_offset() const {
+    return start_;
+  }
+  uint32_t end_offset() const {
+    return end_;
+  }
+  bool has_source_range() const {
+    return start_ or end_;
+  }
+
+  void set_source_range(uint32_t start, uint32_t end) {
+    assert(start <= end && "invalid source range");
+    start_ = start, end_ = end;
   }
 
 protected:
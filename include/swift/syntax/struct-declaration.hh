@@ -57,6 +57,9 @@ public:
   const ast::statement *declarations() const {
     return declarations_;
   }
+  void set_declarations(ast::statement *declarations) {
+    declarations_ = declarations;
+  }
 };
 }
 
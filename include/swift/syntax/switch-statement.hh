@@ -50,6 +50,7 @@ public:
 private:
   ast::expression *control_expression_;
   std::vector<case_item> case_statements_;
+  bool exhaustive_ = false;
 
 public:
   void *operator new(size_t size, const ast::context &context,
@@ -69,6 +70,15 @@ public:
     return { std::begin(case_statements_), std::end(case_statements_) };
   }
 
+  /// Whether the cases are known to match every value of the subject, even
+  /// without a `default` case.
+  bool exhaustive() const noexcept {
+    return exhaustive_;
+  }
+  void set_exhaustive(bool exhaustive) noexcept {
+    exhaustive_ = exhaustive;
+  }
+
 private:
   void *operator new(size_t) noexcept {
     swift_unreachable("statement cannot be allocated with 'new'");
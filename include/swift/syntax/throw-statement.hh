@@ -33,12 +33,16 @@
 #include "swift/syntax/control-transfer-statement.hh"
 
 namespace swift::ast {
+class context;
 class expression;
 
 class throw_statement : public control_transfer_statement {
   ast::expression *expression_;
 
 public:
+  void *operator new(size_t size, const ast::context &context,
+                     unsigned alignment = 8);
+
   throw_statement(ast::expression *expression)
       : ast::control_transfer_statement(control_transfer_statement::type::throw_statement),
         expression_(expression) {}
@@ -46,6 +50,14 @@ public:
   const ast::expression *expression() const {
     return expression_;
   }
+
+private:
+  void *operator new(size_t) noexcept {
+    swift_unreachable("statement cannot be allocated with 'new'");
+  }
+  void operator delete(void *) noexcept {
+    swift_unreachable("statement cannot be unallocated with 'delete'");
+  }
 };
 }
 
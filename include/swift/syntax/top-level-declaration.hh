@@ -34,12 +34,25 @@
 #include "swift/syntax/declaration-context.hh"
 
 namespace swift::ast {
+/// A run of top-level code in a script (main file), which forms part of the
+/// entry point of the program.
 class top_level_declaration : public declaration, public declaration_context {
+  ast::statement *body_;
+
 public:
-  top_level_declaration(ast::declaration_context *declaration_context)
+  top_level_declaration(ast::declaration_context *declaration_context,
+                        ast::statement *body)
       : ast::declaration(declaration::type::top_level_declaration,
                          declaration_context),
-        ast::declaration_context(declaration_context::type::top_level_declaration) {
+        ast::declaration_context(declaration_context::type::top_level_declaration),
+        body_(body) {
+  }
+
+  const ast::statement *body() const {
+    return body_;
+  }
+  ast::statement *body() {
+    return body_;
   }
 };
 }
@@ -34,6 +34,8 @@
 
 namespace swift {
 namespace ast {
+class type;
+
 class type_casting_expression : public expression {
 public:
   enum class type {
@@ -43,15 +45,33 @@ public:
   };
 
 private:
-  type type_;
+  expression *operand_;
+  ast::type *cast_type_;
 
 protected:
-  type_casting_expression(type_casting_expression::type type)
-      : expression(expression::type::type_casting_expression), type_(type) {}
+  type_casting_expression(type_casting_expression::type type,
+                          ast::type *cast_type)
+      : expression(to_kind<node_kind::first_type_casting_expression>(type)),
+        operand_(nullptr), cast_type_(cast_type) {}
 
 public:
   type_casting_expression::type type() const {
-    return type_;
+    return from_kind<node_kind::first_type_casting_expression,
+                     enum type_casting_expression::type>();
+  }
+
+  /// The expression being cast; this is only known once the enclosing
+  /// sequence expression has been folded.
+  const expression *operand() const {
+    return operand_;
+  }
+
+  void set_operand(expression *operand) {
+    operand_ = operand;
+  }
+
+  const ast::type *cast_type() const {
+    return cast_type_;
   }
 };
 }
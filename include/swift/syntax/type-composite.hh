@@ -45,6 +45,11 @@ public:
   type_composite(const std::vector<ast::type_identifier *> &protocols)
       : type(type::kind::composite), protocols_(protocols) {}
 
+  const std::vector<const ast::type_identifier *> protocols() const noexcept {
+    return std::vector<const ast::type_identifier *>(protocols_.begin(),
+                                                     protocols_.end());
+  }
+
   void dump() const override;
 };
 }
@@ -35,6 +35,8 @@
 #include <ext/string_view>
 
 namespace swift::ast {
+class type;
+
 class declaration_context;
 
 class typealias_declaration : public declaration {
@@ -42,14 +44,16 @@ class typealias_declaration : public declaration {
   std::u32string_view alias_;
   // TODO(compnerd) make this an identifier
   std::u32string_view type_name_;
+  ast::type *aliased_type_;
 
 public:
   typealias_declaration(ast::declaration_context *declaration_context,
                         std::u32string_view alias,
-                        std::u32string_view type_name)
+                        std::u32string_view type_name,
+                        ast::type *aliased_type)
       : declaration(declaration::type::typealias_declaration,
                     declaration_context),
-        alias_(alias), type_name_(type_name) {}
+        alias_(alias), type_name_(type_name), aliased_type_(aliased_type) {}
 
   std::u32string_view alias() const noexcept {
     return alias_;
@@ -57,6 +61,9 @@ public:
   std::u32string_view type_name() const noexcept {
     return type_name_;
   }
+  const ast::type *aliased_type() const noexcept {
+    return aliased_type_;
+  }
 };
 }
 
@@ -52,6 +52,7 @@
 #include "swift/syntax/prefix-unary-expression.hh"
 #include "swift/syntax/in-out-expression.hh"
 #include "swift/syntax/sequence-expression.hh"
+#include "swift/syntax/binary-expression.hh"
 #include "swift/syntax/assignment-expression.hh"
 #include "swift/syntax/conditional-expression.hh"
 #include "swift/syntax/type-casting-expression.hh"
@@ -102,6 +103,7 @@
 #include "swift/syntax/extension-declaration.hh"
 #include "swift/syntax/subscript-declaration.hh"
 #include "swift/syntax/operator-declaration.hh"
+#include "swift/syntax/enumeration-element-declaration.hh"
 
 #include "swift/syntax/loop-statement.hh"
 #include "swift/syntax/for-statement.hh"
@@ -161,6 +163,7 @@ class visitor
                            prefix_unary_expression,
                            in_out_expression,
                            sequence_expression,
+                           binary_expression,
                            postfix_unary_expression,
                            assignment_expression,
                            conditional_expression,
@@ -206,6 +209,7 @@ class visitor
                            extension_declaration,
                            subscript_declaration,
                            operator_declaration,
+                           enumeration_element_declaration,
                          loop_statement,
                            for_statement,
                            for_in_statement,
@@ -291,6 +295,9 @@ protected:
   using sequence_expression_reference =
       typename ::visits<sequence_expression, ReturnType,
                         ConstVisitor>::reference_type;
+  using binary_expression_reference =
+      typename ::visits<binary_expression, ReturnType,
+                        ConstVisitor>::reference_type;
   using postfix_unary_expression =
       typename ::visits<postfix_unary_expression, ReturnType,
                         ConstVisitor>::reference_type;
@@ -432,6 +439,9 @@ protected:
   using operator_declaration_reference =
       typename ::visits<operator_declaration, ReturnType,
                         ConstVisitor>::reference_type;
+  using enumeration_element_declaration_reference =
+      typename ::visits<enumeration_element_declaration, ReturnType,
+                        ConstVisitor>::reference_type;
 
   using for_statement_reference =
       typename ::visits<for_statement, ReturnType, ConstVisitor>::reference_type;
@@ -603,6 +613,9 @@ visitor<VisitorType, ResultType, ConstVisitor>::visit(expression_reference expre
   case expression::type::sequence_expression:
     return static_cast<VisitorType &>(*this)
         .visit(static_cast<sequence_expression_reference>(expression));
+  case expression::type::binary_expression:
+    return static_cast<VisitorType &>(*this)
+        .visit(static_cast<binary_expression_reference>(expression));
   case expression::type::assignment_expression:
     return static_cast<VisitorType &>(*this)
         .visit(static_cast<assignment_expression_reference>(expression));
@@ -710,6 +723,9 @@ visitor<VisitorType, ResultType, ConstVisitor>::visit(declaration_reference decl
   case declaration::type::operator_declaration:
     return static_cast<VisitorType &>(*this)
         .visit(static_cast<operator_declaration_reference>(declaration));
+  case declaration::type::enumeration_element_declaration:
+    return static_cast<VisitorType &>(*this).visit(
+        static_cast<enumeration_element_declaration_reference>(declaration));
   }
 }
 
@@ -55,6 +55,69 @@ void proxy_consumer::handle_diagnostic(diagnostic::level level,
                                        const diagnostic_info &info) {
   target_.handle_diagnostic(level, info);
 }
+
+void buffering_consumer::reset() {
+  consumer::reset();
+  diagnostics_.clear();
+  held_errors_ = 0;
+}
+
+void buffering_consumer::handle_diagnostic(diagnostic::level level,
+                                           const diagnostic_info &info) {
+  consumer::handle_diagnostic(level, info);
+
+  const engine *engine = info.engine();
+  held_diagnostic held{};
+  held.id = engine->current_diagnostic_id_;
+  held.range = engine->range_;
+  held.arguments = engine->arguments_;
+  for (signed char argument = 0; argument < engine->arguments_; ++argument) {
+    held.argument_types[argument] = engine->argument_types_[argument];
+    switch (engine->argument_types_[argument]) {
+    case engine::argument_type::string:
+      held.argument_strings[argument] =
+          std::string(engine->argument_strings_[argument]);
+      break;
+    case engine::argument_type::u32string:
+      held.argument_u32strings[argument] =
+          std::u32string(engine->argument_u32strings_[argument]);
+      break;
+    default:
+      held.argument_values[argument] = engine->argument_values_[argument];
+      break;
+    }
+  }
+
+  if (level == diagnostic::level::error or level == diagnostic::level::fatal)
+    ++held_errors_;
+  diagnostics_.push_back(std::move(held));
+}
+
+void buffering_consumer::replay(engine &engine) {
+  // the errors are counted again as they are reported
+  engine.errors_ -= held_errors_;
+
+  for (const auto &held : diagnostics_) {
+    engine.current_diagnostic_id_ = held.id;
+    engine.range_ = held.range;
+    engine.arguments_ = held.arguments;
+    for (signed char argument = 0; argument < held.arguments; ++argument) {
+      engine.argument_types_[argument] = held.argument_types[argument];
+      engine.argument_strings_[argument] = held.argument_strings[argument];
+      engine.argument_u32strings_[argument] =
+          held.argument_u32strings[argument];
+      engine.argument_values_[argument] = held.argument_values[argument];
+    }
+    engine.emit_current_diagnostic();
+  }
+
+  reset();
+}
+
+void buffering_consumer::discard(engine &engine) {
+  engine.errors_ -= held_errors_;
+  reset();
+}
 }
 }
 
@@ -36,13 +36,22 @@ static const struct {
   const char *format;
 } diagnostics[] = {
   [static_cast<int>(diagnostic::err_additional_case_blocks_cannot_appear_after_default)] = { diagnostic::level::error, "additional 'case' blocks cannot appear after 'default' block of a 'switch'" },
+  [static_cast<int>(diagnostic::err_arithmetic_operation_results_in_an_overflow)] = { diagnostic::level::error, "arithmetic operation '%0 %1 %2' (on type '%3') results in an overflow" },
+  [static_cast<int>(diagnostic::err_attributes_are_not_allowed_on_syntax)] = { diagnostic::level::error, "attributes are not allowed on %0" },
   [static_cast<int>(diagnostic::err_cannot_create_variadic_tuple)] = { diagnostic::level::error, "cannot create variadic tuple" },
   [static_cast<int>(diagnostic::err_cannot_declare_a_custom_prefix_name_operator)] = { diagnostic::level::error, "cannot declare a custom prefix '%0' operator" },
   [static_cast<int>(diagnostic::err_cannot_declare_a_custom_postfix_name_operator)] = { diagnostic::level::error, "cannot declare a custom prefix '%0' operator" },
+  [static_cast<int>(diagnostic::err_cannot_find_a_consistent_type_for_the_expression)] = { diagnostic::level::error, "cannot find a consistent type for the expression" },
+  [static_cast<int>(diagnostic::err_constant_used_before_being_initialized)] = { diagnostic::level::error, "constant '%0' used before being initialized" },
   [static_cast<int>(diagnostic::err_declaration_is_only_valid_at_file_scope)] = { diagnostic::level::error, "declaration is only valid at file scope" },
   [static_cast<int>(diagnostic::err_declaration_attribute_on_type)] = { diagnostic::level::error, "attribute can only be applied to declarations, not types" },
+  [static_cast<int>(diagnostic::err_declaration_modifiers_are_not_allowed_on_syntax)] = { diagnostic::level::error, "declaration modifiers are not allowed on %0" },
+  [static_cast<int>(diagnostic::err_division_by_zero)] = { diagnostic::level::error, "division by zero" },
+  [static_cast<int>(diagnostic::err_expected_a_digit_in_floating_point_exponent)] = { diagnostic::level::error, "expected a digit in floating point exponent" },
   [static_cast<int>(diagnostic::err_expected_an_attribute_name)] = { diagnostic::level::error, "expected an attribute name" },
   [static_cast<int>(diagnostic::err_expected_argument_list)] = { diagnostic::level::error, "expected argument list" },
+  [static_cast<int>(diagnostic::err_expected_associativity)] = { diagnostic::level::error, "expected 'none', 'left', or 'right' after 'associativity'" },
+  [static_cast<int>(diagnostic::err_expected_declaration)] = { diagnostic::level::error, "expected declaration" },
   [static_cast<int>(diagnostic::err_expected_dictionary_value_type)] = { diagnostic::level::error, "expected dictionary value type" },
   [static_cast<int>(diagnostic::err_expected_element_type)] = { diagnostic::level::error, "expected element type" },
   [static_cast<int>(diagnostic::err_expected_expression)] = { diagnostic::level::error, "expected expression" },
@@ -53,6 +62,7 @@ static const struct {
   [static_cast<int>(diagnostic::err_expected_expression_in)] = { diagnostic::level::error, "expected expression in %0" },
   [static_cast<int>(diagnostic::err_expected_expression_or_binding_in)] = { diagnostic::level::error, "expected expression, var, or let in %0" },
   [static_cast<int>(diagnostic::err_expected_filename)] = { diagnostic::level::error, "expected filename string literal for #line directive" },
+  [static_cast<int>(diagnostic::err_expected_hexadecimal_code_in_braces_after_unicode_escape)] = { diagnostic::level::error, "expected hexadecimal code in braces after unicode escape" },
   [static_cast<int>(diagnostic::err_expected_identifier_after_syntax)] = { diagnostic::level::error, "expected identifier after %0" },
   [static_cast<int>(diagnostic::err_expected_identifier)] = { diagnostic::level::error, "expected identifer" },
   [static_cast<int>(diagnostic::err_expected_identifier_in)] = { diagnostic::level::error, "expected identifier in %0" },
@@ -65,6 +75,7 @@ static const struct {
   [static_cast<int>(diagnostic::err_expected_parameter_name)] = { diagnostic::level::error, "expected parameter name" },
   [static_cast<int>(diagnostic::err_expected_parameter_type_following)] = { diagnostic::level::error, "expected parameter type following '%0'" },
   [static_cast<int>(diagnostic::err_expected_pattern)] = { diagnostic::level::error, "expected pattern" },
+  [static_cast<int>(diagnostic::err_expected_precedence_level)] = { diagnostic::level::error, "expected a precedence level between 0 and 255 after 'precedence'" },
   [static_cast<int>(diagnostic::err_expected_starting_line_number)] = { diagnostic::level::error, "expected starting line number for #line directive" },
   [static_cast<int>(diagnostic::err_expected_token)] = { diagnostic::level::error, "expected '%0'" },
   [static_cast<int>(diagnostic::err_expected_token_after_syntax)] = { diagnostic::level::error, "expected '%0' after %1" },
@@ -76,22 +87,35 @@ static const struct {
   [static_cast<int>(diagnostic::err_expected_token_to_syntax)] = { diagnostic::level::error, "expected '%0' to %1" },
   [static_cast<int>(diagnostic::err_expected_token_type)] = { diagnostic::level::error, "expected '%0' %1" },
   [static_cast<int>(diagnostic::err_expected_type)] = { diagnostic::level::error, "expected type" },
+  [static_cast<int>(diagnostic::err_expected_type_after_syntax)] = { diagnostic::level::error, "expected type after %0" },
   [static_cast<int>(diagnostic::err_expected_type_in)] = { diagnostic::level::error, "expected type in %0" },
   [static_cast<int>(diagnostic::err_expected_type_for_function_result)] = { diagnostic::level::error, "expected type for function result" },
   [static_cast<int>(diagnostic::err_expected_typed_expression_for)] = { diagnostic::level::error, "expected %0 expression for %1" },
   [static_cast<int>(diagnostic::err_expected_value_in)] = { diagnostic::level::error, "expected value in %0" },
   [static_cast<int>(diagnostic::err_expressions_not_allowed_at_the_top_level)] = { diagnostic::level::error, "expressions not allowed at the top level" },
+  [static_cast<int>(diagnostic::err_extraneous_token_at_top_level)] = { diagnostic::level::error, "extraneous '%0' at top level" },
+  [static_cast<int>(diagnostic::err_hexadecimal_floating_point_literal_must_end_with_an_exponent)] = { diagnostic::level::error, "hexadecimal floating point literal must end with an exponent" },
   [static_cast<int>(diagnostic::err_initializer_cannot_be_referenced_without_arguments)] = { diagnostic::level::error, "initializer cannot be referenced without arguments" },
+  [static_cast<int>(diagnostic::err_integer_literal_overflows_when_stored_into)] = { diagnostic::level::error, "integer literal '%0' overflows when stored into '%1'" },
   [static_cast<int>(diagnostic::err_invalid_character_in_source_file)] = { diagnostic::level::error, "invalid character in source file" },
+  [static_cast<int>(diagnostic::err_invalid_escape_sequence_in_literal)] = { diagnostic::level::error, "invalid escape sequence in literal" },
+  [static_cast<int>(diagnostic::err_invalid_unicode_scalar)] = { diagnostic::level::error, "invalid unicode scalar" },
+  [static_cast<int>(diagnostic::err_labels_are_only_valid_on_loop_and_switch_statements)] = { diagnostic::level::error, "labels are only valid on loop and switch statements" },
   [static_cast<int>(diagnostic::err_migration_new_array_syntax)] = { diagnostic::level::error, "array types are now written with the brackets around the element type" },
+  [static_cast<int>(diagnostic::err_name_references_itself)] = { diagnostic::level::error, "'%0' references itself" },
+  [static_cast<int>(diagnostic::err_nesting_exceeds_maximum_depth_of)] = { diagnostic::level::error, "nesting exceeds the maximum depth of %0" },
+  [static_cast<int>(diagnostic::err_non_associative_operator_is_adjacent_to_operator_of_same_precedence)] = { diagnostic::level::error, "non-associative operator is adjacent to operator of same precedence" },
+  [static_cast<int>(diagnostic::err_operator_is_not_a_known_binary_operator)] = { diagnostic::level::error, "operator '%0' is not a known binary operator" },
   [static_cast<int>(diagnostic::err_operator_must_be_declared_as_prefix_postfix_or_infix)] = { diagnostic::level::error, "operator must be declared as 'prefix', 'postfix', or 'infix'" },
   [static_cast<int>(diagnostic::err_operators_must_have_one_or_two_arguments)] = { diagnostic::level::error, "operators must have one or two arguments" },
   [static_cast<int>(diagnostic::err_parameter_may_not_have_multiple_specifiers)] = { diagnostic::level::error, "parameter may not have multiple 'inout, 'var', or 'let' specifiers" },
   [static_cast<int>(diagnostic::err_raw_value_for_enum_case_must_be_a_literal)] = { diagnostic::level::error, "raw value for enum case must be a literal" },
   [static_cast<int>(diagnostic::err_return_invalid_outside_of_a_func)] = { diagnostic::level::error, "return invalid outside of a func" },
+  [static_cast<int>(diagnostic::err_switch_must_be_exhaustive_consider_adding_a_default_clause)] = { diagnostic::level::error, "switch must be exhaustive, consider adding a default clause" },
   [static_cast<int>(diagnostic::err_syntax_is_not_allowed_outside_of_an_enum)] = { diagnostic::level::error, "%0 is not allowed outside of an enum" },
   [static_cast<int>(diagnostic::err_syntax_should_have_at_least_one_executable_statement)] = { diagnostic::level::error, "%0 should have at least one executable statement" },
   [static_cast<int>(diagnostic::err_target_unknown_triple)] = { diagnostic::level::error, "unknown target triple '%0'" },
+  [static_cast<int>(diagnostic::err_the_compiler_is_unable_to_type_check_this_expression_in_reasonable_time)] = { diagnostic::level::error, "the compiler is unable to type-check this expression in reasonable time; try breaking up the expression into distinct sub-expressions" },
   [static_cast<int>(diagnostic::err_the_line_number_needs_to_be_greater_than_zero)] = { diagnostic::level::error, "the line number needs to be greater than zero" },
   [static_cast<int>(diagnostic::err_token_cannot_appear_nested_inside_another_pattern)] = { diagnostic::level::error, "'%0' cannot appear nested instead another 'var' or 'let' pattern" },
   [static_cast<int>(diagnostic::err_token_modifier_is_not_required_or_allowed_on_func_declarations)] = { diagnostic::level::error, "'%0' modifier is not required or allowed on func declarations" },
@@ -102,10 +126,23 @@ static const struct {
   [static_cast<int>(diagnostic::err_unexpected_configuration_block_terminator)] = { diagnostic::level::error, "unexpected configuration block terminator" },
   [static_cast<int>(diagnostic::err_unexpected_token_separator)] = { diagnostic::level::error, "unexpected '%0' separator" },
   [static_cast<int>(diagnostic::err_unknown_attribute)] = { diagnostic::level::error, "unknown attribute '%0'" },
+  [static_cast<int>(diagnostic::err_unsupported_feature)] = { diagnostic::level::error, "unsupported feature %0" },
+  [static_cast<int>(diagnostic::err_unterminated_block_comment)] = { diagnostic::level::error, "unterminated '/*' comment" },
+  [static_cast<int>(diagnostic::err_unterminated_string_literal)] = { diagnostic::level::error, "unterminated string literal" },
+  [static_cast<int>(diagnostic::err_variable_used_before_being_initialized)] = { diagnostic::level::error, "variable '%0' used before being initialized" },
 
+  [static_cast<int>(diagnostic::warn_case_is_already_handled_by_previous_patterns)] = { diagnostic::level::warning, "case is already handled by previous patterns; consider removing it" },
+  [static_cast<int>(diagnostic::warn_default_will_never_be_executed)] = { diagnostic::level::warning, "default will never be executed" },
   [static_cast<int>(diagnostic::warn_extraneous_token_in)] = { diagnostic::level::warning, "extraneous '%0' in %1" },
+  [static_cast<int>(diagnostic::warn_immutable_value_was_never_used)] = { diagnostic::level::warning, "immutable value '%0' was never used; consider replacing with '_' or removing it" },
+  [static_cast<int>(diagnostic::warn_initialization_of_immutable_value_was_never_used)] = { diagnostic::level::warning, "initialization of immutable value '%0' was never used; consider replacing with assignment to '_' or removing it" },
+  [static_cast<int>(diagnostic::warn_initialization_of_variable_was_never_used)] = { diagnostic::level::warning, "initialization of variable '%0' was never used; consider replacing with assignment to '_' or removing it" },
   [static_cast<int>(diagnostic::warn_parameter_name_can_be_expression_more_succinctly_as)] = { diagnostic::level::warning, "'%0 %0' can be expressed more succinctly as '#%0'" },
+  [static_cast<int>(diagnostic::warn_variable_was_never_mutated)] = { diagnostic::level::warning, "variable '%0' was never mutated; consider changing to 'let' constant" },
+  [static_cast<int>(diagnostic::warn_variable_was_never_used)] = { diagnostic::level::warning, "variable '%0' was never used; consider replacing with '_' or removing it" },
+  [static_cast<int>(diagnostic::warn_variable_was_written_to_but_never_read)] = { diagnostic::level::warning, "variable '%0' was written to, but never read" },
 
+  [static_cast<int>(diagnostic::note_missing_case)] = { diagnostic::level::note, "missing case: '%0'" },
   [static_cast<int>(diagnostic::note_to_match_this_opening_token)] = { diagnostic::level::note, "to match this opening '%0'" },
 
 
@@ -33,11 +33,15 @@
 namespace swift {
 namespace diagnostics {
 engine::engine(diagnostics::options *options, diagnostics::consumer *consumer)
-    : options_(options), consumer_(consumer),
+    : options_(options), consumer_(consumer), errors_(0), suppressed_(false),
       current_diagnostic_id_(diagnostic::invalid) {}
 
 engine::~engine() {}
 
+void engine::consumer(diagnostics::consumer *consumer) {
+  consumer_ = consumer;
+}
+
 void engine::emit_current_diagnostic() {
   assert(consumer_ && "diagnostic consumer not set");
   process_diagnostic();
@@ -47,9 +51,15 @@ void engine::emit_current_diagnostic() {
 void engine::process_diagnostic() {
   assert(not (current_diagnostic_id_ == diagnostic::invalid) &&
          "no current diagnostic");
+  if (suppressed_)
+    return;
+
   diagnostics::diagnostic_info info(this);
   // FIXME(compnerd) hoist out the ids to actually be able to share that
-  consumer_->handle_diagnostic(diagnostic::get_level(info.id()), info);
+  const diagnostic::level level = diagnostic::get_level(info.id());
+  if (level == diagnostic::level::error or level == diagnostic::level::fatal)
+    ++errors_;
+  consumer_->handle_diagnostic(level, info);
 }
 }
 }
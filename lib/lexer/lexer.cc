@@ -31,6 +31,7 @@
 #include "swift/support/debug.hh"
 #include "swift/support/error-handling.hh"
 
+#include <algorithm>
 #include <limits>
 
 using namespace swift::diagnostics;
@@ -382,10 +383,8 @@ token lexer::consume<token::type::whitespace>() {
 
 template <>
 token lexer::consume<token::type::comment>() {
-  if (buffer_end_ - cursor_ < 2)
-    __builtin_trap();  // TODO(compnerd) diagnose unexpected end
-
-  assert(cursor_[0] == U'/' && (cursor_[1] == U'/' || cursor_[1] == U'*') &&
+  assert(buffer_end_ - cursor_ >= 2 &&
+         cursor_[0] == U'/' && (cursor_[1] == U'/' || cursor_[1] == U'*') &&
          "comment must start with '//' or '/*'");
 
   auto b = position();
@@ -410,11 +409,16 @@ token lexer::consume<token::type::comment>() {
     else if (cursor_[0] == U'/' && cursor_[1] == U'/')
       while (cursor_ < buffer_end_ && *cursor_ != U'\r' && *cursor_ != U'\n')
         ++cursor_, ++column_;
+    else if (cursor_[0] == U'\n')
+      ++cursor_, column_ = 0, ++line_;
     else
       ++cursor_, ++column_;
 
-  if (depth)
-    __builtin_trap();  // TODO(compnerd) diagnose unexpected end
+  if (depth) {
+    diagnostics_engine_.report(b, diagnostic::err_unterminated_block_comment);
+    // NOTE(compnerd) the remainder of the buffer is part of the comment
+    cursor_ = buffer_end_;
+  }
 
   return std::move<token>({
       token::type::comment, std::u32string_view(), b, position()
@@ -427,10 +431,13 @@ token lexer::consume<token::type::identifier>() {
   bool reserved = false;
 
   if (not (*cursor_ == U'$' or *cursor_ == U'`' or is_identifier_head(*cursor_))) {
-    diagnostics_engine_.report(position(),
+    auto b = position();
+    diagnostics_engine_.report(b,
                                diagnostic::err_invalid_character_in_source_file);
+    // NOTE(compnerd) skip the offending character to guarantee progress
+    ++cursor_, ++column_;
     return std::move<token>({ token::type::invalid, std::u32string_view(),
-                              position(), position() });
+                              b, position() });
   }
 
   auto b = position();
@@ -445,26 +452,31 @@ token lexer::consume<token::type::identifier>() {
     ++cursor_, ++column_;
     /* fall through */
   default:
-    if (!is_identifier_head(*cursor_))
-      __builtin_trap();  // TODO(compnerd) diagnose invalid identifier
+    if (cursor_ == buffer_end_ or !is_identifier_head(*cursor_)) {
+      diagnostics_engine_.report(position(), diagnostic::err_expected_identifier);
+      return std::move<token>({ token::type::invalid, std::u32string_view(),
+                                b, position() });
+    }
 
-    while (is_identifier_character(*cursor_))
+    while (cursor_ < buffer_end_ and is_identifier_character(*cursor_))
       ++cursor_, ++column_;
 
     if (!reserved)
       break;
 
-    if (*cursor_ == U'`')
+    if (cursor_ < buffer_end_ and *cursor_ == U'`')
       ++cursor_, ++column_;
     else
-      __builtin_trap();  // TODO(compnerd) diagnose missing `
+      diagnostics_engine_.report(position(), diagnostic::err_expected_token)
+          << "`";
 
     break;
   }
   auto e = position();
 
+  const std::u32string_view value(name, e.column() - b.column());
   return std::move<token>({
-      std::u32string_view(name, e.column() - b.column()), b, e
+      value, b, e, identifiers_ ? &identifiers_->get(value) : nullptr
   });
 }
 
@@ -484,19 +496,23 @@ token lexer::consume<token::type::identifier>() {
 // unicode-scalar-digits → Between one and eight hexadecimal digits
 template <>
 token lexer::consume<token::literal_type::string>() {
-  assert((buffer_end_ - cursor_ >= 2 and *cursor_ == U'"') &&
+  assert((buffer_end_ - cursor_ >= 1 and *cursor_ == U'"') &&
          "expected string-literal");
 
   const char32_t *literal = cursor_;
 
   auto b = position();
   for (++cursor_, ++column_;
+       cursor_ < buffer_end_ and
        not set<U'"', U'\u000a', U'\u000d'>::contains(*cursor_);
        ++cursor_, ++column_) {
     if (*cursor_ == U'\\') {
-      switch (cursor_[1]) {
+      switch (cursor_ + 1 < buffer_end_ ? cursor_[1] : U'\0') {
       default:
-        __builtin_trap();  // TODO(compnerd) diagnose invalid string-literal
+        diagnostics_engine_.report(position(),
+                                   diagnostic::err_invalid_escape_sequence_in_literal);
+        ++cursor_, ++column_;  // '\'
+        break;
       case U'0':
       case U'\\':
       case U't':
@@ -507,12 +523,49 @@ token lexer::consume<token::literal_type::string>() {
         ++cursor_, ++column_;  // '\'
         ++cursor_, ++column_;  // .
         break;
-      case 'u':
-        __builtin_trap();  // FIXME(compnerd) handle unicode codepoint
+      case 'u': {
+        auto escape = position();
+        ++cursor_, ++column_;  // '\'
+        ++cursor_, ++column_;  // 'u'
+
+        if (cursor_ == buffer_end_ or *cursor_ != U'{') {
+          diagnostics_engine_.report(escape,
+                                     diagnostic::err_expected_hexadecimal_code_in_braces_after_unicode_escape);
+          break;
+        }
+        ++cursor_, ++column_;  // '{'
+
+        uint32_t scalar = 0;
+        unsigned digits = 0;
+        for (; cursor_ < buffer_end_ and isxdigit(*cursor_);
+             ++cursor_, ++column_, ++digits)
+          if (digits < 8)
+            scalar = (scalar << 4) | (isdigit(*cursor_)
+                                          ? *cursor_ - U'0'
+                                          : (*cursor_ | 0x20) - U'a' + 10);
+
+        if (digits == 0 or digits > 8 or cursor_ == buffer_end_ or
+            *cursor_ != U'}') {
+          diagnostics_engine_.report(escape,
+                                     diagnostic::err_expected_hexadecimal_code_in_braces_after_unicode_escape);
+          break;
+        }
+        ++cursor_, ++column_;  // '}'
+
+        if (scalar > 0x10ffff or (scalar >= 0xd800 and scalar <= 0xdfff))
+          diagnostics_engine_.report(escape,
+                                     diagnostic::err_invalid_unicode_scalar);
+        break;
+      }
       case '(':
         ++cursor_, ++column_;  // '\'
         ++cursor_, ++column_;  // '('
-        for (unsigned level = 1; level > 0; ++cursor_, ++column_) {
+        // NOTE(compnerd) an interpolation may not span lines; leave the
+        // terminator for the enclosing loop to diagnose
+        for (unsigned level = 1;
+             level > 0 and cursor_ < buffer_end_ and
+             not set<U'\u000a', U'\u000d'>::contains(*cursor_);
+             ++cursor_, ++column_) {
           switch (*cursor_) {
           default:
             break;
@@ -532,7 +585,16 @@ token lexer::consume<token::literal_type::string>() {
       --cursor_, --column_;
     }
   }
-  assert(*cursor_ == U'"' && "expected '\"'");
+
+  if (cursor_ == buffer_end_ or *cursor_ != U'"') {
+    diagnostics_engine_.report(b, diagnostic::err_unterminated_string_literal);
+    auto e = position();
+    return std::move<token>({
+        token::literal_type::string,
+        std::u32string_view(literal + 1, e.column() - b.column() - 1), b, e
+    });
+  }
+
   ++cursor_, ++column_;
   auto e = position();
 
@@ -638,9 +700,40 @@ token lexer::consume<token::type::literal>() {
                ++cursor_, ++column_)
             ;
 
-          if (*cursor_ == '.') {
-            type = token::literal_type::floating_point;
-            __builtin_trap();  // TODO(compnerd) generate a floating point literal
+          // hexadecimal-fraction → '.' hexadecimal-digit hexadecimal-literal-characters[opt]
+          // hexadecimal-exponent → floating-point-p sign[opt] decimal-literal
+          if (cursor_ < buffer_end_ and set<U'.', U'p', U'P'>::contains(*cursor_)) {
+            const char32_t *mark = cursor_;
+            const unsigned column = column_;
+
+            bool fraction = false;
+            if (*cursor_ == U'.' and buffer_end_ - cursor_ >= 2 and
+                isxdigit(cursor_[1])) {
+              fraction = true;
+              for (++cursor_, ++column_;
+                   cursor_ < buffer_end_ and (isxdigit(*cursor_) or *cursor_ == U'_');
+                   ++cursor_, ++column_)
+                ;
+            }
+
+            if (cursor_ < buffer_end_ and set<U'p', U'P'>::contains(*cursor_)) {
+              type = token::literal_type::floating_point;
+              ++cursor_, ++column_;
+              if (cursor_ < buffer_end_ and set<U'+', U'-'>::contains(*cursor_))
+                ++cursor_, ++column_;
+              if (cursor_ == buffer_end_ or not isdigit(*cursor_))
+                diagnostics_engine_.report(position(),
+                                           diagnostic::err_expected_a_digit_in_floating_point_exponent);
+              while (cursor_ < buffer_end_ and (isdigit(*cursor_) or *cursor_ == U'_'))
+                ++cursor_, ++column_;
+            } else if (fraction and not isdigit(mark[1])) {
+              // NOTE(compnerd) `0x1.foo` is a member access on an integer
+              cursor_ = mark, column_ = column;
+            } else if (fraction) {
+              type = token::literal_type::floating_point;
+              diagnostics_engine_.report(position(),
+                                         diagnostic::err_hexadecimal_floating_point_literal_must_end_with_an_exponent);
+            }
           }
 
           break;
@@ -903,7 +996,7 @@ token lexer::lex() {
   case U';':
     return consume<token::type::semi>();
   case U'/':
-    if (cursor_[1] == U'/' || cursor_[1] == U'*')
+    if (buffer_end_ - cursor_ >= 2 and (cursor_[1] == U'/' || cursor_[1] == U'*'))
       return consume<token::type::comment>(), next();
     break;
   case U'_':
@@ -1118,29 +1211,108 @@ token lexer::lex() {
   return consume<token::type::identifier>();
 }
 
+void lexer::fill() {
+  const unsigned errors = diagnostics_engine_.error_count();
+  lookahead_.push_back(lex());
+  if (checkpoints_ and diagnostics_engine_.error_count() != errors)
+    diagnosed_.push_back(lookahead_.size() - 1);
+}
+
 token lexer::head() {
-  if (lookahead_.empty())
-    lookahead_.push_back(next());
-  return lookahead_.front();
+  if (head_ == lookahead_.size())
+    fill();
+  return lookahead_[head_];
 }
 
 token lexer::peek() {
-  while (lookahead_.size() < 2) {
-    lookahead_.push_back(lex());
+  while (lookahead_.size() - head_ < 2) {
+    fill();
     if (lookahead_.back().is<token::type::eof>())
       break;
   }
-  return lookahead_.back();
+  return lookahead_.size() - head_ > 1 ? lookahead_[head_ + 1]
+                                       : lookahead_.back();
 }
 
 token lexer::next() {
-  if (!lookahead_.empty()) {
-    auto token = lookahead_.front();
+#if defined(SWIFT_PARSER_PROFILING)
+  ++consumed_;
+#endif
+
+  if (head_ == lookahead_.size()) {
+    if (not checkpoints_) {
+      auto token = lex();
+      previous_end_ = token.location().end();
+      return token;
+    }
+    fill();
+  }
+
+  auto token = lookahead_[head_];
+  if (checkpoints_)
+    ++head_;
+  else
     lookahead_.pop_front();
-    return token;
+  previous_end_ = token.location().end();
+  return token;
+}
+
+lexer::checkpoint lexer::mark() {
+  ++checkpoints_;
+  return checkpoint(head_, lookahead_.size(), previous_end_);
+}
+
+void lexer::rewind(const checkpoint &checkpoint) {
+  assert(checkpoints_ && "no outstanding checkpoint");
+
+  for (auto index = diagnosed_.begin(); index != diagnosed_.end(); ++index) {
+    if (*index < checkpoint.lexed_)
+      continue;
+
+    const location start = lookahead_[*index].location().start();
+    cursor_ = buffer_start_ + start.offset();
+    line_ = start.line();
+    column_ = start.column();
+    lookahead_.erase(lookahead_.begin() + *index, lookahead_.end());
+    diagnosed_.erase(index, diagnosed_.end());
+    break;
   }
 
-  return lex();
+  head_ = checkpoint.head_;
+  previous_end_ = checkpoint.previous_end_;
+  release(checkpoint);
+}
+
+void lexer::release(const checkpoint &checkpoint) {
+  assert(checkpoints_ && "no outstanding checkpoint");
+  assert(checkpoint.head_ <= head_ && "checkpoint released out of order");
+
+  if (--checkpoints_)
+    return;
+
+  lookahead_.erase(lookahead_.begin(), lookahead_.begin() + head_);
+  head_ = 0;
+  diagnosed_.clear();
+}
+
+// Appends the offsets of the lines which start after the line breaks within
+// the `length` characters at `offset`.
+void lexer::index(size_t offset, size_t length,
+                  std::vector<uint32_t> &lines) const {
+  // NOTE(compnerd) this must agree with the accounting of whitespace tokens
+  for (const char32_t *character = buffer_start_ + offset,
+                      *end = buffer_start_ + offset + length;
+       character != end; ++character) {
+    switch (*character) {
+    case U'\r':
+    case U'\n':
+    case U'\v':
+      lines.push_back(character - buffer_start_ + 1);
+      break;
+    default:
+      break;
+    }
+  }
 }
 
 void lexer::set_buffer(const char32_t *buffer, size_t length) {
@@ -1148,10 +1320,73 @@ void lexer::set_buffer(const char32_t *buffer, size_t length) {
   // is invalid (nullptr, 0) when a new buffer is provided?
   buffer_start_ = buffer;
   buffer_end_ = buffer + length;
+  lines_.assign(1, 0);
+  index(0, length, lines_);
+  reset();
+}
+
+void lexer::set_buffer(const char32_t *buffer, size_t length, size_t offset,
+                       size_t removed, size_t inserted) {
+  assert(offset + inserted <= length && "edit out of range");
+  buffer_start_ = buffer;
+  buffer_end_ = buffer + length;
+
+  // the lines which started after a removed line break are replaced by those
+  // after an inserted one, and the lines after the edit are moved
+  const auto first =
+      std::upper_bound(lines_.begin(), lines_.end(), offset);
+  const auto last =
+      std::upper_bound(first, lines_.end(), offset + removed);
+  const int64_t delta =
+      static_cast<int64_t>(inserted) - static_cast<int64_t>(removed);
+  for (auto line = last; line != lines_.end(); ++line)
+    *line += delta;
+
+  std::vector<uint32_t> lines;
+  index(offset, inserted, lines);
+  lines_.insert(lines_.erase(first, last), lines.begin(), lines.end());
+
+  reset();
+}
+
+void lexer::reset() {
   cursor_ = buffer_start_;
   line_ = 1;
   column_ = 0;
+  previous_end_ = location();
+  assert(not checkpoints_ && "cannot replace the buffer of a marked lexer");
   lookahead_.clear();
+  head_ = 0;
+  diagnosed_.clear();
+}
+
+void lexer::seek(location position, location previous_end) {
+  assert(position.offset() <= static_cast<size_t>(buffer_end_ - buffer_start_) &&
+         "cannot seek beyond the end of the buffer");
+  cursor_ = buffer_start_ + position.offset();
+  line_ = position.line();
+  column_ = position.column();
+  previous_end_ = previous_end;
+  assert(not checkpoints_ && "cannot seek a marked lexer");
+  lookahead_.clear();
+  head_ = 0;
+  diagnosed_.clear();
+}
+
+location lexer::locate(size_t offset) const {
+  assert(offset <= static_cast<size_t>(buffer_end_ - buffer_start_) &&
+         "cannot locate beyond the end of the buffer");
+
+  const auto start =
+      std::upper_bound(lines_.begin(), lines_.end(), offset) - 1;
+
+  // NOTE(compnerd) this must agree with the accounting of whitespace tokens
+  unsigned column = 0;
+  for (const char32_t *character = buffer_start_ + *start;
+       character != buffer_start_ + offset; ++character)
+    if (*character != U'\f')
+      ++column;
+  return location(start - lines_.begin() + 1, column, offset);
 }
 }
 
@@ -0,0 +1,624 @@
+/**
+ * Copyright © 2014 Saleem Abdulrasool <compnerd@compnerd.org>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+
+#include "swift/parser/document.hh"
+#include "swift/lexer/lexer.hh"
+#include "swift/parser/parser.hh"
+#include "swift/syntax/visitor.hh"
+
+#include "swift/syntax/pattern-expression.hh"
+#include "swift/syntax/pattern-tuple.hh"
+#include "swift/syntax/pattern-typed.hh"
+#include "swift/syntax/pattern-var.hh"
+
+#include <llvm/ADT/SmallVector.h>
+
+#include <algorithm>
+#include <cassert>
+
+namespace {
+using namespace swift;
+
+using node_list = llvm::SmallVectorImpl<const ast::statement *>;
+
+void add(node_list &nodes, const ast::statement *statement) {
+  if (statement)
+    nodes.push_back(statement);
+}
+
+void add(node_list &nodes, const ast::pattern *pattern) {
+  if (not pattern)
+    return;
+
+  switch (pattern->type()) {
+  case ast::pattern::type::any:
+  case ast::pattern::type::named:
+    break;
+  case ast::pattern::type::tuple:
+    for (const auto *element :
+         static_cast<const ast::pattern_tuple *>(pattern)->elements())
+      add(nodes, element);
+    break;
+  case ast::pattern::type::typed:
+    add(nodes, static_cast<const ast::pattern_typed *>(pattern)->pattern());
+    break;
+  case ast::pattern::type::var:
+    add(nodes, static_cast<const ast::pattern_var *>(pattern)->pattern());
+    break;
+  case ast::pattern::type::expression:
+    add(nodes,
+        static_cast<const ast::pattern_expression *>(pattern)->expression());
+    break;
+  }
+}
+
+// Collects the nodes directly beneath `statement`, including those reached
+// through patterns.  Function bodies which have not been parsed are skipped
+// rather than parsed.
+void children(const ast::statement *statement, node_list &nodes) {
+  using namespace swift::ast;
+
+  switch (statement->kind()) {
+  case node_kind::labelled_statement:
+    add(nodes, static_cast<const labelled_statement *>(statement)->statement());
+    break;
+  case node_kind::defer_statement:
+    add(nodes, static_cast<const defer_statement *>(statement)->code_block());
+    break;
+  case node_kind::do_statement: {
+    const auto *block = static_cast<const do_statement *>(statement);
+    add(nodes, block->body());
+    for (const auto &clause : block->catch_clauses()) {
+      add(nodes, std::get<0>(clause));
+      add(nodes, std::get<1>(clause));
+    }
+    break;
+  }
+  case node_kind::statements:
+    for (const auto *substatement :
+         static_cast<const statements *>(statement)->substatements())
+      add(nodes, substatement);
+    break;
+
+  case node_kind::prefix_unary_expression: {
+    const auto *prefix = static_cast<const prefix_unary_expression *>(statement);
+    add(nodes, prefix->prefix_operator());
+    add(nodes, prefix->subexpression());
+    break;
+  }
+  case node_kind::in_out_expression:
+    add(nodes, static_cast<const in_out_expression *>(statement)->subexpression());
+    break;
+  case node_kind::sequence_expression:
+    for (const auto *expression :
+         *static_cast<const sequence_expression *>(statement))
+      add(nodes, expression);
+    break;
+  case node_kind::binary_expression: {
+    const auto *binary = static_cast<const binary_expression *>(statement);
+    add(nodes, binary->lhs());
+    add(nodes, binary->binary_operator());
+    add(nodes, binary->rhs());
+    break;
+  }
+  case node_kind::assignment_expression: {
+    const auto *assignment = static_cast<const assignment_expression *>(statement);
+    add(nodes, assignment->lhs());
+    add(nodes, assignment->rhs());
+    break;
+  }
+  case node_kind::conditional_expression: {
+    const auto *conditional =
+        static_cast<const conditional_expression *>(statement);
+    add(nodes, conditional->condition());
+    add(nodes, conditional->true_clause());
+    add(nodes, conditional->false_clause());
+    break;
+  }
+  case node_kind::closure_expression:
+    add(nodes, static_cast<const closure_expression *>(statement)->body());
+    break;
+  case node_kind::parenthesized_expression:
+    for (const auto *element :
+         static_cast<const parenthesized_expression *>(statement)->elements())
+      add(nodes, element);
+    break;
+  case node_kind::postfix_unary_expression: {
+    const auto *postfix = static_cast<const postfix_unary_expression *>(statement);
+    add(nodes, postfix->subexpression());
+    add(nodes, postfix->postfix_operator());
+    break;
+  }
+  case node_kind::function_call_expression: {
+    const auto *call = static_cast<const function_call_expression *>(statement);
+    add(nodes, call->function());
+    add(nodes, call->arguments());
+    break;
+  }
+  case node_kind::initializer_expression:
+    add(nodes,
+        static_cast<const initializer_expression *>(statement)->declaration());
+    break;
+  case node_kind::explicit_member_expression:
+    add(nodes,
+        static_cast<const explicit_member_expression *>(statement)->expression());
+    break;
+  case node_kind::postfix_self_expression:
+    add(nodes, static_cast<const postfix_self_expression *>(statement)->instance());
+    break;
+  case node_kind::dynamic_type_expression:
+    add(nodes,
+        static_cast<const dynamic_type_expression *>(statement)->expression());
+    break;
+  case node_kind::forced_value_expression:
+    add(nodes,
+        static_cast<const forced_value_expression *>(statement)->expression());
+    break;
+  case node_kind::is_subtype_expression:
+  case node_kind::checked_cast_expression:
+  case node_kind::conditional_checked_cast_expression:
+    add(nodes, static_cast<const type_casting_expression *>(statement)->operand());
+    break;
+  case node_kind::array_literal_expression:
+    add(nodes, static_cast<const array_literal_expression *>(statement)->items());
+    break;
+  case node_kind::dictionary_literal_expression:
+    add(nodes,
+        static_cast<const dictionary_literal_expression *>(statement)->items());
+    break;
+
+  case node_kind::constant_declaration: {
+    const auto *constant = static_cast<const constant_declaration *>(statement);
+    add(nodes, constant->name());
+    add(nodes, constant->initializer());
+    break;
+  }
+  case node_kind::variable_declaration: {
+    const auto *variable = static_cast<const variable_declaration *>(statement);
+    add(nodes, variable->name());
+    add(nodes, variable->initializer());
+    break;
+  }
+  case node_kind::top_level_declaration:
+    add(nodes, static_cast<const top_level_declaration *>(statement)->body());
+    break;
+  case node_kind::function_declaration: {
+    const auto *function = static_cast<const function_declaration *>(statement);
+    for (const auto *parameters : function->parameter_clauses())
+      add(nodes, parameters);
+    if (not function->has_unparsed_body())
+      add(nodes, function->body());
+    break;
+  }
+  case node_kind::enum_declaration:
+    for (const auto *member :
+         static_cast<const enum_declaration *>(statement)->members())
+      add(nodes, member);
+    break;
+  case node_kind::struct_declaration:
+    add(nodes,
+        static_cast<const struct_declaration *>(statement)->declarations());
+    break;
+  case node_kind::class_declaration:
+    add(nodes, static_cast<const class_declaration *>(statement)->body());
+    break;
+  case node_kind::protocol_declaration:
+    add(nodes, static_cast<const protocol_declaration *>(statement)->members());
+    break;
+  case node_kind::initializer_declaration: {
+    const auto *initializer =
+        static_cast<const initializer_declaration *>(statement);
+    add(nodes, initializer->parameters());
+    add(nodes, initializer->body());
+    break;
+  }
+  case node_kind::deinitializer_declaration:
+    add(nodes, static_cast<const deinitializer_declaration *>(statement)->body());
+    break;
+  case node_kind::extension_declaration:
+    add(nodes, static_cast<const extension_declaration *>(statement)->body());
+    break;
+  case node_kind::subscript_declaration: {
+    const auto *subscript = static_cast<const subscript_declaration *>(statement);
+    add(nodes, subscript->parameters());
+    add(nodes, subscript->getter());
+    add(nodes, subscript->setter());
+    break;
+  }
+
+  case node_kind::for_statement: {
+    const auto *loop = static_cast<const for_statement *>(statement);
+    add(nodes, loop->initializer());
+    add(nodes, loop->condition());
+    add(nodes, loop->increment());
+    add(nodes, loop->body());
+    break;
+  }
+  case node_kind::for_in_statement: {
+    const auto *loop = static_cast<const for_in_statement *>(statement);
+    add(nodes, loop->item());
+    add(nodes, loop->collection());
+    add(nodes, loop->body());
+    break;
+  }
+  case node_kind::while_statement: {
+    const auto *loop = static_cast<const while_statement *>(statement);
+    add(nodes, loop->condition());
+    add(nodes, loop->body());
+    break;
+  }
+  case node_kind::repeat_while_statement: {
+    const auto *loop = static_cast<const repeat_while_statement *>(statement);
+    add(nodes, loop->body());
+    add(nodes, loop->condition());
+    break;
+  }
+
+  case node_kind::if_statement: {
+    const auto *branch = static_cast<const if_statement *>(statement);
+    add(nodes, branch->condition());
+    add(nodes, branch->true_clause());
+    add(nodes, branch->false_clause());
+    break;
+  }
+  case node_kind::guard_statement: {
+    const auto *guard = static_cast<const guard_statement *>(statement);
+    for (const auto *condition : guard->condition_clause())
+      add(nodes, condition);
+    add(nodes, guard->body());
+    break;
+  }
+  case node_kind::switch_statement: {
+    const auto *branch = static_cast<const switch_statement *>(statement);
+    add(nodes, branch->control_expression());
+    for (const auto &item : branch->cases()) {
+      for (const auto &label : std::get<0>(item)) {
+        add(nodes, std::get<0>(label));
+        add(nodes, std::get<1>(label));
+      }
+      add(nodes, std::get<1>(item));
+    }
+    break;
+  }
+
+  case node_kind::return_statement:
+    add(nodes, static_cast<const return_statement *>(statement)->value());
+    break;
+  case node_kind::throw_statement:
+    add(nodes, static_cast<const throw_statement *>(statement)->expression());
+    break;
+
+  case node_kind::build_configuration_statement: {
+    const auto *configuration =
+        static_cast<const build_configuration_statement *>(statement);
+    add(nodes, configuration->condition());
+    add(nodes, configuration->true_clause());
+    add(nodes, configuration->false_clause());
+    break;
+  }
+
+  case node_kind::declaration_reference_expression:
+  case node_kind::superclass_expression:
+  case node_kind::implicit_member_expression:
+  case node_kind::wildcard_expression:
+  case node_kind::subscript_expression:
+  case node_kind::optional_chaining_expression:
+  case node_kind::boolean_literal_expression:
+  case node_kind::floating_point_literal_expression:
+  case node_kind::integer_literal_expression:
+  case node_kind::nil_literal_expression:
+  case node_kind::string_literal_expression:
+  case node_kind::magic_literal_expression:
+  case node_kind::import_declaration:
+  case node_kind::typealias_declaration:
+  case node_kind::operator_declaration:
+  case node_kind::enumeration_element_declaration:
+  case node_kind::break_statement:
+  case node_kind::continue_statement:
+  case node_kind::fallthrough_statement:
+  case node_kind::line_control_statement:
+    break;
+  }
+}
+
+// Collects the declarations within `statement` (including itself), which are
+// removed from their contexts when the statement is replaced.
+void declarations(const ast::statement *statement,
+                  std::vector<ast::declaration *> &declarations) {
+  if (statement->type() == ast::statement::type::declaration)
+    declarations.push_back(const_cast<ast::declaration *>(
+        static_cast<const ast::declaration *>(statement)));
+
+  llvm::SmallVector<const ast::statement *, 4> nodes;
+  children(statement, nodes);
+  for (const auto *node : nodes)
+    ::declarations(node, declarations);
+}
+
+void unlink(swift::parser &parser,
+            const std::vector<ast::declaration *> &declarations) {
+  for (auto *declaration : declarations)
+    parser.forget(declaration);
+}
+
+// An edit, in terms of the buffer before it was applied.
+struct extent {
+  uint32_t begin;         // offset of the first replaced character
+  uint32_t end;           // offset past the replaced characters
+  int32_t delta;          // change in the length of the buffer
+};
+
+// Updates the source ranges beneath `statement` for the edit: nodes after the
+// edit are moved, and nodes which enclose it are resized.  Nodes before the
+// edit (and their children) are not visited.  The lexer holds the edited
+// buffer.
+void adjust(const ast::statement *statement, const extent &extent,
+            const lexer &lexer) {
+  auto *node = const_cast<ast::statement *>(statement);
+
+  if (node->has_source_range()) {
+    if (node->end_offset() < extent.begin)
+      return;
+    if (node->start_offset() >= extent.end)
+      node->set_source_range(node->start_offset() + extent.delta,
+                             node->end_offset() + extent.delta);
+    else if (node->end_offset() >= extent.end)
+      node->set_source_range(node->start_offset(),
+                             node->end_offset() + extent.delta);
+  }
+
+  if (node->kind() == ast::node_kind::function_declaration) {
+    auto *function = static_cast<ast::function_declaration *>(node);
+    if (function->body_location().valid() and
+        function->body_location().offset() >= extent.end)
+      function->set_body_location(
+          lexer.locate(function->body_location().offset() + extent.delta));
+  }
+
+  llvm::SmallVector<const ast::statement *, 4> nodes;
+  children(statement, nodes);
+  for (const auto *child : nodes)
+    ::adjust(child, extent, lexer);
+}
+
+// The first index in [first, last) for which `predicate` does not hold, which
+// holds for a prefix of the range.
+template <typename Predicate>
+size_t partition_point(size_t first, size_t last, Predicate predicate) {
+  while (first != last) {
+    const size_t middle = first + (last - first) / 2;
+    if (predicate(middle))
+      first = middle + 1;
+    else
+      last = middle;
+  }
+  return first;
+}
+
+// The innermost function beneath `statement` whose body strictly encloses the
+// characters [begin, end), i.e. the edit leaves both braces intact.
+ast::function_declaration *
+enclosing_function(const ast::statement *statement, uint32_t begin,
+                   uint32_t end) {
+  if (statement->has_source_range() and
+      (statement->start_offset() > begin or statement->end_offset() < end))
+    return nullptr;
+
+  llvm::SmallVector<const ast::statement *, 4> nodes;
+  children(statement, nodes);
+  for (const auto *child : nodes)
+    if (auto *function = enclosing_function(child, begin, end))
+      return function;
+
+  if (statement->kind() != ast::node_kind::function_declaration)
+    return nullptr;
+
+  const auto *function = static_cast<const ast::function_declaration *>(statement);
+  if (not function->body_location().valid() or
+      function->body_location().offset() >= begin or
+      end >= function->end_offset())
+    return nullptr;
+  return const_cast<ast::function_declaration *>(function);
+}
+}
+
+namespace swift {
+namespace parse {
+document::document(swift::lexer &lexer, swift::parser &parser,
+                   std::u32string source)
+    : lexer_(lexer), parser_(parser), source_(std::move(source)) {
+  lexer_.set_buffer(source_.data(), source_.size());
+  while (auto statement = parser_.parse_top_level_declaration())
+    statements_.push_back(*statement);
+  shifts_.assign(statements_.size() + 1, 0);
+}
+
+int32_t document::shift(size_t index) const {
+  int32_t shift = 0;
+  for (size_t node = index + 1; node; node &= node - 1)
+    shift += shifts_[node];
+  return shift;
+}
+
+// Moves the statements from `index` on by `delta`.
+void document::move(size_t index, int32_t delta) {
+  if (delta)
+    unsettled_ = true;
+  for (size_t node = index + 1; node < shifts_.size(); node += node & -node)
+    shifts_[node] += delta;
+}
+
+// Rebuilds the tree from the distance which each statement is yet to be moved.
+void document::reindex(const std::vector<int32_t> &shifts) {
+  assert(shifts.size() == statements_.size() && "mismatched shifts");
+
+  shifts_.assign(statements_.size() + 1, 0);
+  for (size_t index = 0; index < shifts.size(); ++index)
+    shifts_[index + 1] = shifts[index] - (index ? shifts[index - 1] : 0);
+  for (size_t node = 1; node < shifts_.size(); ++node)
+    if (node + (node & -node) < shifts_.size())
+      shifts_[node + (node & -node)] += shifts_[node];
+
+  unsettled_ = std::any_of(shifts.begin(), shifts.end(),
+                           [](int32_t shift) { return shift != 0; });
+}
+
+uint32_t document::start(size_t index) const {
+  return statements_[index]->start_offset() + shift(index);
+}
+
+uint32_t document::end(size_t index) const {
+  return statements_[index]->end_offset() + shift(index);
+}
+
+// Moves the statement at `index` for the edits preceding it since it was last
+// visited.
+void document::settle(size_t index) {
+  const int32_t shift = document::shift(index);
+  if (not shift)
+    return;
+
+  adjust(statements_[index], extent{ 0, 0, shift }, lexer_);
+  move(index, -shift);
+  move(index + 1, shift);
+}
+
+const std::vector<ast::statement *> &document::statements() {
+  if (unsettled_) {
+    for (size_t index = 0; index < statements_.size(); ++index)
+      settle(index);
+    unsettled_ = false;
+  }
+  return statements_;
+}
+
+void document::apply(const edit &edit) {
+  assert(edit.offset + edit.length <= source_.size() && "edit out of range");
+
+  extent extent;
+  extent.begin = edit.offset;
+  extent.end = edit.offset + edit.length;
+  extent.delta = static_cast<int32_t>(edit.text.size()) -
+                 static_cast<int32_t>(edit.length);
+
+  source_.replace(edit.offset, edit.length, edit.text.data(), edit.text.size());
+  lexer_.set_buffer(source_.data(), source_.size(), edit.offset, edit.length,
+                    edit.text.size());
+
+  // the first statement which the edit may affect; the statements before it
+  // end before the edit and are unchanged
+  size_t first = partition_point(0, statements_.size(),
+                                 [this, &extent](size_t index) {
+                                   return end(index) < extent.begin;
+                                 });
+
+  // an edit within a single function body only invalidates that body
+  if (first != statements_.size() and start(first) <= extent.begin and
+      end(first) >= extent.end) {
+    settle(first);
+    if (auto *function =
+            enclosing_function(statements_[first], extent.begin, extent.end)) {
+      std::vector<ast::declaration *> replaced;
+      if (not function->has_unparsed_body() and function->body())
+        declarations(function->body(), replaced);
+
+      if (parser_.reparse_function_body(*function,
+                                        function->end_offset() + extent.delta)) {
+        unlink(parser_, replaced);
+        adjust(statements_[first], extent, lexer_);
+        move(first + 1, extent.delta);
+        return;
+      }
+    }
+  }
+
+  // NOTE(compnerd) the edit may extend the statement preceding it (e.g. by
+  // continuing an expression), so reparse from the start of that statement
+  if (first != 0 and
+      (first == statements_.size() or start(first) >= extent.begin))
+    --first;
+
+  // the statement before which the edit cannot reach
+  size_t last = partition_point(first, statements_.size(),
+                                [this, &extent](size_t index) {
+                                  return start(index) <= extent.end;
+                                });
+
+  const uint32_t start =
+      first != statements_.size() and document::start(first) < extent.begin
+          ? document::start(first)
+          : 0;
+  const uint32_t edited = edit.offset + edit.text.size();
+
+  lexer_.seek(lexer_.locate(start));
+
+  std::vector<ast::statement *> reparsed;
+  while (not lexer_.head().is<token::type::eof>()) {
+    // resume reusing the old statements once the parser reaches the start of
+    // one past the edit; any which have been consumed are replaced
+    const uint32_t position = lexer_.head().location().start().offset();
+    if (position >= edited) {
+      while (last != statements_.size() and
+             document::start(last) + extent.delta < position)
+        ++last;
+      if (last != statements_.size() and
+          document::start(last) + extent.delta == position)
+        break;
+    }
+
+    if (auto statement = parser_.parse_top_level_declaration())
+      reparsed.push_back(*statement);
+    else
+      break;
+  }
+  if (lexer_.head().is<token::type::eof>())
+    last = statements_.size();
+
+  std::vector<ast::declaration *> replaced;
+  for (size_t statement = first; statement != last; ++statement)
+    declarations(statements_[statement], replaced);
+  unlink(parser_, replaced);
+
+  // the reparsed statements are in place, and those after them are yet to be
+  // moved for the edit
+  std::vector<int32_t> shifts;
+  shifts.reserve(statements_.size() - (last - first) + reparsed.size());
+  for (size_t statement = 0; statement < first; ++statement)
+    shifts.push_back(shift(statement));
+  shifts.resize(first + reparsed.size(), 0);
+  for (size_t statement = last; statement < statements_.size(); ++statement)
+    shifts.push_back(shift(statement) + extent.delta);
+
+  statements_.insert(statements_.erase(statements_.begin() + first,
+                                       statements_.begin() + last),
+                     reparsed.begin(), reparsed.end());
+  reindex(shifts);
+}
+}
+}
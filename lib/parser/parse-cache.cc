@@ -0,0 +1,290 @@
+/**
+ * Copyright © 2014 Saleem Abdulrasool <compnerd@compnerd.org>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+
+#include "swift/parser/parse-cache.hh"
+#include "swift/compiler/target_options.hh"
+#include "swift/lexer/lexer.hh"
+#include "swift/parser/parser.hh"
+#include "swift/syntax/ast-reader.hh"
+#include "swift/syntax/ast-writer.hh"
+#include "swift/syntax/context.hh"
+#include "swift/syntax/source-file.hh"
+
+#include <llvm/Support/MD5.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iterator>
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utime.h>
+
+#if !defined(SWIFT_BUILD_ID)
+#error SWIFT_BUILD_ID must identify the build of the compiler
+#endif
+
+namespace {
+// FNV-1a over 32-bit units (the source is already UCS-4), followed by a final
+// avalanche so that the low bits of the key are well distributed.
+constexpr uint64_t fnv_offset_basis = 0xcbf29ce484222325ull;
+constexpr uint64_t fnv_prime = 0x00000100000001b3ull;
+
+uint64_t hash(uint64_t state, const char32_t *data, size_t length) {
+  for (const char32_t *end = data + length; data != end; ++data)
+    state = (state ^ static_cast<uint32_t>(*data)) * fnv_prime;
+  return state;
+}
+
+uint64_t hash(uint64_t state, const std::string &data) {
+  for (const char byte : data)
+    state = (state ^ static_cast<unsigned char>(byte)) * fnv_prime;
+  return state;
+}
+
+uint64_t finalise(uint64_t state) {
+  state = (state ^ (state >> 33)) * 0xff51afd7ed558ccdull;
+  state = (state ^ (state >> 33)) * 0xc4ceb9fe1a85ec53ull;
+  return state ^ (state >> 33);
+}
+}
+
+namespace swift {
+namespace parse {
+cache::cache(std::string directory, const compiler::target_options &options)
+    : directory_(std::move(directory)) {
+  // NOTE(compnerd) there is no compiler version to speak of yet; the build
+  // identifies the revision and the host compiler which built it.
+  salt_ = SWIFT_BUILD_ID;
+  salt_ = salt_ + '\0' + std::to_string(ast::format::version);
+  salt_ = salt_ + '\0' + options.triple;
+}
+
+std::string cache::path(const std::string &key) const {
+  return directory_ + '/' + key + ".ast";
+}
+
+cache::identity cache::identify(const swift::parser &parser,
+                                std::u32string_view source) const {
+  // the settings which change the tree which the parser builds
+  const std::string settings =
+      salt_ + '\0' + std::to_string(parser.script_mode()) + '\0' +
+      std::to_string(parser.delay_function_bodies()) + '\0' +
+      std::to_string(parser.maximum_nesting_depth());
+
+  identity identity;
+
+  char key[17];
+  std::snprintf(key, sizeof(key), "%016llx",
+                static_cast<unsigned long long>(finalise(
+                    hash(hash(fnv_offset_basis, settings), source.data(),
+                         source.size()))));
+  identity.key = key;
+
+  identity.length = source.size();
+
+  llvm::MD5 md5;
+  md5.update(settings);
+  md5.update(llvm::ArrayRef<uint8_t>(
+      reinterpret_cast<const uint8_t *>(source.data()),
+      source.size() * sizeof(char32_t)));
+  llvm::MD5::MD5Result digest;
+  md5.final(digest);
+  for (unsigned index = 0; index < sizeof(identity.digest); ++index)
+    identity.digest[index] = digest[index];
+
+  return identity;
+}
+
+std::unique_ptr<ast::reader> cache::lookup(ast::context &context,
+                                           const identity &identity,
+                                           swift::parser &parser) const {
+  const std::string path = this->path(identity.key);
+  std::unique_ptr<ast::reader> reader =
+      ast::reader::open(context, path, &parser);
+  if (not reader)
+    return nullptr;
+
+  // the key is only a 64-bit hash; reject an entry for a colliding source
+  if (reader->source_length() != identity.length or
+      not std::equal(std::begin(identity.digest), std::end(identity.digest),
+                     std::begin(reader->source_digest())))
+    return nullptr;
+
+  ::utime(path.c_str(), nullptr);  // keep the entry from being pruned
+  return reader;
+}
+
+bool cache::store(const identity &identity, const ast::writer &writer) const {
+  const std::string &key = identity.key;
+
+  if (::mkdir(directory_.c_str(), 0777) and errno != EEXIST)
+    return false;
+
+  // Write to a private temporary and publish it by renaming it into place;
+  // the rename is atomic so concurrent readers see either no entry or a
+  // complete one, and concurrent writers of the same key are interchangeable.
+  std::string temporary = path(key) + ".XXXXXX";
+  const int fd = ::mkstemp(&temporary[0]);
+  if (fd < 0)
+    return false;
+  ::close(fd);
+
+  std::ofstream os(temporary, std::ios::binary | std::ios::trunc);
+  writer.emit(os);
+  os.close();
+
+  if (not os or std::rename(temporary.c_str(), path(key).c_str())) {
+    ::unlink(temporary.c_str());
+    return false;
+  }
+  return true;
+}
+
+std::vector<ast::statement *> cache::parse(swift::parser &parser,
+                                           swift::lexer &lexer,
+                                           ast::context &context,
+                                           std::u32string_view source) const {
+  const identity identity = identify(parser, source);
+  std::vector<ast::statement *> statements;
+
+  // the buffer locates the loaded statements and their skipped bodies
+  lexer.set_buffer(source.data(), source.size());
+
+  if (std::unique_ptr<ast::reader> reader = lookup(context, identity, parser)) {
+    // the declarations are linked into the source file as they are read
+    ast::declaration_context *declarations =
+        context.source_file()->declaration_context();
+    ast::declaration *last = nullptr;
+    for (auto *declaration : *declarations)
+      last = declaration;
+
+    for (unsigned index = 0; index < reader->size(); ++index) {
+      ast::statement *statement = reader->statement(index);
+      if (not statement)
+        break;
+      statements.push_back(statement);
+    }
+    if (statements.size() == reader->size()) {
+      for (auto *statement : statements)
+        parser.replay(statement);
+      return statements;
+    }
+
+    // the entry is damaged; forget what was read of it and fall back to
+    // parsing, which will replace it
+    std::vector<ast::declaration *> read;
+    std::copy(last ? ++ast::declaration_context::iterator(last)
+                   : declarations->begin(),
+              declarations->end(), std::back_inserter(read));
+    for (auto *declaration : read)
+      parser.forget(declaration);
+    statements.clear();
+  }
+
+  ast::writer writer;
+  writer.set_source(identity.length, identity.digest);
+  bool cacheable = true;
+  const unsigned errors = context.diagnostics_engine().error_count();
+
+  for (;;) {
+    parse::result<ast::statement> statement =
+        parser.parse_top_level_declaration();
+    if (not statement) {
+      // only cache sources which parsed cleanly to the end of the input
+      cacheable = cacheable and lexer.head().is<token::type::eof>() and
+                  context.diagnostics_engine().error_count() == errors;
+      break;
+    }
+
+    // NOTE(compnerd) top-level code is analysed as it is parsed, statement by
+    // statement, which cannot be replayed; scripts are not cached.
+    statements.push_back(*statement);
+    cacheable = cacheable and
+                (*statement)->kind() != ast::node_kind::top_level_declaration and
+                writer.add(*statement);
+  }
+
+  if (cacheable)
+    store(identity, writer);
+  return statements;
+}
+
+void cache::prune(uint64_t maximum_size,
+                  std::chrono::seconds maximum_age) const {
+  struct entry {
+    std::string path;
+    uint64_t size;
+    time_t modified;
+  };
+  std::vector<entry> entries;
+
+  DIR *directory = ::opendir(directory_.c_str());
+  if (not directory)
+    return;
+
+  while (const struct dirent *dirent = ::readdir(directory)) {
+    // entries as well as the temporaries of interrupted writers
+    if (not std::strstr(dirent->d_name, ".ast"))
+      continue;
+
+    struct stat status;
+    std::string path = directory_ + '/' + dirent->d_name;
+    if (::stat(path.c_str(), &status) or not S_ISREG(status.st_mode))
+      continue;
+
+    entries.push_back({ std::move(path), static_cast<uint64_t>(status.st_size),
+                        status.st_mtime });
+  }
+  ::closedir(directory);
+
+  std::sort(entries.begin(), entries.end(),
+            [](const entry &lhs, const entry &rhs) {
+              return lhs.modified > rhs.modified;
+            });
+
+  // NOTE(compnerd) unlinking an entry which another job has mapped is safe;
+  // the mapping remains valid until it is released.
+  const time_t now = std::time(nullptr);
+  uint64_t size = 0;
+  for (const auto &entry : entries) {
+    if (now - entry.modified > maximum_age.count() or
+        size + entry.size > maximum_size)
+      ::unlink(entry.path.c_str());
+    else
+      size = size + entry.size;
+  }
+}
+}
+}
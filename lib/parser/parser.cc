@@ -27,17 +27,27 @@
  * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **/
 
+#include "swift/diagnostics/consumer.hh"
 #include "swift/lexer/lexer.hh"
 #include "swift/parser/parser.hh"
 #include "swift/semantic/import_kind.hh"
 #include "swift/support/error-handling.hh"
 #include "swift/support/tribool.hh"
 #include "swift/syntax/statements.hh"
+#include "swift/syntax/class-declaration.hh"
+#include "swift/syntax/context.hh"
+#include "swift/syntax/declaration-context.hh"
 #include "swift/syntax/declaration.hh"
+#include "swift/syntax/enum-declaration.hh"
 #include "swift/syntax/expression.hh"
+#include "swift/syntax/extension-declaration.hh"
 #include "swift/syntax/literal-expression.hh"
 #include "swift/syntax/pattern.hh"
 #include "swift/syntax/pattern-tuple.hh"
+#include "swift/syntax/protocol-declaration.hh"
+#include "swift/syntax/struct-declaration.hh"
+
+#include <limits>
 
 using namespace swift::diagnostics;
 
@@ -54,7 +64,66 @@ static constexpr bool underscore(const swift::token &token) {
   return token.is<swift::token::type::identifier>() and token.value() == U"_";
 }
 
+// NOTE(compnerd) top-level code is grouped up to the next token which begins a
+// declaration; a declaration which begins otherwise is grouped with the code.
+static bool begins_declaration(const swift::token &token) {
+  switch (token) {
+  default:
+    return false;
+  case swift::token::type::at:
+  case swift::token::type::kw_import:
+  case swift::token::type::kw_let:
+  case swift::token::type::kw_var:
+  case swift::token::type::kw_typealias:
+  case swift::token::type::kw_func:
+  case swift::token::type::kw_enum:
+  case swift::token::type::kw_struct:
+  case swift::token::type::kw_class:
+  case swift::token::type::kw_protocol:
+  case swift::token::type::kw_init:
+  case swift::token::type::kw_deinit:
+  case swift::token::type::kw_extension:
+  case swift::token::type::kw_subscript:
+  case swift::token::type::kw_prefix:
+  case swift::token::type::kw_postfix:
+  case swift::token::type::kw_infix:
+    return true;
+  }
+}
+
+// NOTE(compnerd) a generic argument clause in an expression is only accepted if
+// it is followed by a token which cannot continue a comparison; `a < b > (c)`
+// is therefore parsed as a generic reference applied to `(c)`.
+static bool follows_generic_argument_clause(const swift::token &token) {
+  switch (token) {
+  default:
+    return false;
+  case swift::token::type::l_paren:
+  case swift::token::type::r_paren:
+  case swift::token::type::r_square:
+  case swift::token::type::r_brace:
+  case swift::token::type::colon:
+  case swift::token::type::semi:
+  case swift::token::type::comma:
+  case swift::token::type::period:
+  case swift::token::type::question:
+  case swift::token::type::eof:
+    return true;
+  case swift::token::type::op:
+    return token.value() == U"==" or token.value() == U"!=";
+  }
+}
+
 namespace swift {
+parser::parser(lexer &lexer, semantic::analyzer &semantic_analyzer,
+               diagnostics::engine &engine)
+    : lexer_(lexer), semantic_analyzer_(semantic_analyzer),
+      diagnostics_engine_(engine) {
+  // NOTE(compnerd) the identifiers are interned in the table in which the
+  // analyzer binds them, so that a reference resolves without hashing its name
+  lexer_.intern(semantic_analyzer_.ast_context().identifiers());
+}
+
 void parser::consume_until(token::type type) {
   while (not (lexer_.head() == type or lexer_.head().is<token::type::eof>()))
     lexer_.next();
@@ -67,30 +136,291 @@ void parser::consume_until(const set<Types...> &types) {
     lexer_.next();
 }
 
+class parser::nesting {
+  parser &parser_;
+
+public:
+  explicit nesting(parser &parser) : parser_(parser) {
+    parser_.end_unwinding();
+    ++parser_.depth_;
+  }
+
+  ~nesting() {
+    if (--parser_.depth_ == 0 and parser_.unwinding_) {
+      parser_.unwinding_ = false;
+      parser_.diagnostics_engine_.suppress(false);
+    }
+    parser_.end_unwinding();
+  }
+
+  nesting(const nesting &) = delete;
+  nesting &operator=(const nesting &) = delete;
+};
+
+/// Diagnoses nesting beyond the maximum depth and skips (without recursing) to
+/// the end of the innermost enclosing group.  The diagnostics of the enclosing
+/// productions, which fail in turn, are suppressed until the parser moves past
+/// the delimiter closing that group (or the outermost production completes, if
+/// the group is not closed) so that the nesting is reported once.
+bool parser::exceeds_maximum_depth() {
+  if (depth_ <= maximum_depth_)
+    return false;
+
+  diagnose(lexer_.head().location().start(),
+           diagnostic::err_nesting_exceeds_maximum_depth_of)
+      << maximum_depth_;
+  if (not diagnostics_engine_.suppressed()) {
+    diagnostics_engine_.suppress(true);
+    unwinding_ = true;
+  }
+
+  unsigned depth = 0;
+  for (;;) {
+    switch (lexer_.head()) {
+    default:
+      break;
+    case token::type::eof:
+      if (unwinding_)
+        unwinding_until_ = std::numeric_limits<uint32_t>::max();
+      return true;
+    case token::type::l_brace:
+    case token::type::l_paren:
+    case token::type::l_square:
+      ++depth;
+      break;
+    case token::type::r_brace:
+    case token::type::r_paren:
+    case token::type::r_square:
+      if (depth == 0) {
+        if (unwinding_)
+          unwinding_until_ = lexer_.head().location().start().offset();
+        return true;
+      }
+      --depth;
+      break;
+    }
+    lexer_.next();
+  }
+}
+
+/// Stops suppressing the diagnostics of the productions unwinding from nesting
+/// beyond the maximum depth once the delimiter at which the skip stopped has
+/// been consumed; the productions which fail as a result have done so by then.
+void parser::end_unwinding() {
+  if (not unwinding_ or
+      lexer_.previous_end().offset() <= unwinding_until_)
+    return;
+  unwinding_ = false;
+  diagnostics_engine_.suppress(false);
+}
+
+template <typename Production>
+auto parser::tentatively(Production &&production) -> decltype(production()) {
+  buffering_consumer buffer;
+  diagnostics::consumer *consumer = diagnostics_engine_.consumer();
+  diagnostics_engine_.consumer(&buffer);
+  const bool unwinding = unwinding_;
+
+  const lexer::checkpoint checkpoint = lexer_.mark();
+  auto result = production();
+
+  diagnostics_engine_.consumer(consumer);
+
+  if (result and buffer.error_count() == 0) {
+    lexer_.release(checkpoint);
+    buffer.replay(diagnostics_engine_);
+    return result;
+  }
+
+  lexer_.rewind(checkpoint);
+  buffer.discard(diagnostics_engine_);
+  // the nesting will be diagnosed again when the tokens are parsed again
+  if (unwinding_ and not unwinding) {
+    unwinding_ = false;
+    diagnostics_engine_.suppress(false);
+  }
+  return decltype(production())();
+}
+
+/// Skips tokens until a point at which parsing can resume after an error: the
+/// start of a declaration or statement, the end of the enclosing block, or a
+/// statement separator.  Bracketed groups are skipped as a whole.
+void parser::synchronise() {
+  unsigned depth = 0;
+  for (;;) {
+    const token head = lexer_.head();
+
+    if (depth == 0 and
+        head.location().start().line() > lexer_.previous_end().line())
+      return;
+
+    switch (head) {
+    default:
+      break;
+    case token::type::eof:
+      return;
+    case token::type::l_brace:
+    case token::type::l_paren:
+    case token::type::l_square:
+      ++depth;
+      break;
+    case token::type::r_paren:
+    case token::type::r_square:
+      if (depth)
+        --depth;
+      break;
+    case token::type::r_brace:
+      if (depth == 0)
+        return;
+      --depth;
+      break;
+    case token::type::semi:
+      if (depth)
+        break;
+      lexer_.next();
+      return;
+    case token::type::at:
+    case token::type::kw_import:
+    case token::type::kw_let:
+    case token::type::kw_var:
+    case token::type::kw_typealias:
+    case token::type::kw_func:
+    case token::type::kw_enum:
+    case token::type::kw_struct:
+    case token::type::kw_class:
+    case token::type::kw_protocol:
+    case token::type::kw_init:
+    case token::type::kw_deinit:
+    case token::type::kw_extension:
+    case token::type::kw_subscript:
+    case token::type::kw_prefix:
+    case token::type::kw_postfix:
+    case token::type::kw_infix:
+    case token::type::kw_for:
+    case token::type::kw_while:
+    case token::type::kw_repeat:
+    case token::type::kw_if:
+    case token::type::kw_switch:
+    case token::type::kw_break:
+    case token::type::kw_continue:
+    case token::type::kw_fallthrough:
+    case token::type::kw_return:
+    case token::type::kw_case:
+    case token::type::kw_default:
+    case token::type::kw_defer:
+    case token::type::kw_do:
+    case token::type::kw_guard:
+    case token::type::pp_if:
+    case token::type::pp_elseif:
+    case token::type::pp_else:
+    case token::type::pp_endif:
+    case token::type::pp_line:
+      if (depth == 0)
+        return;
+      break;
+    }
+
+    lexer_.next();
+  }
+}
+
+/// Resumes parsing after a construct starting at `start` failed to parse.  At
+/// least one token is consumed so that the caller is guaranteed to progress.
+void parser::recover(location start) {
+  if (lexer_.head().location().start().offset() == start.offset())
+    lexer_.next();
+  synchronise();
+}
+
+/// Records the extent of `node` from `start` to the end of the last consumed
+/// token, unless a more precise extent was already recorded.
+template <typename Node>
+parse::result<Node> &parser::locate(parse::result<Node> &node, location start) {
+  if (node and not node->has_source_range())
+    node->set_source_range(start.offset(), lexer_.previous_end().offset());
+  return node;
+}
+
 // top-level-declaration → statements[opt]
+//
+// Declarations are returned individually.  Each run of top-level code between
+// them is returned as a single top-level declaration in script mode, and
+// rejected otherwise.
 parse::result<ast::statement> parser::parse_top_level_declaration() {
-  if (lexer_.head() == token::type::eof)
-    return parse::result<ast::statement>();
+  PROFILE_PRODUCTION();
+  parse::result<ast::statement> statement;
+  std::vector<ast::statement *> code;
+  location code_start;
+
+  // NOTE(compnerd) an invalid result is only returned at the end of the input;
+  // anything which fails to parse is diagnosed and skipped
+  while (not lexer_.head().is<token::type::eof>()) {
+    if (not code.empty() and begins_declaration(lexer_.head())) {
+      statement = semantic_analyzer_.top_level_declaration(
+          range(code_start, lexer_.previous_end()), code);
+      if (locate(statement, code_start))
+        return statement;
+      code.clear();
+    }
+
+    location start = lexer_.head().location().start();
+    const unsigned errors = diagnostics_engine_.error_count();
+
+    if (lexer_.head().is<token::type::r_brace>()) {
+      diagnose(lexer_.head().location(),
+               diagnostic::err_extraneous_token_at_top_level)
+          << lexer_.head();
+      lexer_.next();
+      continue;
+    }
+
+    if ((statement = parse_statement())) {
+      if (code.empty() and
+          ast::isa<ast::statement::type::declaration>(statement))
+        return statement;
+      if (code.empty())
+        code_start = start;
+      code.push_back(*statement);
+      continue;
+    }
 
-  parse::result<ast::statement> statement = parse_statement();
-  if (ast::isa<ast::statement::type::expression>(statement)) {
-    std::vector<ast::statement *> statements{ *statement };
-    statement = semantic_analyzer_.statements(statements);
+    if (diagnostics_engine_.error_count() == errors)
+      diagnose(start, diagnostic::err_expected_expression);
+    recover(start);
   }
-  return statement;
+
+  statement = parse::result<ast::statement>();
+  if (not code.empty())
+    statement = semantic_analyzer_.top_level_declaration(
+        range(code_start, lexer_.previous_end()), code);
+  return locate(statement, code_start);
 }
 
 // statements → statement statements[opt]
 parse::result<ast::statement> parser::parse_statements() {
+  PROFILE_PRODUCTION();
   parse::result<ast::statement> statements;
   std::vector<ast::statement *> parsed_statements;
 
-  for (bool parsed = false; ; parsed = true)
-    if (auto statement = parse_statement())
+  for (;;) {
+    location start = lexer_.head().location().start();
+    const unsigned errors = diagnostics_engine_.error_count();
+
+    if (auto statement = parse_statement()) {
       parsed_statements.push_back(*statement);
-    else
+      continue;
+    }
+
+    if (set<token::type::r_brace, token::type::eof, token::type::kw_case,
+            token::type::kw_default, token::type::pp_elseif,
+            token::type::pp_else, token::type::pp_endif>::contains(lexer_.head()))
       break;
 
+    if (diagnostics_engine_.error_count() == errors)
+      diagnose(start, diagnostic::err_expected_expression);
+    recover(start);
+  }
+
   if (parsed_statements.size() == 1 and
       not semantic_analyzer_.current_scope()
               .is<semantic::scope::type::switch_statement>())
@@ -109,7 +439,13 @@ parse::result<ast::statement> parser::parse_statements() {
 // statement → do-statement ';'[opt]
 // statement → compiler-control-statement
 parse::result<ast::statement> parser::parse_statement() {
+  PROFILE_PRODUCTION();
+  const nesting level(*this);
+  if (exceeds_maximum_depth())
+    return parse::result<ast::statement>();
+
   parse::result<ast::statement> statement;
+  location start = lexer_.head().location().start();
 
   switch (lexer_.head()) {
   case token::type::identifier:
@@ -120,8 +456,12 @@ parse::result<ast::statement> parser::parse_statement() {
     }
     [[clang::fallthrough]];
   default:
-    if ((statement = parse_expression()))
+    if ((statement = parse_expression())) {
+      semantic_analyzer_.check_expression(
+          static_cast<ast::expression *>(*statement),
+          range(start, lexer_.previous_end()));
       break;
+    }
 
     switch (lexer_.head()) {
     default:
@@ -174,9 +514,11 @@ parse::result<ast::statement> parser::parse_statement() {
     return statement;
   case token::type::pp_if:
   case token::type::pp_line:
-    return parse_compiler_control_statement();
+    statement = parse_compiler_control_statement();
+    return locate(statement, start);
   }
 
+  locate(statement, start);
   if (lexer_.head().is<token::type::semi>())
     lexer_.next();
   return statement;
@@ -184,32 +526,32 @@ parse::result<ast::statement> parser::parse_statement() {
 
 // expression → try-operator[opt] prefix-expression binary-expressions[opt]
 parse::result<ast::expression> parser::parse_expression() {
-  bool push_scope =
-      semantic_analyzer_.current_scope().is<semantic::scope::type::top_level>();
-
-  semantic::scope_raii scope(semantic_analyzer_.current_scope(),
-                             semantic::scope::type::expression);
-  if (not push_scope)
-    scope.reset();
+  PROFILE_PRODUCTION();
+  const nesting level(*this);
+  if (exceeds_maximum_depth())
+    return parse::result<ast::expression>();
 
   parse::result<ast::expression> expression;
+  location start = lexer_.head().location().start();
   if (not (expression = parse_prefix_expression()))
     return expression;
 
   if (auto binary_expressions = parse_binary_expressions(expression))
     expression = binary_expressions;
 
-  return expression;
+  return locate(expression, start);
 }
 
 // prefix-expression → prefix-operator[opt] postfix-expression
 // prefix-expression → in-out-expression
 parse::result<ast::expression> parser::parse_prefix_expression() {
+  PROFILE_PRODUCTION();
   if (lexer_.head().is<token::type::amp>())
     return parse_in_out_expression();
 
   parse::result<ast::expression> prefix_operator;
   parse::result<ast::expression> postfix_expression;
+  location start = lexer_.head().location().start();
 
   if (lexer_.head().is<token::operator_type::unary_prefix>())
     if (not (prefix_operator = parse_prefix_operator()))
@@ -220,11 +562,12 @@ parse::result<ast::expression> parser::parse_prefix_expression() {
     postfix_expression =
         semantic_analyzer_.prefix_unary_expression(prefix_operator,
                                                    postfix_expression);
-  return postfix_expression;
+  return locate(postfix_expression, start);
 }
 
 // in-out-expression → '&' identifier
 parse::result<ast::expression> parser::parse_in_out_expression() {
+  PROFILE_PRODUCTION();
   assert(lexer_.head().is<token::type::amp>() && "expected '&'");
 
   parse::result<ast::expression> in_out_expression;
@@ -243,6 +586,7 @@ parse::result<ast::expression> parser::parse_in_out_expression() {
 
 // prefix-operator → operator
 parse::result<ast::expression> parser::parse_prefix_operator() {
+  PROFILE_PRODUCTION();
   parse::result<ast::expression> prefix_operator;
 
   if (not lexer_.head().is<token::operator_type::unary_prefix>())
@@ -250,14 +594,18 @@ parse::result<ast::expression> parser::parse_prefix_operator() {
 
   token op = lexer_.next();
   return (prefix_operator =
-              semantic_analyzer_.declaration_reference_expression(op.value()));
+              semantic_analyzer_.declaration_reference_expression(op));
 }
 
 // operator → operator-head operator-characters[opt]
 // operator → dot-operator-head dot-operator-characters[opt]
 parse::result<ast::expression> parser::parse_operator() {
+  PROFILE_PRODUCTION();
   assert(lexer_.head().is<token::type::op>() && "expected operator");
-  __builtin_trap();
+
+  parse::result<ast::expression> op;
+  token name = lexer_.next();
+  return (op = semantic_analyzer_.declaration_reference_expression(name));
 }
 
 // postfix-expression → primary-expression
@@ -271,11 +619,15 @@ parse::result<ast::expression> parser::parse_operator() {
 // postfix-expression → forced-value-expression
 // postfix-expression → optional-chaining-expression
 parse::result<ast::expression> parser::parse_postfix_expression() {
+  PROFILE_PRODUCTION();
   parse::result<ast::expression> postfix_expression;
+  location start = lexer_.head().location().start();
 
   postfix_expression = parse_primary_expression();
 
   while (true) {
+    locate(postfix_expression, start);
+
     switch (lexer_.head()) {
     default:
       if (lexer_.head().is<token::type::op>() and
@@ -288,7 +640,7 @@ parse::result<ast::expression> parser::parse_postfix_expression() {
                                                         postfix_operator);
       }
 
-      return postfix_expression;
+      return locate(postfix_expression, start);
 
     case token::type::l_paren:
       postfix_expression = parse_function_call_expression(postfix_expression);
@@ -354,6 +706,7 @@ parse::result<ast::expression> parser::parse_postfix_expression() {
 
 parse::result<ast::expression>
 parser::parse_initializer_expression(ast::expression *expression) {
+  PROFILE_PRODUCTION();
   assert(lexer_.head().is<token::type::kw_init>() && "expected 'init'");
 
   parse::result<ast::expression> initializer_expression;
@@ -372,6 +725,7 @@ parser::parse_initializer_expression(ast::expression *expression) {
 
 parse::result<ast::expression>
 parser::parse_explicit_member_expression(ast::expression *expression) {
+  PROFILE_PRODUCTION();
   assert((lexer_.head().is<token::type::identifier>() or
           lexer_.head().is<token::type::literal>()) &&
          "expected identifier or literal");
@@ -382,13 +736,17 @@ parser::parse_explicit_member_expression(ast::expression *expression) {
                                                     lexer_.next().value());
 
   if (less(lexer_.head()))
-    parse_generic_argument_clause();
+    tentatively([this]() -> bool {
+      return parse_generic_argument_clause() and
+             follows_generic_argument_clause(lexer_.head());
+    });
 
   return explicit_member_expression;
 }
 
 parse::result<ast::expression>
 parser::parse_postfix_self_expression(ast::expression *expression) {
+  PROFILE_PRODUCTION();
   assert(lexer_.head().is<token::type::kw_self>() && "expected 'self'");
   lexer_.next();
   return parse::result<ast::expression>(
@@ -397,6 +755,7 @@ parser::parse_postfix_self_expression(ast::expression *expression) {
 
 parse::result<ast::expression>
 parser::parse_dynamic_type_expression(ast::expression *expression) {
+  PROFILE_PRODUCTION();
   assert(lexer_.head().is<token::type::kw_dynamicType>() &&
          "expected 'dynamicType'");
   lexer_.next();
@@ -406,6 +765,7 @@ parser::parse_dynamic_type_expression(ast::expression *expression) {
 
 parse::result<ast::expression>
 parser::parse_forced_value_expression(ast::expression *expression) {
+  PROFILE_PRODUCTION();
   assert((lexer_.head().is<token::type::exclaim>() and
           lexer_.head().is<token::operator_type::unary_postfix>()) &&
          "expected unary postfix '!'");
@@ -416,31 +776,33 @@ parser::parse_forced_value_expression(ast::expression *expression) {
 
 parse::result<ast::expression>
 parser::parse_optional_chaining_expression(ast::expression *) {
+  PROFILE_PRODUCTION();
   assert((lexer_.head().is<token::type::question>() and
           lexer_.head().is<token::operator_type::unary_postfix>()) &&
          "expected postfix unary '?'");
-  __builtin_trap();
+  lexer_.next();
+  // TODO(compnerd) retain the chained expression
+  return parse::result<ast::expression>(
+      semantic_analyzer_.optional_chaining_expression());
 }
 
 // function-call-expression → postfix-expression parenthesized-expression
 // function-call-expression → postfix-expression parenthesized-expression[opt] trailing-closure
 parse::result<ast::expression>
 parser::parse_function_call_expression(ast::expression *function) {
+  PROFILE_PRODUCTION();
   assert((lexer_.head().is<token::type::l_paren>() or
           lexer_.head().is<token::type::l_brace>()) &&
          "expected postfix-expression to be parsed");
 
   parse::result<ast::expression> function_call;
 
-  bool push_scope =
-      semantic_analyzer_.current_scope().is<semantic::scope::type::top_level>();
-  semantic::scope_raii scope(semantic_analyzer_.current_scope(),
-                             semantic::scope::type::statement);
-  if (not push_scope)
-    scope.reset();
-
-  if (lexer_.head().is<token::type::l_brace>())
-    __builtin_trap(); // return parse_trailing_closure();
+  if (lexer_.head().is<token::type::l_brace>()) {
+    parse::result<ast::expression> closure = parse_trailing_closure();
+    if (not closure)
+      return function_call;
+    return (function_call = semantic_analyzer_.function_call(function, closure));
+  }
 
   parse::result<ast::expression> arguments = parse_parenthesized_expression();
   if (not arguments)
@@ -475,8 +837,38 @@ parser::parse_function_call_expression(ast::expression *function) {
 //
 // same-type-requirement → type-identifier '==' type-identifier
 bool parser::parse_generic_parameter_clause() {
+  PROFILE_PRODUCTION();
   assert(less(lexer_.head()) && "expected '<'");
-  __builtin_trap();
+
+  token less = lexer_.head();
+  diagnose(less.location(), diagnostic::err_unsupported_feature)
+      << "generic parameter clause";
+
+  // NOTE(compnerd) skip the clause, accounting for the lexer combining adjacent
+  // angle brackets into a single operator (e.g. '>>')
+  size_t depth = 0;
+  do {
+    const token head = lexer_.head();
+    if (head.is<token::type::op>()) {
+      const std::u32string_view spelling = head.value();
+      if (spelling.find_first_not_of(U'<') == std::u32string_view::npos)
+        depth = depth + spelling.length();
+      else if (spelling.find_first_not_of(U'>') == std::u32string_view::npos)
+        depth = depth > spelling.length() ? depth - spelling.length() : 0;
+    } else if (set<token::type::l_brace, token::type::l_paren,
+                   token::type::eof>::contains(head)) {
+      diagnose(head.location().start(), diagnostic::err_expected_token_to_syntax)
+          << token(token::type::op, U">", location(), location())
+          << "complete generic parameter clause";
+      diagnose(less.location().start(),
+               diagnostic::note_to_match_this_opening_token)
+          << less;
+      return false;
+    }
+    lexer_.next();
+  } while (depth);
+
+  return true;
 }
 
 // generic-argument-clause → '<' generic-argument-list '>'
@@ -484,6 +876,7 @@ bool parser::parse_generic_parameter_clause() {
 // generic-argument-list → generic-argument ',' generic-argument-list
 // generic-argument → type
 parse::result<ast::type> parser::parse_generic_argument_clause() {
+  PROFILE_PRODUCTION();
   assert(less(lexer_.head()) && "expected '<'");
 
   parse::result<ast::type> type;
@@ -520,11 +913,45 @@ parse::result<ast::type> parser::parse_generic_argument_clause() {
 // subscript-expression → postfix-expression '[' expression-list ']'
 parse::result<ast::expression>
 parser::parse_subscript_expression(ast::expression *) {
-  __builtin_trap();
+  PROFILE_PRODUCTION();
+  assert(lexer_.head().is<token::type::l_square>() && "expected '['");
+
+  parse::result<ast::expression> subscript_expression;
+
+  token l_square = lexer_.next();
+  while (not lexer_.head().is<token::type::r_square>()) {
+    location expression_location = lexer_.head().location().start();
+    if (not parse_expression()) {
+      diagnose(expression_location, diagnostic::err_expected_expression_in)
+          << "subscript";
+      consume_until(set<token::type::r_square, token::type::r_brace>());
+      break;
+    }
+
+    if (not lexer_.head().is<token::type::comma>())
+      break;
+    lexer_.next();
+  }
+
+  if (not lexer_.head().is<token::type::r_square>()) {
+    diagnose(lexer_.head().location().start(),
+             diagnostic::err_expected_token_to_syntax)
+        << token(token::type::r_square, U"]", location(), location())
+        << "complete subscript expression";
+    diagnose(l_square.location().start(),
+             diagnostic::note_to_match_this_opening_token)
+        << l_square;
+    return subscript_expression;
+  }
+  lexer_.next();
+
+  // TODO(compnerd) retain the base and index expressions
+  return (subscript_expression = semantic_analyzer_.subscript_expression());
 }
 
 // trailing-closure → closure-expression
 parse::result<ast::expression> parser::parse_trailing_closure() {
+  PROFILE_PRODUCTION();
   assert(lexer_.head().is<token::type::l_brace>() && "expected '{'");
 
   assert(not semantic_analyzer_.current_scope()
@@ -543,7 +970,9 @@ parse::result<ast::expression> parser::parse_trailing_closure() {
 // primary-expression → implicit-member-expression
 // primary-expression → wildcard-expression
 parse::result<ast::expression> parser::parse_primary_expression() {
+  PROFILE_PRODUCTION();
   parse::result<ast::expression> primary_expression;
+  location start = lexer_.head().location().start();
 
   switch (lexer_.head()) {
   default: break;
@@ -552,10 +981,13 @@ parse::result<ast::expression> parser::parse_primary_expression() {
     token identifier = lexer_.next();
 
     if (less(lexer_.head()))
-      parse_generic_argument_clause();
+      tentatively([this]() -> bool {
+        return parse_generic_argument_clause() and
+               follows_generic_argument_clause(lexer_.head());
+      });
 
     primary_expression =
-        semantic_analyzer_.declaration_reference_expression(identifier.value());
+        semantic_analyzer_.declaration_reference_expression(identifier);
     break;
   }
   case token::type::literal:
@@ -564,26 +996,34 @@ parse::result<ast::expression> parser::parse_primary_expression() {
   case token::type::kw___LINE__:
   case token::type::kw___COLUMN__:
   case token::type::kw___FUNCTION__:
-    return parse_literal_expression();
+    primary_expression = parse_literal_expression();
+    break;
   case token::type::kw_self:
-    return parse_self_expression();
+    primary_expression = parse_self_expression();
+    break;
   case token::type::kw_super:
-    return parse_superclass_expression();
+    primary_expression = parse_superclass_expression();
+    break;
   case token::type::l_brace:
-    return parse_closure_expression();
+    primary_expression = parse_closure_expression();
+    break;
   case token::type::l_paren:
-    return parse_parenthesized_expression();
+    primary_expression = parse_parenthesized_expression();
+    break;
   case token::type::period:
-    return parse_implicit_member_expression();
+    primary_expression = parse_implicit_member_expression();
+    break;
   case token::type::underscore:
-    return parse_wildcard_expression();
+    primary_expression = parse_wildcard_expression();
+    break;
   }
 
-  return primary_expression;
+  return locate(primary_expression, start);
 }
 
 // postfix-operator → operator
 parse::result<ast::expression> parser::parse_postfix_operator() {
+  PROFILE_PRODUCTION();
   parse::result<ast::expression> postfix_operator;
 
   if (not lexer_.head().is<token::operator_type::unary_postfix>())
@@ -591,7 +1031,7 @@ parse::result<ast::expression> parser::parse_postfix_operator() {
 
   token op = lexer_.next();
   return (postfix_operator =
-              semantic_analyzer_.declaration_reference_expression(op.value()));
+              semantic_analyzer_.declaration_reference_expression(op));
 }
 
 // literal-expression → literal
@@ -614,6 +1054,7 @@ parse::result<ast::expression> parser::parse_postfix_operator() {
 // dictionary-literal-items → dictionary-literal-item ',' dictionary-literal-items
 // dictionary-literal-item → expression ':' expression
 parse::result<ast::expression> parser::parse_literal_expression() {
+  PROFILE_PRODUCTION();
   assert((lexer_.head().is<token::type::literal>() or
           lexer_.head().is<token::type::l_square>() or
           lexer_.head().is<token::type::kw___COLUMN__>() or
@@ -736,13 +1177,14 @@ parse::result<ast::expression> parser::parse_literal_expression() {
 // self-expression → 'self' '[' expression ']'
 // self-expression → 'self' '.' 'init'
 parse::result<ast::expression> parser::parse_self_expression() {
+  PROFILE_PRODUCTION();
   assert(lexer_.head().is<token::type::kw_self>() && "expected 'self'");
 
   parse::result<ast::expression> self_expression;
 
   token self = lexer_.next();
   self_expression =
-      semantic_analyzer_.declaration_reference_expression(self.value());
+      semantic_analyzer_.declaration_reference_expression(self);
 
   switch (lexer_.head()) {
   default: break;
@@ -764,7 +1206,8 @@ parse::result<ast::expression> parser::parse_self_expression() {
     break;
   }
   case token::type::l_square:
-    __builtin_trap();
+    self_expression = parse_subscript_expression(self_expression);
+    break;
   }
 
   return self_expression;
@@ -778,6 +1221,7 @@ parse::result<ast::expression> parser::parse_self_expression() {
 // superclass-subscript-expression → 'super' '[' expression ']'
 // superclass-initializer-expression → 'super' '.' 'init'
 parse::result<ast::expression> parser::parse_superclass_expression() {
+  PROFILE_PRODUCTION();
   assert(lexer_.head().is<token::type::kw_super>() && "expected 'super'");
 
   parse::result<ast::expression> superclass_expression;
@@ -810,7 +1254,8 @@ parse::result<ast::expression> parser::parse_superclass_expression() {
     break;
   }
   case token::type::l_square:
-    __builtin_trap();
+    superclass_expression = parse_subscript_expression(superclass_expression);
+    break;
   }
 
   return superclass_expression;
@@ -834,6 +1279,7 @@ parse::result<ast::expression> parser::parse_superclass_expression() {
 // identifier-list → identifier
 // identifier-list → identifier ',' identifier-list
 parse::result<ast::expression> parser::parse_closure_expression() {
+  PROFILE_PRODUCTION();
   assert(lexer_.head().is<token::type::l_brace>() && "expected '{'");
 
   parse::result<ast::expression> closure;
@@ -841,21 +1287,57 @@ parse::result<ast::expression> parser::parse_closure_expression() {
 
   token l_brace = lexer_.next();
 
-  switch (lexer_.head()) {
-  default: break;
-  case token::type::l_paren:
-    parse_parameter_clause();
-    __builtin_trap();
-    break;
-  case token::type::l_square:
-    __builtin_trap();
-    break;
-  case token::type::identifier:
-    __builtin_trap();
+  semantic::scope_raii scope(semantic_analyzer_.current_scope(),
+                             semantic::scope::type::function);
+  semantic::analyzer::lexical_scope_raii lexical_scope(semantic_analyzer_);
+
+  auto is_identifier_list = [](swift::lexer &lexer) -> bool {
+    return lexer.head().is<token::type::identifier>() and
+           set<token::type::comma, token::type::kw_in,
+               token::type::arrow>::contains(lexer.peek());
+  };
+
+  // TODO(compnerd) the capture list and result type are not yet retained
+  parse::result<ast::pattern> parameters;
+  bool signature = false;
+  if (lexer_.head().is<token::type::l_square>() and
+      set<token::type::kw_weak, token::type::kw_unowned>::contains(lexer_.peek())) {
+    diagnose(lexer_.head().location(), diagnostic::warn_unsupported_feature)
+        << "closure capture list";
+    consume_until(set<token::type::r_square, token::type::r_brace>());
+    if (lexer_.head().is<token::type::r_square>())
+      lexer_.next();
+    signature = true;
+  }
+
+  // NOTE(compnerd) a parenthesised signature cannot be distinguished from a
+  // parenthesised expression beginning the closure body until the 'in'.
+  if (lexer_.head().is<token::type::l_paren>() or is_identifier_list(lexer_))
+    if ((parameters = tentatively([this]() { return parse_closure_signature(); })))
+      signature = false;
+
+  // the parameters are bound only once the signature is known to be one, as
+  // a tentative parse is not undone in the lexical scope
+  if (parameters)
+    semantic_analyzer_.bind_parameters(*parameters);
+
+  if (signature) {
+    if (lexer_.head().is<token::type::arrow>())
+      parse_function_result();
+
+    if (not lexer_.head().is<token::type::kw_in>()) {
+      diagnose(lexer_.head().location().start(),
+               diagnostic::err_expected_token_in)
+          << token(token::type::kw_in, U"in", location(), location())
+          << "closure signature";
+      consume_until(set<token::type::kw_in, token::type::r_brace>());
+    }
+    if (lexer_.head().is<token::type::kw_in>())
+      lexer_.next();
   }
 
   if (not (statements = parse_statements()))
-    __builtin_trap();
+    return closure;
 
   if (not lexer_.head().is<token::type::r_brace>()) {
     diagnose(lexer_.head().location().start(), diagnostic::err_expected_token_at)
@@ -868,7 +1350,47 @@ parse::result<ast::expression> parser::parse_closure_expression() {
   }
   lexer_.next();
 
-  return (closure = semantic_analyzer_.closure_expression(*statements));
+  return (closure = semantic_analyzer_.closure_expression(
+              parameters ? *parameters : nullptr, *statements));
+}
+
+// closure-signature → parameter-clause function-result[opt] 'in'
+// closure-signature → identifier-list function-result[opt] 'in'
+//
+// The parameters are returned as a parameter clause; an identifier list forms
+// a clause of untyped parameters.
+parse::result<ast::pattern> parser::parse_closure_signature() {
+  PROFILE_PRODUCTION();
+  parse::result<ast::pattern> parameters;
+
+  if (lexer_.head().is<token::type::l_paren>()) {
+    if (lexer_.peek().is<token::type::r_paren>()) {
+      lexer_.next();
+      lexer_.next();
+      parameters = semantic_analyzer_.pattern_tuple({});
+    } else if (not (parameters = parse_parameter_clause())) {
+      return parse::result<ast::pattern>();
+    }
+  } else {
+    std::vector<ast::pattern *> elements;
+    while (lexer_.head().is<token::type::identifier>()) {
+      elements.push_back(
+          semantic_analyzer_.pattern_named(lexer_.next().value(), false));
+      if (not lexer_.head().is<token::type::comma>())
+        break;
+      lexer_.next();
+    }
+    parameters = semantic_analyzer_.pattern_tuple(elements);
+  }
+
+  if (lexer_.head().is<token::type::arrow>() and not parse_function_result())
+    return parse::result<ast::pattern>();
+
+  if (not lexer_.head().is<token::type::kw_in>())
+    return parse::result<ast::pattern>();
+  lexer_.next();
+
+  return parameters;
 }
 
 // parenthesized-expression → '(' expression-element-list[opt] ')'
@@ -877,8 +1399,9 @@ parse::result<ast::expression> parser::parse_closure_expression() {
 // expression-element → expression
 // expression-element → identifier ':' expression
 parse::result<ast::expression> parser::parse_parenthesized_expression() {
+  PROFILE_PRODUCTION();
   assert(lexer_.head().is<token::type::l_paren>() && "expected '('");
-  lexer_.next();
+  token l_paren = lexer_.next();
 
   parse::result<ast::expression> parenthesized_expression;
   std::vector<ast::expression *> elements;
@@ -918,7 +1441,16 @@ parse::result<ast::expression> parser::parse_parenthesized_expression() {
     lexer_.next();
   }
 
-  assert(lexer_.head().is<token::type::r_paren>() && "expected ')'");
+  if (not lexer_.head().is<token::type::r_paren>()) {
+    diagnose(lexer_.head().location().start(),
+             diagnostic::err_expected_token_to_syntax)
+        << token(token::type::r_paren, U")", location(), location())
+        << "complete expression list";
+    diagnose(l_paren.location().start(),
+             diagnostic::note_to_match_this_opening_token)
+        << l_paren;
+    return parenthesized_expression;
+  }
   lexer_.next();
 
   parenthesized_expression =
@@ -928,6 +1460,7 @@ parse::result<ast::expression> parser::parse_parenthesized_expression() {
 
 // implicit-member-expression → '.' identifier
 parse::result<ast::expression> parser::parse_implicit_member_expression() {
+  PROFILE_PRODUCTION();
   assert(lexer_.head().is<token::type::period>() && "expected '.'");
 
   parse::result<ast::expression> implicit_member_expression;
@@ -948,6 +1481,7 @@ parse::result<ast::expression> parser::parse_implicit_member_expression() {
 
 // wildcard-expression → '_'
 parse::result<ast::expression> parser::parse_wildcard_expression() {
+  PROFILE_PRODUCTION();
   assert(lexer_.head().is<token::type::underscore>() && "expected '_'");
   lexer_.next();
   return parse::result<ast::expression>(semantic_analyzer_.wildcard_expression());
@@ -956,6 +1490,7 @@ parse::result<ast::expression> parser::parse_wildcard_expression() {
 // binary-expressions → binary-expression binary-expressions[opt]
 parse::result<ast::expression>
 parser::parse_binary_expressions(ast::expression *lhs) {
+  PROFILE_PRODUCTION();
   auto is_binary_expression_head = [](swift::lexer &lexer) -> bool {
     return (lexer.head().is<token::type::op>() and
             lexer.head().is<token::operator_type::binary>()) or
@@ -970,20 +1505,24 @@ parser::parse_binary_expressions(ast::expression *lhs) {
 
   parse::result<ast::expression> sequence;
   std::vector<ast::expression *> expressions;
+  std::vector<range> operators;
 
   while (is_binary_expression_head(lexer_)) {
+    const range op = lexer_.head().location();
     auto binary_expression = parse_binary_expression();
     if (not binary_expression[0] or not binary_expression[1])
       break;
     expressions.push_back(*binary_expression[0]);
     expressions.push_back(*binary_expression[1]);
+    operators.push_back(op);
   }
 
   if (expressions.empty())
     return sequence;
 
   expressions.insert(expressions.begin(), lhs);
-  return (sequence = semantic_analyzer_.sequence_expression(expressions));
+  return (sequence =
+              semantic_analyzer_.sequence_expression(expressions, operators));
 }
 
 // binary-expression → binary-operator prefix-expression
@@ -992,6 +1531,7 @@ parser::parse_binary_expressions(ast::expression *lhs) {
 // binary-expression → type-casting-operator
 std::array<parse::result<ast::expression>, 2>
 parser::parse_binary_expression() {
+  PROFILE_PRODUCTION();
   assert(((lexer_.head().is<token::type::op>() and
            lexer_.head().is<token::operator_type::binary>()) or
           lexer_.head().is<token::type::equal>() or
@@ -1065,22 +1605,54 @@ parser::parse_binary_expression() {
 // type-casting-operator → 'as' '?' type
 std::array<parse::result<ast::expression>, 2>
 parser::parse_type_casting_operator() {
+  PROFILE_PRODUCTION();
   assert((lexer_.head().is<token::type::kw_is>() or
           lexer_.head().is<token::type::kw_as>()) &&
          "expected 'is' or 'as'");
 
-  switch (lexer_.head()) {
+  std::array<parse::result<ast::expression>, 2> type_casting_operator;
+
+  token op = lexer_.next();
+  token::type conditional = token::type::invalid;
+  if (op.is<token::type::kw_as>() and
+      (lexer_.head().is<token::type::question>() or
+       lexer_.head().is<token::type::exclaim>()))
+    conditional = lexer_.next();
+
+  location type_location = lexer_.head().location().start();
+  parse::result<ast::type> type = parse_type();
+  if (not type) {
+    diagnose(type_location, diagnostic::err_expected_type_after_syntax)
+        << (op.is<token::type::kw_is>() ? "'is'" : "'as'");
+    return type_casting_operator;
+  }
+
+  switch (op) {
   default:
     swift_unreachable("invalid type casting operator");
   case token::type::kw_is:
-    __builtin_trap();
+    type_casting_operator[0] = semantic_analyzer_.is_subtype_expression(type);
+    break;
   case token::type::kw_as:
-    __builtin_trap();
+    if (conditional == token::type::question)
+      type_casting_operator[0] =
+          semantic_analyzer_.conditional_checked_cast_expression(type);
+    else
+      type_casting_operator[0] =
+          semantic_analyzer_.checked_cast_expression(type);
+    break;
   }
+
+  // NOTE(compnerd) the cast has no right hand side; it stands in for its own
+  // operand so that the sequence remains a list of alternating operators and
+  // operands until it is folded
+  type_casting_operator[1] = type_casting_operator[0];
+  return type_casting_operator;
 }
 
 // binary-operator → operator
 parse::result<ast::expression> parser::parse_binary_operator() {
+  PROFILE_PRODUCTION();
   parse::result<ast::expression> binary_operator;
 
   if (not lexer_.head().is<token::operator_type::binary>())
@@ -1089,20 +1661,22 @@ parse::result<ast::expression> parser::parse_binary_operator() {
   token op = lexer_.next();
 
   return parse::result<ast::expression>(
-      semantic_analyzer_.declaration_reference_expression(op.value()));
+      semantic_analyzer_.declaration_reference_expression(op));
 }
 
 // assignment-operator → '='
 parse::result<ast::expression> parser::parse_assignment_operator() {
+  PROFILE_PRODUCTION();
   assert(lexer_.head().is<token::type::equal>() && "expected '='");
 
   token equal = lexer_.next();
   return parse::result<ast::expression>(
-      semantic_analyzer_.declaration_reference_expression(equal.value()));
+      semantic_analyzer_.declaration_reference_expression(equal));
 }
 
 // conditional-operator → '?' expression ':'
 parse::result<ast::expression> parser::parse_conditional_operator() {
+  PROFILE_PRODUCTION();
   assert(lexer_.head().is<token::type::question>() && "expected '?'");
 
   parse::result<ast::expression> conditional_operator;
@@ -1134,6 +1708,7 @@ parse::result<ast::expression> parser::parse_conditional_operator() {
 
 // type-annotation → : attributes[opt] type
 parse::result<ast::type> parser::parse_type_annotation() {
+  PROFILE_PRODUCTION();
   assert(lexer_.head().is<token::type::colon>() && "expected ':'");
 
   token colon = lexer_.next();
@@ -1177,6 +1752,11 @@ parse::result<ast::type> parser::parse_type_annotation() {
 // metatype-type → type '.' 'Type'
 // metatype-type → type '.' 'Protocol'
 parse::result<ast::type> parser::parse_type() {
+  PROFILE_PRODUCTION();
+  const nesting level(*this);
+  if (exceeds_maximum_depth())
+    return parse::result<ast::type>();
+
   parse::result<ast::type> type;
 
   switch (lexer_.head()) {
@@ -1296,12 +1876,17 @@ parse::result<ast::type> parser::parse_type() {
         break;
 
       case token::type::kw_Type:
+        lexer_.next();
         lexer_.next();
         type = semantic_analyzer_.type_metatype(type);
         break;
 
       case token::type::kw_Protocol:
-        __builtin_trap();
+        lexer_.next();
+        diagnose(lexer_.next().location().start(),
+                 diagnostic::warn_unsupported_feature)
+            << "protocol metatype";
+        type = semantic_analyzer_.type_metatype(type);
         break;
       }
 
@@ -1317,6 +1902,7 @@ parse::result<ast::type> parser::parse_type() {
 // type-identifier → type-name generic-argument-clause[opt] '.' type-identifier
 // type-name → identifier
 parse::result<ast::type> parser::parse_type_identifier() {
+  PROFILE_PRODUCTION();
   parse::result<ast::type> type_identifier;
   std::vector<std::u32string_view> components;
 
@@ -1352,6 +1938,7 @@ parse::result<ast::type> parser::parse_type_identifier() {
 // tuple-type-element → 'inout'[opt] element-name type-annotation
 // element-name → identifier
 parse::result<ast::type> parser::parse_tuple_type() {
+  PROFILE_PRODUCTION();
   assert(lexer_.head().is<token::type::l_paren>() && "expected '('");
 
   parse::result<ast::type> type;
@@ -1388,7 +1975,18 @@ parse::result<ast::type> parser::parse_tuple_type() {
         element = semantic_analyzer_.type_inout(*element);
       elements.push_back(*element);
     } else {
-      __builtin_trap();
+      // TODO(compnerd) retain the element name
+      diagnose(lexer_.head().location(), diagnostic::warn_unsupported_feature)
+          << "tuple type element name";
+      lexer_.next();  // element-name
+
+      parse::result<ast::type> element = parse_type_annotation();
+      if (not element)
+        return type;
+
+      if (is_inout)
+        element = semantic_analyzer_.type_inout(*element);
+      elements.push_back(*element);
     }
 
     if (ellipsis(lexer_.head()) and
@@ -1427,6 +2025,7 @@ parse::result<ast::type> parser::parse_tuple_type() {
 // protocol-identifier-list → protocol-identifier ',' protocol-identifier-list
 // protocol-identifier → type-identifier
 parse::result<ast::type> parser::parse_protocol_composition_type() {
+  PROFILE_PRODUCTION();
   assert(lexer_.head().is<token::type::kw_protocol>() && "expected 'protocol'");
 
   parse::result<ast::type> type;
@@ -1478,14 +2077,29 @@ parse::result<ast::type> parser::parse_protocol_composition_type() {
 // declarations → declaration
 // declarations → declaration declarations[opt]
 parse::result<ast::statement> parser::parse_declarations() {
+  PROFILE_PRODUCTION();
   std::vector<ast::statement *> declarations;
   parse::result<ast::statement> statement;
 
-  for (parse::result<ast::statement> declaration;
-       (declaration = parse_declaration());
-       declarations.push_back(*declaration))
-    if (lexer_.head().is<token::type::semi>())
-      lexer_.next();
+  semantic::analyzer::lexical_scope_raii lexical_scope(semantic_analyzer_);
+  for (;;) {
+    location start = lexer_.head().location().start();
+    const unsigned errors = diagnostics_engine_.error_count();
+
+    if (auto declaration = parse_declaration()) {
+      declarations.push_back(*declaration);
+      if (lexer_.head().is<token::type::semi>())
+        lexer_.next();
+      continue;
+    }
+
+    if (set<token::type::r_brace, token::type::eof>::contains(lexer_.head()))
+      break;
+
+    if (diagnostics_engine_.error_count() == errors)
+      diagnose(start, diagnostic::err_expected_declaration);
+    recover(start);
+  }
 
   return declarations.size()
              ? (statement = semantic_analyzer_.statements(declarations))
@@ -1507,6 +2121,8 @@ parse::result<ast::statement> parser::parse_declarations() {
 // declaration → subscript-declaration
 // declaration → operator-declaration
 parse::result<ast::declaration> parser::parse_declaration() {
+  PROFILE_PRODUCTION();
+  location start = lexer_.head().location().start();
   bool parsed_attributes = parse_attributes(/*is_declaration=*/true);
   bool parsed_declaration_modifiers = parse_declaration_modifiers();
 
@@ -1519,48 +2135,73 @@ parse::result<ast::declaration> parser::parse_declaration() {
 
   switch (lexer_.head()) {
   default:
-    if (parsed_attributes)
-      __builtin_trap();  // TODO(compnerd) diagnose invalid declaration
+    if (parsed_attributes or parsed_declaration_modifiers)
+      diagnose(lexer_.head().location().start(),
+               diagnostic::err_expected_declaration);
     return declaration;
   case token::type::kw_import:
     if (parsed_declaration_modifiers)
-      __builtin_trap();  // TODO(compnerd) diagnose invalid declaration
-    return parse_import_declaration();
+      diagnose(lexer_.head().location(),
+               diagnostic::err_declaration_modifiers_are_not_allowed_on_syntax)
+          << "import";
+    declaration = parse_import_declaration();
+    break;
   case token::type::kw_let:
-    return parse_constant_declaration();
+    declaration = parse_constant_declaration();
+    break;
   case token::type::kw_var:
-    return parse_variable_declaration();
+    declaration = parse_variable_declaration();
+    break;
   case token::type::kw_typealias:
-    return parse_typealias_declaration();
+    declaration = parse_typealias_declaration();
+    break;
   case token::type::kw_func:
-    return parse_function_declaration();
+    declaration = parse_function_declaration();
+    break;
   case token::type::kw_enum:
-    return parse_enum_declaration();
+    declaration = parse_enum_declaration();
+    break;
   case token::type::kw_struct:
-    return parse_struct_declaration();
+    declaration = parse_struct_declaration();
+    break;
   case token::type::kw_class:
-    return parse_class_declaration();
+    declaration = parse_class_declaration();
+    break;
   case token::type::kw_protocol:
-    return parse_protocol_declaration();
+    declaration = parse_protocol_declaration();
+    break;
   case token::type::kw_init:
-    return parse_initializer_declaration();
+    declaration = parse_initializer_declaration();
+    break;
   case token::type::kw_deinit:
     if (parsed_declaration_modifiers)
-      __builtin_trap();  // TODO(compnerd) diagnose invalid declaration
-    return parse_deinitializer_declaration();
+      diagnose(lexer_.head().location(),
+               diagnostic::err_declaration_modifiers_are_not_allowed_on_syntax)
+          << "deinitializer";
+    declaration = parse_deinitializer_declaration();
+    break;
   case token::type::kw_extension:
     if (parsed_attributes)
-      __builtin_trap();  // TODO(compnerd) diagnose invalid declaration
-    return parse_extension_declaration();
+      diagnose(lexer_.head().location(),
+               diagnostic::err_attributes_are_not_allowed_on_syntax)
+          << "extension";
+    declaration = parse_extension_declaration();
+    break;
   case token::type::kw_subscript:
     if (parsed_declaration_modifiers)
-      __builtin_trap();  // TODO(compnerd) diagnose invalid declaration
-    return parse_subscript_declaration();
+      diagnose(lexer_.head().location(),
+               diagnostic::err_declaration_modifiers_are_not_allowed_on_syntax)
+          << "subscript";
+    declaration = parse_subscript_declaration();
+    break;
   case token::type::kw_prefix:
   case token::type::kw_postfix:
   case token::type::kw_infix:
-    return parse_operator_declaration();
+    declaration = parse_operator_declaration();
+    break;
   }
+
+  return locate(declaration, start);
 }
 
 // import-declaration → attributes[opt] 'import' import-kind[opt] import-path
@@ -1579,6 +2220,7 @@ parse::result<ast::declaration> parser::parse_declaration() {
 // import-path-identifier → identifier
 // import-path-identifier → operator
 parse::result<ast::declaration> parser::parse_import_declaration() {
+  PROFILE_PRODUCTION();
   assert(lexer_.head().is<token::type::kw_import>() && "expected 'import'");
 
   parse::result<ast::declaration> import_declaration;
@@ -1649,6 +2291,7 @@ parse::result<ast::declaration> parser::parse_import_declaration() {
 
 // constant-declaration → attributes[opt] declaration-modifiers[opt] 'let' pattern-initializer-list
 parse::result<ast::declaration> parser::parse_constant_declaration() {
+  PROFILE_PRODUCTION();
   assert(lexer_.head().is<token::type::kw_let>() && "expected 'let'");
   lexer_.next();
 
@@ -1690,6 +2333,7 @@ parse::result<ast::declaration> parser::parse_constant_declaration() {
 // willSet-clause → attributes[opt] 'willSet' setter-name[opt] code-block
 // didSet-clause → attributes[opt] 'didSet' setter-name[opt] code-block
 parse::result<ast::declaration> parser::parse_variable_declaration() {
+  PROFILE_PRODUCTION();
   assert(lexer_.head().is<token::type::kw_var>() && "expected 'var'");
 
   lexer_.next();
@@ -1720,6 +2364,7 @@ parse::result<ast::declaration> parser::parse_variable_declaration() {
   }
 
   parse::result<ast::expression> initializer;
+  const location initializer_start = lexer_.head().location().start();
   if (lexer_.head().is<token::type::equal>()) {
     token equal = lexer_.head();
 
@@ -1732,6 +2377,8 @@ parse::result<ast::declaration> parser::parse_variable_declaration() {
   }
 
   // TODO(compnerd) ensure that the pattern was typed
+  semantic_analyzer_.check_initializer(
+      pattern, initializer, range(initializer_start, lexer_.previous_end()));
 
   variable_declaration =
       semantic_analyzer_.variable_declaration(pattern, initializer);
@@ -1743,6 +2390,7 @@ parse::result<ast::declaration> parser::parse_variable_declaration() {
 // typealias-name → identifier
 // typealias-assignment → '=' type
 parse::result<ast::declaration> parser::parse_typealias_declaration() {
+  PROFILE_PRODUCTION();
   assert(lexer_.head().is<token::type::kw_typealias>() && "expected 'typealias'");
 
   parse::result<ast::declaration> typealias;
@@ -1766,13 +2414,15 @@ parse::result<ast::declaration> parser::parse_typealias_declaration() {
   lexer_.next();
 
   location position = lexer_.head().location().start();
-  if (not parse_type()) {
+  parse::result<ast::type> type = parse_type();
+  if (not type) {
     diagnose(position, diagnostic::err_expected_type_in)
         << "typealias declaration";
     return typealias;
   }
 
-  typealias = semantic_analyzer_.typealias_declaration(name.value(), U"");
+  typealias =
+      semantic_analyzer_.typealias_declaration(name.value(), U"", *type);
   return typealias;
 }
 
@@ -1787,6 +2437,7 @@ parse::result<ast::declaration> parser::parse_typealias_declaration() {
 //
 // function-body → code-block
 parse::result<ast::declaration> parser::parse_function_declaration() {
+  PROFILE_PRODUCTION();
   assert(lexer_.head().is<token::type::kw_func>() && "expected 'func'");
 
   parse::result<ast::declaration> function;
@@ -1808,6 +2459,9 @@ parse::result<ast::declaration> parser::parse_function_declaration() {
 
   semantic::scope_raii scope(semantic_analyzer_.current_scope(),
                              semantic::scope::type::function);
+  // NOTE(compnerd) the parameters are bound in a scope enclosing the body; the
+  // function itself is bound in the enclosing scope once it is declared
+  semantic::analyzer::lexical_scope_raii lexical_scope(semantic_analyzer_);
 
   if (less(lexer_.head()))
     parse_generic_parameter_clause();
@@ -1846,19 +2500,56 @@ parse::result<ast::declaration> parser::parse_function_declaration() {
     return function;
   }
 
+  const location body_start = lexer_.head().location().start();
+  if (delay_function_bodies_) {
+    if (not skip_code_block())
+      return function;
+
+    lexical_scope.reset();
+    function =
+        semantic_analyzer_.function_declaration(name.value(), parameter_clauses,
+                                                result_type, nullptr);
+    auto *declaration = static_cast<ast::function_declaration *>(*function);
+    declaration->set_unparsed_body(this, body_start);
+    semantic_analyzer_.defer(declaration);
+    return function;
+  }
+
+  // NOTE(compnerd) the function is declared before its body is parsed so that
+  // the body is parsed within it, and so that it may refer to itself
+  lexical_scope.reset();
+  auto *declaration = static_cast<ast::function_declaration *>(
+      semantic_analyzer_.function_declaration(name.value(), parameter_clauses,
+                                              result_type, nullptr));
+  declaration->set_body_location(body_start);
+
   // NOTE(compnerd) if the parsing of the body failed, we have already emitted a
   // diagnostic.
   // TODO(compnerd) ensure that a diagnostic was presented, if not, emit a
   // secondary one.
-  if (parse::result<ast::statement> body = parse_code_block())
-    function =
-        semantic_analyzer_.function_declaration(name.value(), parameter_clauses,
-                                                result_type, body);
-  return function;
+  parse::result<ast::statement> body;
+  {
+    semantic::analyzer::lexical_scope_raii body_scope(semantic_analyzer_);
+    semantic::analyzer::declaration_context_raii context(semantic_analyzer_,
+                                                         declaration);
+    for (const auto *clause : parameter_clauses)
+      semantic_analyzer_.bind_parameters(clause);
+    body = parse_code_block();
+  }
+
+  if (not body) {
+    forget(declaration);
+    return function;
+  }
+
+  semantic_analyzer_.check_function_body(*body, lexer_);
+  declaration->set_body(*body);
+  return (function = declaration);
 }
 
 // parameter-clauses → parameter-clause parameter-clauses[opt]
 std::vector<ast::pattern *> parser::parse_parameter_clauses() {
+  PROFILE_PRODUCTION();
   std::vector<ast::pattern *> clauses;
 
   do
@@ -1874,6 +2565,7 @@ std::vector<ast::pattern *> parser::parse_parameter_clauses() {
 // parameter-clause → '(' ')'
 // parameter-clause → '(' parameter-list '...'[opt] ')'
 parse::result<ast::pattern> parser::parse_parameter_clause() {
+  PROFILE_PRODUCTION();
   assert(lexer_.head().is<token::type::l_paren>() && "expected '('");
 
   parse::result<ast::pattern> parameter_clause;
@@ -1910,6 +2602,7 @@ parse::result<ast::pattern> parser::parse_parameter_clause() {
 // parameter-list → parameter
 // parameter-list → parameter ',' parameter-list
 std::vector<ast::pattern *> parser::parse_parameter_list() {
+  PROFILE_PRODUCTION();
   std::vector<ast::pattern *> parameter_list;
 
   while (true) {
@@ -1938,6 +2631,7 @@ std::vector<ast::pattern *> parser::parse_parameter_list() {
 //
 // default-argument-clause → '=' expression
 parse::result<ast::pattern> parser::parse_parameter() {
+  PROFILE_PRODUCTION();
   parse::result<ast::pattern> parameter;
   token external_name;
   parse::result<ast::pattern> external_parameter_name;
@@ -1945,6 +2639,21 @@ parse::result<ast::pattern> parser::parse_parameter() {
   parse::result<ast::pattern> local_parameter_name;
   parse::result<ast::type> type;
 
+  // TODO(compnerd) retain the default argument
+  auto parse_default_argument_clause = [this]() -> bool {
+    token equal = lexer_.next();
+    diagnose(equal.location(), diagnostic::warn_unsupported_feature)
+        << "default argument";
+
+    location expression_location = lexer_.head().location().start();
+    if (parse_expression())
+      return true;
+
+    diagnose(expression_location, diagnostic::err_expected_initial_value_after)
+        << equal;
+    return false;
+  };
+
   // attributes[opt] type default-argument-clause[opt]
   if (lexer_.head().is<token::type::at>() or
       (lexer_.head().is<token::type::identifier>() and
@@ -1963,7 +2672,8 @@ parse::result<ast::pattern> parser::parse_parameter() {
     }
 
     if (lexer_.head().is<token::type::equal>())
-      __builtin_trap();
+      if (not parse_default_argument_clause())
+        return parameter.invalidate();
 
     return parameter;
   }
@@ -2012,7 +2722,8 @@ parse::result<ast::pattern> parser::parse_parameter() {
   }
 
   if (lexer_.head().is<token::type::hash>())
-    __builtin_trap();
+    diagnose(lexer_.next().location(), diagnostic::warn_unsupported_feature)
+        << "'#' parameter name";
 
   // external-parameter-name[opt] local-parameter-name
   if (lexer_.head().is<token::type::identifier>() and
@@ -2048,7 +2759,8 @@ parse::result<ast::pattern> parser::parse_parameter() {
     parameter = semantic_analyzer_.pattern_typed(local_parameter_name, *type);
 
     if (lexer_.head().is<token::type::equal>())
-      __builtin_trap();
+      if (not parse_default_argument_clause())
+        return parameter.invalidate();
   }
 
   return parameter;
@@ -2056,6 +2768,7 @@ parse::result<ast::pattern> parser::parse_parameter() {
 
 // function-result → '->' attributes[opt] type
 parse::result<ast::type> parser::parse_function_result() {
+  PROFILE_PRODUCTION();
   assert(lexer_.head().is<token::type::arrow>() && "expected '->'");
 
   lexer_.next();
@@ -2072,6 +2785,7 @@ parse::result<ast::type> parser::parse_function_result() {
 
 // code-block → '{' statements[opt] '}'
 parse::result<ast::statement> parser::parse_code_block() {
+  PROFILE_PRODUCTION();
   assert(lexer_.head().is<token::type::l_brace>() && "expected '{'");
 
   parse::result<ast::statement> code_block;
@@ -2079,6 +2793,7 @@ parse::result<ast::statement> parser::parse_code_block() {
   // TODO(compnerd) track this location
   lexer_.next();
 
+  semantic::analyzer::lexical_scope_raii lexical_scope(semantic_analyzer_);
   code_block = parse_statements();
 
   if (not lexer_.head().is<token::type::r_brace>()) {
@@ -2092,6 +2807,84 @@ parse::result<ast::statement> parser::parse_code_block() {
   return code_block;
 }
 
+// Skips over a code-block by matching the braces without parsing the
+// statements within it.
+bool parser::skip_code_block() {
+  assert(lexer_.head().is<token::type::l_brace>() && "expected '{'");
+
+  unsigned depth = 0;
+  do {
+    switch (lexer_.head()) {
+    case token::type::l_brace:
+      ++depth;
+      break;
+    case token::type::r_brace:
+      --depth;
+      break;
+    case token::type::eof:
+      diagnose(lexer_.head().location().start(),
+               diagnostic::err_expected_token_at)
+          << token(token::type::r_brace, U"}", location(), location())
+          << "end of brace statement";
+      return false;
+    default:
+      break;
+    }
+    lexer_.next();
+  } while (depth);
+
+  return true;
+}
+
+ast::statement *
+parser::parse_function_body(const ast::function_declaration &function) {
+  PROFILE_PRODUCTION();
+  assert(function.has_unparsed_body() && "function body already parsed");
+
+  // NOTE(compnerd) the body may be requested while parsing; resume from the
+  // current position once the body has been parsed.  The end of file token
+  // does not carry a location, so resume after the last token instead.
+  const location previous_end = lexer_.previous_end();
+  const location resume = lexer_.head().is<token::type::eof>()
+                              ? previous_end
+                              : lexer_.head().location().start();
+
+  lexer_.seek(function.body_location());
+
+  semantic::scope_raii scope(semantic_analyzer_.current_scope(),
+                             semantic::scope::type::function);
+  semantic::analyzer::lexical_scope_raii lexical_scope(semantic_analyzer_);
+  // NOTE(compnerd) the declarations within the body are added to the function
+  semantic::analyzer::declaration_context_raii context(
+      semantic_analyzer_, const_cast<ast::function_declaration *>(&function));
+  for (const auto *clause : function.parameter_clauses())
+    semantic_analyzer_.bind_parameters(clause);
+  parse::result<ast::statement> body = parse_code_block();
+  if (body)
+    semantic_analyzer_.check_function_body(*body, lexer_);
+
+  lexer_.seek(resume, previous_end);
+  return body ? *body : nullptr;
+}
+
+bool parser::reparse_function_body(ast::function_declaration &function,
+                                   uint32_t end) {
+  // NOTE(compnerd) match the braces first so that a body which no longer ends
+  // where it used to is rejected before any nodes are created for it
+  lexer_.seek(function.body_location());
+  if (not skip_code_block() or lexer_.previous_end().offset() != end)
+    return false;
+
+  function.set_unparsed_body(this, function.body_location());
+  return true;
+}
+
+void parser::forget(ast::declaration *declaration) {
+  if (auto *context = declaration->declaration_context())
+    context->remove_declaration(declaration);
+  semantic_analyzer_.unbind(declaration);
+}
+
 // enum-declaration → attributes[opt] access-level-modifier[opt] union-style-enum
 // enum-declaration → attributes[opt] access-level-modifier[opt] raw-value-style-enum
 //
@@ -2129,7 +2922,7 @@ parse::result<ast::statement> parser::parse_code_block() {
 //
 // raw-value-assignment → '=' literal
 parse::result<ast::declaration> parser::parse_enum_declaration() {
-#if 0
+  PROFILE_PRODUCTION();
   assert(lexer_.head().is<token::type::kw_enum>() && "expected 'enum'");
 
   parse::result<ast::declaration> enum_declaration;
@@ -2151,83 +2944,110 @@ parse::result<ast::declaration> parser::parse_enum_declaration() {
   parse_type_inheritance_clause();
 
   if (not lexer_.head().is<token::type::l_brace>()) {
-    diagnose(lexer_.head().location().start(),
-                               diagnostic::err_expected_token_in)
+    diagnose(lexer_.head().location().start(), diagnostic::err_expected_token_in)
         << token(token::type::l_brace, U"{", location(), location()) << "enum";
     return enum_declaration;
   }
-  lexer_.next();
+  token l_brace = lexer_.next();
 
-  for (bool parsed = false; not lexer_.head().is<token::type::r_brace>();
-       parsed = true) {
-    if (lexer_.head().is<token::type::at>() or
-        lexer_.head().is<token::type::kw_case>()) {
+  // NOTE(compnerd) the enumeration is declared before its members are parsed
+  // so that they are declared within it
+  auto *declaration = static_cast<ast::enum_declaration *>(
+      semantic_analyzer_.enum_declaration(enum_name.value(), members));
+  semantic::analyzer::lexical_scope_raii members_scope(semantic_analyzer_);
+  semantic::analyzer::declaration_context_raii context(semantic_analyzer_,
+                                                       declaration);
+
+  while (not lexer_.head().is<token::type::r_brace>() and
+         not lexer_.head().is<token::type::eof>()) {
+    location start = lexer_.head().location().start();
+    const unsigned errors = diagnostics_engine_.error_count();
+
+    if (lexer_.head().is<token::type::at>())
       parse_attributes(/*is_declaration=*/true);
 
-      if (not lexer_.head().is<token::type::kw_case>())
-        __builtin_trap();  // TODO(compnerd) diagnose missing 'case'
-      lexer_.next();
+    if (not lexer_.head().is<token::type::kw_case>()) {
+      if (auto declaration = parse_declaration()) {
+        members.push_back(*declaration);
+        continue;
+      }
 
-      while (not lexer_.head().is<token::type::eof>()) {
-        if (not lexer_.head().is<token::type::identifier>()) {
-          diagnose(lexer_.head().location().start(),
-                                     diagnostic::err_expected_identifier_in)
-              << "enum case declaration";
-          return enum_declaration;
-        }
-        token case_name = lexer_.next();
-
-        if (lexer_.head().is<token::type::l_paren>()) {
-          location type_location = lexer_.peek().location().start();
-          if (not parse_tuple_type()) {
-            diagnose(type_location,
-                                       diagnostic::err_expected_type);
-            return enum_declaration;
-          }
-        } else if (lexer_.head().is<token::type::equal>()) {
-          lexer_.next();
+      if (lexer_.head().is<token::type::r_brace>())
+        break;
+      if (diagnostics_engine_.error_count() == errors)
+        diagnose(start, diagnostic::err_expected_declaration);
+      recover(start);
+      continue;
+    }
+    lexer_.next();
 
-          if (not lexer_.head().is<token::type::literal>()) {
-            diagnose(lexer_.head().location().start(),
-                     diagnostic::err_raw_value_for_enum_case_must_be_a_literal);
-            return enum_declaration;
-          }
-          lexer_.next();
-        }
+    while (not lexer_.head().is<token::type::eof>()) {
+      parse::result<ast::declaration> enumeration_element =
+          parse_enum_case_name();
+      if (not enumeration_element)
+        break;
 
-        ast::declaration *enumeration_element =
-            semantic_analyzer_.enumeration_element_declaration(
-                case_name.value());
-        if (not enumeration_element)
-          return enum_declaration;
-        members.push_back(enumeration_element);
+      if (lexer_.head().is<token::type::l_paren>()) {
+        location type_location = lexer_.peek().location().start();
+        if (not parse_tuple_type()) {
+          diagnose(type_location, diagnostic::err_expected_type);
+          break;
+        }
+      } else if (lexer_.head().is<token::type::equal>()) {
+        lexer_.next();
 
-        if (not lexer_.head().is<token::type::comma>())
+        if (not lexer_.head().is<token::type::literal>()) {
+          diagnose(lexer_.head().location().start(),
+                   diagnostic::err_raw_value_for_enum_case_must_be_a_literal);
           break;
+        }
         lexer_.next();
       }
-    } else {
-      if (auto declaration = parse_declaration())
-        members.push_back(*declaration);
-      else if (parsed)
-        __builtin_trap();  // TODO(compnerd) diagnose bad *-style-enum-member
+
+      members.push_back(*enumeration_element);
+
+      if (not lexer_.head().is<token::type::comma>())
+        break;
+      lexer_.next();
     }
+
+    if (diagnostics_engine_.error_count() != errors)
+      recover(start);
   }
 
-  if (not lexer_.head().is<token::type::r_brace>())
-    __builtin_trap();  // TODO(compnerd) diagnose missing '}'
+  context.reset();
+  members_scope.reset();
+
+  if (not lexer_.head().is<token::type::r_brace>()) {
+    diagnose(lexer_.head().location().start(), diagnostic::err_expected_token_in)
+        << token(token::type::r_brace, U"}", location(), location()) << "enum";
+    diagnose(l_brace.location().start(),
+             diagnostic::note_to_match_this_opening_token)
+        << l_brace;
+    forget(declaration);
+    return enum_declaration;
+  }
   lexer_.next();
 
-  enum_declaration =
-      semantic_analyzer_.enum_declaration(enum_name.value(), members);
-  return enum_declaration;
-#endif
-  __builtin_trap();
+  declaration->set_members(members);
+  return (enum_declaration = declaration);
 }
 
 // enum-case-name → identifier
 parse::result<ast::declaration> parser::parse_enum_case_name() {
-  __builtin_trap();
+  PROFILE_PRODUCTION();
+  parse::result<ast::declaration> enum_case_name;
+
+  if (not lexer_.head().is<token::type::identifier>()) {
+    diagnose(lexer_.head().location().start(),
+             diagnostic::err_expected_identifier_in)
+        << "enum case declaration";
+    return enum_case_name;
+  }
+
+  token case_name = lexer_.next();
+  return (enum_case_name =
+              semantic_analyzer_.enumeration_element_declaration(case_name.value()));
 }
 
 // struct-declaration → attributes[opt] access-level-modifier[opt] 'struct' struct-name generic-parameter-clause[opt] type-inheritance-clause[opt] struct-body
@@ -2236,6 +3056,7 @@ parse::result<ast::declaration> parser::parse_enum_case_name() {
 //
 // struct-body → '{' declarations[opt] '}'
 parse::result<ast::declaration> parser::parse_struct_declaration() {
+  PROFILE_PRODUCTION();
   assert(lexer_.head().is<token::type::kw_struct>() && "expected 'struct'");
 
   parse::result<ast::declaration> struct_declaration;
@@ -2261,23 +3082,42 @@ parse::result<ast::declaration> parser::parse_struct_declaration() {
         << "struct";
     return struct_declaration;
   }
-  lexer_.next();
+  token l_brace = lexer_.next();
 
-  parse::result<ast::statement> declarations = parse_declarations();
+  // NOTE(compnerd) the struct is declared before its members are parsed so that
+  // they are declared within it
+  auto *declaration = static_cast<ast::struct_declaration *>(
+      semantic_analyzer_.struct_declaration(struct_name.value(), nullptr));
+
+  parse::result<ast::statement> declarations;
+  {
+    semantic::analyzer::lexical_scope_raii members_scope(semantic_analyzer_);
+    semantic::analyzer::declaration_context_raii context(semantic_analyzer_,
+                                                         declaration);
+    declarations = parse_declarations();
+  }
 
-  if (not lexer_.head().is<token::type::r_brace>())
-    __builtin_trap();  // TODO(compnerd) diagnose missing '}'
+  if (not lexer_.head().is<token::type::r_brace>()) {
+    diagnose(lexer_.head().location().start(), diagnostic::err_expected_token_in)
+        << token(token::type::r_brace, U"}", location(), location())
+        << "struct";
+    diagnose(l_brace.location().start(),
+             diagnostic::note_to_match_this_opening_token)
+        << l_brace;
+    forget(declaration);
+    return struct_declaration;
+  }
   lexer_.next();
 
-  struct_declaration =
-      semantic_analyzer_.struct_declaration(struct_name.value(), *declarations);
-  return struct_declaration;
+  declaration->set_declarations(*declarations);
+  return (struct_declaration = declaration);
 }
 
 // class-declaration → attributes[opt] access-level-modifier[opt] 'class' class-name generic-parameter-clause[opt] type-inheritance-clause[opt] class-body
 // class-name → identifier
 // class-body → '{' declarations[opt] '}'
 parse::result<ast::declaration> parser::parse_class_declaration() {
+  PROFILE_PRODUCTION();
   assert(lexer_.head().is<token::type::kw_class>() && "expected 'class'");
 
   parse::result<ast::declaration> class_declaration;
@@ -2302,17 +3142,34 @@ parse::result<ast::declaration> parser::parse_class_declaration() {
         << token(token::type::l_brace, U"{", location(), location()) << "class";
     return class_declaration;
   }
-  lexer_.next();
+  token l_brace = lexer_.next();
 
-  parse::result<ast::statement> declarations = parse_declarations();
+  // NOTE(compnerd) the class is declared before its members are parsed so that
+  // they are declared within it
+  auto *declaration = static_cast<ast::class_declaration *>(
+      semantic_analyzer_.class_declaration(class_name.value(), nullptr));
+
+  parse::result<ast::statement> declarations;
+  {
+    semantic::analyzer::lexical_scope_raii members_scope(semantic_analyzer_);
+    semantic::analyzer::declaration_context_raii context(semantic_analyzer_,
+                                                         declaration);
+    declarations = parse_declarations();
+  }
 
-  if (not lexer_.head().is<token::type::r_brace>())
-    __builtin_trap();  // TODO(compnerd) diagnose invalid class-body
+  if (not lexer_.head().is<token::type::r_brace>()) {
+    diagnose(lexer_.head().location().start(), diagnostic::err_expected_token_in)
+        << token(token::type::r_brace, U"}", location(), location()) << "class";
+    diagnose(l_brace.location().start(),
+             diagnostic::note_to_match_this_opening_token)
+        << l_brace;
+    forget(declaration);
+    return class_declaration;
+  }
   lexer_.next();
 
-  class_declaration =
-      semantic_analyzer_.class_declaration(class_name.value(), *declarations);
-  return class_declaration;
+  declaration->set_body(*declarations);
+  return (class_declaration = declaration);
 }
 
 // protocol-declaration → attributes[opt] access-level-modifier[opt] 'protocol' protocol-name type-inheritance-clause[opt] protocol-body
@@ -2320,6 +3177,7 @@ parse::result<ast::declaration> parser::parse_class_declaration() {
 // protocol-name → identifier
 // protocol-body → '{' protocol-member-declarations[opt] '}'
 parse::result<ast::declaration> parser::parse_protocol_declaration() {
+  PROFILE_PRODUCTION();
   assert(lexer_.head().is<token::type::kw_protocol>() && "expected 'protocol'");
 
   parse::result<ast::declaration> protocol_declaration;
@@ -2342,21 +3200,39 @@ parse::result<ast::declaration> parser::parse_protocol_declaration() {
         << "protocol type";
     return protocol_declaration;
   }
-  lexer_.next();
+  token l_brace = lexer_.next();
+
+  // NOTE(compnerd) the protocol is declared before its members are parsed so
+  // that they are declared within it
+  ast::declaration *declaration =
+      semantic_analyzer_.protocol_declaration(protocol_name.value(), nullptr);
 
-  parse_protocol_member_declarations();
+  {
+    semantic::analyzer::lexical_scope_raii members_scope(semantic_analyzer_);
+    semantic::analyzer::declaration_context_raii context(
+        semantic_analyzer_,
+        static_cast<ast::protocol_declaration *>(declaration));
+    parse_protocol_member_declarations();
+  }
 
-  if (not lexer_.head().is<token::type::r_brace>())
-    __builtin_trap();  // TODO(compnerd) diagnose invalid protocol-declaration
+  if (not lexer_.head().is<token::type::r_brace>()) {
+    diagnose(lexer_.head().location().start(), diagnostic::err_expected_token_in)
+        << token(token::type::r_brace, U"}", location(), location())
+        << "protocol type";
+    diagnose(l_brace.location().start(),
+             diagnostic::note_to_match_this_opening_token)
+        << l_brace;
+    forget(declaration);
+    return protocol_declaration;
+  }
   lexer_.next();
 
-  protocol_declaration =
-      semantic_analyzer_.protocol_declaration(protocol_name.value(), nullptr);
-  return protocol_declaration;
+  return (protocol_declaration = declaration);
 }
 
 // protocol-member-declarations → protocol-member-declaration protocol-member-declarations[opt]
 bool parser::parse_protocol_member_declarations() {
+  PROFILE_PRODUCTION();
   for (bool parsed = false; ; parsed = true)
     if (not parse_protocol_member_declaration())
       return parsed;
@@ -2378,23 +3254,59 @@ bool parser::parse_protocol_member_declarations() {
 //
 // protocol-associated-type-declaration → typealias-head type-inheritance-clause[opt] typealias-assignment[opt]
 bool parser::parse_protocol_member_declaration() {
+  PROFILE_PRODUCTION();
   bool has_attributes = parse_attributes(/*is_declaration=*/true);
   bool has_modifiers = parse_declaration_modifiers();
 
   switch (lexer_.head()) {
   default:
     if (has_attributes or has_modifiers)
-      __builtin_trap();  // TODO(compnerd) diagnose invalid
-                         // protocol-member-declaration
+      diagnose(lexer_.head().location().start(),
+               diagnostic::err_expected_declaration);
     return false;
   case token::type::kw_var:
-    __builtin_trap();
   case token::type::kw_func:
-    __builtin_trap();
   case token::type::kw_init:
-    __builtin_trap();
   case token::type::kw_subscript:
-    __builtin_trap();
+  case token::type::kw_typealias:
+    break;
+  }
+
+  // TODO(compnerd) parse the protocol requirements
+  diagnose(lexer_.next().location(), diagnostic::warn_unsupported_feature)
+      << "protocol member declaration";
+
+  // skip to the next member or the end of the protocol body
+  for (unsigned depth = 0; not lexer_.head().is<token::type::eof>();
+       lexer_.next()) {
+    switch (lexer_.head()) {
+    default:
+      break;
+    case token::type::l_brace:
+    case token::type::l_paren:
+    case token::type::l_square:
+      ++depth;
+      break;
+    case token::type::r_paren:
+    case token::type::r_square:
+      if (depth)
+        --depth;
+      break;
+    case token::type::r_brace:
+      if (depth == 0)
+        return true;
+      --depth;
+      break;
+    case token::type::at:
+    case token::type::kw_var:
+    case token::type::kw_func:
+    case token::type::kw_init:
+    case token::type::kw_subscript:
+    case token::type::kw_typealias:
+      if (depth == 0)
+        return true;
+      break;
+    }
   }
 
   return true;
@@ -2409,6 +3321,7 @@ bool parser::parse_protocol_member_declaration() {
 //
 // class-requirement → 'class'
 bool parser::parse_type_inheritance_clause() {
+  PROFILE_PRODUCTION();
   if (not lexer_.head().is<token::type::colon>())
     return false;
   lexer_.next();
@@ -2421,9 +3334,11 @@ bool parser::parse_type_inheritance_clause() {
   }
 
   while (true) {
-    if (not parse_type_identifier())
-      __builtin_trap();  // TODO(compnerd) diagnose incorrect
-                         // type-inheritance-clause
+    if (not lexer_.head().is<token::type::identifier>() or
+        not parse_type_identifier()) {
+      diagnose(lexer_.head().location().start(), diagnostic::err_expected_type);
+      return false;
+    }
     if (not lexer_.head().is<token::type::comma>())
       break;
     lexer_.next();
@@ -2438,19 +3353,147 @@ bool parser::parse_type_inheritance_clause() {
 //
 // initializer-body → code-block
 parse::result<ast::declaration> parser::parse_initializer_declaration() {
-  __builtin_trap();
+  PROFILE_PRODUCTION();
+  assert(lexer_.head().is<token::type::kw_init>() && "expected 'init'");
+
+  parse::result<ast::declaration> initializer;
+
+  lexer_.next();
+
+  if (lexer_.head().is<token::type::question>() or
+      lexer_.head().is<token::type::exclaim>())
+    diagnose(lexer_.next().location(), diagnostic::warn_unsupported_feature)
+        << "failable initializer";
+
+  semantic::scope_raii scope(semantic_analyzer_.current_scope(),
+                             semantic::scope::type::function);
+
+  if (less(lexer_.head()))
+    parse_generic_parameter_clause();
+
+  if (not lexer_.head().is<token::type::l_paren>()) {
+    diagnose(lexer_.head().location().start(), diagnostic::err_expected_token_in)
+        << token(token::type::l_paren, U"(", location(), location())
+        << "initializer parameter list";
+    return initializer;
+  }
+
+  parse::result<ast::pattern> parameters = parse_parameter_clause();
+  if (not parameters)
+    return initializer;
+
+  if (not lexer_.head().is<token::type::l_brace>()) {
+    diagnose(lexer_.head().location().start(), diagnostic::err_expected_token_in)
+        << token(token::type::l_brace, U"{", location(), location())
+        << "body of initializer declaration";
+    return initializer;
+  }
+
+  semantic::analyzer::lexical_scope_raii lexical_scope(semantic_analyzer_);
+  semantic_analyzer_.bind_parameters(*parameters);
+  parse::result<ast::statement> body = parse_code_block();
+  lexical_scope.reset();
+
+  if (body)
+    initializer = semantic_analyzer_.initializer_declaration(parameters, body);
+  return initializer;
 }
 
 // deinitializer-declaration → attributes[opt] 'deinit' code-block
 parse::result<ast::declaration> parser::parse_deinitializer_declaration() {
-  __builtin_trap();
+  PROFILE_PRODUCTION();
+  assert(lexer_.head().is<token::type::kw_deinit>() && "expected 'deinit'");
+
+  parse::result<ast::declaration> deinitializer;
+
+  lexer_.next();
+
+  if (not lexer_.head().is<token::type::l_brace>()) {
+    diagnose(lexer_.head().location().start(), diagnostic::err_expected_token_in)
+        << token(token::type::l_brace, U"{", location(), location())
+        << "deinitializer";
+    return deinitializer;
+  }
+
+  semantic::scope_raii scope(semantic_analyzer_.current_scope(),
+                             semantic::scope::type::function);
+  if (parse::result<ast::statement> body = parse_code_block())
+    deinitializer = semantic_analyzer_.deinitializer_declaration(body);
+  return deinitializer;
 }
 
 // extension-declaration → access-level-modifier[opt] 'extension' type-identifier type-inheritance-clause[opt] extension-body
 //
 // extension-body → '{' declarations[opt] '}'
 parse::result<ast::declaration> parser::parse_extension_declaration() {
-  __builtin_trap();
+  PROFILE_PRODUCTION();
+  assert(lexer_.head().is<token::type::kw_extension>() &&
+         "expected 'extension'");
+
+  parse::result<ast::declaration> extension;
+  std::vector<std::u32string_view> adopted_protocols;
+
+  lexer_.next();
+
+  if (not lexer_.head().is<token::type::identifier>()) {
+    diagnose(lexer_.head().location().start(),
+             diagnostic::err_expected_identifier_in)
+        << "extension declaration";
+    return extension;
+  }
+  token type_name = lexer_.next();
+
+  if (lexer_.head().is<token::type::colon>()) {
+    lexer_.next();
+    while (true) {
+      if (not lexer_.head().is<token::type::identifier>()) {
+        diagnose(lexer_.head().location().start(), diagnostic::err_expected_type);
+        return extension;
+      }
+      adopted_protocols.push_back(lexer_.next().value());
+
+      if (not lexer_.head().is<token::type::comma>())
+        break;
+      lexer_.next();
+    }
+  }
+
+  if (not lexer_.head().is<token::type::l_brace>()) {
+    diagnose(lexer_.head().location().start(), diagnostic::err_expected_token_in)
+        << token(token::type::l_brace, U"{", location(), location())
+        << "extension";
+    return extension;
+  }
+  token l_brace = lexer_.next();
+
+  // NOTE(compnerd) the extension is declared before its members are parsed so
+  // that they are declared within it
+  auto *declaration = static_cast<ast::extension_declaration *>(
+      semantic_analyzer_.extension_declaration(type_name.value(),
+                                               adopted_protocols, nullptr));
+
+  parse::result<ast::statement> declarations;
+  {
+    semantic::analyzer::lexical_scope_raii members_scope(semantic_analyzer_);
+    semantic::analyzer::declaration_context_raii context(semantic_analyzer_,
+                                                         declaration);
+    declarations = parse_declarations();
+  }
+
+  if (not lexer_.head().is<token::type::r_brace>()) {
+    diagnose(lexer_.head().location().start(), diagnostic::err_expected_token_in)
+        << token(token::type::r_brace, U"}", location(), location())
+        << "extension";
+    diagnose(l_brace.location().start(),
+             diagnostic::note_to_match_this_opening_token)
+        << l_brace;
+    forget(declaration);
+    return extension;
+  }
+  lexer_.next();
+
+  declaration->set_body(*declarations);
+  return (extension = declaration);
 }
 
 // subscript-declaration → subscript-head subscript-result code-block
@@ -2461,7 +3504,19 @@ parse::result<ast::declaration> parser::parse_extension_declaration() {
 //
 // subscript-result → attributes[opt] type
 parse::result<ast::declaration> parser::parse_subscript_declaration() {
-  __builtin_trap();
+  PROFILE_PRODUCTION();
+  assert(lexer_.head().is<token::type::kw_subscript>() &&
+         "expected 'subscript'");
+
+  // TODO(compnerd) parse the getter and setter
+  diagnose(lexer_.next().location(), diagnostic::err_unsupported_feature)
+      << "subscript declaration";
+
+  consume_until(set<token::type::l_brace, token::type::r_brace>());
+  if (lexer_.head().is<token::type::l_brace>())
+    skip_code_block();
+
+  return parse::result<ast::declaration>();
 }
 
 // operator-declaration → prefix-operator-declaration
@@ -2484,6 +3539,7 @@ parse::result<ast::declaration> parser::parse_subscript_declaration() {
 // associativity → 'right'
 // associativity → 'none'
 parse::result<ast::declaration> parser::parse_operator_declaration() {
+  PROFILE_PRODUCTION();
   assert((lexer_.head().is<token::type::kw_infix>() or
           lexer_.head().is<token::type::kw_prefix>() or
           lexer_.head().is<token::type::kw_postfix>()) &&
@@ -2509,7 +3565,7 @@ parse::result<ast::declaration> parser::parse_operator_declaration() {
              diagnostic::err_expected_operator_name_in_operator_declaration);
     return operator_declaration;
   }
-  lexer_.next();
+  token name = lexer_.next();
 
   if (not lexer_.head().is<token::type::l_brace>()) {
     diagnose(lexer_.head().location(),
@@ -2518,9 +3574,72 @@ parse::result<ast::declaration> parser::parse_operator_declaration() {
         << "operator name in 'operator' declaration";
     return operator_declaration;
   }
+  token l_brace = lexer_.next();
+
+  unsigned precedence = 100;
+  token associativity(token::type::kw_none, U"none", location(), location());
+
+  while (operator_type.is<token::type::kw_infix>() and
+         not lexer_.head().is<token::type::r_brace>()) {
+    switch (lexer_.head()) {
+    default:
+      diagnose(lexer_.head().location(), diagnostic::err_unknown_attribute)
+          << lexer_.head();
+      consume_until(token::type::r_brace);
+      break;
+    case token::type::kw_precedence: {
+      lexer_.next();
+
+      bool valid = lexer_.head().is<token::literal_type::integral>();
+      unsigned value = 0;
+      for (const char32_t digit : lexer_.head().value())
+        if (digit >= U'0' and digit <= U'9' and value <= 255)
+          value = value * 10 + (digit - U'0');
+        else
+          valid = false;
+
+      if (not valid or value > 255) {
+        diagnose(lexer_.head().location(),
+                 diagnostic::err_expected_precedence_level);
+        consume_until(token::type::r_brace);
+        break;
+      }
+
+      lexer_.next();
+      precedence = value;
+      break;
+    }
+    case token::type::kw_associativity:
+      lexer_.next();
+
+      if (not set<token::type::kw_left, token::type::kw_right,
+                  token::type::kw_none>::contains(lexer_.head())) {
+        diagnose(lexer_.head().location(),
+                 diagnostic::err_expected_associativity);
+        consume_until(token::type::r_brace);
+        break;
+      }
+
+      associativity = lexer_.next();
+      break;
+    }
+  }
+
+  if (not lexer_.head().is<token::type::r_brace>()) {
+    diagnose(lexer_.head().location().start(), diagnostic::err_expected_token_in)
+        << token(token::type::r_brace, U"}", location(), location())
+        << "operator declaration";
+    diagnose(l_brace.location().start(),
+             diagnostic::note_to_match_this_opening_token)
+        << l_brace;
+    return operator_declaration;
+  }
   lexer_.next();
 
-  __builtin_trap();
+  return (operator_declaration =
+              semantic_analyzer_.operator_declaration(operator_type, name.value(),
+                                                      precedence,
+                                                      associativity));
 }
 
 // loop-statement → for-statement
@@ -2528,6 +3647,7 @@ parse::result<ast::declaration> parser::parse_operator_declaration() {
 // loop-statement → while-statement
 // loop-statement → do-while-statement
 parse::result<ast::statement> parser::parse_loop_statement() {
+  PROFILE_PRODUCTION();
   assert((lexer_.head().is<token::type::kw_for>() or
           lexer_.head().is<token::type::kw_while>() or
           lexer_.head().is<token::type::kw_repeat>()) &&
@@ -2553,11 +3673,23 @@ parse::result<ast::statement> parser::parse_loop_statement() {
 // for-init → variable-declaration
 // for-init → expression-list
 parse::result<ast::statement> parser::parse_for_statement() {
-  __builtin_trap();
+  PROFILE_PRODUCTION();
+  assert(lexer_.head().is<token::type::kw_for>() && "expected 'for'");
+
+  // TODO(compnerd) parse the C-style for-statement
+  diagnose(lexer_.next().location(), diagnostic::err_unsupported_feature)
+      << "C-style for statement";
+
+  consume_until(set<token::type::l_brace, token::type::r_brace>());
+  if (lexer_.head().is<token::type::l_brace>())
+    skip_code_block();
+
+  return parse::result<ast::statement>();
 }
 
 // for-in-statement → 'for' pattern 'in' expression code-block
 parse::result<ast::statement> parser::parse_for_in_statement() {
+  PROFILE_PRODUCTION();
   assert(lexer_.head().is<token::type::kw_for>() && "expected 'for'");
 
   parse::result<ast::statement> for_each_statement;
@@ -2573,8 +3705,13 @@ parse::result<ast::statement> parser::parse_for_in_statement() {
     return for_each_statement;
   }
 
-  if (not lexer_.head().is<token::type::kw_in>())
-    __builtin_trap();  // TODO(compnerd) diagnose invalid for-in-statement
+  if (not lexer_.head().is<token::type::kw_in>()) {
+    diagnose(lexer_.head().location().start(),
+             diagnostic::err_expected_token_after_syntax)
+        << token(token::type::kw_in, U"in", location(), location())
+        << "for-each pattern";
+    return for_each_statement;
+  }
   lexer_.next();
 
   if (not (expression = parse_expression())) {
@@ -2601,6 +3738,7 @@ parse::result<ast::statement> parser::parse_for_in_statement() {
 
 // while-statement → 'while' while-condition code-block
 parse::result<ast::statement> parser::parse_while_statement() {
+  PROFILE_PRODUCTION();
   assert(lexer_.head().is<token::type::kw_while>() && "expected 'while'");
 
   parse::result<ast::statement> while_statement;
@@ -2633,6 +3771,7 @@ parse::result<ast::statement> parser::parse_while_statement() {
 
 // repeat-while-statement → 'repat' code-block 'while' expression
 parse::result<ast::statement> parser::parse_repeat_while_statement() {
+  PROFILE_PRODUCTION();
   assert(lexer_.head().is<token::type::kw_repeat>() && "expected 'repeat'");
 
   parse::result<ast::statement> repeat_while;
@@ -2680,6 +3819,7 @@ parse::result<ast::statement> parser::parse_repeat_while_statement() {
 // while-condition → expression
 // while-condition → declaration
 parse::result<ast::statement> parser::parse_while_condition() {
+  PROFILE_PRODUCTION();
   parse::result<ast::statement> while_condition;
 
   if (auto expression = parse_expression())
@@ -2694,6 +3834,7 @@ parse::result<ast::statement> parser::parse_while_condition() {
 // branch-statement → if-statement
 // branch-statement → switch-statement
 parse::result<ast::statement> parser::parse_branch_statement() {
+  PROFILE_PRODUCTION();
   assert((lexer_.head().is<token::type::kw_if>() or
           lexer_.head().is<token::type::kw_switch>()) &&
          "expected 'if' or 'switch'");
@@ -2715,6 +3856,7 @@ parse::result<ast::statement> parser::parse_branch_statement() {
 // else-clause → 'else' code-block
 // else-clause → 'else' if-statement
 parse::result<ast::statement> parser::parse_if_statement() {
+  PROFILE_PRODUCTION();
   assert(lexer_.head().is<token::type::kw_if>() && "expected 'if'");
 
   parse::result<ast::statement> if_statement;
@@ -2808,12 +3950,13 @@ parse::result<ast::statement> parser::parse_if_statement() {
 //
 // guard-expression → expression
 parse::result<ast::statement> parser::parse_switch_statement() {
+  PROFILE_PRODUCTION();
   assert(lexer_.head().is<token::type::kw_switch>() && "expected 'switch'");
 
   parse::result<ast::statement> switch_statement;
   parse::result<ast::expression> control_expression;
 
-  lexer_.next();
+  location switch_location = lexer_.next().location().start();
 
   semantic::scope_raii scope(semantic_analyzer_.current_scope(),
                              semantic::scope::type::switch_statement);
@@ -2835,6 +3978,7 @@ parse::result<ast::statement> parser::parse_switch_statement() {
   lexer_.next();
 
   std::vector<ast::switch_statement::case_item> cases;
+  std::vector<range> item_ranges;
 
   // TODO(compnerd) parse optional switch_cases
   for (bool seen_default = false;
@@ -2851,6 +3995,7 @@ parse::result<ast::statement> parser::parse_switch_statement() {
     if (case_token.is<token::type::kw_default>()) {
       seen_default = true;
       case_item_list.emplace_back(semantic_analyzer_.pattern_any(), nullptr);
+      item_ranges.emplace_back(case_token.location());
     } else {
       while (not lexer_.head().is<token::type::colon>()) {
         location pattern_location = lexer_.head().location().start();
@@ -2880,6 +4025,7 @@ parse::result<ast::statement> parser::parse_switch_statement() {
         }
 
         case_item_list.emplace_back(pattern, guard);
+        item_ranges.emplace_back(pattern_location, lexer_.previous_end());
 
         if (not lexer_.head().is<token::type::comma>())
           break;
@@ -2928,6 +4074,9 @@ parse::result<ast::statement> parser::parse_switch_statement() {
 
   switch_statement =
       semantic_analyzer_.switch_statement(control_expression, cases);
+  semantic_analyzer_.check_switch(
+      static_cast<ast::switch_statement *>(*switch_statement),
+      range(switch_location, lexer_.previous_end()), item_ranges);
   return switch_statement;
 }
 
@@ -2939,6 +4088,7 @@ parse::result<ast::statement> parser::parse_switch_statement() {
 //
 // label-name → identifier
 parse::result<ast::statement> parser::parse_labelled_statement() {
+  PROFILE_PRODUCTION();
   assert((lexer_.head().is<token::type::identifier>() and
           lexer_.peek().is<token::type::colon>()) &&
          "expected label");
@@ -2960,7 +4110,9 @@ parse::result<ast::statement> parser::parse_labelled_statement() {
       return body;
     break;
   default:
-    __builtin_trap(); // TODO(compnerd) diagnose
+    diagnose(label_name.location(),
+             diagnostic::err_labels_are_only_valid_on_loop_and_switch_statements);
+    return parse_statement();
   }
 
   body = semantic_analyzer_.labelled_statement(label_name.value(), body);
@@ -2972,6 +4124,7 @@ parse::result<ast::statement> parser::parse_labelled_statement() {
 // control-transfer-statement → fallthrough-statement
 // control-transfer-statement → return-statement
 parse::result<ast::statement> parser::parse_control_transfer_statement() {
+  PROFILE_PRODUCTION();
   assert((lexer_.head().is<token::type::kw_break>() or
           lexer_.head().is<token::type::kw_continue>() or
           lexer_.head().is<token::type::kw_fallthrough>() or
@@ -2993,6 +4146,7 @@ parse::result<ast::statement> parser::parse_control_transfer_statement() {
 
 // break-statement → 'break' label-name[opt]
 parse::result<ast::statement> parser::parse_break_statement() {
+  PROFILE_PRODUCTION();
   assert(lexer_.head().is<token::type::kw_break>() && "expected 'break'");
 
   std::u32string_view label_name;
@@ -3009,6 +4163,7 @@ parse::result<ast::statement> parser::parse_break_statement() {
 
 // continue-statement → 'continue' label-name[opt]
 parse::result<ast::statement> parser::parse_continue_statement() {
+  PROFILE_PRODUCTION();
   assert(lexer_.head().is<token::type::kw_continue>() && "expected 'continue'");
 
   std::u32string_view label_name;
@@ -3025,13 +4180,17 @@ parse::result<ast::statement> parser::parse_continue_statement() {
 
 // fallthrough-statement → 'fallthrough'
 parse::result<ast::statement> parser::parse_fallthrough_statement() {
+  PROFILE_PRODUCTION();
   assert(lexer_.head().is<token::type::kw_fallthrough>() &&
          "expected 'fallthrough'");
-  __builtin_trap();
+
+  lexer_.next();
+  return parse::result<ast::statement>(semantic_analyzer_.fallthrough_statement());
 }
 
 // return-statement → 'return' expression[opt]
 parse::result<ast::statement> parser::parse_return_statement() {
+  PROFILE_PRODUCTION();
   assert(lexer_.head().is<token::type::kw_return>() && "expected 'return'");
 
   token return_token = lexer_.next();
@@ -3044,6 +4203,7 @@ parse::result<ast::statement> parser::parse_return_statement() {
 
 // defer-statement → 'defer' code-block
 parse::result<ast::statement> parser::parse_defer_statement() {
+  PROFILE_PRODUCTION();
   assert(lexer_.head().is<token::type::kw_defer>() && "expected 'defer'");
 
   token defer_token = lexer_.next();
@@ -3060,14 +4220,23 @@ parse::result<ast::statement> parser::parse_defer_statement() {
 // where-clause → 'where' where-expression
 // where-expression → expression
 parse::result<ast::statement> parser::parse_do_statement() {
+  PROFILE_PRODUCTION();
   assert(lexer_.head().is<token::type::kw_do>() && "expected 'do'");
-  lexer_.next();
-  __builtin_trap();
+
+  // TODO(compnerd) represent the do-statement and its catch-clauses
+  diagnose(lexer_.next().location(), diagnostic::err_unsupported_feature)
+      << "do statement";
+
+  if (lexer_.head().is<token::type::l_brace>())
+    skip_code_block();
+
+  return parse::result<ast::statement>();
 }
 
 // compiler-control-statement → build-configuration-statement
 // compiler-control-statement → line-control-statement
 parse::result<ast::statement> parser::parse_compiler_control_statement() {
+  PROFILE_PRODUCTION();
   assert((lexer_.head().is<token::type::pp_if>() ||
           lexer_.head().is<token::type::pp_line>()) &&
          "expected '#if' or '#line'");
@@ -3103,8 +4272,23 @@ parse::result<ast::statement> parser::parse_compiler_control_statement() {
 //
 // architecture → 'i386­' | 'x86_64­' | 'arm­' | 'arm64'
 parse::result<ast::statement> parser::parse_build_configuration_statement() {
+  PROFILE_PRODUCTION();
   assert(lexer_.head().is<token::type::pp_if>() && "expected '#if'");
-  __builtin_trap();
+
+  // TODO(compnerd) evaluate the build configuration
+  diagnose(lexer_.head().location(), diagnostic::err_unsupported_feature)
+      << "build configuration statement";
+
+  // skip to the matching '#endif'
+  for (unsigned depth = 0; not lexer_.head().is<token::type::eof>(); ) {
+    token directive = lexer_.next();
+    if (directive.is<token::type::pp_if>())
+      ++depth;
+    else if (directive.is<token::type::pp_endif>() and --depth == 0)
+      break;
+  }
+
+  return parse::result<ast::statement>();
 }
 
 // line-control-statement → '#line'
@@ -3112,6 +4296,7 @@ parse::result<ast::statement> parser::parse_build_configuration_statement() {
 // line-number → A decimal integer greater than zero
 // file-name → static-string-literal
 parse::result<ast::statement> parser::parse_line_control_statement() {
+  PROFILE_PRODUCTION();
   assert(lexer_.head().is<token::type::pp_line>() && "expected '#line'");
 
   parse::result<ast::statement> line_control_statement;
@@ -3140,6 +4325,7 @@ parse::result<ast::statement> parser::parse_line_control_statement() {
 
 // attributes → attribute attributes[opt]
 bool parser::parse_attributes(bool is_declaration) {
+  PROFILE_PRODUCTION();
   for (bool parsed = false; ; parsed = true)
     if (not parse_attribute(is_declaration))
       return parsed;
@@ -3156,6 +4342,7 @@ bool parser::parse_attributes(bool is_declaration) {
 // balanced-token → any identifier, keyword, literal, or operator
 // balanced-token → any punctuation except '(', ')', '[', ']', '{', or '}'
 bool parser::parse_attribute(bool is_declaration) {
+  PROFILE_PRODUCTION();
   enum : uint8_t {
     invalid_attribute = (9 << 0),
     declaration_attribute = (1 << 0),
@@ -3282,6 +4469,7 @@ bool parser::parse_attribute(bool is_declaration) {
 // pattern-initializer-list → pattern-initializer ',' pattern-initializer-list
 bool
 parser::parse_pattern_initializer_list(std::vector<ast::declaration *> &list) {
+  PROFILE_PRODUCTION();
   while (true) {
     parse::result<ast::declaration> initializer = parse_pattern_initializer();
     if (not initializer)
@@ -3296,6 +4484,7 @@ parser::parse_pattern_initializer_list(std::vector<ast::declaration *> &list) {
 
 // pattern-initializer → pattern initializer[opt]
 parse::result<ast::declaration> parser::parse_pattern_initializer() {
+  PROFILE_PRODUCTION();
   parse::result<ast::declaration> pattern_initializer;
 
   parse::result<ast::pattern> named = parse_pattern();
@@ -3303,6 +4492,7 @@ parse::result<ast::declaration> parser::parse_pattern_initializer() {
     return pattern_initializer;
 
   parse::result<ast::expression> initializer;
+  const location initializer_start = lexer_.head().location().start();
   if (lexer_.head().is<token::type::equal>()) {
     swift::token equal = lexer_.head();
     if (not (initializer = parse_initializer())) {
@@ -3312,6 +4502,8 @@ parse::result<ast::declaration> parser::parse_pattern_initializer() {
       return pattern_initializer;
     }
   }
+  semantic_analyzer_.check_initializer(
+      named, initializer, range(initializer_start, lexer_.previous_end()));
 
   pattern_initializer =
       semantic_analyzer_.constant_declaration(named, initializer);
@@ -3338,15 +4530,23 @@ parse::result<ast::declaration> parser::parse_pattern_initializer() {
 // is-pattern → 'is' type
 // as-pattern → pattern 'as' type
 parse::result<ast::pattern> parser::parse_pattern() {
+  PROFILE_PRODUCTION();
+  const nesting level(*this);
+  if (exceeds_maximum_depth())
+    return parse::result<ast::pattern>();
+
   parse::result<ast::pattern> pattern;
 
   switch (lexer_.head()) {
-  default:
+  default: {
+    location expression_location = lexer_.head().location().start();
+    const unsigned errors = diagnostics_engine_.error_count();
     if (parse::result<ast::expression> expression = parse_expression())
       pattern = semantic_analyzer_.pattern_expression(expression);
-    else
-      __builtin_trap();
+    else if (diagnostics_engine_.error_count() == errors)
+      diagnose(expression_location, diagnostic::err_expected_pattern);
     break;
+  }
   case token::type::kw_let:
   case token::type::kw_var:
     if (semantic_analyzer_.current_scope().is<semantic::scope::type::pattern>()) {
@@ -3366,7 +4566,31 @@ parse::result<ast::pattern> parser::parse_pattern() {
     break;
   }
   case token::type::l_paren:  // tuple-pattern
-    pattern = parse_tuple_pattern();
+    if (not semantic_analyzer_.current_scope()
+                .is<semantic::scope::type::switch_case>()) {
+      pattern = parse_tuple_pattern();
+      break;
+    }
+
+    // NOTE(compnerd) in a case label, `(a, b)` is a tuple pattern whereas
+    // `(a + b) * c` is an expression pattern; the tuple pattern is only
+    // retained if it is not followed by the remainder of an expression.
+    pattern = tentatively([this]() -> parse::result<ast::pattern> {
+      parse::result<ast::pattern> tuple_pattern = parse_tuple_pattern();
+      if (not set<token::type::colon, token::type::comma, token::type::r_paren,
+                  token::type::kw_where, token::type::equal,
+                  token::type::kw_in>::contains(lexer_.head()))
+        tuple_pattern.invalidate();
+      return tuple_pattern;
+    });
+    if (pattern)
+      break;
+
+    location expression_location = lexer_.head().location().start();
+    if (parse::result<ast::expression> expression = parse_expression())
+      pattern = semantic_analyzer_.pattern_expression(expression);
+    else
+      diagnose(expression_location, diagnostic::err_expected_pattern);
     break;
   }
 
@@ -3386,6 +4610,7 @@ parse::result<ast::pattern> parser::parse_pattern() {
 // value-binding-pattern → 'var' pattern
 // value-binding-pattern → 'let' pattern
 parse::result<ast::pattern> parser::parse_value_binding_pattern() {
+  PROFILE_PRODUCTION();
   assert((lexer_.head().is<token::type::kw_var>() or
           lexer_.head().is<token::type::kw_let>()) &&
          "expected 'let' or 'var'");
@@ -3409,12 +4634,13 @@ parse::result<ast::pattern> parser::parse_value_binding_pattern() {
 //
 // tuple-pattern-element → pattern
 parse::result<ast::pattern> parser::parse_tuple_pattern() {
+  PROFILE_PRODUCTION();
   assert(lexer_.head().is<token::type::l_paren>() && "expected '('");
 
   parse::result<ast::pattern> tuple_pattern;
   std::vector<ast::pattern *> elements;
 
-  lexer_.next();
+  token l_paren = lexer_.next();
 
   while (not lexer_.head().is<token::type::eof>()) {
     if (auto pattern = parse_pattern()) {
@@ -3440,8 +4666,16 @@ parse::result<ast::pattern> parser::parse_tuple_pattern() {
   if (lexer_.head().is<token::type::eof>())
     return tuple_pattern;
 
-  if (not lexer_.head().is<token::type::r_paren>())
-    __builtin_trap();  // TODO(compnerd) diagnose missing ')'
+  if (not lexer_.head().is<token::type::r_paren>()) {
+    diagnose(lexer_.head().location().start(),
+             diagnostic::err_expected_token_to_syntax)
+        << token(token::type::r_paren, U")", location(), location())
+        << "complete tuple pattern";
+    diagnose(l_paren.location().start(),
+             diagnostic::note_to_match_this_opening_token)
+        << l_paren;
+    return tuple_pattern;
+  }
   lexer_.next();
 
   return (tuple_pattern = semantic_analyzer_.pattern_tuple(elements));
@@ -3449,6 +4683,7 @@ parse::result<ast::pattern> parser::parse_tuple_pattern() {
 
 // initializer → '=' expression
 parse::result<ast::expression> parser::parse_initializer() {
+  PROFILE_PRODUCTION();
   assert(lexer_.head().is<token::type::equal>() && "expected '='");
   lexer_.next();
   return parse_expression();
@@ -3456,6 +4691,7 @@ parse::result<ast::expression> parser::parse_initializer() {
 
 // access-level-modifiers → access-level-modifier access-level-modifiers[opt]
 bool parser::parse_access_level_modifiers() {
+  PROFILE_PRODUCTION();
   for (bool parsed = false; ; parsed = true)
     if (not parse_access_level_modifier())
       return parsed;
@@ -3468,6 +4704,7 @@ bool parser::parse_access_level_modifiers() {
 // access-level-modifier → 'public'
 // access-level-modifier → 'public' '(' 'set' ')'
 bool parser::parse_access_level_modifier() {
+  PROFILE_PRODUCTION();
   switch (lexer_.head()) {
   default:
     return false;
@@ -3481,12 +4718,24 @@ bool parser::parse_access_level_modifier() {
   if (lexer_.head().is<token::type::l_paren>()) {
     lexer_.next();
 
-    if (not lexer_.head().is<token::type::kw_set>())
-      __builtin_trap();
-    lexer_.next();
+    if (not lexer_.head().is<token::type::kw_set>()) {
+      diagnose(lexer_.head().location().start(),
+               diagnostic::err_expected_token_in)
+          << token(token::type::kw_set, U"set", location(), location())
+          << "access level modifier";
+      consume_until(set<token::type::r_paren, token::type::l_brace,
+                        token::type::r_brace>());
+    } else {
+      lexer_.next();
+    }
 
-    if (not lexer_.head().is<token::type::r_paren>())
-      __builtin_trap();
+    if (not lexer_.head().is<token::type::r_paren>()) {
+      diagnose(lexer_.head().location().start(),
+               diagnostic::err_expected_token_in)
+          << token(token::type::r_paren, U")", location(), location())
+          << "access level modifier";
+      return true;
+    }
     lexer_.next();
   }
 
@@ -3495,6 +4744,7 @@ bool parser::parse_access_level_modifier() {
 
 // declaration-modifiers → declaration-modifier declaration-modifiers[opt]
 bool parser::parse_declaration_modifiers() {
+  PROFILE_PRODUCTION();
   for (bool parsed = false; ; parsed = true)
     if (not parse_declaration_modifier())
       return parsed;
@@ -3520,6 +4770,7 @@ bool parser::parse_declaration_modifiers() {
 // declaration-modifier → 'weak'
 // declaration-modifier → access-level-modifier
 bool parser::parse_declaration_modifier() {
+  PROFILE_PRODUCTION();
   switch (lexer_.head()) {
   default:
     return parse_access_level_modifier();
@@ -3551,7 +4802,33 @@ bool parser::parse_declaration_modifier() {
     lexer_.next();
     break;
   case token::type::kw_unowned:
-    __builtin_trap();
+    lexer_.next();
+    if (not lexer_.head().is<token::type::l_paren>())
+      break;
+    lexer_.next();
+
+    if (not (lexer_.head().is<token::type::identifier>() and
+             (lexer_.head().value() == U"safe" or
+              lexer_.head().value() == U"unsafe"))) {
+      diagnose(lexer_.head().location().start(),
+               diagnostic::err_expected_token_in)
+          << token(token::type::identifier, U"safe", location(), location())
+          << "'unowned' modifier";
+      consume_until(set<token::type::r_paren, token::type::l_brace,
+                        token::type::r_brace>());
+    } else {
+      lexer_.next();
+    }
+
+    if (not lexer_.head().is<token::type::r_paren>()) {
+      diagnose(lexer_.head().location().start(),
+               diagnostic::err_expected_token_in)
+          << token(token::type::r_paren, U")", location(), location())
+          << "'unowned' modifier";
+      return true;
+    }
+    lexer_.next();
+    break;
   case token::type::kw_weak:
     lexer_.next();
     break;
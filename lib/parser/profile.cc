@@ -0,0 +1,113 @@
+/**
+ * Copyright © 2014 Saleem Abdulrasool <compnerd@compnerd.org>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+
+
+#include "swift/parser/profile.hh"
+
+#if defined(SWIFT_PARSER_PROFILING)
+
+#include "swift/lexer/lexer.hh"
+
+#include <algorithm>
+#include <iomanip>
+#include <mutex>
+#include <ostream>
+
+namespace {
+std::mutex names_lock;
+std::vector<const char *> names;
+}
+
+namespace swift {
+namespace parse {
+unsigned profile::intern(const char *name) {
+  std::lock_guard<std::mutex> lock(names_lock);
+  names.push_back(name);
+  return names.size() - 1;
+}
+
+profile::scope::scope(profile &profile, unsigned id, const lexer &lexer)
+    : profile_(profile), lexer_(lexer), id_(id), tokens_(0) {
+  production &entry = profile_.entry(id_);
+  ++entry.invocations;
+  if (entry.active++)
+    return;
+  tokens_ = lexer_.consumed();
+  start_ = clock::now();
+}
+
+profile::scope::~scope() {
+  // NOTE(compnerd) nested productions may have grown the table; re-index
+  production &entry = profile_.entry(id_);
+  if (--entry.active)
+    return;
+  entry.time = entry.time + (clock::now() - start_);
+  entry.tokens = entry.tokens + (lexer_.consumed() - tokens_);
+}
+
+void profile::merge(const profile &other) {
+  for (unsigned id = 0; id < other.productions_.size(); ++id) {
+    const production &source = other.productions_[id];
+    production &destination = entry(id);
+    destination.invocations = destination.invocations + source.invocations;
+    destination.tokens = destination.tokens + source.tokens;
+    destination.time = destination.time + source.time;
+  }
+}
+
+void profile::print(std::ostream &os) const {
+  std::vector<unsigned> order;
+  for (unsigned id = 0; id < productions_.size(); ++id)
+    if (productions_[id].invocations)
+      order.push_back(id);
+  std::sort(order.begin(), order.end(), [this](unsigned lhs, unsigned rhs) {
+    return productions_[lhs].time > productions_[rhs].time;
+  });
+
+  std::lock_guard<std::mutex> lock(names_lock);
+
+  os << "*** Parser Profile (cumulative, most expensive first):\n";
+  os << "  " << std::setw(12) << "time (us)" << ' ' << std::setw(10)
+     << "calls" << ' ' << std::setw(10) << "tokens" << ' ' << std::setw(10)
+     << "tokens/call" << "  production\n";
+  for (unsigned id : order) {
+    const production &entry = productions_[id];
+    const auto time =
+        std::chrono::duration_cast<std::chrono::microseconds>(entry.time);
+    os << "  " << std::setw(12) << time.count() << ' ' << std::setw(10)
+       << entry.invocations << ' ' << std::setw(10) << entry.tokens << ' '
+       << std::setw(10) << std::fixed << std::setprecision(1)
+       << static_cast<double>(entry.tokens) / entry.invocations << "  "
+       << names[id] << '\n';
+  }
+}
+}
+}
+
+#endif
@@ -29,8 +29,16 @@
 
 #include "swift/semantic/analyzer.hh"
 
+#include "swift/diagnostics/consumer.hh"
 #include "swift/diagnostics/diagnostics.hh"
 
+#include "swift/lexer/lexer.hh"
+
+#include "swift/semantic/control_flow_graph.hh"
+#include "swift/semantic/space_engine.hh"
+#include "swift/semantic/variable_checker.hh"
+
+#include "swift/support/thread-pool.hh"
 #include "swift/support/ucs4-support.hh"
 
 #include "swift/syntax/context.hh"
@@ -53,6 +61,7 @@
 #include "swift/syntax/prefix-unary-expression.hh"
 #include "swift/syntax/in-out-expression.hh"
 #include "swift/syntax/sequence-expression.hh"
+#include "swift/syntax/binary-expression.hh"
 #include "swift/syntax/assignment-expression.hh"
 #include "swift/syntax/conditional-expression.hh"
 #include "swift/syntax/type-casting-expression.hh"
@@ -100,6 +109,8 @@
 #include "swift/syntax/extension-declaration.hh"
 #include "swift/syntax/subscript-declaration.hh"
 #include "swift/syntax/operator-declaration.hh"
+#include "swift/syntax/enumeration-element-declaration.hh"
+#include "swift/syntax/top-level-declaration.hh"
 
 #include "swift/syntax/for-statement.hh"
 #include "swift/syntax/for-in-statement.hh"
@@ -137,8 +148,11 @@
 #include "swift/syntax/type-metatype.hh"
 #include "swift/syntax/type-tuple.hh"
 
+#include <llvm/ADT/STLExtras.h>
+#include <llvm/ADT/SmallVector.h>
 #include <llvm/ADT/StringRef.h>
 
+#include <algorithm>
 #include <sstream>
 
 using namespace swift::ast;
@@ -162,11 +176,599 @@ static bool get_integer_value(std::u32string_view literal, unsigned radix,
 }
 
 namespace swift::semantic {
+// The name which a declaration other than a constant or a variable binds, if
+// any.
+static std::u32string_view declared_name(const ast::declaration *declaration) {
+  switch (declaration->type()) {
+  case ast::declaration::type::typealias_declaration:
+    return static_cast<const ast::typealias_declaration *>(declaration)->alias();
+  case ast::declaration::type::function_declaration:
+    return static_cast<const ast::function_declaration *>(declaration)->name();
+  case ast::declaration::type::enum_declaration:
+    return static_cast<const ast::enum_declaration *>(declaration)->name();
+  case ast::declaration::type::struct_declaration:
+    return static_cast<const ast::struct_declaration *>(declaration)->name();
+  case ast::declaration::type::class_declaration:
+    return static_cast<const ast::class_declaration *>(declaration)->name();
+  case ast::declaration::type::protocol_declaration:
+    return static_cast<const ast::protocol_declaration *>(declaration)->name();
+  default:
+    return std::u32string_view();
+  }
+}
+
+// Indexes the lookup tables of `context` and of the declaration contexts which
+// it contains.
+static void index(const ast::declaration_context *context) {
+  context->index();
+  for (const auto *declaration : *context) {
+    switch (declaration->type()) {
+    case ast::declaration::type::enum_declaration:
+      index(static_cast<const ast::enum_declaration *>(declaration));
+      break;
+    case ast::declaration::type::struct_declaration:
+      index(static_cast<const ast::struct_declaration *>(declaration));
+      break;
+    case ast::declaration::type::class_declaration:
+      index(static_cast<const ast::class_declaration *>(declaration));
+      break;
+    case ast::declaration::type::protocol_declaration:
+      index(static_cast<const ast::protocol_declaration *>(declaration));
+      break;
+    case ast::declaration::type::extension_declaration:
+      index(static_cast<const ast::extension_declaration *>(declaration));
+      break;
+    default:
+      // NOTE(compnerd) the contexts of code (e.g. function bodies) are only
+      // looked up by the thread which builds them
+      break;
+    }
+  }
+}
+
 analyzer::analyzer(ast::context &ast_context)
     : scope_(nullptr, scope::type::top_level), ast_context_(ast_context),
-      diagnostics_engine_(ast_context.diagnostics_engine()) {
+      diagnostics_engine_(ast_context.diagnostics_engine()),
+      evaluator_(ast_context_, diagnostics_engine_) {
   // FIXME(compnerd) this really should be done lazily
   declaration_context_ = ast_context_.source_file()->declaration_context();
+
+  static const struct {
+    const char32_t *name;
+    uint8_t precedence;
+    enum operator_declaration::associativity associativity;
+  } standard_operators[] = {
+    { U"<<", 160, operator_declaration::associativity::none },
+    { U">>", 160, operator_declaration::associativity::none },
+
+    { U"*", 150, operator_declaration::associativity::left },
+    { U"/", 150, operator_declaration::associativity::left },
+    { U"%", 150, operator_declaration::associativity::left },
+    { U"&*", 150, operator_declaration::associativity::left },
+    { U"&/", 150, operator_declaration::associativity::left },
+    { U"&%", 150, operator_declaration::associativity::left },
+    { U"&", 150, operator_declaration::associativity::left },
+
+    { U"+", 140, operator_declaration::associativity::left },
+    { U"-", 140, operator_declaration::associativity::left },
+    { U"&+", 140, operator_declaration::associativity::left },
+    { U"&-", 140, operator_declaration::associativity::left },
+    { U"|", 140, operator_declaration::associativity::left },
+    { U"^", 140, operator_declaration::associativity::left },
+
+    { U"..<", 135, operator_declaration::associativity::none },
+    { U"...", 135, operator_declaration::associativity::none },
+
+    { U"??", 131, operator_declaration::associativity::right },
+
+    { U"<", 130, operator_declaration::associativity::none },
+    { U"<=", 130, operator_declaration::associativity::none },
+    { U">", 130, operator_declaration::associativity::none },
+    { U">=", 130, operator_declaration::associativity::none },
+    { U"==", 130, operator_declaration::associativity::none },
+    { U"!=", 130, operator_declaration::associativity::none },
+    { U"===", 130, operator_declaration::associativity::none },
+    { U"!==", 130, operator_declaration::associativity::none },
+    { U"~=", 130, operator_declaration::associativity::none },
+
+    { U"&&", 120, operator_declaration::associativity::left },
+
+    { U"||", 110, operator_declaration::associativity::left },
+
+    { U"*=", 90, operator_declaration::associativity::right },
+    { U"/=", 90, operator_declaration::associativity::right },
+    { U"%=", 90, operator_declaration::associativity::right },
+    { U"+=", 90, operator_declaration::associativity::right },
+    { U"-=", 90, operator_declaration::associativity::right },
+    { U"<<=", 90, operator_declaration::associativity::right },
+    { U">>=", 90, operator_declaration::associativity::right },
+    { U"&=", 90, operator_declaration::associativity::right },
+    { U"^=", 90, operator_declaration::associativity::right },
+    { U"|=", 90, operator_declaration::associativity::right },
+    { U"&&=", 90, operator_declaration::associativity::right },
+    { U"||=", 90, operator_declaration::associativity::right },
+  };
+
+  for (const auto &op : standard_operators)
+    declare_infix_operator(op.name, op.precedence, op.associativity);
+}
+
+void analyzer::declare_infix_operator(
+    std::u32string_view name, uint8_t precedence,
+    enum operator_declaration::associativity associativity) {
+  infix_operators_[&ast_context_.identifiers().get(name)] = {
+    precedence, associativity
+  };
+}
+
+void analyzer::bind(const ast::pattern *pattern,
+                    ast::declaration *declaration) {
+  if (not pattern)
+    return;
+
+  switch (pattern->type()) {
+  case ast::pattern::type::named: {
+    const auto *named = static_cast<const ast::pattern_named *>(pattern);
+    symbols_.bind(ast_context_.identifiers().get(named->name()), declaration,
+                  named);
+    break;
+  }
+  case ast::pattern::type::tuple:
+    for (const auto *element :
+         static_cast<const ast::pattern_tuple *>(pattern)->elements())
+      bind(element, declaration);
+    break;
+  case ast::pattern::type::typed:
+    bind(static_cast<const ast::pattern_typed *>(pattern)->pattern(),
+         declaration);
+    break;
+  case ast::pattern::type::var:
+    bind(static_cast<const ast::pattern_var *>(pattern)->pattern(),
+         declaration);
+    break;
+  case ast::pattern::type::any:
+  case ast::pattern::type::expression:
+    break;
+  }
+}
+
+void analyzer::bind(std::u32string_view name, ast::declaration *declaration) {
+  symbols_.bind(ast_context_.identifiers().get(name), declaration, nullptr);
+}
+
+void analyzer::bind(ast::declaration *declaration) {
+  switch (declaration->type()) {
+  case ast::declaration::type::constant_declaration:
+    bind(static_cast<ast::constant_declaration *>(declaration)->name(),
+         declaration);
+    break;
+  case ast::declaration::type::variable_declaration:
+    bind(static_cast<ast::variable_declaration *>(declaration)->name(),
+         declaration);
+    break;
+  default: {
+    const std::u32string_view name = declared_name(declaration);
+    if (not name.empty())
+      bind(name, declaration);
+    break;
+  }
+  }
+}
+
+void analyzer::bind_parameters(const ast::pattern *parameter_clause) {
+  bind(parameter_clause, nullptr);
+  if (type_checker_)
+    type_checker_->declare(parameter_clause, nullptr);
+}
+
+void analyzer::unbind(const ast::pattern *pattern,
+                      const ast::declaration *declaration) {
+  if (not pattern)
+    return;
+
+  switch (pattern->type()) {
+  case ast::pattern::type::named:
+    symbols_.unbind(ast_context_.identifiers().get(
+                        static_cast<const ast::pattern_named *>(pattern)
+                            ->name()),
+                    declaration);
+    break;
+  case ast::pattern::type::tuple:
+    for (const auto *element :
+         static_cast<const ast::pattern_tuple *>(pattern)->elements())
+      unbind(element, declaration);
+    break;
+  case ast::pattern::type::typed:
+    unbind(static_cast<const ast::pattern_typed *>(pattern)->pattern(),
+           declaration);
+    break;
+  case ast::pattern::type::var:
+    unbind(static_cast<const ast::pattern_var *>(pattern)->pattern(),
+           declaration);
+    break;
+  case ast::pattern::type::any:
+  case ast::pattern::type::expression:
+    break;
+  }
+}
+
+void analyzer::unbind(const ast::declaration *declaration) {
+  switch (declaration->type()) {
+  case ast::declaration::type::constant_declaration:
+    unbind(static_cast<const ast::constant_declaration *>(declaration)->name(),
+           declaration);
+    break;
+  case ast::declaration::type::variable_declaration:
+    unbind(static_cast<const ast::variable_declaration *>(declaration)->name(),
+           declaration);
+    break;
+  default: {
+    const std::u32string_view name = declared_name(declaration);
+    if (not name.empty())
+      symbols_.unbind(ast_context_.identifiers().get(name), declaration);
+    break;
+  }
+  }
+  evaluator_.invalidate_interface_type(declaration);
+  if (const auto *context = declaration->declaration_context())
+    evaluator_.invalidate_members(context);
+  deferred_functions_.erase(std::remove(deferred_functions_.begin(),
+                                        deferred_functions_.end(), declaration),
+                            deferred_functions_.end());
+}
+
+void analyzer::replay(ast::statement *statement, const lexer &lexer) {
+  if (not statement)
+    return;
+
+  // NOTE(compnerd) the members are only exposed as const by the enclosing
+  // declarations; the loaded tree is owned by the caller and is not shared.
+  // As when parsed, the members are only bound within the declaration.
+  const auto replay_members = [this, &lexer](const ast::statement *members) {
+    if (not members or members->kind() != node_kind::statements)
+      return;
+    lexical_scope_raii members_scope(*this);
+    for (const auto *member :
+         static_cast<const ast::statements *>(members)->substatements())
+      replay(const_cast<ast::statement *>(member), lexer);
+  };
+  const auto extent = [&lexer](const ast::statement *statement) {
+    return range(lexer.locate(statement->start_offset()),
+                 lexer.locate(statement->end_offset()));
+  };
+
+  switch (statement->kind()) {
+  case node_kind::constant_declaration: {
+    auto *constant = static_cast<ast::constant_declaration *>(statement);
+    const ast::expression *initializer = constant->initializer();
+    check_initializer(constant->name(), initializer,
+                      extent(initializer ? initializer : statement));
+    bind(constant);
+    break;
+  }
+  case node_kind::variable_declaration: {
+    auto *variable = static_cast<ast::variable_declaration *>(statement);
+    const ast::expression *initializer = variable->initializer();
+    check_initializer(variable->name(), initializer,
+                      extent(initializer ? initializer : statement));
+    bind(variable);
+    break;
+  }
+  case node_kind::typealias_declaration:
+    bind(static_cast<ast::declaration *>(statement));
+    break;
+  case node_kind::function_declaration: {
+    auto *function = static_cast<ast::function_declaration *>(statement);
+    bind(function);
+    if (function->has_unparsed_body())
+      defer(function);
+    break;
+  }
+  case node_kind::enum_declaration: {
+    auto *enumeration = static_cast<ast::enum_declaration *>(statement);
+    bind(enumeration);
+    lexical_scope_raii members_scope(*this);
+    for (const auto *member : enumeration->members())
+      replay(const_cast<ast::declaration *>(member), lexer);
+    break;
+  }
+  case node_kind::struct_declaration: {
+    auto *structure = static_cast<ast::struct_declaration *>(statement);
+    bind(structure);
+    replay_members(structure->declarations());
+    break;
+  }
+  case node_kind::class_declaration: {
+    auto *klass = static_cast<ast::class_declaration *>(statement);
+    bind(klass);
+    replay_members(klass->body());
+    break;
+  }
+  case node_kind::protocol_declaration: {
+    auto *protocol = static_cast<ast::protocol_declaration *>(statement);
+    bind(protocol);
+    replay_members(protocol->members());
+    break;
+  }
+  case node_kind::extension_declaration:
+    replay_members(
+        static_cast<ast::extension_declaration *>(statement)->body());
+    break;
+  case node_kind::operator_declaration: {
+    const auto *op = static_cast<ast::operator_declaration *>(statement);
+    if (op->type() == operator_declaration::type::infix)
+      declare_infix_operator(op->name(), op->precedence(), op->associativity());
+    break;
+  }
+  default:
+    // NOTE(compnerd) top-level code is checked as it is parsed, statement by
+    // statement, and is therefore never loaded (see parse::cache).
+    assert(statement->kind() != node_kind::top_level_declaration &&
+           "top-level code cannot be replayed");
+    break;
+  }
+}
+
+struct analyzer::function_body {
+  ast::function_declaration *function;
+  diagnostics::buffering_consumer consumer;
+  diagnostics::engine diagnostics_engine;
+  std::unique_ptr<ast::context> ast_context;
+
+  explicit function_body(ast::function_declaration *function)
+      : function(function), diagnostics_engine(nullptr, &consumer) {}
+};
+
+analyzer::~analyzer() = default;
+
+void analyzer::analyze_function_bodies(thread_pool &pool,
+                                       const body_parser &parse_body) {
+  // NOTE(compnerd) the lookup tables are extended on lookup; index the members
+  // of the nominal types before they are looked up concurrently by the bodies
+  for (const auto *source_file : ast_context_.source_files())
+    index(source_file);
+
+  for (auto *function : deferred_functions_) {
+    // the body may have been parsed on demand since it was skipped
+    if (not function->has_unparsed_body())
+      continue;
+
+    function_bodies_.push_back(std::make_unique<function_body>(function));
+    pool.async([this, &body = *function_bodies_.back(), parse_body]() {
+      // NOTE(compnerd) each body is analysed in a context of its own so that
+      // its nodes are allocated without contention; only the type table of
+      // this context is shared, and this analyzer is only read
+      body.ast_context =
+          std::make_unique<ast::context>(body.diagnostics_engine);
+      body.ast_context->use_types_of(ast_context_);
+      body.ast_context->adopt_into(ast_context_);
+      if (ast_context_.statistics_enabled())
+        body.ast_context->enable_statistics();
+
+      analyzer semantic_analyzer(*body.ast_context);
+      semantic_analyzer.script_mode_ = script_mode_;
+      auto &identifiers = body.ast_context->identifiers();
+      for (const auto &op : infix_operators_)
+        semantic_analyzer.infix_operators_[&identifiers.get(
+            std::u32string_view(op.first->name()))] = op.second;
+      if (type_checker_) {
+        semantic_analyzer.type_checker_.emplace(
+            *body.ast_context, body.diagnostics_engine,
+            semantic_analyzer.evaluator_, *type_checker_);
+        semantic_analyzer.constant_evaluator_.emplace(
+            *body.ast_context, body.diagnostics_engine,
+            &*semantic_analyzer.type_checker_);
+      }
+
+      // bind the enclosing declarations, outermost first, so that the names
+      // which the body references resolve to them
+      llvm::SmallVector<ast::declaration_context *, 4> contexts;
+      for (auto *context = static_cast<ast::declaration *>(body.function)
+                               ->declaration_context();
+           context;
+           context = context->is_source_file() ? nullptr : context->parent())
+        contexts.push_back(context);
+      for (auto *context : llvm::reverse(contexts)) {
+        semantic_analyzer.symbols_.push_scope();
+        for (auto *declaration : *context)
+          semantic_analyzer.bind(declaration);
+      }
+
+      declaration_context_raii declaration_context(
+          semantic_analyzer, body.function->declaration_context());
+      body.function->set_body(parse_body(*body.function, semantic_analyzer));
+    });
+  }
+  deferred_functions_.clear();
+}
+
+void analyzer::complete_function_bodies() {
+  for (auto &body : function_bodies_) {
+    body->consumer.replay(diagnostics_engine_);
+    if (body->ast_context)
+      ast_context_.adopt(std::move(body->ast_context));
+  }
+  function_bodies_.clear();
+}
+
+void analyzer::check_expression(const ast::expression *expression,
+                                range range) {
+  if (type_checker_ and type_checker_->check(expression, range))
+    constant_evaluator_->fold(expression, range);
+}
+
+void analyzer::check_initializer(const ast::pattern *pattern,
+                                 const ast::expression *initializer,
+                                 range range) {
+  if (not type_checker_)
+    return;
+
+  const semantic::type *type = nullptr;
+  if (initializer) {
+    const semantic::type *annotated =
+        pattern->type() == ast::pattern::type::typed
+            ? evaluator_.resolve(
+                  static_cast<const ast::pattern_typed *>(pattern)
+                      ->pattern_type())
+            : nullptr;
+    type = type_checker_->check(initializer, range, annotated);
+    if (type)
+      constant_evaluator_->fold(initializer, range);
+  }
+  type_checker_->declare(pattern, type);
+}
+
+void analyzer::check_function_body(const ast::statement *body,
+                                   const lexer &lexer) {
+  if (not type_checker_ or not body)
+    return;
+
+  const semantic::control_flow_graph graph(ast_context_, body);
+  semantic::variable_checker(ast_context_, diagnostics_engine_, lexer)
+      .check(graph);
+}
+
+void analyzer::check_switch(ast::switch_statement *statement, range range,
+                            llvm::ArrayRef<swift::range> items) {
+  if (not type_checker_ or not statement)
+    return;
+
+  statement->set_exhaustive(
+      semantic::space_engine(diagnostics_engine_, evaluator_, *type_checker_,
+                             declaration_context_)
+          .check(statement, range, items));
+}
+
+analyzer::infix_operator
+analyzer::lookup_infix_operator(const ast::expression *op, range range) {
+  // the assignment and conditional operators are represented by placeholder
+  // nodes which are completed when folded
+  switch (op->type()) {
+  case expression::type::assignment_expression:
+    return { 90, operator_declaration::associativity::right };
+  case expression::type::conditional_expression:
+    return { 100, operator_declaration::associativity::right };
+  case expression::type::type_casting_expression:
+    return { 132, operator_declaration::associativity::none };
+  case expression::type::declaration_reference_expression: {
+    const std::u32string_view name =
+        static_cast<const ast::declaration_reference_expression *>(op)->name();
+    const auto entry =
+        infix_operators_.find(&ast_context_.identifiers().get(name));
+    if (entry != infix_operators_.end())
+      return entry->second;
+
+    diagnose(range, diagnostic::err_operator_is_not_a_known_binary_operator)
+        << name;
+    break;
+  }
+  default:
+    swift_unreachable("unexpected binary operator");
+  }
+
+  // NOTE(compnerd) treat an unknown operator as an operator declared without
+  // a precedence or associativity to avoid cascading diagnostics
+  return { 100, operator_declaration::associativity::none };
+}
+
+ast::expression *analyzer::fold_binary_expression(ast::expression *op,
+                                                  ast::expression *lhs,
+                                                  ast::expression *rhs) {
+  ast::expression *expression;
+  switch (op->type()) {
+  case expression::type::assignment_expression:
+    expression = new (ast_context_) ast::assignment_expression(lhs, rhs);
+    break;
+  case expression::type::conditional_expression: {
+    auto *conditional = static_cast<ast::conditional_expression *>(op);
+    expression = new (ast_context_) ast::conditional_expression(
+        lhs, const_cast<ast::expression *>(conditional->true_clause()), rhs);
+    break;
+  }
+  default:
+    expression = new (ast_context_) ast::binary_expression(op, lhs, rhs);
+    break;
+  }
+
+  if (lhs->has_source_range() and rhs->has_source_range())
+    expression->set_source_range(lhs->start_offset(), rhs->end_offset());
+  return expression;
+}
+
+// Operator precedence parsing over the flattened sequence; every operator is
+// pushed and reduced exactly once, so the fold is linear in the sequence.
+ast::expression *analyzer::fold_sequence_expression(
+    const std::vector<ast::expression *> &expressions,
+    const std::vector<range> &operators) {
+  assert(expressions.size() % 2 == 1 &&
+         "expected alternating operands and operators");
+  assert(operators.size() == expressions.size() / 2 &&
+         "expected the range of each operator");
+
+  struct pending_operator {
+    ast::expression *op;
+    infix_operator info;
+  };
+
+  llvm::SmallVector<ast::expression *, 8> operands;
+  llvm::SmallVector<pending_operator, 8> pending;
+
+  auto reduce = [&]() {
+    ast::expression *rhs = operands.pop_back_val();
+    ast::expression *lhs = operands.pop_back_val();
+    const pending_operator op = pending.pop_back_val();
+    operands.push_back(fold_binary_expression(op.op, lhs, rhs));
+  };
+
+  operands.push_back(expressions.front());
+  for (size_t index = 1, count = expressions.size(); index < count;
+       index = index + 2) {
+    const range &operator_range = operators[index / 2];
+    const pending_operator op{
+      expressions[index],
+      lookup_infix_operator(expressions[index], operator_range)
+    };
+
+    while (not pending.empty()) {
+      const infix_operator &top = pending.back().info;
+      if (top.precedence < op.info.precedence)
+        break;
+      if (top.precedence == op.info.precedence and
+          op.op->type() != expression::type::type_casting_expression) {
+        if (top.associativity == operator_declaration::associativity::right and
+            op.info.associativity == operator_declaration::associativity::right)
+          break;
+        if (top.associativity != op.info.associativity or
+            op.info.associativity == operator_declaration::associativity::none)
+          diagnose(operator_range,
+                   diagnostic::err_non_associative_operator_is_adjacent_to_operator_of_same_precedence);
+      }
+      reduce();
+    }
+
+    // NOTE(compnerd) a type cast has no right hand operand; the parser places
+    // the cast in that position as well.  Apply it to the operand directly so
+    // that it binds as a postfix of the reduced left hand side.
+    if (op.op->type() == expression::type::type_casting_expression) {
+      assert(expressions[index + 1] == op.op && "malformed type cast sequence");
+      auto *cast = static_cast<ast::type_casting_expression *>(op.op);
+      ast::expression *operand = operands.pop_back_val();
+      cast->set_operand(operand);
+      if (operand->has_source_range() and cast->has_source_range())
+        cast->set_source_range(operand->start_offset(), cast->end_offset());
+      operands.push_back(cast);
+      continue;
+    }
+
+    pending.push_back(op);
+    operands.push_back(expressions[index + 1]);
+  }
+
+  while (not pending.empty())
+    reduce();
+
+  assert(operands.size() == 1 && "sequence did not fold to a single tree");
+  return operands.front();
 }
 
 ast::expression *
@@ -181,14 +783,9 @@ expression *analyzer::in_out_expression(ast::expression *expression) {
 }
 
 ast::expression *
-analyzer::sequence_expression(const std::vector<ast::expression *> &exprs) {
-  if (scope_.is<scope::type::top_level>()) {
-    diagnose(location(),
-             diagnostic::err_expressions_not_allowed_at_the_top_level);
-    return nullptr;
-  }
-
-  return new (ast_context_) ast::sequence_expression(exprs);
+analyzer::sequence_expression(const std::vector<ast::expression *> &exprs,
+                              const std::vector<range> &operators) {
+  return fold_sequence_expression(exprs, operators);
 }
 
 ast::expression *
@@ -210,16 +807,17 @@ ast::expression *analyzer::conditional_expression(ast::expression *condition,
       ast::conditional_expression(condition, if_true, if_false);
 }
 
-ast::expression *analyzer::is_subtype_expression() {
-  return new (ast_context_) ast::is_subtype_expression();
+ast::expression *analyzer::is_subtype_expression(ast::type *type) {
+  return new (ast_context_) ast::is_subtype_expression(type);
 }
 
-ast::expression *analyzer::checked_cast_expression() {
-  return new (ast_context_) ast::checked_cast_expression();
+ast::expression *analyzer::checked_cast_expression(ast::type *type) {
+  return new (ast_context_) ast::checked_cast_expression(type);
 }
 
-ast::expression *analyzer::conditional_checked_cast_expression() {
-  return new (ast_context_) ast::conditional_checked_cast_expression();
+ast::expression *
+analyzer::conditional_checked_cast_expression(ast::type *type) {
+  return new (ast_context_) ast::conditional_checked_cast_expression(type);
 }
 
 expression *
@@ -261,8 +859,19 @@ ast::expression *analyzer::optional_chaining_expression() {
 }
 
 ast::expression *
-analyzer::declaration_reference_expression(std::u32string_view value) {
-  return new (ast_context_) ast::declaration_reference_expression(value);
+analyzer::declaration_reference_expression(const swift::token &name) {
+  auto *reference =
+      new (ast_context_) ast::declaration_reference_expression(name.value());
+  // NOTE(compnerd) identifiers are interned by the lexer; operators and
+  // keywords (e.g. `self`) are not, and are looked up by name
+  const identifier_info &identifier =
+      name.identifier() ? *name.identifier()
+                        : ast_context_.identifiers().get(name.value());
+  // TODO(compnerd) names declared later (e.g. a subsequent global) are not yet
+  // bound and remain unresolved
+  if (const auto *binding = symbol_table::lookup(identifier))
+    reference->resolve(binding->declaration, binding->pattern);
+  return reference;
 }
 
 expression *analyzer::boolean_literal_expression(const swift::token &token) {
@@ -336,8 +945,9 @@ ast::expression *analyzer::superclass_expression() {
 }
 
 ast::expression *
-analyzer::closure_expression(ast::statement *statements) {
-  return new (ast_context_) ast::closure_expression(statements);
+analyzer::closure_expression(ast::pattern *parameters,
+                             ast::statement *statements) {
+  return new (ast_context_) ast::closure_expression(parameters, statements);
 }
 
 expression *analyzer::parenthesized_expression(
@@ -369,20 +979,27 @@ analyzer::import_declaration(range declaration_range,
 
 ast::declaration *analyzer::constant_declaration(ast::pattern *name,
                                                  ast::expression *initializer) {
-  return new (ast_context_, declaration_context_)
+  auto *declaration = new (ast_context_, declaration_context_)
       ast::constant_declaration(declaration_context_, name, initializer);
+  bind(name, declaration);
+  return declaration;
 }
 
 ast::declaration *analyzer::variable_declaration(ast::pattern *name,
                                                  ast::expression *initializer) {
-  return new (ast_context_, declaration_context_)
+  auto *declaration = new (ast_context_, declaration_context_)
       ast::variable_declaration(declaration_context_, name, initializer);
+  bind(name, declaration);
+  return declaration;
 }
 
 ast::declaration *analyzer::typealias_declaration(std::u32string_view alias,
-                                                  std::u32string_view type) {
-  return new (ast_context_, declaration_context_)
-      ast::typealias_declaration(declaration_context_, alias, type);
+                                                  std::u32string_view type_name,
+                                                  ast::type *type) {
+  auto *declaration = new (ast_context_, declaration_context_)
+      ast::typealias_declaration(declaration_context_, alias, type_name, type);
+  bind(alias, declaration);
+  return declaration;
 }
 
 ast::declaration *
@@ -390,37 +1007,47 @@ analyzer::function_declaration(std::u32string_view function_name,
                                const std::vector<ast::pattern *> &parameters,
                                ast::type *result_type,
                                ast::statement *body) {
-  return new (ast_context_, declaration_context_)
+  auto *declaration = new (ast_context_, declaration_context_)
       ast::function_declaration(declaration_context_, function_name, parameters,
                                 result_type, body);
+  bind(function_name, declaration);
+  return declaration;
 }
 
 ast::declaration *
 analyzer::enum_declaration(std::u32string_view enumeration_name,
                            const std::vector<ast::declaration *> &elements) {
-  return new (ast_context_, declaration_context_)
+  auto *declaration = new (ast_context_, declaration_context_)
       ast::enum_declaration(declaration_context_, enumeration_name, elements);
+  bind(enumeration_name, declaration);
+  return declaration;
 }
 
 ast::declaration *
 analyzer::struct_declaration(std::u32string_view struct_name,
                              ast::statement *declarations) {
-  return new (ast_context_, declaration_context_)
+  auto *declaration = new (ast_context_, declaration_context_)
       ast::struct_declaration(declaration_context_, struct_name, declarations);
+  bind(struct_name, declaration);
+  return declaration;
 }
 
 ast::declaration *
 analyzer::class_declaration(std::u32string_view class_name,
                             ast::statement *statements) {
-  return new (ast_context_, declaration_context_)
+  auto *declaration = new (ast_context_, declaration_context_)
       ast::class_declaration(declaration_context_, class_name, statements);
+  bind(class_name, declaration);
+  return declaration;
 }
 
 ast::declaration *
 analyzer::protocol_declaration(std::u32string_view protocol_name,
                                ast::statement *members) {
-  return new (ast_context_, declaration_context_)
+  auto *declaration = new (ast_context_, declaration_context_)
       ast::protocol_declaration(declaration_context_, protocol_name, members);
+  bind(protocol_name, declaration);
+  return declaration;
 }
 
 ast::declaration *
@@ -505,6 +1132,10 @@ analyzer::operator_declaration(token type, std::u32string_view operator_name,
     return nullptr;
   }
 
+  // TODO(compnerd) operators declared after their use are not yet honoured
+  if (operator_type == operator_declaration::type::infix)
+    declare_infix_operator(operator_name, precedence, operator_associativity);
+
   return new (ast_context_, declaration_context_)
       ast::operator_declaration(declaration_context_, operator_type,
                                 operator_name, precedence,
@@ -590,7 +1221,7 @@ analyzer::labelled_statement(std::u32string_view label,
   }
   }
 
-  __builtin_trap();
+  swift_unreachable("labels are only valid on loop and switch statements");
 }
 
 /* control transfer statement constructor */
@@ -642,6 +1273,26 @@ analyzer::line_control_statement(std::u32string_view file_name,
 }
 
 /* auxiliary constructors */
+ast::declaration *
+analyzer::enumeration_element_declaration(std::u32string_view name) {
+  return new (ast_context_, declaration_context_)
+      ast::enumeration_element_declaration(declaration_context_, name);
+}
+
+ast::declaration *
+analyzer::top_level_declaration(range code_range,
+                                std::vector<ast::statement *> &code) {
+  if (not script_mode_) {
+    diagnose(code_range,
+             diagnostic::err_expressions_not_allowed_at_the_top_level);
+    return nullptr;
+  }
+
+  return new (ast_context_, declaration_context_)
+      ast::top_level_declaration(declaration_context_, statements(code));
+}
+
+/* pattern constructors */
 
 pattern *analyzer::pattern_any() {
   return new (ast_context_) ast::pattern_any();
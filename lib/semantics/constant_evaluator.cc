@@ -0,0 +1,524 @@
+/**
+ * Copyright © 2014 Saleem Abdulrasool <compnerd@compnerd.org>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+
+
+#include "swift/semantic/constant_evaluator.hh"
+#include "swift/diagnostics/diagnostics.hh"
+#include "swift/diagnostics/engine.hh"
+#include "swift/semantic/type_checker.hh"
+#include "swift/support/error-handling.hh"
+#include "swift/syntax/context.hh"
+
+#include "swift/syntax/binary-expression.hh"
+#include "swift/syntax/boolean-literal-expression.hh"
+#include "swift/syntax/declaration-reference-expression.hh"
+#include "swift/syntax/floating-point-literal-expression.hh"
+#include "swift/syntax/integer-literal-expression.hh"
+#include "swift/syntax/parenthesized-expression.hh"
+#include "swift/syntax/prefix-unary-expression.hh"
+
+#include "swift/syntax/constant-declaration.hh"
+
+#include "swift/syntax/pattern.hh"
+#include "swift/syntax/pattern-typed.hh"
+
+#include <llvm/ADT/SmallString.h>
+
+#include <string>
+
+using diagnostic = swift::diagnostics::diagnostic;
+
+namespace {
+using namespace swift;
+using semantic::builtin_type;
+
+// The width and signedness of the integers of kind `kind`, or false if it is
+// not an integer type.
+bool integer_format(builtin_type::kind kind, unsigned &width,
+                    bool &is_unsigned) {
+  switch (kind) {
+  case builtin_type::kind::sint8:
+  case builtin_type::kind::uint8:
+    width = 8;
+    break;
+  case builtin_type::kind::sint16:
+  case builtin_type::kind::uint16:
+    width = 16;
+    break;
+  case builtin_type::kind::sint32:
+  case builtin_type::kind::uint32:
+    width = 32;
+    break;
+  case builtin_type::kind::sint64:
+  case builtin_type::kind::uint64:
+    width = 64;
+    break;
+  default:
+    return false;
+  }
+  is_unsigned = kind >= builtin_type::kind::uint8;
+  return true;
+}
+
+const llvm::fltSemantics *floating_point_semantics(builtin_type::kind kind) {
+  switch (kind) {
+  case builtin_type::kind::float32:
+    return &llvm::APFloat::IEEEsingle;
+  case builtin_type::kind::float64:
+    return &llvm::APFloat::IEEEdouble;
+  default:
+    return nullptr;
+  }
+}
+
+// The name of the integer type of which `value` is a value.
+std::string_view integer_type_name(const llvm::APSInt &value) {
+  switch (value.getBitWidth()) {
+  case 8:
+    return value.isUnsigned() ? "UInt8" : "Int8";
+  case 16:
+    return value.isUnsigned() ? "UInt16" : "Int16";
+  case 32:
+    return value.isUnsigned() ? "UInt32" : "Int32";
+  case 64:
+    return value.isUnsigned() ? "UInt" : "Int";
+  }
+  swift_unreachable("unknown integer width");
+}
+
+std::string to_string(const llvm::APSInt &value) {
+  llvm::SmallString<24> string;
+  value.toString(string, 10);
+  return string.str().str();
+}
+
+// The name of the builtin operator referenced by `op`, or empty if it is an
+// operator implemented by a function.
+std::u32string_view builtin_operator(const ast::expression *op) {
+  if (op->kind() != ast::node_kind::declaration_reference_expression)
+    return {};
+  const auto *reference =
+      static_cast<const ast::declaration_reference_expression *>(op);
+  if (const ast::declaration *declaration = reference->declaration())
+    if (declaration->type() == ast::declaration::type::function_declaration)
+      return {};
+  return reference->name();
+}
+}
+
+namespace swift::semantic {
+constant_evaluator::constant_evaluator(ast::context &ast_context,
+                                       diagnostics::engine &diagnostics_engine,
+                                       const type_checker *type_checker)
+    : ast_context_(ast_context), diagnostics_engine_(diagnostics_engine),
+      type_checker_(type_checker) {}
+
+const constant *constant_evaluator::intern(constant value) {
+  constants_.push_back(std::move(value));
+  return &constants_.back();
+}
+
+const builtin_type *
+constant_evaluator::type_of(const ast::expression *expression,
+                            builtin_type::kind fallback) const {
+  if (not type_checker_)
+    return ast_context_.builtin_type(fallback);
+
+  const type *type = type_checker_->type_of(expression);
+  if (not type or type->typeclass() != typeclass::builtin)
+    return nullptr;
+  return static_cast<const builtin_type *>(type);
+}
+
+const constant *constant_evaluator::fold(const ast::expression *expression,
+                                         range range) {
+  return evaluate(expression, &range);
+}
+
+const constant *
+constant_evaluator::value(const ast::expression *expression) const {
+  const auto entry = values_.find(expression);
+  return entry == values_.end() ? nullptr : entry->second;
+}
+
+const constant *
+constant_evaluator::evaluate(const ast::expression *expression,
+                             const range *range) {
+  const auto entry = values_.find(expression);
+  if (entry != values_.end())
+    return entry->second;
+
+  using kind = ast::node_kind;
+
+  const constant *value = nullptr;
+  switch (expression->kind()) {
+  case kind::boolean_literal_expression:
+    value = intern(constant(
+        static_cast<const ast::boolean_literal_expression *>(expression)
+            ->value()));
+    break;
+  case kind::integer_literal_expression:
+    value = evaluate_integer_literal(
+        static_cast<const ast::integer_literal_expression *>(expression),
+        false, range);
+    break;
+  case kind::floating_point_literal_expression: {
+    const builtin_type *type =
+        type_of(expression, builtin_type::kind::float64);
+    const llvm::fltSemantics *semantics =
+        type ? floating_point_semantics(type->typeclass()) : nullptr;
+    if (not semantics)
+      break;
+
+    llvm::APFloat literal =
+        static_cast<const ast::floating_point_literal_expression *>(
+            expression)->value();
+    bool loses_information;
+    literal.convert(*semantics, llvm::APFloat::rmNearestTiesToEven,
+                    &loses_information);
+    value = intern(constant(std::move(literal)));
+    break;
+  }
+
+  case kind::parenthesized_expression: {
+    const auto elements =
+        static_cast<const ast::parenthesized_expression *>(expression)
+            ->elements();
+    if (elements.size() == 1)
+      value = evaluate(elements.front(), range);
+    break;
+  }
+  case kind::prefix_unary_expression:
+    value = evaluate_prefix(
+        static_cast<const ast::prefix_unary_expression *>(expression), range);
+    break;
+  case kind::binary_expression:
+    value = evaluate_binary(
+        static_cast<const ast::binary_expression *>(expression), range);
+    break;
+  case kind::declaration_reference_expression:
+    value = evaluate_reference(
+        static_cast<const ast::declaration_reference_expression *>(
+            expression));
+    break;
+
+  default:
+    break;
+  }
+
+  values_[expression] = value;
+  return value;
+}
+
+const constant *constant_evaluator::evaluate_integer_literal(
+    const ast::integer_literal_expression *literal, bool negative,
+    const range *range) {
+  const builtin_type *type = type_of(literal, builtin_type::kind::sint64);
+  if (not type)
+    return nullptr;
+
+  const llvm::APSInt &magnitude = literal->value();
+
+  if (const auto *semantics = floating_point_semantics(type->typeclass())) {
+    llvm::APFloat value = llvm::APFloat::getZero(*semantics);
+    value.convertFromAPInt(magnitude, false,
+                           llvm::APFloat::rmNearestTiesToEven);
+    if (negative)
+      value.changeSign();
+    return intern(constant(std::move(value)));
+  }
+
+  unsigned width;
+  bool is_unsigned;
+  if (not integer_format(type->typeclass(), width, is_unsigned))
+    return nullptr;
+
+  // NOTE(compnerd) the magnitude of the least signed value exceeds that of the
+  // greatest by one, and so a negated literal is evaluated as a whole
+  const unsigned bits = magnitude.getActiveBits();
+  const bool fits =
+      is_unsigned ? (negative ? bits == 0 : bits <= width)
+                  : (bits < width or
+                     (negative and bits == width and magnitude.isPowerOf2()));
+  if (not fits) {
+    if (range)
+      diagnostics_engine_.report(
+          *range, diagnostic::err_integer_literal_overflows_when_stored_into)
+          << (negative ? "-" : "") + to_string(magnitude)
+          << integer_type_name(llvm::APSInt(width, is_unsigned));
+    return nullptr;
+  }
+
+  llvm::APInt value = magnitude.zextOrTrunc(width);
+  if (negative)
+    value = llvm::APInt(width, 0) - value;
+  return intern(constant(llvm::APSInt(value, is_unsigned)));
+}
+
+const constant *constant_evaluator::evaluate_prefix(
+    const ast::prefix_unary_expression *expression, const range *range) {
+  const std::u32string_view op =
+      builtin_operator(expression->prefix_operator());
+  if (op.empty())
+    return nullptr;
+
+  const ast::expression *subexpression = expression->subexpression();
+  if (op == U"-" and
+      subexpression->kind() == ast::node_kind::integer_literal_expression)
+    return evaluate_integer_literal(
+        static_cast<const ast::integer_literal_expression *>(subexpression),
+        true, range);
+
+  const constant *operand = evaluate(subexpression, range);
+  if (not operand)
+    return nullptr;
+
+  switch (operand->kind()) {
+  case constant::kind::integer: {
+    const llvm::APSInt &value = operand->integer();
+    if (op == U"+")
+      return operand;
+    if (op == U"~")
+      return intern(constant(llvm::APSInt(~value, value.isUnsigned())));
+    if (op == U"-") {
+      const llvm::APSInt zero(value.getBitWidth(), value.isUnsigned());
+      return evaluate_integer(op, zero, value, range);
+    }
+    return nullptr;
+  }
+  case constant::kind::floating_point: {
+    if (op == U"+")
+      return operand;
+    if (op == U"-") {
+      llvm::APFloat value = operand->floating_point();
+      value.changeSign();
+      return intern(constant(std::move(value)));
+    }
+    return nullptr;
+  }
+  case constant::kind::boolean:
+    if (op == U"!")
+      return intern(constant(not operand->boolean()));
+    return nullptr;
+  }
+  swift_unreachable("unknown constant kind");
+}
+
+const constant *
+constant_evaluator::evaluate_binary(const ast::binary_expression *expression,
+                                    const range *range) {
+  const std::u32string_view op =
+      builtin_operator(expression->binary_operator());
+  if (op.empty())
+    return nullptr;
+
+  // NOTE(compnerd) constant operands have no side effects, and so the
+  // short-circuiting operators may evaluate both of them
+  const constant *lhs = evaluate(expression->lhs(), range);
+  const constant *rhs = evaluate(expression->rhs(), range);
+  if (not lhs or not rhs or lhs->kind() != rhs->kind())
+    return nullptr;
+
+  switch (lhs->kind()) {
+  case constant::kind::integer:
+    return evaluate_integer(op, lhs->integer(), rhs->integer(), range);
+  case constant::kind::floating_point:
+    return evaluate_floating_point(op, lhs->floating_point(),
+                                   rhs->floating_point());
+  case constant::kind::boolean:
+    return evaluate_boolean(op, lhs->boolean(), rhs->boolean());
+  }
+  swift_unreachable("unknown constant kind");
+}
+
+const constant *constant_evaluator::evaluate_reference(
+    const ast::declaration_reference_expression *reference) {
+  const ast::declaration *declaration = reference->declaration();
+  if (not declaration or
+      declaration->type() != ast::declaration::type::constant_declaration)
+    return nullptr;
+
+  const auto *let = static_cast<const ast::constant_declaration *>(declaration);
+  if (not let->initializer())
+    return nullptr;
+
+  // only a name bound by the pattern alone is bound to the whole initializer
+  const ast::pattern *pattern = let->name();
+  if (pattern->type() == ast::pattern::type::typed)
+    pattern = static_cast<const ast::pattern_typed *>(pattern)->pattern();
+  if (pattern->type() != ast::pattern::type::named)
+    return nullptr;
+
+  // the initializer is diagnosed where the constant is declared
+  return evaluate(let->initializer(), nullptr);
+}
+
+const constant *constant_evaluator::evaluate_integer(std::u32string_view op,
+                                                     const llvm::APSInt &lhs,
+                                                     const llvm::APSInt &rhs,
+                                                     const range *range) {
+  if (lhs.getBitWidth() != rhs.getBitWidth() or
+      lhs.isUnsigned() != rhs.isUnsigned())
+    return nullptr;
+
+  if (op == U"==")
+    return intern(constant(lhs == rhs));
+  if (op == U"!=")
+    return intern(constant(lhs != rhs));
+  if (op == U"<")
+    return intern(constant(lhs < rhs));
+  if (op == U"<=")
+    return intern(constant(lhs <= rhs));
+  if (op == U">")
+    return intern(constant(lhs > rhs));
+  if (op == U">=")
+    return intern(constant(lhs >= rhs));
+
+  const bool is_unsigned = lhs.isUnsigned();
+  const unsigned width = lhs.getBitWidth();
+
+  bool overflow = false;
+  llvm::APInt value;
+  if (op == U"+") {
+    value = is_unsigned ? lhs.uadd_ov(rhs, overflow)
+                        : lhs.sadd_ov(rhs, overflow);
+  } else if (op == U"-") {
+    value = is_unsigned ? lhs.usub_ov(rhs, overflow)
+                        : lhs.ssub_ov(rhs, overflow);
+  } else if (op == U"*") {
+    value = is_unsigned ? lhs.umul_ov(rhs, overflow)
+                        : lhs.smul_ov(rhs, overflow);
+  } else if (op == U"/" or op == U"%") {
+    if (not rhs.getBoolValue()) {
+      if (range)
+        diagnostics_engine_.report(*range, diagnostic::err_division_by_zero);
+      return nullptr;
+    }
+    if (is_unsigned)
+      value = op == U"/" ? lhs.udiv(rhs) : lhs.urem(rhs);
+    else if (op == U"/")
+      value = lhs.sdiv_ov(rhs, overflow);
+    else if (lhs.isMinSignedValue() and rhs.isAllOnesValue())
+      overflow = true;
+    else
+      value = lhs.srem(rhs);
+  } else if (op == U"&+") {
+    value = lhs + rhs;
+  } else if (op == U"&-") {
+    value = lhs - rhs;
+  } else if (op == U"&*") {
+    value = lhs * rhs;
+  } else if (op == U"&") {
+    value = lhs & rhs;
+  } else if (op == U"|") {
+    value = lhs | rhs;
+  } else if (op == U"^") {
+    value = lhs ^ rhs;
+  } else if (op == U"<<" or op == U">>") {
+    // a negative shift shifts the other way, and an overshift shifts out all
+    // of the bits (leaving the sign of a right shifted signed value)
+    const bool negative = not is_unsigned and rhs.isNegative();
+    const llvm::APInt amount =
+        negative ? llvm::APInt(width, 0) - rhs : static_cast<llvm::APInt>(rhs);
+    const bool left = (op == U"<<") != negative;
+    if (amount.uge(width))
+      value = left or is_unsigned or not lhs.isNegative()
+                  ? llvm::APInt(width, 0)
+                  : llvm::APInt::getAllOnesValue(width);
+    else if (left)
+      value = lhs.shl(amount);
+    else
+      value = is_unsigned ? lhs.lshr(amount) : lhs.ashr(amount);
+  } else {
+    return nullptr;
+  }
+
+  if (overflow) {
+    if (range)
+      diagnostics_engine_.report(
+          *range, diagnostic::err_arithmetic_operation_results_in_an_overflow)
+          << to_string(lhs) << op << to_string(rhs)
+          << integer_type_name(lhs);
+    return nullptr;
+  }
+  return intern(constant(llvm::APSInt(value, is_unsigned)));
+}
+
+const constant *
+constant_evaluator::evaluate_floating_point(std::u32string_view op,
+                                            const llvm::APFloat &lhs,
+                                            const llvm::APFloat &rhs) {
+  if (&lhs.getSemantics() != &rhs.getSemantics())
+    return nullptr;
+
+  const llvm::APFloat::cmpResult order = lhs.compare(rhs);
+  if (op == U"==")
+    return intern(constant(order == llvm::APFloat::cmpEqual));
+  if (op == U"!=")
+    return intern(constant(order != llvm::APFloat::cmpEqual));
+  if (op == U"<")
+    return intern(constant(order == llvm::APFloat::cmpLessThan));
+  if (op == U"<=")
+    return intern(constant(order == llvm::APFloat::cmpLessThan or
+                           order == llvm::APFloat::cmpEqual));
+  if (op == U">")
+    return intern(constant(order == llvm::APFloat::cmpGreaterThan));
+  if (op == U">=")
+    return intern(constant(order == llvm::APFloat::cmpGreaterThan or
+                           order == llvm::APFloat::cmpEqual));
+
+  // NOTE(compnerd) IEEE arithmetic saturates to infinity rather than
+  // overflowing, which is not diagnosed
+  llvm::APFloat value = lhs;
+  if (op == U"+")
+    value.add(rhs, llvm::APFloat::rmNearestTiesToEven);
+  else if (op == U"-")
+    value.subtract(rhs, llvm::APFloat::rmNearestTiesToEven);
+  else if (op == U"*")
+    value.multiply(rhs, llvm::APFloat::rmNearestTiesToEven);
+  else if (op == U"/")
+    value.divide(rhs, llvm::APFloat::rmNearestTiesToEven);
+  else
+    return nullptr;
+  return intern(constant(std::move(value)));
+}
+
+const constant *constant_evaluator::evaluate_boolean(std::u32string_view op,
+                                                     bool lhs, bool rhs) {
+  if (op == U"&&")
+    return intern(constant(lhs and rhs));
+  if (op == U"||")
+    return intern(constant(lhs or rhs));
+  if (op == U"==")
+    return intern(constant(lhs == rhs));
+  if (op == U"!=")
+    return intern(constant(lhs != rhs));
+  return nullptr;
+}
+}
@@ -0,0 +1,559 @@
+/**
+ * Copyright © 2014 Saleem Abdulrasool <compnerd@compnerd.org>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+
+
+#include "swift/semantic/control_flow_graph.hh"
+#include "swift/support/error-handling.hh"
+#include "swift/syntax/context.hh"
+#include "swift/syntax/expression.hh"
+#include "swift/syntax/statement.hh"
+#include "swift/syntax/statements.hh"
+
+#include "swift/syntax/break-statement.hh"
+#include "swift/syntax/continue-statement.hh"
+#include "swift/syntax/defer-statement.hh"
+#include "swift/syntax/do-statement.hh"
+#include "swift/syntax/fallthrough-statement.hh"
+#include "swift/syntax/for-in-statement.hh"
+#include "swift/syntax/for-statement.hh"
+#include "swift/syntax/guard-statement.hh"
+#include "swift/syntax/if-statement.hh"
+#include "swift/syntax/labelled-statement.hh"
+#include "swift/syntax/repeat-while-statement.hh"
+#include "swift/syntax/return-statement.hh"
+#include "swift/syntax/switch-statement.hh"
+#include "swift/syntax/throw-statement.hh"
+#include "swift/syntax/while-statement.hh"
+
+#include "swift/syntax/pattern.hh"
+
+#include <llvm/ADT/SmallVector.h>
+
+#include <algorithm>
+#include <vector>
+#include <ext/string_view>
+
+namespace {
+using namespace swift;
+
+constexpr unsigned none = ~0U;
+
+// Lays out the blocks of a function body, which are then flattened into the
+// graph.
+class builder {
+  struct block {
+    llvm::SmallVector<const ast::statement *, 4> statements;
+    const ast::statement *terminator = nullptr;
+    llvm::SmallVector<unsigned, 2> successors;
+  };
+
+  // a statement which `break` (or `continue`) may leave
+  struct target {
+    std::u32string_view label;
+    unsigned break_block;
+    unsigned continue_block;
+    size_t depth;
+  };
+
+  // the clauses of a `do` statement which catch the errors thrown within it
+  struct handler {
+    llvm::SmallVector<unsigned, 2> catch_blocks;
+    size_t depth;
+  };
+
+  std::vector<block> blocks_;
+  unsigned current_;
+
+  // the `defer` statements registered in each enclosing scope, innermost last
+  std::vector<llvm::SmallVector<const ast::defer_statement *, 2>> scopes_;
+  std::vector<target> targets_;
+  std::vector<handler> handlers_;
+  // the case to which `fallthrough` transfers control, and its depth
+  std::vector<std::pair<unsigned, size_t>> fallthroughs_;
+  // the label of the labelled statement being visited
+  std::u32string_view label_;
+
+  unsigned create() {
+    blocks_.emplace_back();
+    return blocks_.size() - 1;
+  }
+
+  void link(unsigned from, unsigned to) {
+    auto &successors = blocks_[from].successors;
+    if (std::find(successors.begin(), successors.end(), to) == successors.end())
+      successors.push_back(to);
+  }
+
+  void append(const ast::statement *statement) {
+    blocks_[current_].statements.push_back(statement);
+  }
+
+  // ends the current block with `statement`, continuing in a new block which
+  // is only reachable through the edges added by the caller
+  unsigned terminate(const ast::statement *statement) {
+    const unsigned block = current_;
+    blocks_[block].terminator = statement;
+    current_ = create();
+    return block;
+  }
+
+  void run_defers(size_t depth);
+  void jump(const ast::statement *statement, unsigned target, size_t depth);
+  void push_target(unsigned break_block, unsigned continue_block);
+  const target *find_target(std::u32string_view label, bool loop) const;
+
+  void visit_scope(const ast::statement *body);
+  void visit(const ast::statement *statement);
+  void visit_if(const ast::if_statement *statement);
+  void visit_guard(const ast::guard_statement *statement);
+  void visit_for(const ast::for_statement *statement);
+  void visit_for_in(const ast::for_in_statement *statement);
+  void visit_while(const ast::while_statement *statement);
+  void visit_repeat_while(const ast::repeat_while_statement *statement);
+  void visit_switch(const ast::switch_statement *statement);
+  void visit_do(const ast::do_statement *statement);
+
+public:
+  explicit builder(const ast::statement *body);
+
+  void flatten(ast::context &context, unsigned &size,
+               const uint32_t *&statement_offsets,
+               const ast::statement *const *&statements,
+               const ast::statement *const *&terminators,
+               const uint32_t *&successor_offsets, const unsigned *&successors,
+               const uint32_t *&predecessor_offsets,
+               const unsigned *&predecessors) const;
+};
+
+builder::builder(const ast::statement *body) {
+  create();
+  create();
+  current_ = semantic::control_flow_graph::entry;
+  visit_scope(body);
+  link(current_, semantic::control_flow_graph::exit);
+}
+
+// Lays out the bodies of the `defer` statements of the scopes nested at `depth`
+// and deeper, as control leaves them.
+void builder::run_defers(size_t depth) {
+  for (size_t scope = scopes_.size(); scope-- > depth;) {
+    // NOTE(compnerd) visiting a body opens a scope, which may reallocate them
+    const auto defers = scopes_[scope];
+    for (auto defer = defers.rbegin(); defer != defers.rend(); ++defer)
+      visit_scope((*defer)->code_block());
+  }
+}
+
+void builder::jump(const ast::statement *statement, unsigned target,
+                   size_t depth) {
+  append(statement);
+  run_defers(depth);
+  link(terminate(statement), target);
+}
+
+void builder::push_target(unsigned break_block, unsigned continue_block) {
+  targets_.push_back({ label_, break_block, continue_block, scopes_.size() });
+  label_ = std::u32string_view();
+}
+
+const builder::target *builder::find_target(std::u32string_view label,
+                                            bool loop) const {
+  for (auto target = targets_.rbegin(); target != targets_.rend(); ++target) {
+    if (loop and target->continue_block == none)
+      continue;
+    if (label.empty() or target->label == label)
+      return &*target;
+  }
+  return nullptr;
+}
+
+void builder::visit_scope(const ast::statement *body) {
+  scopes_.emplace_back();
+  if (body)
+    visit(body);
+  run_defers(scopes_.size() - 1);
+  scopes_.pop_back();
+}
+
+void builder::visit(const ast::statement *statement) {
+  using kind = ast::node_kind;
+
+  switch (statement->kind()) {
+  case kind::statements:
+    for (const auto *substatement :
+         static_cast<const ast::statements *>(statement)->substatements())
+      visit(substatement);
+    return;
+
+  case kind::labelled_statement: {
+    const auto *labelled =
+        static_cast<const ast::labelled_statement *>(statement);
+    label_ = labelled->label();
+    visit(labelled->statement());
+    return;
+  }
+
+  case kind::defer_statement:
+    scopes_.back().push_back(
+        static_cast<const ast::defer_statement *>(statement));
+    return;
+
+  case kind::if_statement:
+    return visit_if(static_cast<const ast::if_statement *>(statement));
+  case kind::guard_statement:
+    return visit_guard(static_cast<const ast::guard_statement *>(statement));
+  case kind::switch_statement:
+    return visit_switch(static_cast<const ast::switch_statement *>(statement));
+  case kind::do_statement:
+    return visit_do(static_cast<const ast::do_statement *>(statement));
+
+  case kind::for_statement:
+    return visit_for(static_cast<const ast::for_statement *>(statement));
+  case kind::for_in_statement:
+    return visit_for_in(static_cast<const ast::for_in_statement *>(statement));
+  case kind::while_statement:
+    return visit_while(static_cast<const ast::while_statement *>(statement));
+  case kind::repeat_while_statement:
+    return visit_repeat_while(
+        static_cast<const ast::repeat_while_statement *>(statement));
+
+  case kind::break_statement:
+  case kind::continue_statement: {
+    const bool loop = statement->kind() == kind::continue_statement;
+    const std::u32string_view label =
+        loop ? static_cast<const ast::continue_statement *>(statement)->label()
+             : static_cast<const ast::break_statement *>(statement)->label();
+    // an unknown label is diagnosed by the parser; the statement is treated
+    // as leaving the function so that the code after it remains unreachable
+    if (const target *target = find_target(label, loop))
+      return jump(statement,
+                  loop ? target->continue_block : target->break_block,
+                  target->depth);
+    return jump(statement, semantic::control_flow_graph::exit, 0);
+  }
+  case kind::fallthrough_statement:
+    if (fallthroughs_.empty())
+      return jump(statement, semantic::control_flow_graph::exit, 0);
+    return jump(statement, fallthroughs_.back().first,
+                fallthroughs_.back().second);
+  case kind::return_statement:
+    return jump(statement, semantic::control_flow_graph::exit, 0);
+  case kind::throw_statement: {
+    if (handlers_.empty())
+      return jump(statement, semantic::control_flow_graph::exit, 0);
+
+    // NOTE(compnerd) the catch clauses are taken to be exhaustive
+    const handler &handler = handlers_.back();
+    append(statement);
+    run_defers(handler.depth);
+    const unsigned block = terminate(statement);
+    for (const unsigned catch_block : handler.catch_blocks)
+      link(block, catch_block);
+    return;
+  }
+
+  default:
+    append(statement);
+    return;
+  }
+}
+
+void builder::visit_if(const ast::if_statement *statement) {
+  append(statement->condition());
+  const unsigned condition = terminate(statement);
+  const unsigned join = create();
+
+  link(condition, current_);
+  visit_scope(statement->true_clause());
+  link(current_, join);
+
+  if (statement->false_clause()) {
+    current_ = create();
+    link(condition, current_);
+    visit_scope(statement->false_clause());
+    link(current_, join);
+  } else {
+    link(condition, join);
+  }
+
+  current_ = join;
+}
+
+void builder::visit_guard(const ast::guard_statement *statement) {
+  for (const auto *condition : statement->condition_clause())
+    append(condition);
+  const unsigned condition = terminate(statement);
+
+  // the body must leave the enclosing scope, and so does not rejoin it
+  link(condition, current_);
+  visit_scope(statement->body());
+
+  current_ = create();
+  link(condition, current_);
+}
+
+void builder::visit_for(const ast::for_statement *statement) {
+  // the names declared by the initializer are scoped to the loop
+  scopes_.emplace_back();
+  if (statement->initializer())
+    visit(statement->initializer());
+
+  const unsigned header = create();
+  link(current_, header);
+  current_ = header;
+  if (statement->condition())
+    append(statement->condition());
+  terminate(statement);
+
+  const unsigned body = current_;
+  const unsigned increment = create();
+  const unsigned after = create();
+  link(header, body);
+  if (statement->condition())
+    link(header, after);
+
+  push_target(after, increment);
+  current_ = body;
+  visit_scope(statement->body());
+  link(current_, increment);
+  targets_.pop_back();
+
+  current_ = increment;
+  if (statement->increment())
+    append(statement->increment());
+  link(increment, header);
+
+  current_ = after;
+  run_defers(scopes_.size() - 1);
+  scopes_.pop_back();
+}
+
+void builder::visit_for_in(const ast::for_in_statement *statement) {
+  append(statement->collection());
+
+  // the header takes the next element of the collection, if any
+  const unsigned header = create();
+  link(current_, header);
+  current_ = header;
+  terminate(statement);
+
+  const unsigned body = current_;
+  const unsigned after = create();
+  link(header, body);
+  link(header, after);
+
+  push_target(after, header);
+  visit_scope(statement->body());
+  link(current_, header);
+  targets_.pop_back();
+
+  current_ = after;
+}
+
+void builder::visit_while(const ast::while_statement *statement) {
+  const unsigned header = create();
+  link(current_, header);
+  current_ = header;
+  append(statement->condition());
+  terminate(statement);
+
+  const unsigned body = current_;
+  const unsigned after = create();
+  link(header, body);
+  link(header, after);
+
+  push_target(after, header);
+  visit_scope(statement->body());
+  link(current_, header);
+  targets_.pop_back();
+
+  current_ = after;
+}
+
+void builder::visit_repeat_while(const ast::repeat_while_statement *statement) {
+  const unsigned body = create();
+  const unsigned condition = create();
+  const unsigned after = create();
+  link(current_, body);
+
+  push_target(after, condition);
+  current_ = body;
+  visit_scope(statement->body());
+  link(current_, condition);
+  targets_.pop_back();
+
+  current_ = condition;
+  append(statement->condition());
+  blocks_[condition].terminator = statement;
+  link(condition, body);
+  link(condition, after);
+
+  current_ = after;
+}
+
+void builder::visit_switch(const ast::switch_statement *statement) {
+  append(statement->control_expression());
+  const unsigned dispatch = terminate(statement);
+  const unsigned after = current_;
+
+  llvm::SmallVector<unsigned, 8> cases;
+  bool exhaustive = statement->exhaustive();
+  for (const auto &item : statement->cases()) {
+    cases.push_back(create());
+    link(dispatch, cases.back());
+
+    for (const auto &pattern : std::get<0>(item))
+      if (std::get<0>(pattern)->type() == ast::pattern::type::any and
+          not std::get<1>(pattern))
+        exhaustive = true;
+  }
+  // NOTE(compnerd) a switch without a `default` (or wildcard) case which is not
+  // known to be exhaustive is taken to be inexhaustive, and so control may pass
+  // over it
+  if (not exhaustive)
+    link(dispatch, after);
+
+  push_target(after, none);
+  unsigned index = 0;
+  for (const auto &item : statement->cases()) {
+    current_ = cases[index];
+    ++index;
+
+    // a guard is evaluated upon matching its pattern, ahead of the body
+    for (const auto &pattern : std::get<0>(item))
+      if (const auto *guard = std::get<1>(pattern))
+        append(guard);
+
+    fallthroughs_.emplace_back(index < cases.size() ? cases[index] : after,
+                               scopes_.size());
+    visit_scope(std::get<1>(item));
+    fallthroughs_.pop_back();
+    link(current_, after);
+  }
+  targets_.pop_back();
+
+  current_ = after;
+}
+
+void builder::visit_do(const ast::do_statement *statement) {
+  llvm::SmallVector<const ast::statement *, 2> clauses;
+  handler handler{ {}, scopes_.size() };
+  for (const auto &clause : statement->catch_clauses()) {
+    clauses.push_back(std::get<1>(clause));
+    handler.catch_blocks.push_back(create());
+  }
+  const unsigned after = create();
+
+  // without a catch clause, the errors propagate to the enclosing handler
+  const bool catches = not clauses.empty();
+  if (catches)
+    handlers_.push_back(handler);
+  visit_scope(statement->body());
+  link(current_, after);
+  if (catches)
+    handlers_.pop_back();
+
+  for (unsigned index = 0; index < clauses.size(); ++index) {
+    current_ = handler.catch_blocks[index];
+    visit_scope(clauses[index]);
+    link(current_, after);
+  }
+
+  current_ = after;
+}
+
+void builder::flatten(ast::context &context, unsigned &size,
+                      const uint32_t *&statement_offsets,
+                      const ast::statement *const *&statements,
+                      const ast::statement *const *&terminators,
+                      const uint32_t *&successor_offsets,
+                      const unsigned *&successors,
+                      const uint32_t *&predecessor_offsets,
+                      const unsigned *&predecessors) const {
+  size = blocks_.size();
+
+  auto *statement_offset = new (context) uint32_t[size + 1];
+  auto *successor_offset = new (context) uint32_t[size + 1];
+  auto *predecessor_offset = new (context) uint32_t[size + 1];
+  auto *terminator = new (context) const ast::statement *[size];
+
+  // count the predecessors of each block ahead of its predecessor offset
+  std::fill(predecessor_offset, predecessor_offset + size + 1, 0);
+  statement_offset[0] = successor_offset[0] = 0;
+  for (unsigned index = 0; index < size; ++index) {
+    const block &block = blocks_[index];
+    statement_offset[index + 1] =
+        statement_offset[index] + block.statements.size();
+    successor_offset[index + 1] =
+        successor_offset[index] + block.successors.size();
+    terminator[index] = block.terminator;
+    for (const unsigned successor : block.successors)
+      ++predecessor_offset[successor + 1];
+  }
+  for (unsigned index = 0; index < size; ++index)
+    predecessor_offset[index + 1] += predecessor_offset[index];
+
+  auto *statement =
+      new (context) const ast::statement *[statement_offset[size]];
+  auto *successor = new (context) unsigned[successor_offset[size]];
+  auto *predecessor = new (context) unsigned[predecessor_offset[size]];
+
+  llvm::SmallVector<uint32_t, 32> filled(predecessor_offset,
+                                         predecessor_offset + size);
+  for (unsigned index = 0; index < size; ++index) {
+    const block &block = blocks_[index];
+    std::copy(block.statements.begin(), block.statements.end(),
+              statement + statement_offset[index]);
+    std::copy(block.successors.begin(), block.successors.end(),
+              successor + successor_offset[index]);
+    for (const unsigned target : block.successors)
+      predecessor[filled[target]++] = index;
+  }
+
+  statement_offsets = statement_offset;
+  statements = statement;
+  terminators = terminator;
+  successor_offsets = successor_offset;
+  successors = successor;
+  predecessor_offsets = predecessor_offset;
+  predecessors = predecessor;
+}
+}
+
+namespace swift::semantic {
+constexpr unsigned control_flow_graph::entry;
+constexpr unsigned control_flow_graph::exit;
+
+control_flow_graph::control_flow_graph(ast::context &context,
+                                       const ast::statement *body) {
+  builder(body).flatten(context, size_, statement_offsets_, statements_,
+                        terminators_, successor_offsets_, successors_,
+                        predecessor_offsets_, predecessors_);
+}
+}
@@ -0,0 +1,103 @@
+/**
+ * Copyright © 2014 Saleem Abdulrasool <compnerd@compnerd.org>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+
+
+#include "swift/semantic/dataflow.hh"
+#include "swift/semantic/control_flow_graph.hh"
+
+#include <algorithm>
+
+namespace swift::semantic {
+dataflow::dataflow(const control_flow_graph &graph, unsigned facts,
+                   enum direction direction, enum meet meet)
+    : graph_(graph), facts_(facts), direction_(direction), meet_(meet),
+      transfers_(graph.size()) {}
+
+std::vector<llvm::BitVector>
+dataflow::solve(const llvm::BitVector &boundary) const {
+  const unsigned size = graph_.size();
+  const bool forward = direction_ == direction::forward;
+  const unsigned start =
+      forward ? control_flow_graph::entry : control_flow_graph::exit;
+
+  // NOTE(compnerd) the blocks are visited in layout order (or its reverse),
+  // but with the exit last (or first), so that it is not revisited as each of
+  // its (potentially many) predecessors is solved
+  std::vector<unsigned> order, position(size);
+  order.reserve(size);
+  order.push_back(control_flow_graph::entry);
+  for (unsigned block = control_flow_graph::exit + 1; block < size; ++block)
+    order.push_back(block);
+  order.push_back(control_flow_graph::exit);
+  if (not forward)
+    std::reverse(order.begin(), order.end());
+  for (unsigned index = 0; index < size; ++index)
+    position[order[index]] = index;
+
+  // the facts start at the top of the lattice and only descend
+  const llvm::BitVector top(facts_, meet_ == meet::all_paths);
+  std::vector<llvm::BitVector> in(size, top), out(size, top);
+
+  llvm::BitVector pending(size, true);
+  for (int next = pending.find_first(); next != -1;
+       next = pending.find_first()) {
+    pending.reset(next);
+    const unsigned block = order[next];
+
+    const llvm::ArrayRef<unsigned> sources =
+        forward ? graph_.predecessors(block) : graph_.successors(block);
+    llvm::BitVector facts = block == start ? boundary : top;
+    if (block != start and not sources.empty()) {
+      facts = out[sources.front()];
+      for (const unsigned source : sources.drop_front())
+        if (meet_ == meet::all_paths)
+          facts &= out[source];
+        else
+          facts |= out[source];
+    }
+
+    llvm::BitVector result = facts;
+    for (const unsigned fact : transfers_[block].killed)
+      result.reset(fact);
+    for (const unsigned fact : transfers_[block].generated)
+      result.set(fact);
+    in[block] = std::move(facts);
+
+    if (result == out[block])
+      continue;
+    out[block] = std::move(result);
+
+    for (const unsigned target :
+         forward ? graph_.successors(block) : graph_.predecessors(block))
+      pending.set(position[target]);
+  }
+
+  return in;
+}
+}
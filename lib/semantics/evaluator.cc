@@ -0,0 +1,424 @@
+/**
+ * Copyright © 2014 Saleem Abdulrasool <compnerd@compnerd.org>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+
+
+#include "swift/semantic/evaluator.hh"
+#include "swift/diagnostics/diagnostics.hh"
+#include "swift/diagnostics/engine.hh"
+#include "swift/semantic/symbol_table.hh"
+#include "swift/support/error-handling.hh"
+#include "swift/syntax/context.hh"
+#include "swift/syntax/declaration.hh"
+#include "swift/syntax/declaration-context.hh"
+#include "swift/syntax/statements.hh"
+
+#include "swift/syntax/class-declaration.hh"
+#include "swift/syntax/constant-declaration.hh"
+#include "swift/syntax/enum-declaration.hh"
+#include "swift/syntax/extension-declaration.hh"
+#include "swift/syntax/function-declaration.hh"
+#include "swift/syntax/protocol-declaration.hh"
+#include "swift/syntax/struct-declaration.hh"
+#include "swift/syntax/typealias-declaration.hh"
+#include "swift/syntax/variable-declaration.hh"
+
+#include "swift/syntax/pattern.hh"
+#include "swift/syntax/pattern-tuple.hh"
+#include "swift/syntax/pattern-typed.hh"
+
+#include "swift/syntax/type-array.hh"
+#include "swift/syntax/type-dictionary.hh"
+#include "swift/syntax/type-function.hh"
+#include "swift/syntax/type-identifier.hh"
+#include "swift/syntax/type-metatype.hh"
+#include "swift/syntax/type-tuple.hh"
+
+#include <llvm/ADT/Hashing.h>
+
+#include <algorithm>
+
+using diagnostic = swift::diagnostics::diagnostic;
+
+namespace {
+using namespace swift;
+
+// The name of the type declared by `declaration`, or empty if it does not
+// declare a type.
+std::u32string_view type_name(const ast::declaration *declaration) {
+  switch (declaration->type()) {
+  case ast::declaration::type::typealias_declaration:
+    return static_cast<const ast::typealias_declaration *>(declaration)
+        ->alias();
+  case ast::declaration::type::enum_declaration:
+    return static_cast<const ast::enum_declaration *>(declaration)->name();
+  case ast::declaration::type::struct_declaration:
+    return static_cast<const ast::struct_declaration *>(declaration)->name();
+  case ast::declaration::type::class_declaration:
+    return static_cast<const ast::class_declaration *>(declaration)->name();
+  case ast::declaration::type::protocol_declaration:
+    return static_cast<const ast::protocol_declaration *>(declaration)->name();
+  default:
+    return std::u32string_view();
+  }
+}
+
+// The context of the members of the nominal type declared by `declaration`, or
+// null if it does not declare a nominal type.
+const ast::declaration_context *
+nominal_context(const ast::declaration *declaration) {
+  switch (declaration->type()) {
+  case ast::declaration::type::enum_declaration:
+    return static_cast<const ast::enum_declaration *>(declaration);
+  case ast::declaration::type::struct_declaration:
+    return static_cast<const ast::struct_declaration *>(declaration);
+  case ast::declaration::type::class_declaration:
+    return static_cast<const ast::class_declaration *>(declaration);
+  case ast::declaration::type::protocol_declaration:
+    return static_cast<const ast::protocol_declaration *>(declaration);
+  default:
+    return nullptr;
+  }
+}
+}
+
+namespace swift::semantic {
+evaluator::request evaluator::request_info::getEmptyKey() {
+  return { request_kind::interface_type,
+           llvm::DenseMapInfo<const void *>::getEmptyKey() };
+}
+
+evaluator::request evaluator::request_info::getTombstoneKey() {
+  return { request_kind::interface_type,
+           llvm::DenseMapInfo<const void *>::getTombstoneKey() };
+}
+
+unsigned evaluator::request_info::getHashValue(const request &key) {
+  return llvm::hash_combine(static_cast<unsigned>(key.kind), key.subject);
+}
+
+bool evaluator::request_info::isEqual(const request &lhs, const request &rhs) {
+  return lhs.kind == rhs.kind and lhs.subject == rhs.subject;
+}
+
+evaluator::evaluator(ast::context &ast_context,
+                     diagnostics::engine &diagnostics_engine)
+    : ast_context_(ast_context), diagnostics_engine_(diagnostics_engine) {}
+
+template <typename Compute>
+evaluator::result evaluator::evaluate(const request &key,
+                                      std::u32string_view name,
+                                      Compute compute) {
+  if (not active_.empty()) {
+    auto &dependents = dependents_[key];
+    const request &dependent = active_.back();
+    if (std::none_of(dependents.begin(), dependents.end(),
+                     [&dependent](const request &request) {
+                       return request_info::isEqual(request, dependent);
+                     }))
+      dependents.push_back(dependent);
+  }
+
+  const auto entry = results_.find(key);
+  if (entry != results_.end()) {
+    if (entry->second.complete)
+      return entry->second;
+
+    // NOTE(compnerd) the request is being evaluated further out; the cycle is
+    // broken here, and the requests on it evaluate as if this one were null
+    diagnostics_engine_.report(location(),
+                               diagnostic::err_name_references_itself)
+        << name;
+    return result();
+  }
+
+  results_[key] = result();
+  active_.push_back(key);
+  result value = compute();
+  active_.pop_back();
+
+  value.complete = true;
+  results_[key] = value;
+  return value;
+}
+
+void evaluator::invalidate(const request &key) {
+  results_.erase(key);
+
+  const auto entry = dependents_.find(key);
+  if (entry == dependents_.end())
+    return;
+
+  const llvm::SmallVector<request, 2> dependents = std::move(entry->second);
+  dependents_.erase(entry);
+  for (const auto &dependent : dependents)
+    invalidate(dependent);
+}
+
+const ast::declaration *evaluator::lookup(std::u32string_view name) {
+  for (const auto *binding =
+           symbol_table::lookup(ast_context_.identifiers().get(name));
+       binding; binding = binding->shadowed)
+    if (binding->declaration and type_name(binding->declaration) == name)
+      return binding->declaration;
+  return nullptr;
+}
+
+const type *
+evaluator::signature_type(const ast::function_declaration *function) {
+  const type *result_type = function->result_type()
+                                ? resolve(function->result_type())
+                                : ast_context_.tuple_type({});
+  if (not result_type)
+    return nullptr;
+
+  // NOTE(compnerd) a curried function returns the function of its remaining
+  // parameter clauses
+  const auto clauses = function->parameter_clauses();
+  for (auto clause = clauses.rbegin(); clause != clauses.rend(); ++clause) {
+    if ((*clause)->type() != ast::pattern::type::tuple)
+      return nullptr;
+
+    llvm::SmallVector<const type *, 4> parameters;
+    for (const auto *parameter :
+         static_cast<const ast::pattern_tuple *>(*clause)->elements()) {
+      if (parameter->type() != ast::pattern::type::typed)
+        return nullptr;
+      const type *parameter_type = resolve(
+          static_cast<const ast::pattern_typed *>(parameter)->pattern_type());
+      if (not parameter_type)
+        return nullptr;
+      parameters.push_back(parameter_type);
+    }
+
+    result_type = ast_context_.function_type(
+        ast_context_.tuple_type(parameters), result_type);
+  }
+  return result_type;
+}
+
+const type *evaluator::interface_type(const ast::declaration *declaration) {
+  const request key{ request_kind::interface_type, declaration };
+  auto compute = [&]() -> result {
+    const ast::pattern *pattern = nullptr;
+
+    switch (declaration->type()) {
+    case ast::declaration::type::typealias_declaration: {
+      const auto *typealias =
+          static_cast<const ast::typealias_declaration *>(declaration);
+      return { resolve(typealias->aliased_type()) };
+    }
+    case ast::declaration::type::function_declaration:
+      return { signature_type(
+          static_cast<const ast::function_declaration *>(declaration)) };
+    case ast::declaration::type::constant_declaration:
+      pattern =
+          static_cast<const ast::constant_declaration *>(declaration)->name();
+      break;
+    case ast::declaration::type::variable_declaration:
+      pattern =
+          static_cast<const ast::variable_declaration *>(declaration)->name();
+      break;
+    default:
+      // TODO(compnerd) model the nominal types
+      return result();
+    }
+
+    // TODO(compnerd) the type of an unannotated value is that inferred for its
+    // initializer
+    if (not pattern or pattern->type() != ast::pattern::type::typed)
+      return result();
+    return { resolve(
+        static_cast<const ast::pattern_typed *>(pattern)->pattern_type()) };
+  };
+  return static_cast<const type *>(
+      evaluate(key, type_name(declaration), compute).value);
+}
+
+llvm::ArrayRef<const ast::declaration *>
+evaluator::members(const ast::declaration_context *context) {
+  const request key{ request_kind::members, context };
+  const result members = evaluate(key, U"", [&]() -> result {
+    llvm::SmallVector<const ast::declaration *, 8> declarations;
+
+    auto append = [&declarations](const ast::statement *body) {
+      if (not body)
+        return;
+      if (body->type() == ast::statement::type::declaration) {
+        declarations.push_back(static_cast<const ast::declaration *>(body));
+        return;
+      }
+      if (body->type() != ast::statement::type::statements)
+        return;
+      for (const auto *statement :
+           static_cast<const ast::statements *>(body)->substatements())
+        if (statement->type() == ast::statement::type::declaration)
+          declarations.push_back(
+              static_cast<const ast::declaration *>(statement));
+    };
+
+    switch (context->type()) {
+    case ast::declaration_context::type::class_declaration:
+      append(static_cast<const ast::class_declaration *>(context)->body());
+      break;
+    case ast::declaration_context::type::enum_declaration:
+      for (const auto *member :
+           static_cast<const ast::enum_declaration *>(context)->members())
+        declarations.push_back(member);
+      break;
+    case ast::declaration_context::type::extension_declaration:
+      append(static_cast<const ast::extension_declaration *>(context)->body());
+      break;
+    case ast::declaration_context::type::protocol_declaration:
+      append(
+          static_cast<const ast::protocol_declaration *>(context)->members());
+      break;
+    case ast::declaration_context::type::struct_declaration:
+      append(static_cast<const ast::struct_declaration *>(context)
+                 ->declarations());
+      break;
+    case ast::declaration_context::type::source_file:
+    case ast::declaration_context::type::top_level_declaration:
+    case ast::declaration_context::type::initializer_declaration:
+    case ast::declaration_context::type::deinitializer_declaration:
+    case ast::declaration_context::type::function_declaration:
+    case ast::declaration_context::type::subscript_declaration:
+      for (const auto *declaration : *context)
+        declarations.push_back(declaration);
+      break;
+    }
+
+    auto *storage =
+        new (ast_context_) const ast::declaration *[declarations.size()];
+    std::copy(declarations.begin(), declarations.end(), storage);
+    return { storage, declarations.size() };
+  });
+  return llvm::makeArrayRef(
+      static_cast<const ast::declaration *const *>(members.value),
+      members.size);
+}
+
+const type *evaluator::resolved_type(const ast::type_identifier *identifier) {
+  const auto components = identifier->components();
+  if (components.empty())
+    return nullptr;
+
+  const request key{ request_kind::resolved_type, identifier };
+  const result resolved = evaluate(key, components.front(), [&]() -> result {
+    const ast::declaration *declaration = lookup(components.front());
+
+    // the remaining components name the members of the nominal types
+    for (auto component = std::next(components.begin());
+         declaration and component != components.end(); ++component) {
+      const ast::declaration_context *members_context =
+          nominal_context(declaration);
+      if (not members_context)
+        return result();
+
+      // NOTE(compnerd) the members are requested, although they are looked up
+      // by name, so that the type is invalidated along with them
+      (void)members(members_context);
+      const auto candidates = members_context->lookup(*component);
+      const auto member =
+          std::find_if(candidates.begin(), candidates.end(),
+                       [&component](const ast::declaration *member) {
+                         return type_name(member) == *component;
+                       });
+      declaration = member == candidates.end() ? nullptr : *member;
+    }
+
+    if (declaration)
+      return { interface_type(declaration) };
+
+    // NOTE(compnerd) the builtin types are those of the standard library, and
+    // so are shadowed by the declarations of the module
+    return { ast_context_.semantic_type(identifier) };
+  });
+  return static_cast<const type *>(resolved.value);
+}
+
+const type *evaluator::resolve(const ast::type *type) {
+  if (not type)
+    return nullptr;
+
+  switch (type->kind()) {
+  case ast::type::kind::identifier:
+    return resolved_type(static_cast<const ast::type_identifier *>(type));
+  case ast::type::kind::tuple: {
+    llvm::SmallVector<const semantic::type *, 4> elements;
+    for (const auto *element :
+         static_cast<const ast::type_tuple *>(type)->elements())
+      if (const auto *element_type = resolve(element))
+        elements.push_back(element_type);
+      else
+        return nullptr;
+    return ast_context_.tuple_type(elements);
+  }
+  case ast::type::kind::function: {
+    const auto *function = static_cast<const ast::type_function *>(type);
+    const auto *parameter_type = resolve(function->parameter_type());
+    const auto *result_type = resolve(function->return_type());
+    if (not parameter_type or not result_type)
+      return nullptr;
+    return ast_context_.function_type(parameter_type, result_type);
+  }
+  case ast::type::kind::array:
+    if (const auto *element_type = resolve(
+            static_cast<const ast::type_array *>(type)->type()))
+      return ast_context_.array_type(element_type);
+    return nullptr;
+  case ast::type::kind::dictionary: {
+    const auto *dictionary = static_cast<const ast::type_dictionary *>(type);
+    const auto *key_type = resolve(dictionary->key_type());
+    const auto *value_type = resolve(dictionary->value_type());
+    if (not key_type or not value_type)
+      return nullptr;
+    return ast_context_.dictionary_type(key_type, value_type);
+  }
+  case ast::type::kind::metatype:
+    if (const auto *instance_type = resolve(
+            static_cast<const ast::type_metatype *>(type)->type()))
+      return ast_context_.metatype_type(instance_type);
+    return nullptr;
+  case ast::type::kind::composite:
+  case ast::type::kind::inout:
+    // TODO(compnerd) model protocol compositions and inout parameters
+    return nullptr;
+  }
+
+  swift_unreachable("unhandled type kind");
+}
+
+void evaluator::invalidate_interface_type(const ast::declaration *declaration) {
+  invalidate(request{ request_kind::interface_type, declaration });
+}
+
+void evaluator::invalidate_members(const ast::declaration_context *context) {
+  invalidate(request{ request_kind::members, context });
+}
+}
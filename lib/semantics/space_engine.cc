@@ -0,0 +1,1011 @@
+/**
+ * Copyright © 2014 Saleem Abdulrasool <compnerd@compnerd.org>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+
+
+#include "swift/semantic/space_engine.hh"
+#include "swift/diagnostics/diagnostics.hh"
+#include "swift/diagnostics/engine.hh"
+#include "swift/semantic/evaluator.hh"
+#include "swift/semantic/type.hh"
+#include "swift/semantic/type_checker.hh"
+#include "swift/support/error-handling.hh"
+#include "swift/support/ucs4-support.hh"
+
+#include "swift/syntax/binary-expression.hh"
+#include "swift/syntax/boolean-literal-expression.hh"
+#include "swift/syntax/declaration-reference-expression.hh"
+#include "swift/syntax/explicit-member-expression.hh"
+#include "swift/syntax/implicit-member-expression.hh"
+#include "swift/syntax/integer-literal-expression.hh"
+#include "swift/syntax/parenthesized-expression.hh"
+#include "swift/syntax/prefix-unary-expression.hh"
+
+#include "swift/syntax/declaration-context.hh"
+#include "swift/syntax/enum-declaration.hh"
+#include "swift/syntax/enumeration-element-declaration.hh"
+
+#include "swift/syntax/pattern.hh"
+#include "swift/syntax/pattern-expression.hh"
+#include "swift/syntax/pattern-tuple.hh"
+#include "swift/syntax/pattern-typed.hh"
+#include "swift/syntax/pattern-var.hh"
+
+#include "swift/syntax/switch-statement.hh"
+
+#include <llvm/ADT/APSInt.h>
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/ADT/FoldingSet.h>
+#include <llvm/ADT/SmallPtrSet.h>
+#include <llvm/ADT/SmallVector.h>
+
+#include <algorithm>
+#include <deque>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using diagnostic = swift::diagnostics::diagnostic;
+
+namespace {
+using namespace swift;
+using semantic::builtin_type;
+
+// the number of missing cases which are spelt out when a switch is not
+// exhaustive
+constexpr size_t maximum_missing_cases = 16;
+
+enum class shape_kind { opaque, boolean, integer, enumeration, tuple };
+
+// The structure of the values of the subject (or of a component of it) as far
+// as the patterns tell them apart.  A value of an opaque shape is only matched
+// by a wildcard or a binding.
+struct shape {
+  shape_kind kind;
+  // the elements of an enumeration, in declaration order
+  const ast::enum_declaration *enumeration = nullptr;
+  llvm::SmallVector<std::u32string_view, 4> cases;
+  // the components of a tuple
+  llvm::SmallVector<const shape *, 4> elements;
+  // the least and greatest values of an integer
+  llvm::APSInt minimum;
+  llvm::APSInt maximum;
+
+  explicit shape(shape_kind kind) : kind(kind) {}
+};
+
+enum class space_kind { empty, everything, constructor, range, disjunction };
+
+// A set of values of a shape.  A constructor is an element of an enumeration,
+// a boolean value, or a tuple (over the spaces of its components).
+struct space : llvm::FoldingSetNode {
+  space_kind kind;
+  const struct shape *form;
+  // the element of an enumeration or the boolean value of a constructor
+  unsigned index;
+  // the bounds of a range, inclusive
+  llvm::APSInt lower;
+  llvm::APSInt upper;
+  // the components of a constructor or the alternatives of a disjunction
+  llvm::SmallVector<const space *, 2> elements;
+
+  space(space_kind kind, const struct shape *form, unsigned index,
+        const llvm::APSInt &lower, const llvm::APSInt &upper,
+        llvm::ArrayRef<const space *> elements)
+      : kind(kind), form(form), index(index), lower(lower), upper(upper),
+        elements(elements.begin(), elements.end()) {}
+
+  static void profile(llvm::FoldingSetNodeID &id, space_kind kind,
+                      const struct shape *form, unsigned index,
+                      const llvm::APSInt &lower, const llvm::APSInt &upper,
+                      llvm::ArrayRef<const space *> elements) {
+    id.AddInteger(static_cast<unsigned>(kind));
+    id.AddPointer(form);
+    id.AddInteger(index);
+    lower.Profile(id);
+    upper.Profile(id);
+    id.AddInteger(elements.size());
+    for (const auto *element : elements)
+      id.AddPointer(element);
+  }
+  void Profile(llvm::FoldingSetNodeID &id) const {
+    profile(id, kind, form, index, lower, upper, elements);
+  }
+};
+
+// The spaces of a switch.  The spaces are uniqued, so that equal spaces are
+// identical and the differences between them may be memoised.
+class space_table {
+  std::deque<shape> shapes_;
+  std::deque<space> spaces_;
+  llvm::FoldingSet<space> unique_;
+  const space empty_;
+
+  llvm::DenseMap<const shape *, const space *> decompositions_;
+  llvm::DenseMap<std::pair<const space *, const space *>, const space *>
+      differences_;
+
+  space_table(const space_table &) = delete;
+  space_table &operator=(const space_table &) = delete;
+
+  const space *intern(space_kind kind, const shape *form, unsigned index,
+                      const llvm::APSInt &lower, const llvm::APSInt &upper,
+                      llvm::ArrayRef<const space *> elements);
+
+public:
+  space_table()
+      : empty_(space_kind::empty, nullptr, 0, llvm::APSInt(),
+               llvm::APSInt(), {}) {}
+
+  shape *make_shape(shape_kind kind) {
+    shapes_.emplace_back(kind);
+    return &shapes_.back();
+  }
+
+  const space *empty() const {
+    return &empty_;
+  }
+  const space *everything(const shape *form);
+  const space *constructor(const shape *form, unsigned index,
+                           llvm::ArrayRef<const space *> elements = {});
+  const space *range(const shape *form, const llvm::APSInt &lower,
+                     const llvm::APSInt &upper);
+  const space *disjunction(llvm::ArrayRef<const space *> alternatives);
+
+  // the space of everything of a shape as the union of its constructors
+  const space *decompose(const space *everything);
+
+  bool disjoint(const space *lhs, const space *rhs);
+  const space *intersect(const space *lhs, const space *rhs);
+  const space *subtract(const space *lhs, const space *rhs);
+};
+
+const space *space_table::intern(space_kind kind, const shape *form,
+                                 unsigned index, const llvm::APSInt &lower,
+                                 const llvm::APSInt &upper,
+                                 llvm::ArrayRef<const space *> elements) {
+  llvm::FoldingSetNodeID id;
+  space::profile(id, kind, form, index, lower, upper, elements);
+
+  void *position;
+  if (const space *existing = unique_.FindNodeOrInsertPos(id, position))
+    return existing;
+
+  spaces_.emplace_back(kind, form, index, lower, upper, elements);
+  unique_.InsertNode(&spaces_.back(), position);
+  return &spaces_.back();
+}
+
+const space *space_table::everything(const shape *form) {
+  // NOTE(compnerd) an enumeration without elements has no values
+  if (form->kind == shape_kind::enumeration and form->cases.empty())
+    return empty();
+  return intern(space_kind::everything, form, 0, llvm::APSInt(),
+                llvm::APSInt(), {});
+}
+
+const space *
+space_table::constructor(const shape *form, unsigned index,
+                         llvm::ArrayRef<const space *> elements) {
+  for (const auto *element : elements)
+    if (element->kind == space_kind::empty)
+      return empty();
+  return intern(space_kind::constructor, form, index, llvm::APSInt(),
+                llvm::APSInt(), elements);
+}
+
+const space *space_table::range(const shape *form, const llvm::APSInt &lower,
+                                const llvm::APSInt &upper) {
+  if (upper < lower)
+    return empty();
+  return intern(space_kind::range, form, 0, lower, upper, {});
+}
+
+const space *
+space_table::disjunction(llvm::ArrayRef<const space *> alternatives) {
+  llvm::SmallVector<const space *, 8> flattened;
+  llvm::SmallPtrSet<const space *, 8> seen;
+
+  auto add = [&](const space *alternative) {
+    if (alternative->kind != space_kind::empty and
+        seen.insert(alternative).second)
+      flattened.push_back(alternative);
+  };
+
+  for (const auto *alternative : alternatives) {
+    if (alternative->kind != space_kind::disjunction) {
+      add(alternative);
+      continue;
+    }
+    for (const auto *element : alternative->elements)
+      add(element);
+  }
+
+  if (flattened.empty())
+    return empty();
+  if (flattened.size() == 1)
+    return flattened.front();
+  return intern(space_kind::disjunction, nullptr, 0, llvm::APSInt(),
+                llvm::APSInt(), flattened);
+}
+
+const space *space_table::decompose(const space *everything) {
+  assert(everything->kind == space_kind::everything && "expected everything");
+
+  const shape *form = everything->form;
+  const auto entry = decompositions_.find(form);
+  if (entry != decompositions_.end())
+    return entry->second;
+
+  const space *decomposition = everything;
+  switch (form->kind) {
+  case shape_kind::opaque:
+    break;
+  case shape_kind::boolean:
+    decomposition =
+        disjunction({ constructor(form, 0), constructor(form, 1) });
+    break;
+  case shape_kind::integer:
+    decomposition = range(form, form->minimum, form->maximum);
+    break;
+  case shape_kind::enumeration: {
+    llvm::SmallVector<const space *, 8> elements;
+    for (unsigned index = 0, count = form->cases.size(); index < count; ++index)
+      elements.push_back(constructor(form, index));
+    decomposition = disjunction(elements);
+    break;
+  }
+  case shape_kind::tuple: {
+    llvm::SmallVector<const space *, 4> components;
+    for (const auto *element : form->elements)
+      components.push_back(this->everything(element));
+    decomposition = constructor(form, 0, components);
+    break;
+  }
+  }
+
+  decompositions_[form] = decomposition;
+  return decomposition;
+}
+
+bool space_table::disjoint(const space *lhs, const space *rhs) {
+  if (lhs->kind == space_kind::empty or rhs->kind == space_kind::empty)
+    return true;
+
+  if (lhs->kind == space_kind::disjunction) {
+    for (const auto *alternative : lhs->elements)
+      if (not disjoint(alternative, rhs))
+        return false;
+    return true;
+  }
+  if (rhs->kind == space_kind::disjunction)
+    return disjoint(rhs, lhs);
+
+  if (lhs->kind == space_kind::constructor and
+      rhs->kind == space_kind::constructor) {
+    if (lhs->index != rhs->index)
+      return true;
+    for (unsigned index = 0, count = lhs->elements.size(); index < count;
+         ++index)
+      if (disjoint(lhs->elements[index], rhs->elements[index]))
+        return true;
+    return false;
+  }
+
+  if (lhs->kind == space_kind::range and rhs->kind == space_kind::range)
+    return lhs->upper < rhs->lower or rhs->upper < lhs->lower;
+
+  return false;
+}
+
+const space *space_table::intersect(const space *lhs, const space *rhs) {
+  if (lhs->kind == space_kind::empty or rhs->kind == space_kind::empty)
+    return empty();
+  if (lhs == rhs or rhs->kind == space_kind::everything)
+    return lhs;
+  if (lhs->kind == space_kind::everything)
+    return rhs;
+
+  if (lhs->kind == space_kind::disjunction or
+      rhs->kind == space_kind::disjunction) {
+    const bool split_lhs = lhs->kind == space_kind::disjunction;
+    llvm::SmallVector<const space *, 8> alternatives;
+    for (const auto *alternative : (split_lhs ? lhs : rhs)->elements)
+      alternatives.push_back(split_lhs ? intersect(alternative, rhs)
+                                       : intersect(lhs, alternative));
+    return disjunction(alternatives);
+  }
+
+  if (lhs->kind == space_kind::constructor and
+      rhs->kind == space_kind::constructor) {
+    if (lhs->index != rhs->index)
+      return empty();
+    llvm::SmallVector<const space *, 4> components;
+    for (unsigned index = 0, count = lhs->elements.size(); index < count;
+         ++index)
+      components.push_back(
+          intersect(lhs->elements[index], rhs->elements[index]));
+    return constructor(lhs->form, lhs->index, components);
+  }
+
+  if (lhs->kind == space_kind::range and rhs->kind == space_kind::range)
+    return range(lhs->form, std::max(lhs->lower, rhs->lower),
+                 std::min(lhs->upper, rhs->upper));
+
+  return lhs;
+}
+
+const space *space_table::subtract(const space *lhs, const space *rhs) {
+  if (lhs->kind == space_kind::empty or rhs->kind == space_kind::empty)
+    return lhs;
+  if (lhs == rhs or rhs->kind == space_kind::everything)
+    return empty();
+
+  const auto key = std::make_pair(lhs, rhs);
+  const auto entry = differences_.find(key);
+  if (entry != differences_.end())
+    return entry->second;
+
+  const space *difference = lhs;
+  if (lhs->kind == space_kind::disjunction) {
+    llvm::SmallVector<const space *, 8> alternatives;
+    for (const auto *alternative : lhs->elements)
+      alternatives.push_back(subtract(alternative, rhs));
+    difference = disjunction(alternatives);
+  } else if (rhs->kind == space_kind::disjunction) {
+    for (const auto *alternative : rhs->elements)
+      if ((difference = subtract(difference, alternative))->kind ==
+          space_kind::empty)
+        break;
+  } else if (disjoint(lhs, rhs)) {
+    difference = lhs;
+  } else if (lhs->kind == space_kind::everything) {
+    const space *decomposition = decompose(lhs);
+    if (decomposition != lhs)
+      difference = subtract(decomposition, rhs);
+  } else if (lhs->kind == space_kind::constructor and
+             rhs->kind == space_kind::constructor) {
+    // NOTE(compnerd) the difference of the products is the union, over each
+    // component, of the products whose preceding components are in both and
+    // whose component is in the left but not the right.  The products are
+    // disjoint, and so are only as many as the components.
+    llvm::SmallVector<const space *, 4> components(lhs->elements.begin(),
+                                                   lhs->elements.end());
+    llvm::SmallVector<const space *, 4> alternatives;
+    for (unsigned index = 0, count = components.size(); index < count;
+         ++index) {
+      const space *component = components[index];
+      components[index] = subtract(component, rhs->elements[index]);
+      alternatives.push_back(constructor(lhs->form, lhs->index, components));
+      components[index] = intersect(component, rhs->elements[index]);
+    }
+    difference = disjunction(alternatives);
+  } else if (lhs->kind == space_kind::range and
+             rhs->kind == space_kind::range) {
+    llvm::SmallVector<const space *, 2> pieces;
+    if (lhs->lower < rhs->lower) {
+      llvm::APSInt upper = rhs->lower;
+      pieces.push_back(range(lhs->form, lhs->lower, --upper));
+    }
+    if (rhs->upper < lhs->upper) {
+      llvm::APSInt lower = rhs->upper;
+      pieces.push_back(range(lhs->form, ++lower, lhs->upper));
+    }
+    difference = disjunction(pieces);
+  }
+
+  differences_[key] = difference;
+  return difference;
+}
+
+// Spells out the values of `values` as patterns, one for each alternative, up
+// to `limit` of them.  The integers are not spelt out, as they are too many.
+std::vector<std::string> spell(const space *values, size_t limit) {
+  switch (values->kind) {
+  case space_kind::empty:
+    return {};
+  case space_kind::everything:
+  case space_kind::range:
+    return { "_" };
+  case space_kind::disjunction: {
+    std::vector<std::string> spellings;
+    for (const auto *alternative : values->elements) {
+      for (auto &spelling : spell(alternative, limit - spellings.size()))
+        spellings.push_back(std::move(spelling));
+      if (spellings.size() >= limit)
+        break;
+    }
+    return spellings;
+  }
+  case space_kind::constructor:
+    break;
+  }
+
+  switch (values->form->kind) {
+  case shape_kind::boolean:
+    return { values->index ? "true" : "false" };
+  case shape_kind::enumeration: {
+    std::ostringstream spelling;
+    spelling << '.' << values->form->cases[values->index];
+    return { spelling.str() };
+  }
+  case shape_kind::tuple: {
+    std::vector<std::string> prefixes{ "" };
+    for (unsigned index = 0, count = values->elements.size(); index < count;
+         ++index) {
+      std::vector<std::string> spellings;
+      const auto components = spell(values->elements[index], limit);
+      for (const auto &prefix : prefixes)
+        for (const auto &component : components)
+          if (spellings.size() < limit)
+            spellings.push_back(prefix + (index ? ", " : "") + component);
+      prefixes = std::move(spellings);
+    }
+    for (auto &prefix : prefixes)
+      prefix = "(" + prefix + ")";
+    return prefixes;
+  }
+  case shape_kind::opaque:
+  case shape_kind::integer:
+    break;
+  }
+  swift_unreachable("unexpected constructor");
+}
+
+// the pattern which `pattern` matches with, without the bindings and the type
+// annotations which match everything
+const ast::pattern *strip(const ast::pattern *pattern) {
+  for (;;) {
+    switch (pattern->type()) {
+    case ast::pattern::type::var:
+      pattern = static_cast<const ast::pattern_var *>(pattern)->pattern();
+      continue;
+    case ast::pattern::type::typed:
+      pattern = static_cast<const ast::pattern_typed *>(pattern)->pattern();
+      continue;
+    default:
+      return pattern;
+    }
+  }
+}
+
+// the expression within the parentheses of `expression`, if it has only one
+const ast::expression *strip(const ast::expression *expression) {
+  while (expression->kind() == ast::node_kind::parenthesized_expression) {
+    const auto elements =
+        static_cast<const ast::parenthesized_expression *>(expression)
+            ->elements();
+    if (elements.size() != 1)
+      break;
+    expression = elements.front();
+  }
+  return expression;
+}
+
+// Infers the shapes of the subjects of switches, and the spaces which their
+// patterns match.
+class projector {
+  semantic::evaluator &evaluator_;
+  const semantic::type_checker &type_checker_;
+  const ast::declaration_context *declaration_context_;
+  space_table &spaces_;
+
+  const shape *boolean_ = nullptr;
+  llvm::DenseMap<unsigned, const shape *> integers_;
+  llvm::DenseMap<const ast::enum_declaration *, const shape *> enumerations_;
+
+  const semantic::type *type_of(const ast::expression *expression) const;
+
+  const shape *boolean();
+  const shape *integer(builtin_type::kind kind);
+  const shape *enumeration(const ast::enum_declaration *declaration);
+  const shape *enumeration(std::u32string_view element);
+  const shape *enumeration(const ast::expression *expression);
+
+  const shape *infer(const semantic::type *type);
+  const shape *infer(const ast::pattern *pattern);
+
+  bool integer(const ast::expression *expression, const shape *form,
+               llvm::APSInt &value) const;
+
+public:
+  projector(semantic::evaluator &evaluator,
+            const semantic::type_checker &type_checker,
+            const ast::declaration_context *declaration_context,
+            space_table &spaces)
+      : evaluator_(evaluator), type_checker_(type_checker),
+        declaration_context_(declaration_context), spaces_(spaces) {}
+
+  // the shape of `subject`, if it is known, or else of the values matched by
+  // `patterns`
+  const shape *infer(const ast::expression *subject,
+                     llvm::ArrayRef<const ast::pattern *> patterns);
+
+  // the values matched by `pattern`, or null if it is not understood;
+  // `binding` is whether the pattern is within a `let` or `var` pattern
+  const space *project(const ast::pattern *pattern, const shape *form,
+                       bool binding = false);
+  const space *project(const ast::expression *expression, const shape *form);
+};
+
+const semantic::type *
+projector::type_of(const ast::expression *expression) const {
+  if (const semantic::type *type = type_checker_.type_of(expression))
+    return type;
+
+  // NOTE(compnerd) the subject is not checked on its own, and so a reference
+  // takes the type of the name that it references
+  if (expression->kind() == ast::node_kind::declaration_reference_expression)
+    if (const ast::pattern_named *binding =
+            static_cast<const ast::declaration_reference_expression *>(
+                expression)->binding())
+      return type_checker_.type_of(binding);
+  return nullptr;
+}
+
+const shape *projector::boolean() {
+  if (not boolean_)
+    boolean_ = spaces_.make_shape(shape_kind::boolean);
+  return boolean_;
+}
+
+const shape *projector::integer(builtin_type::kind kind) {
+  unsigned width;
+  switch (kind) {
+  case builtin_type::kind::sint8:
+  case builtin_type::kind::uint8:
+    width = 8;
+    break;
+  case builtin_type::kind::sint16:
+  case builtin_type::kind::uint16:
+    width = 16;
+    break;
+  case builtin_type::kind::sint32:
+  case builtin_type::kind::uint32:
+    width = 32;
+    break;
+  case builtin_type::kind::sint64:
+  case builtin_type::kind::uint64:
+    width = 64;
+    break;
+  default:
+    return nullptr;
+  }
+  const bool is_unsigned = kind >= builtin_type::kind::uint8;
+
+  const shape *&form = integers_[static_cast<unsigned>(kind)];
+  if (not form) {
+    shape *integer = spaces_.make_shape(shape_kind::integer);
+    integer->minimum = llvm::APSInt::getMinValue(width, is_unsigned);
+    integer->maximum = llvm::APSInt::getMaxValue(width, is_unsigned);
+    form = integer;
+  }
+  return form;
+}
+
+const shape *
+projector::enumeration(const ast::enum_declaration *declaration) {
+  const shape *&form = enumerations_[declaration];
+  if (not form) {
+    shape *enumeration = spaces_.make_shape(shape_kind::enumeration);
+    enumeration->enumeration = declaration;
+    for (const auto *member : evaluator_.members(declaration))
+      if (member->type() ==
+          ast::declaration::type::enumeration_element_declaration)
+        enumeration->cases.push_back(
+            static_cast<const ast::enumeration_element_declaration *>(member)
+                ->name());
+    form = enumeration;
+  }
+  return form;
+}
+
+const shape *projector::enumeration(std::u32string_view element) {
+  // NOTE(compnerd) an implicit member names an element of the enumeration
+  // which is the type of the subject, which is not inferred; the enumerations
+  // visible from the switch which have such an element are taken instead, if
+  // the innermost of them is unambiguous
+  for (const ast::declaration_context *context = declaration_context_; context;
+       context = context->is_source_file() ? nullptr : context->parent()) {
+    const ast::enum_declaration *candidate = nullptr;
+    for (const auto *member : evaluator_.members(context)) {
+      if (member->type() != ast::declaration::type::enum_declaration)
+        continue;
+      const auto *declaration =
+          static_cast<const ast::enum_declaration *>(member);
+      const auto &cases = enumeration(declaration)->cases;
+      if (std::find(cases.begin(), cases.end(), element) == cases.end())
+        continue;
+      if (candidate)
+        return nullptr;
+      candidate = declaration;
+    }
+    if (candidate)
+      return enumeration(candidate);
+  }
+  return nullptr;
+}
+
+const shape *projector::enumeration(const ast::expression *expression) {
+  switch (expression->kind()) {
+  case ast::node_kind::implicit_member_expression:
+    return enumeration(
+        static_cast<const ast::implicit_member_expression *>(expression)
+            ->name());
+  case ast::node_kind::explicit_member_expression: {
+    const ast::expression *base =
+        static_cast<const ast::explicit_member_expression *>(expression)
+            ->expression();
+    if (base->kind() != ast::node_kind::declaration_reference_expression)
+      return nullptr;
+    const ast::declaration *declaration =
+        static_cast<const ast::declaration_reference_expression *>(base)
+            ->declaration();
+    if (not declaration or
+        declaration->type() != ast::declaration::type::enum_declaration)
+      return nullptr;
+    return enumeration(
+        static_cast<const ast::enum_declaration *>(declaration));
+  }
+  default:
+    return nullptr;
+  }
+}
+
+const shape *projector::infer(const semantic::type *type) {
+  switch (type->typeclass()) {
+  case semantic::typeclass::builtin: {
+    const auto kind = static_cast<const builtin_type *>(type)->typeclass();
+    if (kind == builtin_type::kind::boolean)
+      return boolean();
+    if (const shape *form = integer(kind))
+      return form;
+    break;
+  }
+  case semantic::typeclass::tuple: {
+    shape *tuple = spaces_.make_shape(shape_kind::tuple);
+    for (const auto *element :
+         static_cast<const semantic::tuple_type *>(type)->elements())
+      tuple->elements.push_back(infer(element));
+    return tuple;
+  }
+  default:
+    break;
+  }
+  return spaces_.make_shape(shape_kind::opaque);
+}
+
+const shape *projector::infer(const ast::pattern *pattern) {
+  pattern = strip(pattern);
+  if (pattern->type() != ast::pattern::type::expression)
+    return nullptr;
+
+  const ast::expression *expression =
+      strip(static_cast<const ast::pattern_expression *>(pattern)
+                ->expression());
+  switch (expression->kind()) {
+  case ast::node_kind::boolean_literal_expression:
+    return boolean();
+  case ast::node_kind::integer_literal_expression:
+  case ast::node_kind::prefix_unary_expression:
+  case ast::node_kind::binary_expression:
+    return integer(builtin_type::kind::sint64);
+  default:
+    return enumeration(expression);
+  }
+}
+
+const shape *
+projector::infer(const ast::expression *subject,
+                 llvm::ArrayRef<const ast::pattern *> patterns) {
+  if (subject) {
+    subject = strip(subject);
+    if (const semantic::type *type = type_of(subject))
+      return infer(type);
+  }
+
+  // a tuple of subjects, or a subject whose type is not known, takes its shape
+  // from the tuple patterns
+  const auto *subjects =
+      subject and subject->kind() == ast::node_kind::parenthesized_expression
+          ? static_cast<const ast::parenthesized_expression *>(subject)
+          : nullptr;
+  for (const auto *pattern : patterns) {
+    pattern = strip(pattern);
+    if (pattern->type() != ast::pattern::type::tuple)
+      continue;
+    const auto elements =
+        static_cast<const ast::pattern_tuple *>(pattern)->elements();
+    const size_t count = std::distance(elements.begin(), elements.end());
+    if (subjects and subjects->elements().size() != count)
+      continue;
+
+    shape *tuple = spaces_.make_shape(shape_kind::tuple);
+    for (size_t index = 0; index < count; ++index) {
+      llvm::SmallVector<const ast::pattern *, 8> components;
+      for (const auto *pattern : patterns) {
+        pattern = strip(pattern);
+        if (pattern->type() != ast::pattern::type::tuple)
+          continue;
+        const auto elements =
+            static_cast<const ast::pattern_tuple *>(pattern)->elements();
+        if (static_cast<size_t>(std::distance(elements.begin(),
+                                              elements.end())) == count)
+          components.push_back(*std::next(elements.begin(), index));
+      }
+      tuple->elements.push_back(
+          infer(subjects ? subjects->elements()[index] : nullptr, components));
+    }
+    return tuple;
+  }
+
+  for (const auto *pattern : patterns)
+    if (const shape *form = infer(pattern))
+      return form;
+  return spaces_.make_shape(shape_kind::opaque);
+}
+
+bool projector::integer(const ast::expression *expression, const shape *form,
+                        llvm::APSInt &value) const {
+  bool negative = false;
+  if (expression->kind() == ast::node_kind::prefix_unary_expression) {
+    const auto *prefix =
+        static_cast<const ast::prefix_unary_expression *>(expression);
+    const ast::expression *op = prefix->prefix_operator();
+    if (op->kind() != ast::node_kind::declaration_reference_expression or
+        static_cast<const ast::declaration_reference_expression *>(op)
+                ->name() != U"-")
+      return false;
+    negative = true;
+    expression = prefix->subexpression();
+  }
+  if (expression->kind() != ast::node_kind::integer_literal_expression)
+    return false;
+
+  const llvm::APSInt &magnitude =
+      static_cast<const ast::integer_literal_expression *>(expression)
+          ->value();
+  const unsigned width = form->minimum.getBitWidth();
+  const bool is_unsigned = form->minimum.isUnsigned();
+
+  // a literal which does not fit the type is diagnosed where it is checked
+  const unsigned bits = magnitude.getActiveBits();
+  const bool fits =
+      is_unsigned ? (negative ? bits == 0 : bits <= width)
+                  : (bits < width or
+                     (negative and bits == width and magnitude.isPowerOf2()));
+  if (not fits)
+    return false;
+
+  llvm::APInt bits_of_value = magnitude.zextOrTrunc(width);
+  if (negative)
+    bits_of_value = llvm::APInt(width, 0) - bits_of_value;
+  value = llvm::APSInt(bits_of_value, is_unsigned);
+  return true;
+}
+
+const space *projector::project(const ast::pattern *pattern,
+                                const shape *form, bool binding) {
+  switch (pattern->type()) {
+  case ast::pattern::type::any:
+    return spaces_.everything(form);
+  case ast::pattern::type::named:
+    // NOTE(compnerd) outside of a `let` or `var` pattern, a name is an
+    // expression which is compared with the subject
+    return binding ? spaces_.everything(form) : nullptr;
+  case ast::pattern::type::typed:
+    return project(static_cast<const ast::pattern_typed *>(pattern)->pattern(),
+                   form, binding);
+  case ast::pattern::type::var:
+    return project(static_cast<const ast::pattern_var *>(pattern)->pattern(),
+                   form, true);
+  case ast::pattern::type::tuple: {
+    const auto elements =
+        static_cast<const ast::pattern_tuple *>(pattern)->elements();
+    if (form->kind != shape_kind::tuple or
+        static_cast<size_t>(std::distance(elements.begin(), elements.end())) !=
+            form->elements.size())
+      return nullptr;
+
+    llvm::SmallVector<const space *, 4> components;
+    for (const auto *element : elements) {
+      const space *component =
+          project(element, form->elements[components.size()], binding);
+      if (not component)
+        return nullptr;
+      components.push_back(component);
+    }
+    return spaces_.constructor(form, 0, components);
+  }
+  case ast::pattern::type::expression:
+    return project(
+        static_cast<const ast::pattern_expression *>(pattern)->expression(),
+        form);
+  }
+  swift_unreachable("unexpected pattern");
+}
+
+const space *projector::project(const ast::expression *expression,
+                                const shape *form) {
+  expression = strip(expression);
+  switch (expression->kind()) {
+  case ast::node_kind::wildcard_expression:
+    return spaces_.everything(form);
+
+  case ast::node_kind::parenthesized_expression: {
+    const auto elements =
+        static_cast<const ast::parenthesized_expression *>(expression)
+            ->elements();
+    if (form->kind != shape_kind::tuple or
+        elements.size() != form->elements.size())
+      return nullptr;
+
+    llvm::SmallVector<const space *, 4> components;
+    for (const auto *element : elements) {
+      const space *component =
+          project(element, form->elements[components.size()]);
+      if (not component)
+        return nullptr;
+      components.push_back(component);
+    }
+    return spaces_.constructor(form, 0, components);
+  }
+
+  case ast::node_kind::boolean_literal_expression:
+    if (form->kind != shape_kind::boolean)
+      return nullptr;
+    return spaces_.constructor(
+        form,
+        static_cast<const ast::boolean_literal_expression *>(expression)
+            ->value());
+
+  case ast::node_kind::integer_literal_expression:
+  case ast::node_kind::prefix_unary_expression: {
+    llvm::APSInt value;
+    if (form->kind != shape_kind::integer or
+        not integer(expression, form, value))
+      return nullptr;
+    return spaces_.range(form, value, value);
+  }
+
+  case ast::node_kind::binary_expression: {
+    const auto *binary =
+        static_cast<const ast::binary_expression *>(expression);
+    const ast::expression *op = binary->binary_operator();
+    if (form->kind != shape_kind::integer or
+        op->kind() != ast::node_kind::declaration_reference_expression)
+      return nullptr;
+
+    const std::u32string_view name =
+        static_cast<const ast::declaration_reference_expression *>(op)->name();
+    llvm::APSInt lower, upper;
+    if ((name != U"..." and name != U"..<") or
+        not integer(strip(binary->lhs()), form, lower) or
+        not integer(strip(binary->rhs()), form, upper))
+      return nullptr;
+
+    if (name == U"..<") {
+      if (upper == form->minimum)
+        return spaces_.empty();
+      --upper;
+    }
+    return spaces_.range(form, lower, upper);
+  }
+
+  case ast::node_kind::implicit_member_expression:
+  case ast::node_kind::explicit_member_expression: {
+    if (form->kind != shape_kind::enumeration or
+        enumeration(expression) != form)
+      return nullptr;
+
+    const std::u32string_view name =
+        expression->kind() == ast::node_kind::implicit_member_expression
+            ? static_cast<const ast::implicit_member_expression *>(expression)
+                  ->name()
+            : static_cast<const ast::explicit_member_expression *>(expression)
+                  ->field();
+    const auto element =
+        std::find(form->cases.begin(), form->cases.end(), name);
+    if (element == form->cases.end())
+      return nullptr;
+    return spaces_.constructor(form, element - form->cases.begin());
+  }
+
+  default:
+    return nullptr;
+  }
+}
+}
+
+namespace swift::semantic {
+space_engine::space_engine(diagnostics::engine &diagnostics_engine,
+                           semantic::evaluator &evaluator,
+                           const type_checker &type_checker,
+                           const ast::declaration_context *declaration_context)
+    : diagnostics_engine_(diagnostics_engine), evaluator_(evaluator),
+      type_checker_(type_checker), declaration_context_(declaration_context) {}
+
+bool space_engine::check(const ast::switch_statement *statement, range range,
+                         llvm::ArrayRef<swift::range> items) {
+  llvm::SmallVector<const ast::pattern *, 16> patterns;
+  llvm::SmallVector<const ast::expression *, 16> guards;
+  for (const auto &item : statement->cases())
+    for (const auto &pattern : std::get<0>(item)) {
+      patterns.push_back(std::get<0>(pattern));
+      guards.push_back(std::get<1>(pattern));
+    }
+  assert(items.size() == patterns.size() && "expected a range for each item");
+
+  space_table spaces;
+  projector projector(evaluator_, type_checker_, declaration_context_, spaces);
+
+  const shape *subject = projector.infer(statement->control_expression(),
+                                         patterns);
+  const space *remaining = spaces.everything(subject);
+  bool understood = true;
+
+  for (unsigned index = 0, count = patterns.size(); index < count; ++index) {
+    const space *matched = projector.project(patterns[index], subject);
+    if (not matched) {
+      // NOTE(compnerd) a pattern which is not understood may match anything,
+      // and so the switch may be exhaustive
+      understood = false;
+      continue;
+    }
+
+    // a case which only matches values matched by the earlier cases is never
+    // taken, even with a guard
+    if (spaces.disjoint(matched, remaining)) {
+      const bool is_default =
+          index + 1 == count and not guards[index] and
+          patterns[index]->type() == ast::pattern::type::any;
+      diagnostics_engine_.report(
+          items[index],
+          is_default ? diagnostic::warn_default_will_never_be_executed
+                     : diagnostic::warn_case_is_already_handled_by_previous_patterns);
+      continue;
+    }
+
+    if (not guards[index])
+      remaining = spaces.subtract(remaining, matched);
+  }
+
+  if (remaining->kind == space_kind::empty)
+    return true;
+  if (not understood)
+    return true;
+
+  diagnostics_engine_.report(
+      range,
+      diagnostic::err_switch_must_be_exhaustive_consider_adding_a_default_clause);
+  for (const auto &spelling : spell(remaining, maximum_missing_cases))
+    diagnostics_engine_.report(range, diagnostic::note_missing_case)
+        << spelling;
+  return false;
+}
+}
@@ -0,0 +1,91 @@
+/**
+ * Copyright © 2014 Saleem Abdulrasool <compnerd@compnerd.org>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+
+
+#include "swift/semantic/symbol_table.hh"
+#include "swift/lexer/identifier-table.hh"
+
+#include <cassert>
+
+namespace swift {
+namespace semantic {
+symbol_table::~symbol_table() {
+  // NOTE(compnerd) the identifiers outlive the table; leave them unbound
+  scopes_.assign(1, 0);
+  pop_scope();
+}
+
+void symbol_table::pop_scope() {
+  assert(not scopes_.empty() && "unbalanced scope");
+
+  const size_t mark = scopes_.back();
+  scopes_.pop_back();
+
+  while (bindings_.size() > mark) {
+    binding &innermost = bindings_.back();
+    // unbound bindings have already been unlinked from their chain
+    if (innermost.name and innermost.name->binding() == &innermost)
+      innermost.name->binding(innermost.shadowed);
+    bindings_.pop_back();
+  }
+}
+
+void symbol_table::bind(identifier_info &name, ast::declaration *declaration,
+                        const ast::pattern_named *pattern) {
+  bindings_.push_back({ &name, declaration, pattern,
+                        static_cast<binding *>(name.binding()) });
+  name.binding(&bindings_.back());
+}
+
+void symbol_table::unbind(identifier_info &name,
+                          const ast::declaration *declaration) {
+  binding *shadowing = nullptr;
+  for (binding *entry = static_cast<binding *>(name.binding()); entry;) {
+    binding *shadowed = entry->shadowed;
+    if (entry->declaration == declaration) {
+      if (shadowing)
+        shadowing->shadowed = shadowed;
+      else
+        name.binding(shadowed);
+
+      entry->name = nullptr;
+      entry->declaration = nullptr;
+      entry->pattern = nullptr;
+    } else {
+      shadowing = entry;
+    }
+    entry = shadowed;
+  }
+}
+
+const symbol_table::binding *symbol_table::lookup(const identifier_info &name) {
+  return static_cast<const binding *>(name.binding());
+}
+}
+}
@@ -0,0 +1,871 @@
+/**
+ * Copyright © 2014 Saleem Abdulrasool <compnerd@compnerd.org>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+
+
+#include "swift/semantic/type_checker.hh"
+
+#include "swift/diagnostics/diagnostics.hh"
+#include "swift/diagnostics/engine.hh"
+#include "swift/semantic/evaluator.hh"
+#include "swift/support/error-handling.hh"
+
+#include "swift/syntax/context.hh"
+
+#include "swift/syntax/expression.hh"
+#include "swift/syntax/declaration.hh"
+#include "swift/syntax/statements.hh"
+
+#include "swift/syntax/array-literal-expression.hh"
+#include "swift/syntax/assignment-expression.hh"
+#include "swift/syntax/binary-expression.hh"
+#include "swift/syntax/closure-expression.hh"
+#include "swift/syntax/conditional-expression.hh"
+#include "swift/syntax/declaration-reference-expression.hh"
+#include "swift/syntax/dictionary-literal-expression.hh"
+#include "swift/syntax/dynamic-type-expression.hh"
+#include "swift/syntax/explicit-member-expression.hh"
+#include "swift/syntax/forced-value-expression.hh"
+#include "swift/syntax/function-call-expression.hh"
+#include "swift/syntax/in-out-expression.hh"
+#include "swift/syntax/parenthesized-expression.hh"
+#include "swift/syntax/postfix-self-expression.hh"
+#include "swift/syntax/postfix-unary-expression.hh"
+#include "swift/syntax/prefix-unary-expression.hh"
+
+#include "swift/syntax/function-declaration.hh"
+
+#include "swift/syntax/pattern.hh"
+#include "swift/syntax/pattern-named.hh"
+#include "swift/syntax/pattern-tuple.hh"
+#include "swift/syntax/pattern-typed.hh"
+#include "swift/syntax/pattern-var.hh"
+
+#include <llvm/ADT/SmallVector.h>
+
+#include <algorithm>
+#include <iterator>
+
+using diagnostic = swift::diagnostics::diagnostic;
+
+namespace {
+using swift::semantic::array_type;
+using swift::semantic::dictionary_type;
+using swift::semantic::function_type;
+using swift::semantic::metatype_type;
+using swift::semantic::tuple_type;
+using swift::semantic::type;
+using swift::semantic::typeclass;
+
+// Decomposes `type` into the types from which a type of class `constructor` is
+// composed, if it is of that class.
+bool decompose(const type *type, typeclass constructor,
+               llvm::SmallVectorImpl<const swift::semantic::type *> &components) {
+  if (type->typeclass() != constructor)
+    return false;
+
+  switch (constructor) {
+  case typeclass::builtin:
+    return false;
+  case typeclass::tuple: {
+    const auto elements = static_cast<const tuple_type *>(type)->elements();
+    components.append(elements.begin(), elements.end());
+    return true;
+  }
+  case typeclass::function: {
+    const auto *function = static_cast<const function_type *>(type);
+    components.push_back(function->parameter_type());
+    components.push_back(function->result_type());
+    return true;
+  }
+  case typeclass::array:
+    components.push_back(static_cast<const array_type *>(type)->element_type());
+    return true;
+  case typeclass::dictionary: {
+    const auto *dictionary = static_cast<const dictionary_type *>(type);
+    components.push_back(dictionary->key_type());
+    components.push_back(dictionary->value_type());
+    return true;
+  }
+  case typeclass::metatype:
+    components.push_back(
+        static_cast<const metatype_type *>(type)->instance_type());
+    return true;
+  }
+  return false;
+}
+
+const type *compose(swift::ast::context &context, typeclass constructor,
+                    llvm::ArrayRef<const type *> components) {
+  switch (constructor) {
+  case typeclass::builtin:
+    break;
+  case typeclass::tuple:
+    return context.tuple_type(components);
+  case typeclass::function:
+    return context.function_type(components[0], components[1]);
+  case typeclass::array:
+    return context.array_type(components[0]);
+  case typeclass::dictionary:
+    return context.dictionary_type(components[0], components[1]);
+  case typeclass::metatype:
+    return context.metatype_type(components[0]);
+  }
+  swift_unreachable("builtin types are not composed");
+}
+}
+
+namespace swift::semantic {
+type_checker::type_checker(ast::context &ast_context,
+                           diagnostics::engine &diagnostics_engine,
+                           semantic::evaluator &evaluator, const limits &limits)
+    : ast_context_(ast_context), diagnostics_engine_(diagnostics_engine),
+      evaluator_(evaluator), limits_(limits) {
+  using kind = builtin_type::kind;
+
+  // NOTE(compnerd) Int and Double lead so that the first solution found uses
+  // the types to which the literals default
+  static const kind numeric[] = {
+    kind::sint64, kind::float64, kind::float32, kind::sint8,  kind::sint16,
+    kind::sint32, kind::uint8,   kind::uint16,  kind::uint32, kind::uint64,
+  };
+  static const kind integral[] = {
+    kind::sint64, kind::sint8,  kind::sint16, kind::sint32,
+    kind::uint8,  kind::uint16, kind::uint32, kind::uint64,
+  };
+
+  auto infix = [this](std::u32string_view name) -> std::vector<const type *> & {
+    return infix_overloads_[&ast_context_.identifiers().get(name)];
+  };
+  auto prefix = [this](std::u32string_view name) -> std::vector<const type *> & {
+    return prefix_overloads_[&ast_context_.identifiers().get(name)];
+  };
+  auto binary = [this](const type *operand, const type *result) {
+    const type *parameters[] = { operand, operand };
+    return ast_context_.function_type(ast_context_.tuple_type(parameters),
+                                      result);
+  };
+  auto unary = [this](const type *operand) {
+    return ast_context_.function_type(ast_context_.tuple_type(operand),
+                                      operand);
+  };
+
+  const type *boolean = ast_context_.builtin_type(kind::boolean);
+  const type *character = ast_context_.builtin_type(kind::character);
+  const type *string = ast_context_.builtin_type(kind::string);
+
+  for (const auto operand_kind : numeric) {
+    const type *operand = ast_context_.builtin_type(operand_kind);
+    for (const auto *name : { U"+", U"-", U"*", U"/" })
+      infix(name).push_back(binary(operand, operand));
+    for (const auto *name : { U"==", U"!=", U"<", U"<=", U">", U">=" })
+      infix(name).push_back(binary(operand, boolean));
+    for (const auto *name : { U"+", U"-" })
+      prefix(name).push_back(unary(operand));
+  }
+
+  for (const auto operand_kind : integral) {
+    const type *operand = ast_context_.builtin_type(operand_kind);
+    for (const auto *name : { U"%", U"&", U"|", U"^", U"<<", U">>" })
+      infix(name).push_back(binary(operand, operand));
+    prefix(U"~").push_back(unary(operand));
+  }
+
+  infix(U"+").push_back(binary(string, string));
+  for (const auto *name : { U"==", U"!=", U"<", U"<=", U">", U">=" })
+    infix(name).push_back(binary(string, boolean));
+  for (const auto *name : { U"==", U"!=" }) {
+    infix(name).push_back(binary(character, boolean));
+    infix(name).push_back(binary(boolean, boolean));
+  }
+  for (const auto *name : { U"&&", U"||" })
+    infix(name).push_back(binary(boolean, boolean));
+  prefix(U"!").push_back(unary(boolean));
+}
+
+type_checker::type_checker(ast::context &ast_context,
+                           diagnostics::engine &diagnostics_engine,
+                           semantic::evaluator &evaluator,
+                           const type_checker &enclosing)
+    : type_checker(ast_context, diagnostics_engine, evaluator,
+                   enclosing.limits_) {
+  enclosing_ = &enclosing;
+}
+
+/* constraint generation */
+
+unsigned type_checker::fresh(const type *binding) {
+  const unsigned index = variables_.size();
+  variables_.push_back({ index, 0, index, binding });
+  constraints_.emplace_back();
+  return index;
+}
+
+void type_checker::construct(unsigned target, typeclass constructor,
+                             llvm::ArrayRef<unsigned> operands) {
+  constraints_[target].constructions.push_back(constructions_.size());
+  constructions_.push_back({ target, constructor,
+                             static_cast<unsigned>(operands_.size()),
+                             static_cast<unsigned>(operands.size()) });
+  operands_.insert(operands_.end(), operands.begin(), operands.end());
+}
+
+void type_checker::constrain(unsigned variable, literal kind) {
+  constraints_[variable].literals.push_back(literals_.size());
+  literals_.push_back({ variable, kind });
+}
+
+unsigned type_checker::apply(unsigned function,
+                             llvm::ArrayRef<unsigned> arguments) {
+  const unsigned parameters = fresh();
+  construct(parameters, typeclass::tuple, arguments);
+
+  const unsigned result = fresh();
+  const unsigned operands[] = { parameters, result };
+  construct(function, typeclass::function, operands);
+  return result;
+}
+
+unsigned type_checker::reference(
+    const ast::expression *expression,
+    const llvm::DenseMap<const identifier_info *, std::vector<const type *>>
+        *overloads) {
+  if (expression->kind() != ast::node_kind::declaration_reference_expression)
+    return generate(expression);
+
+  const auto *reference =
+      static_cast<const ast::declaration_reference_expression *>(expression);
+  const unsigned variable = fresh();
+  expressions_.push_back({ expression, variable });
+
+  if (overloads) {
+    const auto entry =
+        overloads->find(&ast_context_.identifiers().get(reference->name()));
+    if (entry != overloads->end()) {
+      disjunctions_.push_back({ variable, entry->second });
+      return variable;
+    }
+  }
+
+  const type *declared = nullptr;
+  if (reference->binding())
+    declared = type_of(reference->binding());
+  else if (reference->declaration() and
+           reference->declaration()->type() ==
+               ast::declaration::type::function_declaration)
+    declared = evaluator_.interface_type(reference->declaration());
+  if (declared)
+    bind(variable, declared);
+  return variable;
+}
+
+unsigned type_checker::generate(const ast::expression *expression) {
+  using kind = ast::node_kind;
+
+  auto unify_or_fail = [this](unsigned lhs, unsigned rhs) {
+    if (not unify(lhs, rhs))
+      inconsistent_ = true;
+  };
+
+  unsigned variable;
+  switch (expression->kind()) {
+  case kind::declaration_reference_expression:
+    return reference(expression, nullptr);
+
+  case kind::boolean_literal_expression:
+    variable = fresh();
+    constrain(variable, literal::boolean);
+    break;
+  case kind::floating_point_literal_expression:
+    variable = fresh();
+    constrain(variable, literal::floating_point);
+    break;
+  case kind::integer_literal_expression:
+    variable = fresh();
+    constrain(variable, literal::integer);
+    break;
+  case kind::string_literal_expression:
+    variable = fresh();
+    constrain(variable, literal::string);
+    break;
+
+  case kind::array_literal_expression: {
+    const unsigned element = fresh();
+    const auto *items =
+        static_cast<const ast::array_literal_expression *>(expression)->items();
+    if (items and items->kind() == kind::parenthesized_expression)
+      for (const auto *item :
+           static_cast<const ast::parenthesized_expression *>(items)->elements())
+        unify_or_fail(element, generate(item));
+
+    variable = fresh();
+    construct(variable, typeclass::array, element);
+    break;
+  }
+  case kind::dictionary_literal_expression: {
+    const unsigned operands[] = { fresh(), fresh() };
+    const auto *items =
+        static_cast<const ast::dictionary_literal_expression *>(expression)
+            ->items();
+    if (items and items->kind() == kind::parenthesized_expression)
+      for (const auto *item :
+           static_cast<const ast::parenthesized_expression *>(items)
+               ->elements()) {
+        if (item->kind() != kind::parenthesized_expression)
+          continue;
+        const auto pair =
+            static_cast<const ast::parenthesized_expression *>(item)
+                ->elements();
+        if (pair.size() != 2)
+          continue;
+        unify_or_fail(operands[0], generate(pair[0]));
+        unify_or_fail(operands[1], generate(pair[1]));
+      }
+
+    variable = fresh();
+    construct(variable, typeclass::dictionary, operands);
+    break;
+  }
+
+  case kind::parenthesized_expression: {
+    const auto elements =
+        static_cast<const ast::parenthesized_expression *>(expression)
+            ->elements();
+    if (elements.size() == 1) {
+      variable = generate(elements.front());
+      break;
+    }
+
+    llvm::SmallVector<unsigned, 4> operands;
+    for (const auto *element : elements)
+      operands.push_back(generate(element));
+    variable = fresh();
+    construct(variable, typeclass::tuple, operands);
+    break;
+  }
+
+  case kind::binary_expression: {
+    const auto *binary =
+        static_cast<const ast::binary_expression *>(expression);
+    const unsigned operands[] = { generate(binary->lhs()),
+                                  generate(binary->rhs()) };
+    variable = apply(reference(binary->binary_operator(), &infix_overloads_),
+                     operands);
+    break;
+  }
+  case kind::prefix_unary_expression: {
+    const auto *prefix =
+        static_cast<const ast::prefix_unary_expression *>(expression);
+    const unsigned operand = generate(prefix->subexpression());
+    variable = apply(reference(prefix->prefix_operator(), &prefix_overloads_),
+                     operand);
+    break;
+  }
+  case kind::postfix_unary_expression: {
+    const auto *postfix =
+        static_cast<const ast::postfix_unary_expression *>(expression);
+    const unsigned operand = generate(postfix->subexpression());
+    variable = apply(reference(postfix->postfix_operator(), nullptr), operand);
+    break;
+  }
+  case kind::function_call_expression: {
+    const auto *call =
+        static_cast<const ast::function_call_expression *>(expression);
+    const unsigned function = generate(call->function());
+
+    llvm::SmallVector<unsigned, 4> arguments;
+    if (call->arguments()->kind() == kind::parenthesized_expression)
+      for (const auto *argument :
+           static_cast<const ast::parenthesized_expression *>(call->arguments())
+               ->elements())
+        arguments.push_back(generate(argument));
+    else
+      arguments.push_back(generate(call->arguments()));
+
+    variable = apply(function, arguments);
+    break;
+  }
+
+  case kind::assignment_expression: {
+    const auto *assignment =
+        static_cast<const ast::assignment_expression *>(expression);
+    unify_or_fail(generate(assignment->lhs()), generate(assignment->rhs()));
+    variable = fresh(ast_context_.tuple_type({}));
+    break;
+  }
+  case kind::conditional_expression: {
+    const auto *conditional =
+        static_cast<const ast::conditional_expression *>(expression);
+    if (not bind(generate(conditional->condition()),
+                 ast_context_.builtin_type(builtin_type::kind::boolean)))
+      inconsistent_ = true;
+    variable = generate(conditional->true_clause());
+    unify_or_fail(variable, generate(conditional->false_clause()));
+    break;
+  }
+
+  case kind::closure_expression: {
+    // TODO(compnerd) constrain the function type by the parameter clause
+    const auto *body =
+        static_cast<const ast::closure_expression *>(expression)->body();
+
+    unsigned result = ~0U;
+    if (body and body->kind() == kind::statements) {
+      const auto statements =
+          static_cast<const ast::statements *>(body)->substatements();
+      if (statements.size() == 1 and
+          statements.front()->kind() >= kind::first_expression and
+          statements.front()->kind() <= kind::last_expression)
+        result = generate(static_cast<const ast::expression *>(statements.front()));
+    }
+    if (result == ~0U)
+      result = fresh();
+
+    const unsigned operands[] = { fresh(), result };
+    variable = fresh();
+    construct(variable, typeclass::function, operands);
+    break;
+  }
+
+  case kind::in_out_expression:
+    generate(static_cast<const ast::in_out_expression *>(expression)
+                 ->subexpression());
+    variable = fresh();
+    break;
+  case kind::explicit_member_expression:
+    generate(static_cast<const ast::explicit_member_expression *>(expression)
+                 ->expression());
+    variable = fresh();
+    break;
+  case kind::forced_value_expression:
+    generate(static_cast<const ast::forced_value_expression *>(expression)
+                 ->expression());
+    variable = fresh();
+    break;
+  case kind::postfix_self_expression:
+    variable = generate(
+        static_cast<const ast::postfix_self_expression *>(expression)
+            ->instance());
+    break;
+  case kind::dynamic_type_expression:
+    generate(static_cast<const ast::dynamic_type_expression *>(expression)
+                 ->expression());
+    variable = fresh();
+    break;
+
+  default:
+    // TODO(compnerd) constrain the remaining expressions
+    variable = fresh();
+    break;
+  }
+
+  expressions_.push_back({ expression, variable });
+  return variable;
+}
+
+/* solution */
+
+unsigned type_checker::find(unsigned index) const {
+  while (variables_[index].parent != index)
+    index = variables_[index].parent;
+  return index;
+}
+
+void type_checker::update(unsigned index, const variable &state) {
+  trail_.push_back({ index, variables_[index] });
+  variables_[index] = state;
+}
+
+bool type_checker::unify(unsigned lhs, unsigned rhs) {
+  lhs = find(lhs);
+  rhs = find(rhs);
+  if (lhs == rhs)
+    return true;
+
+  const type *binding = variables_[lhs].binding;
+  if (const type *other = variables_[rhs].binding) {
+    if (binding and binding != other)
+      return false;
+    binding = other;
+  }
+
+  // union by rank; the trees are not compressed so that they may be rewound
+  if (variables_[lhs].rank < variables_[rhs].rank)
+    std::swap(lhs, rhs);
+
+  variable root = variables_[lhs];
+  root.binding = binding;
+  if (root.rank == variables_[rhs].rank)
+    root.rank = root.rank + 1;
+
+  variable child = variables_[rhs];
+  child.parent = lhs;
+
+  // splice the cycles of the classes together
+  std::swap(root.sibling, child.sibling);
+
+  update(rhs, child);
+  update(lhs, root);
+  return true;
+}
+
+bool type_checker::bind(unsigned index, const type *type) {
+  index = find(index);
+  if (const semantic::type *binding = variables_[index].binding)
+    return binding == type;
+
+  variable state = variables_[index];
+  state.binding = type;
+  update(index, state);
+  return true;
+}
+
+void type_checker::rewind(size_t mark) {
+  while (trail_.size() > mark) {
+    variables_[trail_.back().index] = trail_.back().state;
+    trail_.pop_back();
+  }
+}
+
+bool type_checker::admits(literal kind, const type *type) const {
+  if (type->typeclass() != typeclass::builtin)
+    return false;
+
+  switch (static_cast<const builtin_type *>(type)->typeclass()) {
+  case builtin_type::kind::boolean:
+    return kind == literal::boolean;
+  case builtin_type::kind::character:
+  case builtin_type::kind::string:
+    return kind == literal::string;
+  case builtin_type::kind::float32:
+  case builtin_type::kind::float64:
+    return kind == literal::floating_point or kind == literal::integer;
+  case builtin_type::kind::sint8:
+  case builtin_type::kind::sint16:
+  case builtin_type::kind::sint32:
+  case builtin_type::kind::sint64:
+  case builtin_type::kind::uint8:
+  case builtin_type::kind::uint16:
+  case builtin_type::kind::uint32:
+  case builtin_type::kind::uint64:
+    return kind == literal::integer;
+  case builtin_type::kind::array:
+  case builtin_type::kind::tuple:
+    return false;
+  }
+  return false;
+}
+
+const type *type_checker::default_type(literal kind) const {
+  switch (kind) {
+  case literal::boolean:
+    return ast_context_.builtin_type(builtin_type::kind::boolean);
+  case literal::floating_point:
+    return ast_context_.builtin_type(builtin_type::kind::float64);
+  case literal::integer:
+    return ast_context_.builtin_type(builtin_type::kind::sint64);
+  case literal::string:
+    return ast_context_.builtin_type(builtin_type::kind::string);
+  }
+  swift_unreachable("unknown literal kind");
+}
+
+// Charges `work` against the budget of the expression being checked,
+// returning false once it has been exhausted.
+bool type_checker::spend(unsigned work) {
+  steps_ = steps_ + work;
+  if (steps_ > limits_.solver_steps)
+    exhausted_ = true;
+  return not exhausted_;
+}
+
+// Whether binding the variable `index` to `choice` is consistent with the
+// constraints upon it, looking through the types which it is composed of.
+// A choice is not viable once the budget is exhausted.
+bool type_checker::viable(const type *choice, unsigned index, unsigned depth) {
+  if (not spend())
+    return false;
+
+  index = find(index);
+  if (const type *binding = variables_[index].binding)
+    return binding == choice;
+
+  unsigned member = index;
+  do {
+    const auto &constraints = constraints_[member];
+    member = variables_[member].sibling;
+
+    for (const unsigned position : constraints.literals)
+      if (not admits(literals_[position].kind, choice))
+        return false;
+
+    if (depth == 4)
+      continue;
+
+    for (const unsigned position : constraints.constructions) {
+      const auto &construction = constructions_[position];
+
+      llvm::SmallVector<const type *, 4> components;
+      if (not decompose(choice, construction.constructor, components) or
+          components.size() != construction.count)
+        return false;
+
+      for (unsigned operand = 0; operand < construction.count; ++operand)
+        if (not viable(components[operand],
+                       operands_[construction.operands + operand], depth + 1))
+          return false;
+    }
+  } while (member != index);
+
+  return true;
+}
+
+// Applies the constraints which do not require a choice to be made until no
+// more variables can be bound, returning false if they are contradictory.
+bool type_checker::propagate() {
+  for (;;) {
+    if (not spend(constructions_.size() + literals_.size()))
+      return false;
+
+    const size_t mark = trail_.size();
+
+    for (const auto &construction : constructions_) {
+      const auto operands = llvm::makeArrayRef(operands_).slice(
+          construction.operands, construction.count);
+      llvm::SmallVector<const type *, 4> components;
+
+      if (const type *binding = variables_[find(construction.target)].binding) {
+        if (not decompose(binding, construction.constructor, components) or
+            components.size() != operands.size())
+          return false;
+        for (unsigned operand = 0; operand < operands.size(); ++operand)
+          if (not bind(operands[operand], components[operand]))
+            return false;
+        continue;
+      }
+
+      for (const unsigned operand : operands)
+        if (const type *binding = variables_[find(operand)].binding)
+          components.push_back(binding);
+        else
+          break;
+      if (components.size() == operands.size())
+        bind(construction.target,
+             compose(ast_context_, construction.constructor, components));
+    }
+
+    for (const auto &constraint : literals_)
+      if (const type *binding = variables_[find(constraint.variable)].binding)
+        if (not admits(constraint.kind, binding))
+          return false;
+
+    for (const auto &disjunction : disjunctions_) {
+      const unsigned variable = find(disjunction.variable);
+      if (const type *binding = variables_[variable].binding) {
+        if (std::find(disjunction.choices.begin(), disjunction.choices.end(),
+                      binding) == disjunction.choices.end())
+          return false;
+        continue;
+      }
+
+      // a disjunction with a single viable choice has been decided
+      const type *decision = nullptr;
+      unsigned candidates = 0;
+      for (const type *choice : disjunction.choices)
+        if (viable(choice, variable)) {
+          decision = choice;
+          if (++candidates > 1)
+            break;
+        }
+      if (candidates == 0 or exhausted_)
+        return false;
+      if (candidates == 1)
+        bind(variable, decision);
+    }
+
+    if (trail_.size() == mark)
+      return true;
+  }
+}
+
+bool type_checker::solve() {
+  if (footprint() > limits_.memory)
+    exhausted_ = true;
+  if (not spend())
+    return false;
+
+  if (not propagate())
+    return false;
+
+  // decide the most constrained disjunction first
+  const disjunction *next = nullptr;
+  unsigned fewest = ~0U;
+  for (const auto &disjunction : disjunctions_) {
+    const unsigned variable = find(disjunction.variable);
+    if (variables_[variable].binding)
+      continue;
+
+    unsigned candidates = 0;
+    for (const type *choice : disjunction.choices)
+      if (viable(choice, variable))
+        candidates = candidates + 1;
+    if (candidates < fewest) {
+      fewest = candidates;
+      next = &disjunction;
+    }
+  }
+
+  if (not next) {
+    // default the literals which are not otherwise constrained
+    for (const auto &constraint : literals_) {
+      const unsigned variable = find(constraint.variable);
+      if (variables_[variable].binding)
+        continue;
+      bind(variable, default_type(constraint.kind));
+      if (not propagate())
+        return false;
+    }
+    return true;
+  }
+
+  const unsigned variable = find(next->variable);
+  const size_t mark = trail_.size();
+  for (const type *choice : next->choices) {
+    if (not viable(choice, variable))
+      continue;
+
+    bind(variable, choice);
+    if (solve())
+      return true;
+    rewind(mark);
+
+    if (exhausted_)
+      return false;
+  }
+  return false;
+}
+
+size_t type_checker::footprint() const {
+  return variables_.size() * sizeof(variable) +
+         constructions_.size() * sizeof(construction) +
+         operands_.size() * sizeof(unsigned) +
+         literals_.size() * sizeof(literal_constraint) +
+         constraints_.size() * sizeof(constraints) +
+         disjunctions_.size() * sizeof(disjunction) +
+         trail_.size() * sizeof(trail_entry) +
+         expressions_.size() * sizeof(expressions_.front());
+}
+
+const type *type_checker::check(const ast::expression *expression,
+                                range range, const type *contextual_type) {
+  variables_.clear();
+  constructions_.clear();
+  operands_.clear();
+  literals_.clear();
+  constraints_.clear();
+  disjunctions_.clear();
+  trail_.clear();
+  expressions_.clear();
+  inconsistent_ = false;
+  exhausted_ = false;
+  steps_ = 0;
+
+  const unsigned root = generate(expression);
+  if (contextual_type and not bind(root, contextual_type))
+    inconsistent_ = true;
+
+  if (inconsistent_ or not solve()) {
+    diagnostics_engine_.report(range,
+        exhausted_
+            ? diagnostic::err_the_compiler_is_unable_to_type_check_this_expression_in_reasonable_time
+            : diagnostic::err_cannot_find_a_consistent_type_for_the_expression);
+    return nullptr;
+  }
+
+  for (const auto &entry : expressions_)
+    if (const type *binding = variables_[find(entry.second)].binding)
+      types_[entry.first] = binding;
+  return variables_[find(root)].binding;
+}
+
+void type_checker::declare(const ast::pattern *pattern, const type *type) {
+  if (not pattern)
+    return;
+
+  switch (pattern->type()) {
+  case ast::pattern::type::named:
+    if (type)
+      bindings_[static_cast<const ast::pattern_named *>(pattern)] = type;
+    break;
+  case ast::pattern::type::typed: {
+    const auto *typed = static_cast<const ast::pattern_typed *>(pattern);
+    const semantic::type *annotated = evaluator_.resolve(typed->pattern_type());
+    declare(typed->pattern(), annotated ? annotated : type);
+    break;
+  }
+  case ast::pattern::type::var:
+    declare(static_cast<const ast::pattern_var *>(pattern)->pattern(), type);
+    break;
+  case ast::pattern::type::tuple: {
+    const auto elements =
+        static_cast<const ast::pattern_tuple *>(pattern)->elements();
+    const auto count = std::distance(elements.begin(), elements.end());
+
+    const tuple_type *tuple = nullptr;
+    if (type and type->typeclass() == typeclass::tuple and
+        static_cast<const tuple_type *>(type)->elements().size() ==
+            static_cast<size_t>(count))
+      tuple = static_cast<const tuple_type *>(type);
+
+    unsigned index = 0;
+    for (const auto *element : elements) {
+      declare(element, tuple ? tuple->elements()[index] : nullptr);
+      index = index + 1;
+    }
+    break;
+  }
+  case ast::pattern::type::any:
+  case ast::pattern::type::expression:
+    break;
+  }
+}
+
+const type *type_checker::type_of(const ast::expression *expression) const {
+  const auto entry = types_.find(expression);
+  if (entry != types_.end())
+    return entry->second;
+  return enclosing_ ? enclosing_->type_of(expression) : nullptr;
+}
+
+const type *type_checker::type_of(const ast::pattern_named *binding) const {
+  const auto entry = bindings_.find(binding);
+  if (entry != bindings_.end())
+    return entry->second;
+  return enclosing_ ? enclosing_->type_of(binding) : nullptr;
+}
+}
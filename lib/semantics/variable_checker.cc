@@ -0,0 +1,726 @@
+/**
+ * Copyright © 2014 Saleem Abdulrasool <compnerd@compnerd.org>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+
+
+#include "swift/semantic/variable_checker.hh"
+#include "swift/diagnostics/diagnostics.hh"
+#include "swift/diagnostics/engine.hh"
+#include "swift/lexer/lexer.hh"
+#include "swift/semantic/control_flow_graph.hh"
+#include "swift/semantic/dataflow.hh"
+#include "swift/syntax/context.hh"
+#include "swift/syntax/statements.hh"
+
+#include "swift/syntax/assignment-expression.hh"
+#include "swift/syntax/binary-expression.hh"
+#include "swift/syntax/array-literal-expression.hh"
+#include "swift/syntax/closure-expression.hh"
+#include "swift/syntax/conditional-expression.hh"
+#include "swift/syntax/declaration-reference-expression.hh"
+#include "swift/syntax/dictionary-literal-expression.hh"
+#include "swift/syntax/dynamic-type-expression.hh"
+#include "swift/syntax/explicit-member-expression.hh"
+#include "swift/syntax/forced-value-expression.hh"
+#include "swift/syntax/function-call-expression.hh"
+#include "swift/syntax/in-out-expression.hh"
+#include "swift/syntax/parenthesized-expression.hh"
+#include "swift/syntax/postfix-self-expression.hh"
+#include "swift/syntax/postfix-unary-expression.hh"
+#include "swift/syntax/prefix-unary-expression.hh"
+#include "swift/syntax/sequence-expression.hh"
+#include "swift/syntax/type-casting-expression.hh"
+
+#include "swift/syntax/constant-declaration.hh"
+#include "swift/syntax/function-declaration.hh"
+#include "swift/syntax/variable-declaration.hh"
+
+#include "swift/syntax/build-configuration-statement.hh"
+#include "swift/syntax/defer-statement.hh"
+#include "swift/syntax/do-statement.hh"
+#include "swift/syntax/for-in-statement.hh"
+#include "swift/syntax/for-statement.hh"
+#include "swift/syntax/guard-statement.hh"
+#include "swift/syntax/if-statement.hh"
+#include "swift/syntax/labelled-statement.hh"
+#include "swift/syntax/repeat-while-statement.hh"
+#include "swift/syntax/return-statement.hh"
+#include "swift/syntax/switch-statement.hh"
+#include "swift/syntax/throw-statement.hh"
+#include "swift/syntax/while-statement.hh"
+
+#include "swift/syntax/pattern.hh"
+#include "swift/syntax/pattern-expression.hh"
+#include "swift/syntax/pattern-named.hh"
+#include "swift/syntax/pattern-tuple.hh"
+#include "swift/syntax/pattern-typed.hh"
+#include "swift/syntax/pattern-var.hh"
+
+#include <llvm/ADT/BitVector.h>
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/ADT/SmallPtrSet.h>
+#include <llvm/ADT/SmallVector.h>
+
+#include <algorithm>
+#include <vector>
+#include <ext/string_view>
+
+using diagnostic = swift::diagnostics::diagnostic;
+
+namespace {
+using namespace swift;
+
+enum class access : uint8_t {
+  declare,    // declared without an initial value
+  initialize, // declared with an initial value
+  read,
+  assign,     // assigned a value, initialising it
+  modify,     // read and written in place
+  capture,    // referenced by a nested function
+};
+
+struct event {
+  const ast::statement *site;
+  const ast::pattern_named *binding;
+  enum access access;
+};
+
+// The names captured by a closure, in the order in which they are first
+// referenced.
+struct capture_list {
+  const ast::closure_expression *closure;
+  llvm::SmallVector<const ast::pattern_named *, 4> bindings;
+};
+
+// The name of the operator `op`, if it is a reference to one.
+std::u32string_view operator_name(const ast::expression *op) {
+  if (op->kind() != ast::node_kind::declaration_reference_expression)
+    return {};
+  return static_cast<const ast::declaration_reference_expression *>(op)
+      ->name();
+}
+
+// Whether `op` modifies its (left) operand in place, e.g. `+=` or `++`.
+bool is_modifying(std::u32string_view op) {
+  if (op == U"++" or op == U"--")
+    return true;
+  if (op.size() < 2 or op.back() != U'=')
+    return false;
+  return op != U"==" and op != U"!=" and op != U"<=" and op != U">=" and
+         op != U"===" and op != U"!==";
+}
+
+swift::range extent(const lexer &lexer, const ast::statement *statement) {
+  if (not statement->has_source_range())
+    return swift::range();
+  return swift::range(lexer.locate(statement->start_offset()),
+                      lexer.locate(statement->end_offset()));
+}
+
+// Lists the accesses to the names bound by patterns which a statement makes,
+// in the order in which it makes them.
+class scanner {
+  std::vector<event> &events_;
+  std::vector<capture_list> &captures_;
+  // the depth of the closures and nested functions being scanned
+  unsigned closures_ = 0;
+  unsigned functions_ = 0;
+
+  // the closures and nested functions being scanned, innermost last, with the
+  // names declared within each (a nested function has no capture list)
+  struct frame {
+    unsigned captures;
+    llvm::SmallPtrSet<const ast::pattern_named *, 8> declared;
+  };
+  std::vector<frame> frames_;
+  // the names declared by the body at any depth, those which are constants,
+  // and those which are written after they are declared
+  llvm::SmallPtrSet<const ast::pattern_named *, 16> declared_;
+  llvm::SmallPtrSet<const ast::pattern_named *, 16> constants_;
+  llvm::SmallPtrSet<const ast::pattern_named *, 16> written_;
+
+  void record(const ast::statement *site, const ast::pattern_named *binding,
+              enum access access);
+  void capture(const ast::statement *site, const ast::pattern_named *binding,
+               enum access access);
+  void bind(const ast::statement *site, const ast::pattern *pattern,
+            enum access access);
+  void match(const ast::pattern *pattern);
+  void store(const ast::expression *expression, enum access access);
+
+public:
+  scanner(std::vector<event> &events, std::vector<capture_list> &captures)
+      : events_(events), captures_(captures) {}
+
+  void scan(const ast::statement *statement);
+  void labels(const ast::switch_statement *statement);
+
+  // Whether `binding` may be written once it is declared.
+  bool mutated(const ast::pattern_named *binding) const {
+    return written_.count(binding) and not constants_.count(binding);
+  }
+};
+
+void scanner::record(const ast::statement *site,
+                     const ast::pattern_named *binding, enum access access) {
+  capture(site, binding, access);
+  if (closures_ or functions_) {
+    // the names declared within a nested body are not locals of this one
+    if (access == access::declare or access == access::initialize)
+      return;
+    if (functions_)
+      access = access::capture;
+    else if (access == access::assign)
+      access = access::modify;
+  }
+  events_.push_back({ site, binding, access });
+}
+
+// Adds `binding` to the capture lists of the closures being scanned which it
+// is declared outside of, as referenced by `site`.
+void scanner::capture(const ast::statement *site,
+                      const ast::pattern_named *binding, enum access access) {
+  if (access == access::declare or access == access::initialize) {
+    declared_.insert(binding);
+    if (site->kind() == ast::node_kind::constant_declaration)
+      constants_.insert(binding);
+    if (not frames_.empty())
+      frames_.back().declared.insert(binding);
+    return;
+  }
+
+  if (access != access::read)
+    written_.insert(binding);
+  if (frames_.empty())
+    return;
+
+  // NOTE(compnerd) a name which is not declared by the body is either a
+  // parameter, which is bound without a declaration, or a global, which is not
+  // captured
+  assert(site->kind() == ast::node_kind::declaration_reference_expression &&
+         "expected a reference");
+  if (static_cast<const ast::declaration_reference_expression *>(site)
+          ->declaration() and
+      not declared_.count(binding))
+    return;
+
+  for (auto frame = frames_.rbegin(); frame != frames_.rend(); ++frame) {
+    if (frame->declared.count(binding))
+      break;
+    if (frame->captures == ~0U)
+      continue;
+    auto &bindings = captures_[frame->captures].bindings;
+    if (std::find(bindings.begin(), bindings.end(), binding) == bindings.end())
+      bindings.push_back(binding);
+  }
+}
+
+// Records the names bound by `pattern` as declared by `site`.
+void scanner::bind(const ast::statement *site, const ast::pattern *pattern,
+                   enum access access) {
+  switch (pattern->type()) {
+  case ast::pattern::type::named:
+    record(site, static_cast<const ast::pattern_named *>(pattern), access);
+    break;
+  case ast::pattern::type::typed:
+    bind(site, static_cast<const ast::pattern_typed *>(pattern)->pattern(),
+         access);
+    break;
+  case ast::pattern::type::var:
+    bind(site, static_cast<const ast::pattern_var *>(pattern)->pattern(),
+         access);
+    break;
+  case ast::pattern::type::tuple:
+    for (const auto *element :
+         static_cast<const ast::pattern_tuple *>(pattern)->elements())
+      bind(site, element, access);
+    break;
+  case ast::pattern::type::any:
+  case ast::pattern::type::expression:
+    break;
+  }
+}
+
+// Records the names read by the expressions matched by `pattern`.
+void scanner::match(const ast::pattern *pattern) {
+  if (not pattern)
+    return;
+
+  switch (pattern->type()) {
+  case ast::pattern::type::expression:
+    scan(static_cast<const ast::pattern_expression *>(pattern)->expression());
+    break;
+  case ast::pattern::type::typed:
+    match(static_cast<const ast::pattern_typed *>(pattern)->pattern());
+    break;
+  case ast::pattern::type::var:
+    match(static_cast<const ast::pattern_var *>(pattern)->pattern());
+    break;
+  case ast::pattern::type::tuple:
+    for (const auto *element :
+         static_cast<const ast::pattern_tuple *>(pattern)->elements())
+      match(element);
+    break;
+  case ast::pattern::type::any:
+  case ast::pattern::type::named:
+    break;
+  }
+}
+
+// Records the names written by storing to `expression`.  Storing to a part of
+// a value (e.g. a member) modifies the whole of it.
+void scanner::store(const ast::expression *expression, enum access access) {
+  using kind = ast::node_kind;
+
+  switch (expression->kind()) {
+  case kind::declaration_reference_expression:
+    if (const auto *binding =
+            static_cast<const ast::declaration_reference_expression *>(
+                expression)->binding())
+      record(expression, binding, access);
+    return;
+  case kind::parenthesized_expression:
+    for (const auto *element :
+         static_cast<const ast::parenthesized_expression *>(expression)
+             ->elements())
+      store(element, access);
+    return;
+  case kind::explicit_member_expression:
+    return store(static_cast<const ast::explicit_member_expression *>(
+                     expression)->expression(),
+                 access::modify);
+  case kind::forced_value_expression:
+    return store(
+        static_cast<const ast::forced_value_expression *>(expression)
+            ->expression(),
+        access::modify);
+  default:
+    return scan(expression);
+  }
+}
+
+void scanner::scan(const ast::statement *statement) {
+  using kind = ast::node_kind;
+
+  if (not statement)
+    return;
+
+  switch (statement->kind()) {
+  case kind::declaration_reference_expression:
+    if (const auto *binding =
+            static_cast<const ast::declaration_reference_expression *>(
+                statement)->binding())
+      record(statement, binding, access::read);
+    return;
+
+  case kind::assignment_expression: {
+    const auto *assignment =
+        static_cast<const ast::assignment_expression *>(statement);
+    scan(assignment->rhs());
+    return store(assignment->lhs(), access::assign);
+  }
+  case kind::binary_expression: {
+    const auto *binary = static_cast<const ast::binary_expression *>(statement);
+    if (is_modifying(operator_name(binary->binary_operator()))) {
+      scan(binary->rhs());
+      return store(binary->lhs(), access::modify);
+    }
+    scan(binary->lhs());
+    return scan(binary->rhs());
+  }
+  case kind::prefix_unary_expression: {
+    const auto *prefix =
+        static_cast<const ast::prefix_unary_expression *>(statement);
+    if (is_modifying(operator_name(prefix->prefix_operator())))
+      return store(prefix->subexpression(), access::modify);
+    return scan(prefix->subexpression());
+  }
+  case kind::postfix_unary_expression: {
+    const auto *postfix =
+        static_cast<const ast::postfix_unary_expression *>(statement);
+    if (is_modifying(operator_name(postfix->postfix_operator())))
+      return store(postfix->subexpression(), access::modify);
+    return scan(postfix->subexpression());
+  }
+  case kind::in_out_expression:
+    return store(
+        static_cast<const ast::in_out_expression *>(statement)->subexpression(),
+        access::modify);
+
+  case kind::sequence_expression:
+    for (const auto *expression :
+         *static_cast<const ast::sequence_expression *>(statement))
+      scan(expression);
+    return;
+  case kind::conditional_expression: {
+    const auto *conditional =
+        static_cast<const ast::conditional_expression *>(statement);
+    scan(conditional->condition());
+    scan(conditional->true_clause());
+    return scan(conditional->false_clause());
+  }
+  case kind::parenthesized_expression:
+    for (const auto *element :
+         static_cast<const ast::parenthesized_expression *>(statement)
+             ->elements())
+      scan(element);
+    return;
+  case kind::closure_expression: {
+    const auto *closure =
+        static_cast<const ast::closure_expression *>(statement);
+    captures_.push_back({ closure, {} });
+    frames_.push_back({ static_cast<unsigned>(captures_.size() - 1), {} });
+    ++closures_;
+    // the parameters are declared by the closure, and so a reference to one
+    // (which may shadow an outer name) is not a capture
+    if (const auto *parameters = closure->parameters())
+      bind(closure, parameters, access::declare);
+    scan(closure->body());
+    --closures_;
+    frames_.pop_back();
+    return;
+  }
+  case kind::function_call_expression: {
+    // NOTE(compnerd) whether a method mutates its receiver is not yet known,
+    // and so calling one is taken to modify it
+    const auto *call =
+        static_cast<const ast::function_call_expression *>(statement);
+    if (call->function()->kind() == kind::explicit_member_expression)
+      store(call->function(), access::modify);
+    else
+      scan(call->function());
+    return scan(call->arguments());
+  }
+  case kind::explicit_member_expression:
+    return scan(static_cast<const ast::explicit_member_expression *>(statement)
+                    ->expression());
+  case kind::postfix_self_expression:
+    return scan(
+        static_cast<const ast::postfix_self_expression *>(statement)
+            ->instance());
+  case kind::dynamic_type_expression:
+    return scan(static_cast<const ast::dynamic_type_expression *>(statement)
+                    ->expression());
+  case kind::forced_value_expression:
+    return scan(static_cast<const ast::forced_value_expression *>(statement)
+                    ->expression());
+  case kind::is_subtype_expression:
+  case kind::checked_cast_expression:
+  case kind::conditional_checked_cast_expression:
+    return scan(static_cast<const ast::type_casting_expression *>(statement)
+                    ->operand());
+  case kind::array_literal_expression:
+    return scan(
+        static_cast<const ast::array_literal_expression *>(statement)->items());
+  case kind::dictionary_literal_expression:
+    return scan(static_cast<const ast::dictionary_literal_expression *>(
+                    statement)->items());
+
+  case kind::constant_declaration: {
+    const auto *constant =
+        static_cast<const ast::constant_declaration *>(statement);
+    scan(constant->initializer());
+    return bind(statement, constant->name(),
+                constant->initializer() ? access::initialize : access::declare);
+  }
+  case kind::variable_declaration: {
+    const auto *variable =
+        static_cast<const ast::variable_declaration *>(statement);
+    scan(variable->initializer());
+    return bind(statement, variable->name(),
+                variable->initializer() ? access::initialize : access::declare);
+  }
+  case kind::function_declaration: {
+    const auto *function =
+        static_cast<const ast::function_declaration *>(statement);
+    if (function->has_unparsed_body())
+      return;
+    frames_.push_back({ ~0U, {} });
+    ++functions_;
+    scan(function->body());
+    --functions_;
+    frames_.pop_back();
+    return;
+  }
+
+  // the statements of a nested body, which is not partitioned into blocks
+  case kind::statements:
+    for (const auto *substatement :
+         static_cast<const ast::statements *>(statement)->substatements())
+      scan(substatement);
+    return;
+  case kind::labelled_statement:
+    return scan(
+        static_cast<const ast::labelled_statement *>(statement)->statement());
+  case kind::defer_statement:
+    return scan(
+        static_cast<const ast::defer_statement *>(statement)->code_block());
+  case kind::do_statement: {
+    const auto *block = static_cast<const ast::do_statement *>(statement);
+    scan(block->body());
+    for (const auto &clause : block->catch_clauses()) {
+      match(std::get<0>(clause));
+      scan(std::get<1>(clause));
+    }
+    return;
+  }
+  case kind::if_statement: {
+    const auto *branch = static_cast<const ast::if_statement *>(statement);
+    scan(branch->condition());
+    scan(branch->true_clause());
+    return scan(branch->false_clause());
+  }
+  case kind::guard_statement: {
+    const auto *guard = static_cast<const ast::guard_statement *>(statement);
+    for (const auto *condition : guard->condition_clause())
+      scan(condition);
+    return scan(guard->body());
+  }
+  case kind::switch_statement: {
+    const auto *branch = static_cast<const ast::switch_statement *>(statement);
+    scan(branch->control_expression());
+    labels(branch);
+    for (const auto &item : branch->cases()) {
+      for (const auto &label : std::get<0>(item))
+        scan(std::get<1>(label));
+      scan(std::get<1>(item));
+    }
+    return;
+  }
+  case kind::for_statement: {
+    const auto *loop = static_cast<const ast::for_statement *>(statement);
+    scan(loop->initializer());
+    scan(loop->condition());
+    scan(loop->body());
+    return scan(loop->increment());
+  }
+  case kind::for_in_statement: {
+    const auto *loop = static_cast<const ast::for_in_statement *>(statement);
+    scan(loop->collection());
+    return scan(loop->body());
+  }
+  case kind::while_statement: {
+    const auto *loop = static_cast<const ast::while_statement *>(statement);
+    scan(loop->condition());
+    return scan(loop->body());
+  }
+  case kind::repeat_while_statement: {
+    const auto *loop =
+        static_cast<const ast::repeat_while_statement *>(statement);
+    scan(loop->body());
+    return scan(loop->condition());
+  }
+  case kind::return_statement:
+    return scan(static_cast<const ast::return_statement *>(statement)->value());
+  case kind::throw_statement:
+    return scan(
+        static_cast<const ast::throw_statement *>(statement)->expression());
+  case kind::build_configuration_statement: {
+    const auto *configuration =
+        static_cast<const ast::build_configuration_statement *>(statement);
+    scan(configuration->true_clause());
+    return scan(configuration->false_clause());
+  }
+
+  default:
+    return;
+  }
+}
+
+// Records the names read by the patterns of the cases of `statement`, which
+// are matched as it dispatches.
+void scanner::labels(const ast::switch_statement *statement) {
+  for (const auto &item : statement->cases())
+    for (const auto &label : std::get<0>(item))
+      match(std::get<0>(label));
+}
+}
+
+namespace swift::semantic {
+variable_checker::variable_checker(ast::context &ast_context,
+                                   diagnostics::engine &diagnostics_engine,
+                                   const lexer &lexer)
+    : ast_context_(ast_context), diagnostics_engine_(diagnostics_engine),
+      lexer_(lexer) {}
+
+void variable_checker::check(const control_flow_graph &graph) {
+  // the accesses made by block `n` span [offsets[n], offsets[n + 1])
+  std::vector<event> events;
+  std::vector<uint32_t> offsets(1, 0);
+  std::vector<capture_list> captures;
+  scanner scanner(events, captures);
+  for (unsigned block = 0; block < graph.size(); ++block) {
+    for (const auto *statement : graph.statements(block))
+      scanner.scan(statement);
+    if (const auto *terminator = graph.terminator(block))
+      if (terminator->kind() == ast::node_kind::switch_statement)
+        scanner.labels(static_cast<const ast::switch_statement *>(terminator));
+    offsets.push_back(events.size());
+  }
+
+  for (const auto &list : captures) {
+    auto *storage = new (ast_context_) ast::capture[list.bindings.size()];
+    for (unsigned index = 0; index < list.bindings.size(); ++index)
+      storage[index] = ast::capture(list.bindings[index],
+                                    scanner.mutated(list.bindings[index]));
+    // NOTE(compnerd) the captures are a property of the closure which is only
+    // known once the whole body is parsed
+    const_cast<ast::closure_expression *>(list.closure)
+        ->set_captures(llvm::makeArrayRef(storage, list.bindings.size()));
+  }
+
+  struct local {
+    const ast::statement *declaration;
+    const ast::pattern_named *binding;
+    bool initialized;
+    unsigned reads;
+    unsigned writes;
+  };
+
+  std::vector<local> locals;
+  llvm::DenseMap<const ast::pattern_named *, unsigned> ordinals;
+  for (const auto &event : events)
+    if (event.access == access::declare or event.access == access::initialize)
+      if (ordinals.insert({ event.binding, locals.size() }).second)
+        locals.push_back({ event.site, event.binding,
+                           event.access == access::initialize, 0, 0 });
+  if (locals.empty())
+    return;
+
+  // NOTE(compnerd) the names which are not locals of this body (e.g. the
+  // parameters) are always initialised, and so are not facts of the problem
+  auto ordinal = [&ordinals](const event &event) -> unsigned {
+    const auto entry = ordinals.find(event.binding);
+    return entry == ordinals.end() ? ~0U : entry->second;
+  };
+
+  dataflow initialization(graph, locals.size(), dataflow::direction::forward,
+                          dataflow::meet::all_paths);
+  llvm::DenseMap<unsigned, bool> effects;
+  for (unsigned block = 0; block < graph.size(); ++block) {
+    effects.clear();
+    for (uint32_t index = offsets[block]; index < offsets[block + 1]; ++index) {
+      const event &event = events[index];
+      const unsigned local = ordinal(event);
+      if (local == ~0U)
+        continue;
+
+      switch (event.access) {
+      case access::declare:
+        effects[local] = false;
+        break;
+      case access::initialize:
+        effects[local] = true;
+        break;
+      case access::read:
+        ++locals[local].reads;
+        break;
+      case access::assign:
+        ++locals[local].writes;
+        effects[local] = true;
+        break;
+      case access::modify:
+      case access::capture:
+        ++locals[local].reads;
+        ++locals[local].writes;
+        break;
+      }
+    }
+
+    auto &effect = initialization.effect(block);
+    for (const auto &entry : effects)
+      (entry.second ? effect.generated : effect.killed).push_back(entry.first);
+  }
+
+  const std::vector<llvm::BitVector> initialized =
+      initialization.solve(llvm::BitVector(locals.size()));
+
+  llvm::BitVector diagnosed(locals.size());
+  for (unsigned block = 0; block < graph.size(); ++block) {
+    llvm::BitVector state = initialized[block];
+    for (uint32_t index = offsets[block]; index < offsets[block + 1]; ++index) {
+      const event &event = events[index];
+      const unsigned local = ordinal(event);
+      if (local == ~0U)
+        continue;
+
+      switch (event.access) {
+      case access::declare:
+        state.reset(local);
+        break;
+      case access::initialize:
+      case access::assign:
+        state.set(local);
+        break;
+      case access::read:
+      case access::modify:
+        if (state.test(local) or diagnosed.test(local))
+          break;
+        diagnosed.set(local);
+        diagnostics_engine_.report(
+            extent(lexer_, event.site),
+            locals[local].declaration->kind() ==
+                    ast::node_kind::variable_declaration
+                ? diagnostic::err_variable_used_before_being_initialized
+                : diagnostic::err_constant_used_before_being_initialized)
+            << locals[local].binding->name();
+        break;
+      case access::capture:
+        break;
+      }
+    }
+  }
+
+  for (const auto &local : locals) {
+    const bool variable =
+        local.declaration->kind() == ast::node_kind::variable_declaration;
+
+    diagnostic::id id;
+    if (local.reads == 0 and local.writes == 0) {
+      if (variable)
+        id = local.initialized
+                 ? diagnostic::warn_initialization_of_variable_was_never_used
+                 : diagnostic::warn_variable_was_never_used;
+      else
+        id = local.initialized
+                 ? diagnostic::
+                       warn_initialization_of_immutable_value_was_never_used
+                 : diagnostic::warn_immutable_value_was_never_used;
+    } else if (variable and local.reads == 0) {
+      id = diagnostic::warn_variable_was_written_to_but_never_read;
+    } else if (variable and local.writes == 0 and local.initialized) {
+      id = diagnostic::warn_variable_was_never_mutated;
+    } else {
+      continue;
+    }
+
+    diagnostics_engine_.report(extent(lexer_, local.declaration), id)
+        << local.binding->name();
+  }
+}
+}
@@ -0,0 +1,126 @@
+/**
+ * Copyright © 2014 Saleem Abdulrasool <compnerd@compnerd.org>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+
+#include "swift/support/thread-pool.hh"
+
+#include <algorithm>
+#include <cassert>
+
+namespace swift {
+thread_pool::thread_pool(unsigned threads)
+    : queued_(0), pending_(0), next_(0), stopping_(false) {
+  threads = std::max(threads, 1u);
+
+  for (unsigned index = 0; index < threads; ++index)
+    queues_.push_back(std::make_unique<queue>());
+  for (unsigned index = 0; index < threads; ++index)
+    threads_.emplace_back([this, index]() { run(index); });
+}
+
+thread_pool::~thread_pool() {
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+    stopping_ = true;
+  }
+  available_.notify_all();
+
+  for (auto &thread : threads_)
+    thread.join();
+}
+
+void thread_pool::async(std::function<void()> task) {
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+    ++pending_;
+  }
+
+  queue &destination = *queues_[next_++ % queues_.size()];
+  {
+    std::lock_guard<std::mutex> lock(destination.lock);
+    destination.tasks.push_back(std::move(task));
+  }
+
+  // NOTE(compnerd) the task is only advertised once it has been queued so that
+  // a thread which claims it is guaranteed to find it
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+    ++queued_;
+  }
+  available_.notify_one();
+}
+
+void thread_pool::wait() {
+  std::unique_lock<std::mutex> lock(lock_);
+  idle_.wait(lock, [this]() { return pending_ == 0; });
+}
+
+bool thread_pool::pop(size_t index, std::function<void()> &task) {
+  for (size_t offset = 0, count = queues_.size(); offset < count; ++offset) {
+    queue &source = *queues_[(index + offset) % count];
+    std::lock_guard<std::mutex> lock(source.lock);
+    if (source.tasks.empty())
+      continue;
+
+    if (offset == 0) {
+      task = std::move(source.tasks.back());
+      source.tasks.pop_back();
+    } else {
+      task = std::move(source.tasks.front());
+      source.tasks.pop_front();
+    }
+    return true;
+  }
+  return false;
+}
+
+void thread_pool::run(size_t index) {
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock(lock_);
+      available_.wait(lock, [this]() { return stopping_ or queued_; });
+      if (queued_ == 0)
+        return;
+      --queued_;
+    }
+
+    // the claim above reserves a task, though another thread may briefly hold
+    // the queue that it is in
+    std::function<void()> task;
+    while (not pop(index, task))
+      std::this_thread::yield();
+
+    task();
+
+    std::lock_guard<std::mutex> lock(lock_);
+    assert(pending_ && "completed more tasks than were submitted");
+    if (--pending_ == 0)
+      idle_.notify_all();
+  }
+}
+}
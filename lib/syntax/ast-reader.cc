@@ -0,0 +1,907 @@
+/**
+ * Copyright © 2014 Saleem Abdulrasool <compnerd@compnerd.org>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+
+#include "swift/syntax/ast-reader.hh"
+#include "swift/syntax/context.hh"
+#include "swift/syntax/visitor.hh"
+
+#include "swift/syntax/pattern-any.hh"
+#include "swift/syntax/pattern-expression.hh"
+#include "swift/syntax/pattern-named.hh"
+#include "swift/syntax/pattern-tuple.hh"
+#include "swift/syntax/pattern-typed.hh"
+#include "swift/syntax/pattern-var.hh"
+
+#include "swift/syntax/type-array.hh"
+#include "swift/syntax/type-composite.hh"
+#include "swift/syntax/type-dictionary.hh"
+#include "swift/syntax/type-function.hh"
+#include "swift/syntax/type-identifier.hh"
+#include "swift/syntax/type-inout.hh"
+#include "swift/syntax/type-metatype.hh"
+#include "swift/syntax/type-tuple.hh"
+
+#include <llvm/ADT/APFloat.h>
+#include <llvm/ADT/APSInt.h>
+#include <llvm/ADT/SmallVector.h>
+
+#include <algorithm>
+#include <limits>
+
+namespace {
+uint64_t word(const uint32_t *operands) {
+  return static_cast<uint64_t>(operands[0]) |
+         static_cast<uint64_t>(operands[1]) << 32;
+}
+}
+
+namespace swift {
+namespace ast {
+std::unique_ptr<reader> reader::open(ast::context &context,
+                                     llvm::StringRef path,
+                                     ast::function_body_parser *body_parser) {
+  // NOTE(compnerd) the buffer is mapped rather than read where possible; only
+  // the pages backing the records which are materialised are touched.
+  auto buffer = llvm::MemoryBuffer::getFile(path, -1,
+                                            /*RequiresNullTerminator=*/false);
+  if (not buffer)
+    return nullptr;
+
+  std::unique_ptr<ast::reader> reader(
+      new ast::reader(context, std::move(*buffer), body_parser));
+  if (not reader->validate())
+    return nullptr;
+  return reader;
+}
+
+bool reader::validate() {
+  const char *start = buffer_->getBufferStart();
+  const uint64_t size = buffer_->getBufferSize();
+
+  if (reinterpret_cast<uintptr_t>(start) % alignof(format::header))
+    return false;
+  if (size < sizeof(format::header))
+    return false;
+
+  header_ = reinterpret_cast<const format::header *>(start);
+  if (header_->magic != format::magic or header_->version != format::version)
+    return false;
+
+  const auto aligned = [](uint64_t offset) {
+    return offset % sizeof(uint32_t) == 0;
+  };
+
+  const uint64_t records_end =
+      header_->records_offset + uint64_t(header_->records_size) * sizeof(uint32_t);
+  const uint64_t sources_end =
+      header_->sources_offset +
+      uint64_t(header_->record_count) * sizeof(format::source_range);
+  const uint64_t characters_offset =
+      header_->strings_offset +
+      uint64_t(header_->string_count) * sizeof(format::string_descriptor);
+  const uint64_t roots_end =
+      header_->roots_offset + uint64_t(header_->root_count) * sizeof(uint32_t);
+
+  if (not aligned(header_->records_offset) or
+      not aligned(header_->sources_offset) or
+      not aligned(header_->strings_offset) or
+      not aligned(header_->roots_offset))
+    return false;
+  if (header_->records_offset < sizeof(format::header) or records_end > size or
+      sources_end > size or roots_end > size)
+    return false;
+  if (characters_offset > header_->roots_offset or
+      (header_->roots_offset - characters_offset) % sizeof(char32_t))
+    return false;
+
+  records_ = reinterpret_cast<const uint32_t *>(start + header_->records_offset);
+  sources_ = reinterpret_cast<const format::source_range *>(
+      start + header_->sources_offset);
+  strings_ = reinterpret_cast<const format::string_descriptor *>(
+      start + header_->strings_offset);
+  characters_ = reinterpret_cast<const char32_t *>(start + characters_offset);
+  character_count_ =
+      (header_->roots_offset - characters_offset) / sizeof(char32_t);
+  roots_ = reinterpret_cast<const uint32_t *>(start + header_->roots_offset);
+
+  for (unsigned index = 0; index < header_->string_count; ++index)
+    if (uint64_t(strings_[index].offset) + strings_[index].length >
+        character_count_)
+      return false;
+  for (unsigned index = 0; index < header_->root_count; ++index)
+    if (roots_[index] >= header_->records_size)
+      return false;
+
+  statements_.resize(header_->root_count, nullptr);
+  string_cache_.resize(header_->string_count, nullptr);
+  return true;
+}
+
+bool reader::fetch(uint32_t position, record &record) {
+  const uint32_t header_words =
+      sizeof(format::record_header) / sizeof(uint32_t);
+
+  if (uint64_t(position) + header_words > header_->records_size) {
+    corrupt_ = true;
+    return false;
+  }
+
+  record.position = position;
+  record.header =
+      reinterpret_cast<const format::record_header *>(&records_[position]);
+  record.operands = &records_[position + header_words];
+
+  if (uint64_t(position) + header_words + record.header->operands >
+          header_->records_size or
+      record.header->index >= header_->record_count) {
+    corrupt_ = true;
+    return false;
+  }
+  return true;
+}
+
+bool reader::expect(const record &record, unsigned operands) {
+  if (record.header->operands == operands)
+    return true;
+  corrupt_ = true;
+  return false;
+}
+
+bool reader::resolve(const record &record, unsigned operand,
+                     uint32_t &position) {
+  assert(operand < record.header->operands && "operand out of range");
+
+  const int32_t offset = static_cast<int32_t>(record.operands[operand]);
+  if (offset == 0)
+    return false;
+
+  // references always point backwards, which also precludes cycles
+  if (offset > 0 or uint32_t(-int64_t(offset)) > record.position) {
+    corrupt_ = true;
+    return false;
+  }
+
+  position = record.position + offset;
+  return true;
+}
+
+std::u32string_view reader::string_operand(const record &record,
+                                           unsigned operand) {
+  assert(operand < record.header->operands && "operand out of range");
+
+  const uint32_t index = record.operands[operand];
+  if (index >= header_->string_count) {
+    corrupt_ = true;
+    return std::u32string_view();
+  }
+
+  const format::string_descriptor &descriptor = strings_[index];
+  if (string_cache_[index] == nullptr) {
+    // NOTE(compnerd) the strings are copied out as the nodes may outlive the
+    // mapping; the copy is performed once per string rather than per use.
+    char32_t *characters =
+        new (context_) char32_t[std::max<uint32_t>(descriptor.length, 1)];
+    std::copy(characters_ + descriptor.offset,
+              characters_ + descriptor.offset + descriptor.length, characters);
+    string_cache_[index] = characters;
+  }
+  return std::u32string_view(string_cache_[index], descriptor.length);
+}
+
+ast::statement *reader::statement_operand(const record &record,
+                                          unsigned operand) {
+  uint32_t position;
+  if (not resolve(record, operand, position))
+    return nullptr;
+  return read_statement(position);
+}
+
+// Reads an operand whose declarations are declared within `within`.
+ast::statement *reader::statement_operand(const record &record,
+                                          unsigned operand,
+                                          ast::declaration_context *within) {
+  ast::declaration_context *enclosing = declaration_context_;
+  declaration_context_ = within;
+  ast::statement *statement = statement_operand(record, operand);
+  declaration_context_ = enclosing;
+  return statement;
+}
+
+ast::expression *reader::expression_operand(const record &record,
+                                            unsigned operand) {
+  ast::statement *statement = statement_operand(record, operand);
+  if (statement and not isa<statement::type::expression>(statement))
+    return corrupt();
+  return static_cast<ast::expression *>(statement);
+}
+
+ast::declaration *reader::declaration_operand(const record &record,
+                                              unsigned operand) {
+  ast::statement *statement = statement_operand(record, operand);
+  if (statement and not isa<statement::type::declaration>(statement))
+    return corrupt();
+  return static_cast<ast::declaration *>(statement);
+}
+
+ast::declaration *
+reader::declaration_operand(const record &record, unsigned operand,
+                            ast::declaration_context *within) {
+  ast::statement *statement = statement_operand(record, operand, within);
+  if (statement and not isa<statement::type::declaration>(statement))
+    return corrupt();
+  return static_cast<ast::declaration *>(statement);
+}
+
+ast::pattern *reader::pattern_operand(const record &record, unsigned operand) {
+  uint32_t position;
+  if (not resolve(record, operand, position))
+    return nullptr;
+  return read_pattern(position);
+}
+
+ast::type *reader::type_operand(const record &record, unsigned operand) {
+  uint32_t position;
+  if (not resolve(record, operand, position))
+    return nullptr;
+  return read_type(position);
+}
+
+ast::statement *reader::create_statement(const record &record) {
+  const unsigned operands = record.header->operands;
+  ast::declaration_context *declaration_context = declaration_context_;
+
+  switch (record.header->kind) {
+  case format::record_kind::labelled_statement: {
+    if (not expect(record, 2))
+      return nullptr;
+    ast::statement *statement = statement_operand(record, 1);
+    if (not isa<statement::type::loop_statement>(statement))
+      return corrupt();
+    return new (context_)
+        ast::labelled_statement(string_operand(record, 0),
+                                static_cast<ast::loop_statement *>(statement));
+  }
+  case format::record_kind::defer_statement:
+    if (not expect(record, 1))
+      return nullptr;
+    return new (context_) ast::defer_statement(statement_operand(record, 0));
+  case format::record_kind::do_statement: {
+    if (operands < 1 or operands % 2 != 1)
+      return corrupt();
+    std::vector<std::tuple<ast::pattern *, ast::statement *>> catch_clauses;
+    for (unsigned operand = 1; operand < operands; operand += 2)
+      catch_clauses.emplace_back(pattern_operand(record, operand),
+                                 statement_operand(record, operand + 1));
+    return new (context_)
+        ast::do_statement(statement_operand(record, 0), catch_clauses);
+  }
+  case format::record_kind::statements: {
+    std::vector<ast::statement *> statements;
+    for (unsigned operand = 0; operand < operands; ++operand)
+      statements.push_back(statement_operand(record, operand));
+    return new (context_) ast::statements(statements);
+  }
+
+  case format::record_kind::prefix_unary_expression:
+    if (not expect(record, 2))
+      return nullptr;
+    return new (context_)
+        ast::prefix_unary_expression(expression_operand(record, 0),
+                                     expression_operand(record, 1));
+  case format::record_kind::in_out_expression:
+    if (not expect(record, 1))
+      return nullptr;
+    return new (context_) ast::in_out_expression(expression_operand(record, 0));
+  case format::record_kind::sequence_expression: {
+    std::vector<ast::expression *> expressions;
+    for (unsigned operand = 0; operand < operands; ++operand)
+      expressions.push_back(expression_operand(record, operand));
+    return new (context_) ast::sequence_expression(expressions);
+  }
+  case format::record_kind::binary_expression:
+    if (not expect(record, 3))
+      return nullptr;
+    return new (context_)
+        ast::binary_expression(expression_operand(record, 0),
+                               expression_operand(record, 1),
+                               expression_operand(record, 2));
+  case format::record_kind::assignment_expression:
+    if (not expect(record, 2))
+      return nullptr;
+    return new (context_)
+        ast::assignment_expression(expression_operand(record, 0),
+                                   expression_operand(record, 1));
+  case format::record_kind::conditional_expression:
+    if (not expect(record, 3))
+      return nullptr;
+    return new (context_)
+        ast::conditional_expression(expression_operand(record, 0),
+                                    expression_operand(record, 1),
+                                    expression_operand(record, 2));
+  case format::record_kind::declaration_reference_expression:
+    if (not expect(record, 1))
+      return nullptr;
+    return new (context_)
+        ast::declaration_reference_expression(string_operand(record, 0));
+  case format::record_kind::superclass_expression:
+    if (not expect(record, 0))
+      return nullptr;
+    return new (context_) ast::superclass_expression();
+  case format::record_kind::closure_expression:
+    if (not expect(record, 2))
+      return nullptr;
+    return new (context_)
+        ast::closure_expression(pattern_operand(record, 0),
+                                statement_operand(record, 1));
+  case format::record_kind::parenthesized_expression: {
+    std::vector<ast::expression *> elements;
+    for (unsigned operand = 0; operand < operands; ++operand)
+      elements.push_back(expression_operand(record, operand));
+    return new (context_) ast::parenthesized_expression(elements);
+  }
+  case format::record_kind::implicit_member_expression:
+    if (not expect(record, 1))
+      return nullptr;
+    return new (context_)
+        ast::implicit_member_expression(string_operand(record, 0));
+  case format::record_kind::wildcard_expression:
+    if (not expect(record, 0))
+      return nullptr;
+    return new (context_) ast::wildcard_expression();
+  case format::record_kind::postfix_unary_expression:
+    if (not expect(record, 2))
+      return nullptr;
+    return new (context_)
+        ast::postfix_unary_expression(expression_operand(record, 0),
+                                      expression_operand(record, 1));
+  case format::record_kind::function_call_expression:
+    if (not expect(record, 2))
+      return nullptr;
+    return new (context_)
+        ast::function_call_expression(expression_operand(record, 0),
+                                      expression_operand(record, 1));
+  case format::record_kind::initializer_expression:
+    if (not expect(record, 1))
+      return nullptr;
+    return new (context_)
+        ast::initializer_expression(expression_operand(record, 0));
+  case format::record_kind::explicit_member_expression:
+    if (not expect(record, 2))
+      return nullptr;
+    return new (context_)
+        ast::explicit_member_expression(expression_operand(record, 0),
+                                        string_operand(record, 1));
+  case format::record_kind::postfix_self_expression:
+    if (not expect(record, 1))
+      return nullptr;
+    return new (context_)
+        ast::postfix_self_expression(expression_operand(record, 0));
+  case format::record_kind::dynamic_type_expression:
+    if (not expect(record, 1))
+      return nullptr;
+    return new (context_)
+        ast::dynamic_type_expression(expression_operand(record, 0));
+  case format::record_kind::subscript_expression:
+    if (not expect(record, 0))
+      return nullptr;
+    return new (context_) ast::subscript_expression();
+  case format::record_kind::forced_value_expression:
+    if (not expect(record, 1))
+      return nullptr;
+    return new (context_)
+        ast::forced_value_expression(expression_operand(record, 0));
+  case format::record_kind::optional_chaining_expression:
+    if (not expect(record, 0))
+      return nullptr;
+    return new (context_) ast::optional_chaining_expression();
+  case format::record_kind::is_subtype_expression:
+  case format::record_kind::checked_cast_expression:
+  case format::record_kind::conditional_checked_cast_expression: {
+    if (not expect(record, 2))
+      return nullptr;
+    ast::type *cast_type = type_operand(record, 0);
+    ast::type_casting_expression *cast;
+    switch (record.header->kind) {
+    case format::record_kind::is_subtype_expression:
+      cast = new (context_) ast::is_subtype_expression(cast_type);
+      break;
+    case format::record_kind::checked_cast_expression:
+      cast = new (context_) ast::checked_cast_expression(cast_type);
+      break;
+    default:
+      cast = new (context_) ast::conditional_checked_cast_expression(cast_type);
+      break;
+    }
+    cast->set_operand(expression_operand(record, 1));
+    return cast;
+  }
+
+  case format::record_kind::boolean_literal_expression:
+    if (not expect(record, 1))
+      return nullptr;
+    return new (context_) ast::boolean_literal_expression(record.operands[0]);
+  case format::record_kind::floating_point_literal_expression: {
+    if (not expect(record, 4))
+      return nullptr;
+    const uint64_t words[] = { word(&record.operands[0]),
+                               word(&record.operands[2]) };
+    llvm::APFloat value(llvm::APFloat::IEEEquad, llvm::APInt(128, words));
+    return new (context_) ast::floating_point_literal_expression(value);
+  }
+  case format::record_kind::integer_literal_expression: {
+    if (operands < 2)
+      return corrupt();
+    const uint32_t bit_width = record.operands[0];
+    if (bit_width == 0 or operands != 2 + 2 * ((uint64_t(bit_width) + 63) / 64))
+      return corrupt();
+    llvm::SmallVector<uint64_t, 2> words;
+    for (unsigned operand = 2; operand < operands; operand += 2)
+      words.push_back(word(&record.operands[operand]));
+    llvm::APSInt value(llvm::APInt(bit_width, words), record.operands[1]);
+    return new (context_) ast::integer_literal_expression(value);
+  }
+  case format::record_kind::nil_literal_expression:
+    if (not expect(record, 0))
+      return nullptr;
+    return new (context_) ast::nil_literal_expression();
+  case format::record_kind::string_literal_expression:
+    if (not expect(record, 1))
+      return nullptr;
+    return new (context_)
+        ast::string_literal_expression(string_operand(record, 0));
+  case format::record_kind::array_literal_expression:
+    if (not expect(record, 1))
+      return nullptr;
+    return new (context_)
+        ast::array_literal_expression(expression_operand(record, 0));
+  case format::record_kind::dictionary_literal_expression:
+    if (not expect(record, 1))
+      return nullptr;
+    return new (context_)
+        ast::dictionary_literal_expression(expression_operand(record, 0));
+  case format::record_kind::magic_literal_expression: {
+    if (operands < 1)
+      return corrupt();
+    const auto type =
+        static_cast<enum magic_literal_expression::type>(record.operands[0]);
+    switch (type) {
+    case magic_literal_expression::type::file:
+    case magic_literal_expression::type::function:
+      if (not expect(record, 2))
+        return nullptr;
+      return new (context_)
+          ast::magic_literal_expression(type, string_operand(record, 1));
+    case magic_literal_expression::type::column:
+    case magic_literal_expression::type::line:
+      if (not expect(record, 3))
+        return nullptr;
+      return new (context_)
+          ast::magic_literal_expression(type, word(&record.operands[1]));
+    }
+    return corrupt();
+  }
+
+  case format::record_kind::import_declaration:
+    if (not expect(record, 1))
+      return nullptr;
+    return new (context_, declaration_context)
+        ast::import_declaration(declaration_context, string_operand(record, 0));
+  case format::record_kind::constant_declaration:
+    if (not expect(record, 2))
+      return nullptr;
+    return new (context_, declaration_context)
+        ast::constant_declaration(declaration_context,
+                                  pattern_operand(record, 0),
+                                  expression_operand(record, 1));
+  case format::record_kind::variable_declaration:
+    if (not expect(record, 2))
+      return nullptr;
+    return new (context_, declaration_context)
+        ast::variable_declaration(declaration_context,
+                                  pattern_operand(record, 0),
+                                  expression_operand(record, 1));
+  case format::record_kind::typealias_declaration:
+    if (not expect(record, 3))
+      return nullptr;
+    return new (context_, declaration_context)
+        ast::typealias_declaration(declaration_context,
+                                   string_operand(record, 0),
+                                   string_operand(record, 1),
+                                   type_operand(record, 2));
+  case format::record_kind::top_level_declaration:
+    if (not expect(record, 1))
+      return nullptr;
+    return new (context_, declaration_context)
+        ast::top_level_declaration(declaration_context,
+                                   statement_operand(record, 0));
+  case format::record_kind::function_declaration: {
+    if (operands < 6)
+      return corrupt();
+    std::vector<ast::pattern *> parameter_clauses;
+    for (unsigned operand = 6; operand < operands; ++operand)
+      parameter_clauses.push_back(pattern_operand(record, operand));
+    // NOTE(compnerd) the declarations are created before their members are
+    // read so that the members are declared within them, as when parsed
+    auto *function = new (context_, declaration_context)
+        ast::function_declaration(declaration_context,
+                                  string_operand(record, 0), parameter_clauses,
+                                  type_operand(record, 1), nullptr);
+    ast::statement *body = statement_operand(record, 2, function);
+    function->set_body(body);
+    const location body_location(record.operands[3], record.operands[4],
+                                 record.operands[5]);
+    if (not body and body_location.valid() and body_parser_)
+      function->set_unparsed_body(body_parser_, body_location);
+    else
+      function->set_body_location(body_location);
+    return function;
+  }
+  case format::record_kind::enum_declaration: {
+    if (operands < 1)
+      return corrupt();
+    auto *declaration = new (context_, declaration_context)
+        ast::enum_declaration(declaration_context, string_operand(record, 0),
+                              std::vector<ast::declaration *>());
+    std::vector<ast::declaration *> members;
+    for (unsigned operand = 1; operand < operands; ++operand)
+      members.push_back(declaration_operand(record, operand, declaration));
+    declaration->set_members(members);
+    return declaration;
+  }
+  case format::record_kind::struct_declaration: {
+    if (not expect(record, 2))
+      return nullptr;
+    auto *declaration = new (context_, declaration_context)
+        ast::struct_declaration(declaration_context, string_operand(record, 0),
+                                nullptr);
+    declaration->set_declarations(statement_operand(record, 1, declaration));
+    return declaration;
+  }
+  case format::record_kind::class_declaration: {
+    if (not expect(record, 2))
+      return nullptr;
+    auto *declaration = new (context_, declaration_context)
+        ast::class_declaration(declaration_context, string_operand(record, 0),
+                               nullptr);
+    declaration->set_body(statement_operand(record, 1, declaration));
+    return declaration;
+  }
+  case format::record_kind::protocol_declaration: {
+    if (not expect(record, 2))
+      return nullptr;
+    auto *declaration = new (context_, declaration_context)
+        ast::protocol_declaration(declaration_context,
+                                  string_operand(record, 0), nullptr);
+    declaration->set_members(statement_operand(record, 1, declaration));
+    return declaration;
+  }
+  case format::record_kind::initializer_declaration:
+    if (not expect(record, 2))
+      return nullptr;
+    return new (context_, declaration_context)
+        ast::initializer_declaration(declaration_context,
+                                     pattern_operand(record, 0),
+                                     statement_operand(record, 1));
+  case format::record_kind::deinitializer_declaration:
+    if (not expect(record, 1))
+      return nullptr;
+    return new (context_, declaration_context)
+        ast::deinitializer_declaration(declaration_context,
+                                       statement_operand(record, 0));
+  case format::record_kind::extension_declaration: {
+    if (operands < 2)
+      return corrupt();
+    std::vector<std::u32string_view> adopted_protocols;
+    for (unsigned operand = 2; operand < operands; ++operand)
+      adopted_protocols.push_back(string_operand(record, operand));
+    auto *declaration = new (context_, declaration_context)
+        ast::extension_declaration(declaration_context,
+                                   string_operand(record, 0),
+                                   adopted_protocols, nullptr);
+    declaration->set_body(statement_operand(record, 1, declaration));
+    return declaration;
+  }
+  case format::record_kind::subscript_declaration:
+    if (not expect(record, 4))
+      return nullptr;
+    return new (context_, declaration_context)
+        ast::subscript_declaration(declaration_context,
+                                   pattern_operand(record, 0),
+                                   type_operand(record, 1),
+                                   declaration_operand(record, 2),
+                                   declaration_operand(record, 3));
+  case format::record_kind::operator_declaration: {
+    using type = enum operator_declaration::type;
+    using associativity = enum operator_declaration::associativity;
+    if (not expect(record, 4))
+      return nullptr;
+    if (record.operands[0] > static_cast<uint32_t>(type::postfix) or
+        record.operands[2] > std::numeric_limits<uint8_t>::max() or
+        record.operands[3] > static_cast<uint32_t>(associativity::right))
+      return corrupt();
+    return new (context_, declaration_context)
+        ast::operator_declaration(
+            declaration_context, static_cast<type>(record.operands[0]),
+            string_operand(record, 1), record.operands[2],
+            static_cast<associativity>(record.operands[3]));
+  }
+  case format::record_kind::enumeration_element_declaration:
+    if (not expect(record, 1))
+      return nullptr;
+    return new (context_, declaration_context)
+        ast::enumeration_element_declaration(declaration_context,
+                                             string_operand(record, 0));
+
+  case format::record_kind::for_statement:
+    if (not expect(record, 4))
+      return nullptr;
+    return new (context_)
+        ast::for_statement(statement_operand(record, 0),
+                           expression_operand(record, 1),
+                           expression_operand(record, 2),
+                           statement_operand(record, 3));
+
+  case format::record_kind::for_in_statement:
+    if (not expect(record, 3))
+      return nullptr;
+    return new (context_)
+        ast::for_in_statement(pattern_operand(record, 0),
+                              expression_operand(record, 1),
+                              statement_operand(record, 2));
+  case format::record_kind::while_statement:
+    if (not expect(record, 2))
+      return nullptr;
+    return new (context_) ast::while_statement(statement_operand(record, 0),
+                                               statement_operand(record, 1));
+  case format::record_kind::repeat_while_statement:
+    if (not expect(record, 2))
+      return nullptr;
+    return new (context_)
+        ast::repeat_while_statement(statement_operand(record, 0),
+                                    expression_operand(record, 1));
+
+  case format::record_kind::if_statement:
+    if (not expect(record, 3))
+      return nullptr;
+    return new (context_) ast::if_statement(statement_operand(record, 0),
+                                            statement_operand(record, 1),
+                                            statement_operand(record, 2));
+  case format::record_kind::guard_statement: {
+    if (operands < 1)
+      return corrupt();
+    std::vector<ast::statement *> condition_clause;
+    for (unsigned operand = 1; operand < operands; ++operand)
+      condition_clause.push_back(statement_operand(record, operand));
+    return new (context_)
+        ast::guard_statement(condition_clause, statement_operand(record, 0));
+  }
+  case format::record_kind::switch_statement: {
+    if (operands < 1)
+      return corrupt();
+    std::vector<ast::switch_statement::case_item> cases;
+    for (unsigned operand = 1; operand < operands;) {
+      const uint32_t count = record.operands[operand++];
+      if (uint64_t(operand) + 1 + 2 * uint64_t(count) > operands)
+        return corrupt();
+      ast::statement *body = statement_operand(record, operand++);
+      std::vector<std::tuple<ast::pattern *, ast::expression *>> items;
+      for (uint32_t item = 0; item < count; ++item, operand += 2)
+        items.emplace_back(pattern_operand(record, operand),
+                           expression_operand(record, operand + 1));
+      cases.emplace_back(std::move(items), body);
+    }
+    return new (context_)
+        ast::switch_statement(expression_operand(record, 0), cases);
+  }
+
+  case format::record_kind::break_statement:
+    if (not expect(record, 1))
+      return nullptr;
+    return new (context_) ast::break_statement(string_operand(record, 0));
+  case format::record_kind::continue_statement:
+    if (not expect(record, 1))
+      return nullptr;
+    return new (context_) ast::continue_statement(string_operand(record, 0));
+  case format::record_kind::return_statement:
+    if (not expect(record, 1))
+      return nullptr;
+    return new (context_) ast::return_statement(expression_operand(record, 0));
+  case format::record_kind::fallthrough_statement:
+    if (not expect(record, 0))
+      return nullptr;
+    return new (context_) ast::fallthrough_statement();
+  case format::record_kind::throw_statement:
+    if (not expect(record, 1))
+      return nullptr;
+    return new (context_) ast::throw_statement(expression_operand(record, 0));
+
+  case format::record_kind::build_configuration_statement:
+    if (not expect(record, 3))
+      return nullptr;
+    return new (context_)
+        ast::build_configuration_statement(statement_operand(record, 0),
+                                           statement_operand(record, 1),
+                                           statement_operand(record, 2));
+  case format::record_kind::line_control_statement:
+    if (not expect(record, 2))
+      return nullptr;
+    return new (context_)
+        ast::line_control_statement(string_operand(record, 0),
+                                    record.operands[1]);
+
+  default:
+    return corrupt();
+  }
+}
+
+ast::statement *reader::read_statement(uint32_t position) {
+  record record;
+  if (not fetch(position, record))
+    return nullptr;
+
+  ast::statement *statement = create_statement(record);
+  if (not statement or corrupt_)
+    return corrupt();
+
+  const format::source_range &range = sources_[record.header->index];
+  if (range.start > range.end)
+    return corrupt();
+
+  statement->set_implicit(record.header->flags & statement::implicit);
+  statement->set_invalid(record.header->flags & statement::invalid);
+  statement->set_source_range(range.start, range.end);
+  return statement;
+}
+
+ast::pattern *reader::read_pattern(uint32_t position) {
+  record record;
+  if (not fetch(position, record))
+    return nullptr;
+
+  const unsigned operands = record.header->operands;
+  ast::pattern *pattern = nullptr;
+
+  switch (record.header->kind) {
+  case format::record_kind::pattern_any:
+    if (expect(record, 0))
+      pattern = new (context_) ast::pattern_any();
+    break;
+  case format::record_kind::pattern_named:
+    if (expect(record, 2))
+      pattern = new (context_)
+          ast::pattern_named(string_operand(record, 0), record.operands[1]);
+    break;
+  case format::record_kind::pattern_tuple: {
+    std::vector<ast::pattern *> elements;
+    for (unsigned operand = 0; operand < operands; ++operand)
+      elements.push_back(pattern_operand(record, operand));
+    pattern = new (context_) ast::pattern_tuple(std::move(elements));
+    break;
+  }
+  case format::record_kind::pattern_typed:
+    if (expect(record, 2))
+      pattern = new (context_) ast::pattern_typed(pattern_operand(record, 0),
+                                                  type_operand(record, 1));
+    break;
+  case format::record_kind::pattern_var:
+    if (expect(record, 1))
+      pattern = new (context_) ast::pattern_var(pattern_operand(record, 0));
+    break;
+  case format::record_kind::pattern_expression:
+    if (expect(record, 1))
+      pattern = new (context_)
+          ast::pattern_expression(expression_operand(record, 0));
+    break;
+  default:
+    corrupt_ = true;
+    break;
+  }
+
+  return corrupt_ ? nullptr : pattern;
+}
+
+ast::type *reader::read_type(uint32_t position) {
+  record record;
+  if (not fetch(position, record))
+    return nullptr;
+
+  const unsigned operands = record.header->operands;
+  ast::type *type = nullptr;
+
+  switch (record.header->kind) {
+  case format::record_kind::type_array:
+    if (expect(record, 1))
+      type = new (context_) ast::type_array(type_operand(record, 0));
+    break;
+  case format::record_kind::type_composite: {
+    std::vector<ast::type_identifier *> protocols;
+    for (unsigned operand = 0; operand < operands; ++operand) {
+      ast::type *protocol = type_operand(record, operand);
+      if (not protocol or protocol->kind() != type::kind::identifier)
+        return corrupt();
+      protocols.push_back(static_cast<ast::type_identifier *>(protocol));
+    }
+    type = new (context_) ast::type_composite(protocols);
+    break;
+  }
+  case format::record_kind::type_dictionary:
+    if (expect(record, 2))
+      type = new (context_) ast::type_dictionary(type_operand(record, 0),
+                                                 type_operand(record, 1));
+    break;
+  case format::record_kind::type_function:
+    if (expect(record, 2))
+      type = new (context_) ast::type_function(type_operand(record, 0),
+                                               type_operand(record, 1));
+    break;
+  case format::record_kind::type_identifier: {
+    std::vector<std::u32string_view> components;
+    for (unsigned operand = 0; operand < operands; ++operand)
+      components.push_back(string_operand(record, operand));
+    type = new (context_) ast::type_identifier(components);
+    break;
+  }
+  case format::record_kind::type_inout:
+    if (expect(record, 1))
+      type = new (context_) ast::type_inout(type_operand(record, 0));
+    break;
+  case format::record_kind::type_metatype:
+    if (expect(record, 1))
+      type = new (context_) ast::type_metatype(type_operand(record, 0));
+    break;
+  case format::record_kind::type_tuple: {
+    std::vector<ast::type *> elements;
+    for (unsigned operand = 0; operand < operands; ++operand)
+      elements.push_back(type_operand(record, operand));
+    type = new (context_) ast::type_tuple(elements);
+    break;
+  }
+  default:
+    corrupt_ = true;
+    break;
+  }
+
+  return corrupt_ ? nullptr : type;
+}
+
+ast::statement *reader::statement(unsigned index) {
+  assert(index < size() && "statement index out of range");
+
+  if (statements_[index] == nullptr) {
+    corrupt_ = false;
+    declaration_context_ = context_.source_file()->declaration_context();
+    ast::statement *statement = read_statement(roots_[index]);
+    if (corrupt_)
+      return nullptr;
+    statements_[index] = statement;
+  }
+  return statements_[index];
+}
+}
+}
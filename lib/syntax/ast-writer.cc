@@ -0,0 +1,768 @@
+/**
+ * Copyright © 2014 Saleem Abdulrasool <compnerd@compnerd.org>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+
+#include "swift/syntax/ast-writer.hh"
+#include "swift/syntax/visitor.hh"
+
+#include "swift/syntax/pattern-any.hh"
+#include "swift/syntax/pattern-expression.hh"
+#include "swift/syntax/pattern-named.hh"
+#include "swift/syntax/pattern-tuple.hh"
+#include "swift/syntax/pattern-typed.hh"
+#include "swift/syntax/pattern-var.hh"
+
+#include "swift/syntax/type-array.hh"
+#include "swift/syntax/type-composite.hh"
+#include "swift/syntax/type-dictionary.hh"
+#include "swift/syntax/type-function.hh"
+#include "swift/syntax/type-identifier.hh"
+#include "swift/syntax/type-inout.hh"
+#include "swift/syntax/type-metatype.hh"
+#include "swift/syntax/type-tuple.hh"
+
+#include <llvm/ADT/SmallVector.h>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <ostream>
+
+namespace {
+template <typename Type>
+void write_raw(std::ostream &os, const Type *data, size_t count) {
+  os.write(reinterpret_cast<const char *>(data), sizeof(Type) * count);
+}
+
+void append(llvm::SmallVectorImpl<uint32_t> &operands, uint64_t value) {
+  operands.push_back(static_cast<uint32_t>(value));
+  operands.push_back(static_cast<uint32_t>(value >> 32));
+}
+
+void append(llvm::SmallVectorImpl<uint32_t> &operands, const llvm::APInt &value) {
+  for (unsigned word = 0, words = value.getNumWords(); word < words; ++word)
+    append(operands, value.getRawData()[word]);
+}
+}
+
+namespace swift {
+namespace ast {
+uint32_t writer::intern(std::u32string_view string) {
+  const auto entry = string_indices_.find(string);
+  if (entry != string_indices_.end())
+    return entry->second;
+
+  const uint32_t index = strings_.size();
+  string_indices_.emplace(string, index);
+  strings_.push_back(string);
+  return index;
+}
+
+uint32_t writer::reference(uint32_t record) const {
+  // records are written in post-order, so any record referenced is already
+  // written and precedes the record being built (which starts at the end).
+  if (record == 0)
+    return 0;
+  return static_cast<uint32_t>(static_cast<int32_t>(record - 1) -
+                               static_cast<int32_t>(records_.size()));
+}
+
+uint32_t writer::emit(format::record_kind kind, uint8_t flags,
+                      format::source_range range,
+                      llvm::ArrayRef<uint32_t> operands) {
+  if (operands.size() > std::numeric_limits<uint16_t>::max()) {
+    failed_ = true;
+    return 0;
+  }
+
+  const format::record_header header = {
+    kind, flags, static_cast<uint16_t>(operands.size()),
+    static_cast<uint32_t>(sources_.size()),
+  };
+
+  uint32_t words[sizeof(header) / sizeof(uint32_t)];
+  std::memcpy(words, &header, sizeof(header));
+
+  const uint32_t position = records_.size();
+  records_.insert(records_.end(), std::begin(words), std::end(words));
+  records_.insert(records_.end(), operands.begin(), operands.end());
+  sources_.push_back(range);
+
+  return position + 1;
+}
+
+uint32_t writer::emit(const ast::statement *statement,
+                      llvm::ArrayRef<uint32_t> operands) {
+  const uint8_t flags = (statement->is_implicit() ? statement::implicit : 0) |
+                        (statement->is_invalid() ? statement::invalid : 0);
+  return emit(static_cast<format::record_kind>(statement->kind()), flags,
+              { statement->start_offset(), statement->end_offset() }, operands);
+}
+
+uint32_t writer::emit(format::record_kind kind,
+                      llvm::ArrayRef<uint32_t> operands) {
+  return emit(kind, 0, { 0, 0 }, operands);
+}
+
+uint32_t writer::write(const ast::statement *statement) {
+  if (not statement or failed_)
+    return 0;
+
+  llvm::SmallVector<uint32_t, 8> records;
+  llvm::SmallVector<uint32_t, 8> operands;
+
+  switch (statement->kind()) {
+  case node_kind::labelled_statement: {
+    const auto *labelled =
+        static_cast<const ast::labelled_statement *>(statement);
+    const uint32_t substatement = write(labelled->statement());
+    return emit(statement,
+                { intern(labelled->label()), reference(substatement) });
+  }
+  case node_kind::defer_statement: {
+    const auto *defer = static_cast<const ast::defer_statement *>(statement);
+    const uint32_t code_block = write(defer->code_block());
+    return emit(statement, { reference(code_block) });
+  }
+  case node_kind::do_statement: {
+    const auto *block = static_cast<const ast::do_statement *>(statement);
+    const uint32_t body = write(block->body());
+    for (const auto &clause : block->catch_clauses()) {
+      records.push_back(write(std::get<0>(clause)));
+      records.push_back(write(std::get<1>(clause)));
+    }
+    operands.push_back(reference(body));
+    for (const auto record : records)
+      operands.push_back(reference(record));
+    return emit(statement, operands);
+  }
+  case node_kind::statements: {
+    const auto *block = static_cast<const ast::statements *>(statement);
+    for (const auto *substatement : block->substatements())
+      records.push_back(write(substatement));
+    for (const auto record : records)
+      operands.push_back(reference(record));
+    return emit(statement, operands);
+  }
+
+  case node_kind::prefix_unary_expression: {
+    const auto *prefix =
+        static_cast<const ast::prefix_unary_expression *>(statement);
+    const uint32_t op = write(prefix->prefix_operator());
+    const uint32_t subexpression = write(prefix->subexpression());
+    return emit(statement, { reference(op), reference(subexpression) });
+  }
+  case node_kind::in_out_expression: {
+    const auto *in_out = static_cast<const ast::in_out_expression *>(statement);
+    const uint32_t subexpression = write(in_out->subexpression());
+    return emit(statement, { reference(subexpression) });
+  }
+  case node_kind::sequence_expression: {
+    const auto *sequence =
+        static_cast<const ast::sequence_expression *>(statement);
+    for (const auto *expression : *sequence)
+      records.push_back(write(expression));
+    for (const auto record : records)
+      operands.push_back(reference(record));
+    return emit(statement, operands);
+  }
+  case node_kind::binary_expression: {
+    const auto *binary = static_cast<const ast::binary_expression *>(statement);
+    const uint32_t op = write(binary->binary_operator());
+    const uint32_t lhs = write(binary->lhs());
+    const uint32_t rhs = write(binary->rhs());
+    return emit(statement,
+                { reference(op), reference(lhs), reference(rhs) });
+  }
+  case node_kind::assignment_expression: {
+    const auto *assignment =
+        static_cast<const ast::assignment_expression *>(statement);
+    const uint32_t lhs = write(assignment->lhs());
+    const uint32_t rhs = write(assignment->rhs());
+    return emit(statement, { reference(lhs), reference(rhs) });
+  }
+  case node_kind::conditional_expression: {
+    const auto *conditional =
+        static_cast<const ast::conditional_expression *>(statement);
+    const uint32_t condition = write(conditional->condition());
+    const uint32_t true_clause = write(conditional->true_clause());
+    const uint32_t false_clause = write(conditional->false_clause());
+    return emit(statement, { reference(condition), reference(true_clause),
+                             reference(false_clause) });
+  }
+  case node_kind::declaration_reference_expression: {
+    const auto *declaration_reference =
+        static_cast<const ast::declaration_reference_expression *>(statement);
+    return emit(statement, { intern(declaration_reference->name()) });
+  }
+  case node_kind::superclass_expression:
+  case node_kind::wildcard_expression:
+  case node_kind::subscript_expression:
+  case node_kind::optional_chaining_expression:
+  case node_kind::nil_literal_expression:
+  case node_kind::fallthrough_statement:
+    return emit(statement, {});
+  case node_kind::closure_expression: {
+    const auto *closure = static_cast<const ast::closure_expression *>(statement);
+    const uint32_t parameters = write(closure->parameters());
+    const uint32_t body = write(closure->body());
+    return emit(statement, { reference(parameters), reference(body) });
+  }
+  case node_kind::parenthesized_expression: {
+    const auto *parenthesized =
+        static_cast<const ast::parenthesized_expression *>(statement);
+    for (const auto *element : parenthesized->elements())
+      records.push_back(write(element));
+    for (const auto record : records)
+      operands.push_back(reference(record));
+    return emit(statement, operands);
+  }
+  case node_kind::implicit_member_expression: {
+    const auto *member =
+        static_cast<const ast::implicit_member_expression *>(statement);
+    return emit(statement, { intern(member->name()) });
+  }
+  case node_kind::postfix_unary_expression: {
+    const auto *postfix =
+        static_cast<const ast::postfix_unary_expression *>(statement);
+    const uint32_t subexpression = write(postfix->subexpression());
+    const uint32_t op = write(postfix->postfix_operator());
+    return emit(statement, { reference(subexpression), reference(op) });
+  }
+  case node_kind::function_call_expression: {
+    const auto *call =
+        static_cast<const ast::function_call_expression *>(statement);
+    const uint32_t function = write(call->function());
+    const uint32_t arguments = write(call->arguments());
+    return emit(statement, { reference(function), reference(arguments) });
+  }
+  case node_kind::initializer_expression: {
+    const auto *initializer =
+        static_cast<const ast::initializer_expression *>(statement);
+    const uint32_t declaration = write(initializer->declaration());
+    return emit(statement, { reference(declaration) });
+  }
+  case node_kind::explicit_member_expression: {
+    const auto *member =
+        static_cast<const ast::explicit_member_expression *>(statement);
+    const uint32_t expression = write(member->expression());
+    return emit(statement, { reference(expression), intern(member->field()) });
+  }
+  case node_kind::postfix_self_expression: {
+    const auto *self =
+        static_cast<const ast::postfix_self_expression *>(statement);
+    const uint32_t instance = write(self->instance());
+    return emit(statement, { reference(instance) });
+  }
+  case node_kind::dynamic_type_expression: {
+    const auto *dynamic_type =
+        static_cast<const ast::dynamic_type_expression *>(statement);
+    const uint32_t expression = write(dynamic_type->expression());
+    return emit(statement, { reference(expression) });
+  }
+  case node_kind::forced_value_expression: {
+    const auto *forced =
+        static_cast<const ast::forced_value_expression *>(statement);
+    const uint32_t expression = write(forced->expression());
+    return emit(statement, { reference(expression) });
+  }
+  case node_kind::is_subtype_expression:
+  case node_kind::checked_cast_expression:
+  case node_kind::conditional_checked_cast_expression: {
+    const auto *cast =
+        static_cast<const ast::type_casting_expression *>(statement);
+    const uint32_t type = write(cast->cast_type());
+    const uint32_t operand = write(cast->operand());
+    return emit(statement, { reference(type), reference(operand) });
+  }
+
+  case node_kind::boolean_literal_expression: {
+    const auto *literal =
+        static_cast<const ast::boolean_literal_expression *>(statement);
+    return emit(statement, { literal->value() });
+  }
+  case node_kind::floating_point_literal_expression: {
+    const auto *literal =
+        static_cast<const ast::floating_point_literal_expression *>(statement);
+    append(operands, literal->value().bitcastToAPInt());
+    return emit(statement, operands);
+  }
+  case node_kind::integer_literal_expression: {
+    const auto *literal =
+        static_cast<const ast::integer_literal_expression *>(statement);
+    operands.push_back(literal->value().getBitWidth());
+    operands.push_back(literal->value().isUnsigned());
+    append(operands, literal->value());
+    return emit(statement, operands);
+  }
+  case node_kind::string_literal_expression: {
+    const auto *literal =
+        static_cast<const ast::string_literal_expression *>(statement);
+    return emit(statement, { intern(literal->value()) });
+  }
+  case node_kind::array_literal_expression: {
+    const auto *literal =
+        static_cast<const ast::array_literal_expression *>(statement);
+    const uint32_t items = write(literal->items());
+    return emit(statement, { reference(items) });
+  }
+  case node_kind::dictionary_literal_expression: {
+    const auto *literal =
+        static_cast<const ast::dictionary_literal_expression *>(statement);
+    const uint32_t items = write(literal->items());
+    return emit(statement, { reference(items) });
+  }
+  case node_kind::magic_literal_expression: {
+    const auto *literal =
+        static_cast<const ast::magic_literal_expression *>(statement);
+    operands.push_back(static_cast<uint32_t>(literal->type()));
+    switch (literal->type()) {
+    case magic_literal_expression::type::file:
+    case magic_literal_expression::type::function:
+      operands.push_back(intern(literal->string_value()));
+      break;
+    case magic_literal_expression::type::column:
+    case magic_literal_expression::type::line:
+      append(operands, literal->integer_value());
+      break;
+    }
+    return emit(statement, operands);
+  }
+
+  case node_kind::import_declaration: {
+    const auto *import = static_cast<const ast::import_declaration *>(statement);
+    return emit(statement, { intern(import->import_path()) });
+  }
+  case node_kind::constant_declaration: {
+    const auto *constant =
+        static_cast<const ast::constant_declaration *>(statement);
+    const uint32_t name = write(constant->name());
+    const uint32_t initializer = write(constant->initializer());
+    return emit(statement, { reference(name), reference(initializer) });
+  }
+  case node_kind::variable_declaration: {
+    const auto *variable =
+        static_cast<const ast::variable_declaration *>(statement);
+    const uint32_t name = write(variable->name());
+    const uint32_t initializer = write(variable->initializer());
+    return emit(statement, { reference(name), reference(initializer) });
+  }
+  case node_kind::typealias_declaration: {
+    const auto *typealias =
+        static_cast<const ast::typealias_declaration *>(statement);
+    const uint32_t type = write(typealias->aliased_type());
+    return emit(statement, { intern(typealias->alias()),
+                             intern(typealias->type_name()), reference(type) });
+  }
+  case node_kind::top_level_declaration: {
+    const auto *code =
+        static_cast<const ast::top_level_declaration *>(statement);
+    const uint32_t body = write(code->body());
+    return emit(statement, { reference(body) });
+  }
+  case node_kind::function_declaration: {
+    const auto *function =
+        static_cast<const ast::function_declaration *>(statement);
+    const uint32_t result_type = write(function->result_type());
+    // a skipped body is recorded by its location so that it remains skipped
+    const uint32_t body =
+        function->has_unparsed_body() ? 0 : write(function->body());
+    for (const auto *parameters : function->parameter_clauses())
+      records.push_back(write(parameters));
+    operands.push_back(intern(function->name()));
+    operands.push_back(reference(result_type));
+    operands.push_back(reference(body));
+    operands.push_back(function->body_location().line());
+    operands.push_back(function->body_location().column());
+    operands.push_back(function->body_location().offset());
+    for (const auto record : records)
+      operands.push_back(reference(record));
+    return emit(statement, operands);
+  }
+  case node_kind::enum_declaration: {
+    const auto *enumeration =
+        static_cast<const ast::enum_declaration *>(statement);
+    for (const auto *member : enumeration->members())
+      records.push_back(write(member));
+    operands.push_back(intern(enumeration->name()));
+    for (const auto record : records)
+      operands.push_back(reference(record));
+    return emit(statement, operands);
+  }
+  case node_kind::struct_declaration: {
+    const auto *structure =
+        static_cast<const ast::struct_declaration *>(statement);
+    const uint32_t declarations = write(structure->declarations());
+    return emit(statement,
+                { intern(structure->name()), reference(declarations) });
+  }
+  case node_kind::class_declaration: {
+    const auto *klass = static_cast<const ast::class_declaration *>(statement);
+    const uint32_t body = write(klass->body());
+    return emit(statement, { intern(klass->name()), reference(body) });
+  }
+  case node_kind::protocol_declaration: {
+    const auto *protocol =
+        static_cast<const ast::protocol_declaration *>(statement);
+    const uint32_t members = write(protocol->members());
+    return emit(statement, { intern(protocol->name()), reference(members) });
+  }
+  case node_kind::initializer_declaration: {
+    const auto *initializer =
+        static_cast<const ast::initializer_declaration *>(statement);
+    const uint32_t parameters = write(initializer->parameters());
+    const uint32_t body = write(initializer->body());
+    return emit(statement, { reference(parameters), reference(body) });
+  }
+  case node_kind::deinitializer_declaration: {
+    const auto *deinitializer =
+        static_cast<const ast::deinitializer_declaration *>(statement);
+    const uint32_t body = write(deinitializer->body());
+    return emit(statement, { reference(body) });
+  }
+  case node_kind::extension_declaration: {
+    const auto *extension =
+        static_cast<const ast::extension_declaration *>(statement);
+    const uint32_t body = write(extension->body());
+    operands.push_back(intern(extension->name()));
+    operands.push_back(reference(body));
+    for (const auto protocol : extension->adopted_protocols())
+      operands.push_back(intern(protocol));
+    return emit(statement, operands);
+  }
+  case node_kind::subscript_declaration: {
+    const auto *subscript =
+        static_cast<const ast::subscript_declaration *>(statement);
+    const uint32_t parameters = write(subscript->parameters());
+    const uint32_t return_type = write(subscript->return_type());
+    const uint32_t getter = write(subscript->getter());
+    const uint32_t setter = write(subscript->setter());
+    return emit(statement, { reference(parameters), reference(return_type),
+                             reference(getter), reference(setter) });
+  }
+  case node_kind::operator_declaration: {
+    const auto *op = static_cast<const ast::operator_declaration *>(statement);
+    return emit(statement, { static_cast<uint32_t>(op->type()),
+                             intern(op->name()), op->precedence(),
+                             static_cast<uint32_t>(op->associativity()) });
+  }
+  case node_kind::enumeration_element_declaration: {
+    const auto *element =
+        static_cast<const ast::enumeration_element_declaration *>(statement);
+    return emit(statement, { intern(element->name()) });
+  }
+
+  case node_kind::for_statement: {
+    const auto *loop = static_cast<const ast::for_statement *>(statement);
+    const uint32_t initializer = write(loop->initializer());
+    const uint32_t condition = write(loop->condition());
+    const uint32_t increment = write(loop->increment());
+    const uint32_t body = write(loop->body());
+    return emit(statement, { reference(initializer), reference(condition),
+                             reference(increment), reference(body) });
+  }
+
+  case node_kind::for_in_statement: {
+    const auto *for_in = static_cast<const ast::for_in_statement *>(statement);
+    const uint32_t item = write(for_in->item());
+    const uint32_t collection = write(for_in->collection());
+    const uint32_t body = write(for_in->body());
+    return emit(statement,
+                { reference(item), reference(collection), reference(body) });
+  }
+  case node_kind::while_statement: {
+    const auto *loop = static_cast<const ast::while_statement *>(statement);
+    const uint32_t condition = write(loop->condition());
+    const uint32_t body = write(loop->body());
+    return emit(statement, { reference(condition), reference(body) });
+  }
+  case node_kind::repeat_while_statement: {
+    const auto *loop =
+        static_cast<const ast::repeat_while_statement *>(statement);
+    const uint32_t body = write(loop->body());
+    const uint32_t condition = write(loop->condition());
+    return emit(statement, { reference(body), reference(condition) });
+  }
+
+  case node_kind::if_statement: {
+    const auto *branch = static_cast<const ast::if_statement *>(statement);
+    const uint32_t condition = write(branch->condition());
+    const uint32_t true_clause = write(branch->true_clause());
+    const uint32_t false_clause = write(branch->false_clause());
+    return emit(statement, { reference(condition), reference(true_clause),
+                             reference(false_clause) });
+  }
+  case node_kind::guard_statement: {
+    const auto *guard = static_cast<const ast::guard_statement *>(statement);
+    const uint32_t body = write(guard->body());
+    for (const auto *condition : guard->condition_clause())
+      records.push_back(write(condition));
+    operands.push_back(reference(body));
+    for (const auto record : records)
+      operands.push_back(reference(record));
+    return emit(statement, operands);
+  }
+  case node_kind::switch_statement: {
+    // NOTE(compnerd) each case is encoded as its item count and body followed
+    // by the { pattern, guard } pair of each item.
+    const auto *branch = static_cast<const ast::switch_statement *>(statement);
+    const uint32_t control = write(branch->control_expression());
+    llvm::SmallVector<uint32_t, 8> counts;
+    for (const auto &item : branch->cases()) {
+      counts.push_back(std::get<0>(item).size());
+      records.push_back(write(std::get<1>(item)));
+      for (const auto &label : std::get<0>(item)) {
+        records.push_back(write(std::get<0>(label)));
+        records.push_back(write(std::get<1>(label)));
+      }
+    }
+    operands.push_back(reference(control));
+    unsigned index = 0;
+    for (const auto count : counts) {
+      operands.push_back(count);
+      for (unsigned record = 0; record <= 2 * count; ++record)
+        operands.push_back(reference(records[index++]));
+    }
+    return emit(statement, operands);
+  }
+
+  case node_kind::break_statement: {
+    const auto *transfer = static_cast<const ast::break_statement *>(statement);
+    return emit(statement, { intern(transfer->label()) });
+  }
+  case node_kind::continue_statement: {
+    const auto *transfer =
+        static_cast<const ast::continue_statement *>(statement);
+    return emit(statement, { intern(transfer->label()) });
+  }
+  case node_kind::return_statement: {
+    const auto *transfer = static_cast<const ast::return_statement *>(statement);
+    const uint32_t value = write(transfer->value());
+    return emit(statement, { reference(value) });
+  }
+  case node_kind::throw_statement: {
+    const auto *transfer = static_cast<const ast::throw_statement *>(statement);
+    const uint32_t expression = write(transfer->expression());
+    return emit(statement, { reference(expression) });
+  }
+
+  case node_kind::build_configuration_statement: {
+    const auto *configuration =
+        static_cast<const ast::build_configuration_statement *>(statement);
+    const uint32_t condition = write(configuration->condition());
+    const uint32_t true_clause = write(configuration->true_clause());
+    const uint32_t false_clause = write(configuration->false_clause());
+    return emit(statement, { reference(condition), reference(true_clause),
+                             reference(false_clause) });
+  }
+  case node_kind::line_control_statement: {
+    const auto *control =
+        static_cast<const ast::line_control_statement *>(statement);
+    return emit(statement,
+                { intern(control->file_name()), control->line_number() });
+  }
+  }
+
+  swift_unreachable("unknown node kind");
+}
+
+uint32_t writer::write(const ast::pattern *pattern) {
+  if (not pattern or failed_)
+    return 0;
+
+  llvm::SmallVector<uint32_t, 8> records;
+  llvm::SmallVector<uint32_t, 8> operands;
+
+  switch (pattern->type()) {
+  case pattern::type::any:
+    return emit(format::record_kind::pattern_any, {});
+  case pattern::type::named: {
+    const auto *named = static_cast<const ast::pattern_named *>(pattern);
+    return emit(format::record_kind::pattern_named,
+                { intern(named->name()), named->implicit() });
+  }
+  case pattern::type::tuple: {
+    const auto *tuple = static_cast<const ast::pattern_tuple *>(pattern);
+    for (const auto *element : tuple->elements())
+      records.push_back(write(element));
+    for (const auto record : records)
+      operands.push_back(reference(record));
+    return emit(format::record_kind::pattern_tuple, operands);
+  }
+  case pattern::type::typed: {
+    const auto *typed = static_cast<const ast::pattern_typed *>(pattern);
+    const uint32_t subpattern = write(typed->pattern());
+    const uint32_t type = write(typed->pattern_type());
+    return emit(format::record_kind::pattern_typed,
+                { reference(subpattern), reference(type) });
+  }
+  case pattern::type::var: {
+    const auto *var = static_cast<const ast::pattern_var *>(pattern);
+    const uint32_t subpattern = write(var->pattern());
+    return emit(format::record_kind::pattern_var, { reference(subpattern) });
+  }
+  case pattern::type::expression: {
+    const auto *expression =
+        static_cast<const ast::pattern_expression *>(pattern);
+    const uint32_t value = write(expression->expression());
+    return emit(format::record_kind::pattern_expression, { reference(value) });
+  }
+  }
+
+  swift_unreachable("unknown pattern type");
+}
+
+uint32_t writer::write(const ast::type *type) {
+  if (not type or failed_)
+    return 0;
+
+  llvm::SmallVector<uint32_t, 8> records;
+  llvm::SmallVector<uint32_t, 8> operands;
+
+  switch (type->kind()) {
+  case type::kind::array: {
+    const auto *array = static_cast<const ast::type_array *>(type);
+    const uint32_t element = write(array->type());
+    return emit(format::record_kind::type_array, { reference(element) });
+  }
+  case type::kind::composite: {
+    const auto *composite = static_cast<const ast::type_composite *>(type);
+    for (const auto *protocol : composite->protocols())
+      records.push_back(write(protocol));
+    for (const auto record : records)
+      operands.push_back(reference(record));
+    return emit(format::record_kind::type_composite, operands);
+  }
+  case type::kind::dictionary: {
+    const auto *dictionary = static_cast<const ast::type_dictionary *>(type);
+    const uint32_t key = write(dictionary->key_type());
+    const uint32_t value = write(dictionary->value_type());
+    return emit(format::record_kind::type_dictionary,
+                { reference(key), reference(value) });
+  }
+  case type::kind::function: {
+    const auto *function = static_cast<const ast::type_function *>(type);
+    const uint32_t parameter = write(function->parameter_type());
+    const uint32_t result = write(function->return_type());
+    return emit(format::record_kind::type_function,
+                { reference(parameter), reference(result) });
+  }
+  case type::kind::identifier: {
+    const auto *identifier = static_cast<const ast::type_identifier *>(type);
+    for (const auto component : identifier->components())
+      operands.push_back(intern(component));
+    return emit(format::record_kind::type_identifier, operands);
+  }
+  case type::kind::inout: {
+    const auto *inout = static_cast<const ast::type_inout *>(type);
+    const uint32_t subtype = write(inout->type());
+    return emit(format::record_kind::type_inout, { reference(subtype) });
+  }
+  case type::kind::metatype: {
+    const auto *metatype = static_cast<const ast::type_metatype *>(type);
+    const uint32_t subtype = write(metatype->type());
+    return emit(format::record_kind::type_metatype, { reference(subtype) });
+  }
+  case type::kind::tuple: {
+    const auto *tuple = static_cast<const ast::type_tuple *>(type);
+    for (const auto *element : tuple->elements())
+      records.push_back(write(element));
+    for (const auto record : records)
+      operands.push_back(reference(record));
+    return emit(format::record_kind::type_tuple, operands);
+  }
+  }
+
+  swift_unreachable("unknown type kind");
+}
+
+void writer::set_source(uint32_t length, const uint8_t (&digest)[16]) {
+  source_length_ = length;
+  std::copy(std::begin(digest), std::end(digest), source_digest_);
+}
+
+bool writer::add(const ast::statement *statement) {
+  const size_t records = records_.size();
+  const size_t sources = sources_.size();
+  const size_t strings = strings_.size();
+
+  failed_ = false;
+  const uint32_t record = write(statement);
+  if (failed_ or record == 0) {
+    records_.resize(records);
+    sources_.resize(sources);
+    // strings are only ever appended, so those interned by the failed entry
+    // are exactly the tail of the table.
+    for (size_t index = strings; index < strings_.size(); ++index)
+      string_indices_.erase(strings_[index]);
+    strings_.resize(strings);
+    return false;
+  }
+
+  roots_.push_back(record - 1);
+  return true;
+}
+
+void writer::emit(std::ostream &os) const {
+  std::vector<format::string_descriptor> descriptors;
+  uint32_t characters = 0;
+  for (const auto &string : strings_) {
+    descriptors.push_back({ characters, static_cast<uint32_t>(string.size()) });
+    characters = characters + string.size();
+  }
+
+  format::header header;
+  header.magic = format::magic;
+  header.version = format::version;
+  header.reserved = 0;
+  header.records_offset = sizeof(header);
+  header.records_size = records_.size();
+  header.sources_offset =
+      header.records_offset + records_.size() * sizeof(uint32_t);
+  header.record_count = sources_.size();
+  header.strings_offset =
+      header.sources_offset + sources_.size() * sizeof(format::source_range);
+  header.string_count = strings_.size();
+  header.roots_offset = header.strings_offset +
+                        descriptors.size() * sizeof(format::string_descriptor) +
+                        characters * sizeof(char32_t);
+  header.root_count = roots_.size();
+  header.source_length = source_length_;
+  std::copy(std::begin(source_digest_), std::end(source_digest_),
+            header.source_digest);
+
+  write_raw(os, &header, 1);
+  write_raw(os, records_.data(), records_.size());
+  write_raw(os, sources_.data(), sources_.size());
+  write_raw(os, descriptors.data(), descriptors.size());
+  for (const auto &string : strings_)
+    write_raw(os, string.data(), string.size());
+  write_raw(os, roots_.data(), roots_.size());
+}
+}
+}
@@ -29,16 +29,332 @@
 
 #include "swift/syntax/context.hh"
 #include "swift/syntax/source-file.hh"
+#include "swift/syntax/type-array.hh"
+#include "swift/syntax/type-dictionary.hh"
+#include "swift/syntax/type-function.hh"
+#include "swift/syntax/type-identifier.hh"
+#include "swift/syntax/type-metatype.hh"
+#include "swift/syntax/type-tuple.hh"
+#include "swift/syntax/visitor.hh"
+
+#include <llvm/ADT/SmallVector.h>
+
+#include <algorithm>
+#include <cassert>
+#include <iomanip>
+#include <iterator>
+#include <mutex>
+#include <ostream>
 
 namespace swift {
 namespace ast {
-context::context(diagnostics::engine &engine) : diagnostics_engine_(engine) {
-  source_file_ = source_file::create(*this, "main");
+context::context(diagnostics::engine &engine, const std::string &name)
+    : diagnostics_engine_(engine), target_info_(nullptr), types_(this),
+      adopter_(nullptr), statistics_(false) {
+  source_file_ = source_file::create(*this, name);
+  source_files_.push_back(source_file_);
+
+  // NOTE(compnerd) the builtin types do not depend on the target; create them
+  // eagerly so that types may be formed before the target is known
+  for (unsigned kind = 0; kind < std::size(builtin_types_); ++kind)
+    builtin_types_[kind] = new (*this, semantic::type::alignment)
+        semantic::builtin_type(static_cast<semantic::builtin_type::kind>(kind));
+}
+
+context::~context() = default;
+
+void context::adopt(std::unique_ptr<context> context) {
+  assert(context.get() != this && "context cannot adopt itself");
+  assert((context->adopter_ == nullptr or context->adopter_ == this) &&
+         "context is to be adopted by another context");
+  context->adopter_ = this;
+  // NOTE(compnerd) a context which only holds nodes referenced from elsewhere
+  // (e.g. a function body analysed in parallel) has an empty source file
+  std::copy_if(context->source_files_.begin(), context->source_files_.end(),
+               std::back_inserter(source_files_),
+               [](const ast::source_file *file) {
+                 return file->begin() != file->end();
+               });
+  adopted_contexts_.push_back(std::move(context));
+}
+
+bool context::is_within(const context &context) const {
+  for (const ast::context *adoptee = this; adoptee;
+       adoptee = adoptee->adopter_)
+    if (adoptee == &context)
+      return true;
+  return false;
 }
 
 void context::initialise_builtin_types(const compiler::target_info &target) {
   target_info_ = &target;
 }
+
+template <typename Type, typename Create>
+const Type *context::unique(llvm::FoldingSet<Type> &types,
+                            const llvm::FoldingSetNodeID &id, Create create) {
+  void *position;
+  {
+    std::shared_lock<std::shared_mutex> lock(types_mutex_);
+    if (auto *type = types.FindNodeOrInsertPos(id, position))
+      return type;
+  }
+
+  // NOTE(compnerd) the type may have been formed by another thread after the
+  // shared lock was released, in which case the search must be repeated
+  std::unique_lock<std::shared_mutex> lock(types_mutex_);
+  if (auto *type = types.FindNodeOrInsertPos(id, position))
+    return type;
+
+  auto *type = create();
+  types.InsertNode(type, position);
+  return type;
+}
+
+const semantic::tuple_type *
+context::tuple_type(llvm::ArrayRef<const semantic::type *> elements) {
+  if (types_ != this)
+    return types_->tuple_type(elements);
+
+  llvm::FoldingSetNodeID id;
+  semantic::tuple_type::profile(id, elements);
+
+  return unique(tuple_types_, id, [&]() {
+    auto *storage = new (*this) const semantic::type *[elements.size()];
+    std::copy(elements.begin(), elements.end(), storage);
+
+    return new (*this, semantic::type::alignment) semantic::tuple_type(
+        llvm::makeArrayRef(storage, elements.size()));
+  });
+}
+
+const semantic::function_type *
+context::function_type(const semantic::type *parameter_type,
+                       const semantic::type *result_type) {
+  if (types_ != this)
+    return types_->function_type(parameter_type, result_type);
+
+  llvm::FoldingSetNodeID id;
+  semantic::function_type::profile(id, parameter_type, result_type);
+
+  return unique(function_types_, id, [&]() {
+    return new (*this, semantic::type::alignment)
+        semantic::function_type(parameter_type, result_type);
+  });
+}
+
+const semantic::array_type *
+context::array_type(const semantic::type *element_type) {
+  if (types_ != this)
+    return types_->array_type(element_type);
+
+  llvm::FoldingSetNodeID id;
+  semantic::array_type::profile(id, element_type);
+
+  return unique(array_types_, id, [&]() {
+    return new (*this, semantic::type::alignment)
+        semantic::array_type(element_type);
+  });
+}
+
+const semantic::dictionary_type *
+context::dictionary_type(const semantic::type *key_type,
+                         const semantic::type *value_type) {
+  if (types_ != this)
+    return types_->dictionary_type(key_type, value_type);
+
+  llvm::FoldingSetNodeID id;
+  semantic::dictionary_type::profile(id, key_type, value_type);
+
+  return unique(dictionary_types_, id, [&]() {
+    return new (*this, semantic::type::alignment)
+        semantic::dictionary_type(key_type, value_type);
+  });
+}
+
+const semantic::metatype_type *
+context::metatype_type(const semantic::type *instance_type) {
+  if (types_ != this)
+    return types_->metatype_type(instance_type);
+
+  llvm::FoldingSetNodeID id;
+  semantic::metatype_type::profile(id, instance_type);
+
+  return unique(metatype_types_, id, [&]() {
+    return new (*this, semantic::type::alignment)
+        semantic::metatype_type(instance_type);
+  });
+}
+
+const semantic::type *context::semantic_type(const ast::type *type) {
+  using builtin_kind = semantic::builtin_type::kind;
+
+  static const struct {
+    std::u32string_view name;
+    builtin_kind kind;
+  } builtin_names[] = {
+    { U"Bool", builtin_kind::boolean },
+    { U"Character", builtin_kind::character },
+    { U"Double", builtin_kind::float64 },
+    { U"Float", builtin_kind::float32 },
+    { U"Float32", builtin_kind::float32 },
+    { U"Float64", builtin_kind::float64 },
+    // TODO(compnerd) size Int and UInt by the target
+    { U"Int", builtin_kind::sint64 },
+    { U"Int16", builtin_kind::sint16 },
+    { U"Int32", builtin_kind::sint32 },
+    { U"Int64", builtin_kind::sint64 },
+    { U"Int8", builtin_kind::sint8 },
+    { U"String", builtin_kind::string },
+    { U"UInt", builtin_kind::uint64 },
+    { U"UInt16", builtin_kind::uint16 },
+    { U"UInt32", builtin_kind::uint32 },
+    { U"UInt64", builtin_kind::uint64 },
+    { U"UInt8", builtin_kind::uint8 },
+  };
+
+  if (not type)
+    return nullptr;
+
+  switch (type->kind()) {
+  case ast::type::kind::identifier: {
+    const auto components =
+        static_cast<const ast::type_identifier *>(type)->components();
+    if (components.size() != 1)
+      return nullptr;
+    for (const auto &builtin : builtin_names)
+      if (builtin.name == components.front())
+        return builtin_type(builtin.kind);
+    return nullptr;
+  }
+  case ast::type::kind::tuple: {
+    llvm::SmallVector<const semantic::type *, 4> elements;
+    for (const auto *element :
+         static_cast<const ast::type_tuple *>(type)->elements())
+      if (const auto *element_type = semantic_type(element))
+        elements.push_back(element_type);
+      else
+        return nullptr;
+    return tuple_type(elements);
+  }
+  case ast::type::kind::function: {
+    const auto *function = static_cast<const ast::type_function *>(type);
+    const auto *parameter_type = semantic_type(function->parameter_type());
+    const auto *result_type = semantic_type(function->return_type());
+    if (not parameter_type or not result_type)
+      return nullptr;
+    return function_type(parameter_type, result_type);
+  }
+  case ast::type::kind::array:
+    if (const auto *element_type =
+            semantic_type(static_cast<const ast::type_array *>(type)->type()))
+      return array_type(element_type);
+    return nullptr;
+  case ast::type::kind::dictionary: {
+    const auto *dictionary = static_cast<const ast::type_dictionary *>(type);
+    const auto *key_type = semantic_type(dictionary->key_type());
+    const auto *value_type = semantic_type(dictionary->value_type());
+    if (not key_type or not value_type)
+      return nullptr;
+    return dictionary_type(key_type, value_type);
+  }
+  case ast::type::kind::metatype:
+    if (const auto *instance_type = semantic_type(
+            static_cast<const ast::type_metatype *>(type)->type()))
+      return metatype_type(instance_type);
+    return nullptr;
+  case ast::type::kind::composite:
+  case ast::type::kind::inout:
+    // TODO(compnerd) model protocol compositions and inout parameters
+    return nullptr;
+  }
+
+  swift_unreachable("unhandled type kind");
+}
+
+size_t context::bytes_allocated() const {
+  size_t allocated = allocator_.getBytesAllocated();
+  for (const auto &context : adopted_contexts_)
+    allocated = allocated + context->bytes_allocated();
+  return allocated;
+}
+
+// the number of the concrete node kinds
+static constexpr unsigned node_kinds = 0
+#define NODE(Id, Parent) +1
+#include "swift/syntax/syntax.def"
+    ;
+
+void *context::allocate_node(size_t size, size_t alignment) const {
+  statement::accounting_ = statistics_ ? this : nullptr;
+  return allocator_.Allocate(size, alignment);
+}
+
+void context::enable_statistics() {
+  statistics_ = true;
+  node_counts_.resize(node_kinds);
+}
+
+struct context::statistics {
+  size_t allocated = 0;
+  size_t reserved = 0;
+  size_t slabs = 0;
+  size_t contexts = 0;
+  std::vector<unsigned> node_counts;
+};
+
+void context::accumulate(statistics &totals) const {
+  totals.allocated = totals.allocated + allocator_.getBytesAllocated();
+  totals.reserved = totals.reserved + allocator_.getTotalMemory();
+  totals.slabs = totals.slabs + allocator_.GetNumSlabs();
+  for (unsigned kind = 0; kind < node_counts_.size(); ++kind)
+    totals.node_counts[kind] = totals.node_counts[kind] + node_counts_[kind];
+
+  totals.contexts = totals.contexts + adopted_contexts_.size();
+  for (const auto &context : adopted_contexts_)
+    context->accumulate(totals);
+}
+
+void context::print_statistics(std::ostream &os) const {
+  static const struct {
+    const char *name;
+    size_t size;
+  } nodes[] = {
+#define NODE(Id, Parent) { #Id, sizeof(ast::Id) },
+#include "swift/syntax/syntax.def"
+  };
+
+  statistics totals;
+  totals.node_counts.resize(node_kinds);
+  accumulate(totals);
+
+  os << "*** AST Context Stats:\n";
+  os << "  " << totals.allocated << " bytes allocated in " << totals.slabs
+     << " slabs (" << totals.reserved << " bytes reserved, "
+     << totals.reserved - totals.allocated << " bytes wasted)\n";
+  if (totals.contexts)
+    os << "  " << totals.contexts << " adopted contexts, "
+       << source_files_.size() << " source files\n";
+  os << "  " << tuple_types_.size() + function_types_.size() +
+                    array_types_.size() + dictionary_types_.size() +
+                    metatype_types_.size()
+     << " uniqued types\n";
+
+  unsigned total_nodes = 0;
+  size_t total_bytes = 0;
+  for (const auto &node : nodes) {
+    unsigned count = totals.node_counts[&node - nodes];
+    if (count == 0)
+      continue;
+
+    os << "    " << std::setw(8) << count << ' ' << node.name << ", "
+       << node.size << " each (" << count * node.size << " bytes)\n";
+
+    total_nodes = total_nodes + count;
+    total_bytes = total_bytes + count * node.size;
+  }
+  os << "  " << total_nodes << " nodes, " << total_bytes << " bytes\n";
+}
 }
 }
 
@@ -28,10 +28,104 @@
  **/
 
 #include "swift/syntax/declaration-context.hh"
+#include "swift/syntax/class-declaration.hh"
+#include "swift/syntax/constant-declaration.hh"
+#include "swift/syntax/context.hh"
+#include "swift/syntax/enum-declaration.hh"
+#include "swift/syntax/enumeration-element-declaration.hh"
+#include "swift/syntax/function-declaration.hh"
+#include "swift/syntax/pattern-named.hh"
+#include "swift/syntax/pattern-tuple.hh"
+#include "swift/syntax/pattern-typed.hh"
+#include "swift/syntax/pattern-var.hh"
+#include "swift/syntax/protocol-declaration.hh"
 #include "swift/syntax/source-file.hh"
+#include "swift/syntax/struct-declaration.hh"
+#include "swift/syntax/typealias-declaration.hh"
+#include "swift/syntax/variable-declaration.hh"
 
 #include <cassert>
 
+namespace {
+using namespace swift;
+
+void bound_names(const ast::pattern *pattern,
+                 llvm::SmallVectorImpl<std::u32string_view> &names) {
+  if (not pattern)
+    return;
+
+  switch (pattern->type()) {
+  case ast::pattern::type::named:
+    names.push_back(static_cast<const ast::pattern_named *>(pattern)->name());
+    break;
+  case ast::pattern::type::tuple:
+    for (const auto *element :
+         static_cast<const ast::pattern_tuple *>(pattern)->elements())
+      bound_names(element, names);
+    break;
+  case ast::pattern::type::typed:
+    bound_names(static_cast<const ast::pattern_typed *>(pattern)->pattern(),
+                names);
+    break;
+  case ast::pattern::type::var:
+    bound_names(static_cast<const ast::pattern_var *>(pattern)->pattern(),
+                names);
+    break;
+  case ast::pattern::type::any:
+  case ast::pattern::type::expression:
+    break;
+  }
+}
+
+void declared_names(const ast::declaration *declaration,
+                    llvm::SmallVectorImpl<std::u32string_view> &names) {
+  switch (declaration->type()) {
+  case ast::declaration::type::constant_declaration:
+    bound_names(
+        static_cast<const ast::constant_declaration *>(declaration)->name(),
+        names);
+    break;
+  case ast::declaration::type::variable_declaration:
+    bound_names(
+        static_cast<const ast::variable_declaration *>(declaration)->name(),
+        names);
+    break;
+  case ast::declaration::type::typealias_declaration:
+    names.push_back(
+        static_cast<const ast::typealias_declaration *>(declaration)->alias());
+    break;
+  case ast::declaration::type::function_declaration:
+    names.push_back(
+        static_cast<const ast::function_declaration *>(declaration)->name());
+    break;
+  case ast::declaration::type::enum_declaration:
+    names.push_back(
+        static_cast<const ast::enum_declaration *>(declaration)->name());
+    break;
+  case ast::declaration::type::enumeration_element_declaration:
+    names.push_back(
+        static_cast<const ast::enumeration_element_declaration *>(declaration)
+            ->name());
+    break;
+  case ast::declaration::type::struct_declaration:
+    names.push_back(
+        static_cast<const ast::struct_declaration *>(declaration)->name());
+    break;
+  case ast::declaration::type::class_declaration:
+    names.push_back(
+        static_cast<const ast::class_declaration *>(declaration)->name());
+    break;
+  case ast::declaration::type::protocol_declaration:
+    names.push_back(
+        static_cast<const ast::protocol_declaration *>(declaration)->name());
+    break;
+  default:
+    // the remaining declarations do not introduce a member name
+    break;
+  }
+}
+}
+
 namespace swift {
 namespace ast {
 declaration_context::~declaration_context() = default;
@@ -45,14 +139,82 @@ ast::context &declaration_context::ast_context() {
 void declaration_context::add_declaration(ast::declaration *declaration) {
   assert(declaration->declaration_context() == this &&
          "declaration inserted into incorrect context");
+  assert(declaration->next_ == nullptr && "declaration already inserted");
 
-  if (first_declaration_)
-    last_declaration_->next_ = last_declaration_;
+  if (last_declaration_)
+    last_declaration_->next_ = declaration;
   else
-    first_declaration_ = last_declaration_;
+    first_declaration_ = declaration;
 
   last_declaration_ = declaration;
 }
+
+void declaration_context::remove_declaration(ast::declaration *declaration) {
+  assert(declaration->declaration_context() == this &&
+         "declaration removed from incorrect context");
+
+  ast::declaration *previous = nullptr;
+  for (ast::declaration *current = first_declaration_; current != declaration;
+       current = current->next_) {
+    assert(current && "declaration not inserted");
+    previous = current;
+  }
+
+  if (previous)
+    previous->next_ = declaration->next_;
+  else
+    first_declaration_ = declaration->next_;
+  if (last_declaration_ == declaration)
+    last_declaration_ = previous;
+  declaration->next_ = nullptr;
+
+  // the lookup table may refer to the declaration; rebuild it on demand
+  lookup_table_.clear();
+  last_indexed_declaration_ = nullptr;
+}
+
+void declaration_context::index() const {
+  ast::declaration *declaration = last_indexed_declaration_
+                                      ? last_indexed_declaration_->next_
+                                      : first_declaration_;
+  if (not declaration)
+    return;
+
+  identifier_table &identifiers =
+      const_cast<declaration_context *>(this)->ast_context().identifiers();
+  llvm::SmallVector<std::u32string_view, 4> names;
+  for (; declaration; declaration = declaration->next_) {
+    names.clear();
+    declared_names(declaration, names);
+    for (const auto name : names)
+      lookup_table_[&identifiers.get(name)].push_back(declaration);
+    last_indexed_declaration_ = declaration;
+  }
 }
+
+llvm::ArrayRef<ast::declaration *>
+declaration_context::lookup(const identifier_info &name) const {
+  index();
+
+  const auto entry = lookup_table_.find(&name);
+  if (entry == lookup_table_.end())
+    return llvm::ArrayRef<ast::declaration *>();
+  return entry->second;
 }
 
+llvm::ArrayRef<ast::declaration *>
+declaration_context::lookup(std::u32string_view name) const {
+  index();
+
+  // NOTE(compnerd) the declared names are interned once indexed, so a name
+  // which is not interned names no declaration; the identifiers are not
+  // modified so that an indexed context may be looked up concurrently
+  const identifier_info *identifier =
+      const_cast<declaration_context *>(this)->ast_context().identifiers().find(
+          name);
+  if (not identifier)
+    return llvm::ArrayRef<ast::declaration *>();
+  return lookup(*identifier);
+}
+}
+}
@@ -45,12 +45,24 @@
 
 namespace swift {
 namespace ast {
+declaration::declaration(enum declaration::type type,
+                         ast::declaration_context *context)
+    : statement(to_kind<node_kind::first_declaration>(type)),
+      declaration_context_(context), next_(nullptr) {
+  if (declaration_context_)
+    declaration_context_->add_declaration(this);
+}
+
 void *declaration::operator new(size_t size, const ast::context &context,
                                 ast::declaration_context *declaration_context,
                                 size_t extra) {
-  assert(declaration_context == nullptr or
-         &declaration_context->ast_context() == &context);
-  return ::operator new(size + extra, context);
+  // NOTE(compnerd) the declaration may be allocated from a context which is
+  // adopted by that of its declaration context (e.g. a local of a function
+  // body analysed in parallel); it lives as long as the latter either way
+  assert((declaration_context == nullptr or
+          context.is_within(declaration_context->ast_context())) &&
+         "declaration must live as long as its declaration context");
+  return context.allocate_node(size + extra, 8);
 }
 
 declaration *
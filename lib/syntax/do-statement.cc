@@ -27,16 +27,13 @@
  * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **/
 
-#include "swift/syntax/enumeration_element_declaration.hh"
-#include "swift/support/ucs4-support.hh"
 
-#include <iostream>
+#include "swift/syntax/do-statement.hh"
+#include "swift/syntax/context.hh"
 
-namespace swift {
-namespace ast {
-void enumeration_element_declaration::dump() const {
-  std::cerr << "EnumerationElementDeclaration '" << name_ << "' type=?" << '\n';
+namespace swift::ast {
+void *do_statement::
+operator new(size_t size, const ast::context &context, unsigned alignment) {
+  return context.allocate_node(size, alignment);
 }
 }
-}
-
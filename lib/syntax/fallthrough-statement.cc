@@ -34,7 +34,7 @@ namespace swift::ast {
 void *fallthrough_statement::operator new(size_t size,
                                           const ast::context &context,
                                           unsigned alignment) {
-  return ::operator new(size, context, alignment);
+  return context.allocate_node(size, alignment);
 }
 }
 
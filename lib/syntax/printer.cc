@@ -107,8 +107,9 @@ void printer::visit(const source_file &) {
   printer::scope scope(*this, "source_file");
 }
 
-void printer::visit(const top_level_declaration &) {
+void printer::visit(const top_level_declaration &declaration) {
   printer::scope scope(*this, "top_level_decl");
+  print(declaration.body());
 }
 
 void printer::visit(const prefix_unary_expression &expression) {
@@ -131,6 +132,14 @@ void printer::visit(const sequence_expression &expression) {
     print(subexpression);
 }
 
+void printer::visit(const binary_expression &expression) {
+  printer::scope scope(*this, "binary_expr");
+  os_ << " type='<null type>'";
+  print(expression.binary_operator());
+  print_expression(expression.lhs());
+  print_expression(expression.rhs());
+}
+
 void printer::visit(const postfix_unary_expression &expression) {
   printer::scope scope(*this, "postfix_unary_expr");
   os_ << " type='<null>'";
@@ -170,7 +179,8 @@ void printer::visit(const dynamic_type_expression &dynamic_type) {
 }
 
 void printer::visit(const subscript_expression &) {
-  __builtin_trap();
+  printer::scope scope(*this, "subscript_expr");
+  os_ << " type='<null>'";
 }
 
 void printer::visit(const forced_value_expression &forced_value_expr) {
@@ -180,7 +190,8 @@ void printer::visit(const forced_value_expression &forced_value_expr) {
 }
 
 void printer::visit(const optional_chaining_expression &) {
-  __builtin_trap();
+  printer::scope scope(*this, "bind_optional_expr");
+  os_ << " type='<null>'";
 }
 
 void printer::visit(const declaration_reference_expression &expression) {
@@ -201,6 +212,18 @@ void printer::visit(const closure_expression &closure) {
   printer::scope(*this, "closure_expr");
   os_ << " type='<null>>'"
       << " descriminator=0";
+  if (not closure.captures().empty()) {
+    os_ << " captures=(";
+    const char *separator = "";
+    for (const auto &capture : closure.captures()) {
+      os_ << separator << capture.binding()->name();
+      if (not capture.mutated())
+        os_ << "<direct>";
+      separator = " ";
+    }
+    os_ << ")";
+  }
+  print(closure.parameters());
   print(closure.body());
 }
 
@@ -238,16 +261,25 @@ void printer::visit(const conditional_expression &conditional_expr) {
   print_expression(conditional_expr.false_clause());
 }
 
-void printer::visit(const is_subtype_expression &) {
-  __builtin_trap();
+void printer::visit(const is_subtype_expression &expression) {
+  printer::scope scope(*this, "is_subtype_expr");
+  os_ << " type='<null>'";
+  print_expression(expression.operand());
+  print(expression.cast_type());
 }
 
-void printer::visit(const checked_cast_expression &) {
-  __builtin_trap();
+void printer::visit(const checked_cast_expression &expression) {
+  printer::scope scope(*this, "unconditional_checked_cast_expr");
+  os_ << " type='<null>'";
+  print_expression(expression.operand());
+  print(expression.cast_type());
 }
 
-void printer::visit(const conditional_checked_cast_expression &) {
-  __builtin_trap();
+void printer::visit(const conditional_checked_cast_expression &expression) {
+  printer::scope scope(*this, "conditional_checked_cast_expr");
+  os_ << " type='<null>'";
+  print_expression(expression.operand());
+  print(expression.cast_type());
 }
 
 void printer::visit(const boolean_literal_expression &literal) {
@@ -352,8 +384,12 @@ void printer::visit(const function_declaration &function) {
     print(decl);
 }
 
-void printer::visit(const enum_declaration &) {
-  __builtin_trap();
+void printer::visit(const enum_declaration &enum_decl) {
+  printer::scope scope(*this, "enum_decl");
+  os_ << " "; print_quoted(enum_decl.name(), '"');
+  os_ << " type='<null type>'";
+  for (const auto *decl : enum_decl.members())
+    print(decl);
 }
 
 void printer::visit(const struct_declaration &struct_decl) {
@@ -384,20 +420,56 @@ void printer::visit(const initializer_declaration &initializer_decl) {
   print(initializer_decl.body());
 }
 
-void printer::visit(const deinitializer_declaration &) {
-  __builtin_trap();
+void printer::visit(const deinitializer_declaration &deinitializer_decl) {
+  printer::scope scope(*this, "destructor_decl");
+  os_ << " type='<null>'";
+  print(deinitializer_decl.body());
 }
 
-void printer::visit(const extension_declaration &) {
-  __builtin_trap();
+void printer::visit(const extension_declaration &extension_decl) {
+  printer::scope scope(*this, "extension_decl");
+  os_ << " "; print_quoted(extension_decl.name(), '"');
+  print(extension_decl.body());
 }
 
 void printer::visit(const subscript_declaration &) {
   __builtin_trap();
 }
 
-void printer::visit(const operator_declaration &) {
-  __builtin_trap();
+void printer::visit(const operator_declaration &operator_decl) {
+  printer::scope scope(*this, "operator_decl");
+  switch (operator_decl.type()) {
+  case operator_declaration::type::infix:
+    os_ << " infix";
+    break;
+  case operator_declaration::type::prefix:
+    os_ << " prefix";
+    break;
+  case operator_declaration::type::postfix:
+    os_ << " postfix";
+    break;
+  }
+  os_ << " "; print_quoted(operator_decl.name(), '"');
+  if (operator_decl.type() != operator_declaration::type::infix)
+    return;
+  os_ << " precedence=" << unsigned(operator_decl.precedence());
+  switch (operator_decl.associativity()) {
+  case operator_declaration::associativity::none:
+    os_ << " associativity=none";
+    break;
+  case operator_declaration::associativity::left:
+    os_ << " associativity=left";
+    break;
+  case operator_declaration::associativity::right:
+    os_ << " associativity=right";
+    break;
+  }
+}
+
+void printer::visit(const enumeration_element_declaration &element_decl) {
+  printer::scope scope(*this, "enum_element_decl");
+  os_ << " "; print_quoted(element_decl.name(), '"');
+  os_ << " type='<null type>'";
 }
 
 void printer::visit(const for_statement &) {
@@ -477,7 +549,7 @@ void printer::visit(const continue_statement &) {
 }
 
 void printer::visit(const fallthrough_statement &) {
-  __builtin_trap();
+  printer::scope scope(*this, "fallthrough_stmt");
 }
 
 void printer::visit(const return_statement &return_stmt) {
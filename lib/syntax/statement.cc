@@ -28,8 +28,56 @@
  **/
 
 #include "swift/syntax/statement.hh"
+#include "swift/syntax/branch-statement.hh"
+#include "swift/syntax/compiler-control-statement.hh"
+#include "swift/syntax/context.hh"
+#include "swift/syntax/control-transfer-statement.hh"
+#include "swift/syntax/declaration.hh"
+#include "swift/syntax/expression.hh"
+#include "swift/syntax/literal-expression.hh"
+#include "swift/syntax/loop-statement.hh"
+#include "swift/syntax/type-casting-expression.hh"
+
+#include <type_traits>
 
 namespace swift::ast {
-statement::~statement() = default;
+// NOTE(compnerd) the per-level types are derived from the node kind by offset;
+// ensure that syntax.def and the enumerations remain in agreement.
+#define CHECK_KIND(Level, Id)                                                  \
+  static_assert(static_cast<unsigned>(node_kind::Id) -                         \
+                        static_cast<unsigned>(node_kind::first_##Level) ==     \
+                    static_cast<unsigned>(Level::type::Id),                    \
+                "syntax.def is out of sync with " #Level "::type")
+
+static_assert(static_cast<unsigned>(node_kind::statements) ==
+                  static_cast<unsigned>(statement::type::statements),
+              "syntax.def is out of sync with statement::type");
+static_assert(node_kind::statements < node_kind::first_expression,
+              "concrete statements must precede the abstract statements");
+
+CHECK_KIND(expression, optional_chaining_expression);
+static_assert(node_kind::optional_chaining_expression <
+                  node_kind::first_type_casting_expression and
+              node_kind::last_type_casting_expression <
+                  node_kind::first_literal_expression,
+              "abstract expressions must follow the concrete expressions");
+
+CHECK_KIND(declaration, enumeration_element_declaration);
+CHECK_KIND(loop_statement, repeat_while_statement);
+CHECK_KIND(branch_statement, switch_statement);
+CHECK_KIND(control_transfer_statement, throw_statement);
+CHECK_KIND(compiler_control_statement, line_control_statement);
+
+#undef CHECK_KIND
+
+static_assert(not std::is_polymorphic<statement>::value,
+              "statement should not carry a vtable");
+static_assert(sizeof(statement) == 12, "statement header should be packed");
+
+thread_local const context *statement::accounting_ = nullptr;
+
+void statement::record(node_kind kind) {
+  ++accounting_->node_counts_[static_cast<unsigned>(kind)];
+}
 }
 
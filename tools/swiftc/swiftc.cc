@@ -0,0 +1,355 @@
+/**
+ * Copyright © 2014 Saleem Abdulrasool <compnerd@compnerd.org>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+
+#include <swift/diagnostics/consumer.hh>
+#include <swift/diagnostics/diagnostic_info.hh>
+#include <swift/diagnostics/engine.hh>
+#include <swift/compiler/target_options.hh>
+#include <swift/lexer/lexer.hh>
+#include <swift/parser/parse-cache.hh>
+#include <swift/parser/parser.hh>
+#include <swift/semantic/analyzer.hh>
+#include <swift/support/thread-pool.hh>
+#include <swift/syntax/context.hh>
+#include <swift/syntax/printer.hh>
+
+#include <llvm/Support/Host.h>
+#include <llvm/Support/MemoryBuffer.h>
+
+#include <algorithm>
+#include <chrono>
+#include <codecvt>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <locale>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+/// Collects the diagnostics for a single source file so that they can be
+/// reported in the order of the inputs once every file has been parsed.
+class buffered_consumer : public swift::diagnostics::consumer {
+  const std::string &path_;
+  std::ostringstream output_;
+
+public:
+  explicit buffered_consumer(const std::string &path) : path_(path) {}
+
+  std::string output() const {
+    return output_.str();
+  }
+
+  void report(const char *message) {
+    output_ << path_ << ": error: " << message << '\n';
+    ++error_count_;
+  }
+
+  void handle_diagnostic(swift::diagnostics::diagnostic::level level,
+                         const swift::diagnostics::diagnostic_info &info)
+      override {
+    consumer::handle_diagnostic(level, info);
+
+    std::string message;
+    info.format(message);
+
+    output_ << path_ << ':' << info.location().line() << ':'
+            << info.location().column() << ": ";
+    switch (level) {
+    case swift::diagnostics::diagnostic::level::ignored:
+      return;
+    case swift::diagnostics::diagnostic::level::note:
+      output_ << "note: ";
+      break;
+    case swift::diagnostics::diagnostic::level::warning:
+      output_ << "warning: ";
+      break;
+    case swift::diagnostics::diagnostic::level::error:
+      output_ << "error: ";
+      break;
+    case swift::diagnostics::diagnostic::level::fatal:
+      output_ << "fatal error: ";
+      break;
+    }
+    output_ << message << '\n';
+  }
+};
+
+/// The state for parsing a single source file.  Each job owns its own
+/// diagnostics, and its own context so that the nodes are allocated without
+/// contention; the contexts are adopted by the module once parsing completes.
+struct job {
+  std::string path;
+  std::u32string source;
+  buffered_consumer consumer;
+  swift::diagnostics::engine diagnostics_engine;
+  std::unique_ptr<swift::ast::context> ast_context;
+  std::unique_ptr<swift::semantic::analyzer> semantic_analyzer;
+  std::vector<swift::ast::statement *> declarations;
+#if defined(SWIFT_PARSER_PROFILING)
+  swift::parse::profile profile;
+#endif
+
+  explicit job(std::string path)
+      : path(std::move(path)), consumer(this->path),
+        diagnostics_engine(nullptr, &consumer) {}
+};
+
+// The bounds on the parse cache, which is pruned once the inputs are compiled.
+constexpr uint64_t parse_cache_maximum_size = uint64_t(512) << 20;
+constexpr std::chrono::hours parse_cache_maximum_age(24 * 7);
+
+// Parses the source of `job`, inferring the types of its expressions within
+// `type_check` unless it is null.  When type checking, the bodies of functions
+// are skipped, to be analysed in parallel once all of the declarations of the
+// source are known.  The declarations are loaded from `cache`, if any, when
+// the source is unchanged.  The nodes are accounted for if `statistics` is set.
+void parse(job &job, bool script, unsigned maximum_nesting_depth,
+           const swift::semantic::type_checker::limits *type_check,
+           const swift::parse::cache *cache, bool statistics) {
+  auto buffer = llvm::MemoryBuffer::getFile(job.path, -1, false);
+  if (not buffer) {
+    job.consumer.report("unable to read file");
+    return;
+  }
+
+  // NOTE(compnerd) the error strings prevent the conversion from throwing
+  std::wstring_convert<std::codecvt_utf8<char32_t>, char32_t>
+      ucs{ std::string(), std::u32string() };
+  job.source = ucs.from_bytes((*buffer)->getBufferStart(),
+                              (*buffer)->getBufferEnd());
+  if (job.source.empty() and (*buffer)->getBufferSize()) {
+    job.consumer.report("file is not valid UTF-8");
+    return;
+  }
+
+  job.ast_context =
+      std::make_unique<swift::ast::context>(job.diagnostics_engine, job.path);
+  if (statistics)
+    job.ast_context->enable_statistics();
+
+  swift::lexer lexer(job.diagnostics_engine, job.source.data(),
+                     job.source.length());
+  job.semantic_analyzer =
+      std::make_unique<swift::semantic::analyzer>(*job.ast_context);
+  if (type_check)
+    job.semantic_analyzer->type_check(*type_check);
+  swift::parser parser(lexer, *job.semantic_analyzer, job.diagnostics_engine);
+  parser.maximum_nesting_depth(maximum_nesting_depth);
+  parser.script_mode(script);
+  parser.delay_function_bodies(type_check);
+
+  if (cache)
+    job.declarations =
+        cache->parse(parser, lexer, *job.ast_context, job.source);
+  else
+    while (auto declaration = parser.parse_top_level_declaration())
+      job.declarations.push_back(*declaration);
+
+#if defined(SWIFT_PARSER_PROFILING)
+  job.profile = parser.profile();
+#endif
+}
+
+void usage(const char *program) {
+  std::cerr << "usage: " << program
+            << " [-j <jobs>] [-module-name <name>] [-max-nesting-depth <depth>]"
+               " [-parse-as-library] [-parse-cache-path <directory>]"
+               " [-dump-parse] [-print-stats]"
+               " [-typecheck] [-solver-step-limit <steps>]"
+               " [-solver-memory-limit <bytes>]"
+#if defined(SWIFT_PARSER_PROFILING)
+               " [-profile-parser]"
+#endif
+               " <file>...\n";
+}
+}
+
+int main(int argc, char **argv) {
+  std::vector<std::unique_ptr<job>> jobs;
+  std::string module_name = "main";
+  unsigned threads = std::thread::hardware_concurrency();
+  unsigned maximum_nesting_depth = 256;
+  bool parse_as_library = false;
+  std::string parse_cache_path;
+  bool dump_parse = false;
+  bool print_stats = false;
+  bool type_check = false;
+  swift::semantic::type_checker::limits limits;
+#if defined(SWIFT_PARSER_PROFILING)
+  bool profile_parser = false;
+#endif
+
+  for (int index = 1; index < argc; ++index) {
+    if (std::strcmp(argv[index], "-j") == 0 and index + 1 < argc) {
+      threads = std::strtoul(argv[++index], nullptr, 10);
+    } else if (std::strcmp(argv[index], "-module-name") == 0 and
+               index + 1 < argc) {
+      module_name = argv[++index];
+    } else if (std::strcmp(argv[index], "-max-nesting-depth") == 0 and
+               index + 1 < argc) {
+      maximum_nesting_depth = std::strtoul(argv[++index], nullptr, 10);
+    } else if (std::strcmp(argv[index], "-parse-as-library") == 0) {
+      parse_as_library = true;
+    } else if (std::strcmp(argv[index], "-parse-cache-path") == 0 and
+               index + 1 < argc) {
+      parse_cache_path = argv[++index];
+    } else if (std::strcmp(argv[index], "-dump-parse") == 0) {
+      dump_parse = true;
+    } else if (std::strcmp(argv[index], "-print-stats") == 0) {
+      print_stats = true;
+    } else if (std::strcmp(argv[index], "-typecheck") == 0) {
+      type_check = true;
+    } else if (std::strcmp(argv[index], "-solver-step-limit") == 0 and
+               index + 1 < argc) {
+      limits.solver_steps = std::strtoul(argv[++index], nullptr, 10);
+    } else if (std::strcmp(argv[index], "-solver-memory-limit") == 0 and
+               index + 1 < argc) {
+      limits.memory = std::strtoull(argv[++index], nullptr, 10);
+#if defined(SWIFT_PARSER_PROFILING)
+    } else if (std::strcmp(argv[index], "-profile-parser") == 0) {
+      profile_parser = true;
+#endif
+    } else if (argv[index][0] == '-') {
+      usage(argv[0]);
+      return EXIT_FAILURE;
+    } else {
+      jobs.push_back(std::make_unique<job>(argv[index]));
+    }
+  }
+
+  if (jobs.empty()) {
+    usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  std::unique_ptr<swift::parse::cache> cache;
+  if (not parse_cache_path.empty()) {
+    swift::compiler::target_options target_options;
+    target_options.triple = llvm::sys::getDefaultTargetTriple();
+    cache = std::make_unique<swift::parse::cache>(parse_cache_path,
+                                                  target_options);
+  }
+
+  // NOTE(compnerd) as with the reference compiler, a lone input or main.swift
+  // is the main file, whose top-level code forms the entry point
+  auto is_script = [&jobs, parse_as_library](const job &job) -> bool {
+    if (parse_as_library)
+      return false;
+    if (jobs.size() == 1)
+      return true;
+    const std::string &path = job.path;
+    const size_t separator = path.find_last_of('/');
+    return path.compare(separator == std::string::npos ? 0 : separator + 1,
+                        std::string::npos, "main.swift") == 0;
+  };
+
+  {
+    // NOTE(compnerd) the function bodies of even a single source may occupy
+    // all of the threads when type checking
+    swift::thread_pool pool(type_check ? threads
+                                       : std::min<size_t>(threads, jobs.size()));
+    for (auto &job : jobs)
+      pool.async([&job, script = is_script(*job), maximum_nesting_depth,
+                  limits = type_check ? &limits : nullptr,
+                  cache = cache.get(), print_stats]() {
+        parse(*job, script, maximum_nesting_depth, limits, cache, print_stats);
+      });
+    pool.wait();
+
+    if (type_check) {
+      for (auto &job : jobs) {
+        if (not job->semantic_analyzer)
+          continue;
+        job->semantic_analyzer->analyze_function_bodies(
+            pool, [&job = *job, maximum_nesting_depth](
+                      const swift::ast::function_declaration &function,
+                      swift::semantic::analyzer &semantic_analyzer) {
+              auto &diagnostics_engine =
+                  semantic_analyzer.ast_context().diagnostics_engine();
+              swift::lexer lexer(diagnostics_engine, job.source.data(),
+                                 job.source.length());
+              swift::parser parser(lexer, semantic_analyzer,
+                                   diagnostics_engine);
+              parser.maximum_nesting_depth(maximum_nesting_depth);
+              return parser.parse_function_body(function);
+            });
+      }
+      pool.wait();
+
+      for (auto &job : jobs)
+        if (job->semantic_analyzer)
+          job->semantic_analyzer->complete_function_bodies();
+    }
+  }
+
+  swift::diagnostics::null_consumer consumer;
+  swift::diagnostics::engine diagnostics_engine(nullptr, &consumer);
+  swift::ast::context module(diagnostics_engine, module_name);
+
+  unsigned errors = 0;
+  for (auto &job : jobs) {
+    std::cerr << job->consumer.output();
+    errors = errors + job->consumer.error_count();
+
+    if (dump_parse) {
+      swift::ast::printer print(std::cout, 2);
+      for (const auto *declaration : job->declarations) {
+        print(declaration);
+        std::cout << '\n';
+      }
+    }
+
+    // the analyzer refers to the identifiers of the context which it analysed
+    job->semantic_analyzer.reset();
+    if (job->ast_context)
+      module.adopt(std::move(job->ast_context));
+  }
+
+  if (print_stats)
+    module.print_statistics(std::cerr);
+
+  if (cache)
+    cache->prune(parse_cache_maximum_size, parse_cache_maximum_age);
+
+#if defined(SWIFT_PARSER_PROFILING)
+  if (profile_parser) {
+    swift::parse::profile profile;
+    for (const auto &job : jobs)
+      profile.merge(job->profile);
+    profile.print(std::cerr);
+  }
+#endif
+
+  return errors ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
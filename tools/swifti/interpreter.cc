@@ -43,6 +43,7 @@ static const std::map<std::string, swift::interpreter::interpreter::command>
     commands{
       { "help", &swift::interpreter::interpreter::do_help },
       { "quit", &swift::interpreter::interpreter::do_quit },
+      { "stats", &swift::interpreter::interpreter::do_stats },
     };
 
 namespace swift {
@@ -51,7 +52,10 @@ interpreter::interpreter()
     : count_(1), quit_(false), diagnostics_engine_(nullptr, this),
       lexer_(diagnostics_engine_, nullptr, 0),
       ast_context_(diagnostics_engine_), semantic_analyzer_(ast_context_),
-      parser_(lexer_, semantic_analyzer_, diagnostics_engine_) {}
+      parser_(lexer_, semantic_analyzer_, diagnostics_engine_) {
+  ast_context_.enable_statistics();
+  parser_.script_mode(true);
+}
 
 void interpreter::run_main_loop() {
   std::cout << "Welcome to Swift!  Type :help for assistance." << std::endl;
@@ -143,6 +147,10 @@ For more information on and command, type ':help <command-name>'.
 void interpreter::do_quit() {
   quit_ = true;
 }
+
+void interpreter::do_stats() {
+  ast_context_.print_statistics(std::cout);
+}
 }
 }
 
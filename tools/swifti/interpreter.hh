@@ -67,6 +67,7 @@ public:  // FIXME(compnerd) make this private via friending the commands table
   void dispatch_command(const std::string &);
   void do_help();
   void do_quit();
+  void do_stats();
 };
 }
 
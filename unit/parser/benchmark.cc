@@ -0,0 +1,291 @@
+/**
+ * Copyright © 2014 Saleem Abdulrasool <compnerd@compnerd.org>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+
+
+#include <swift/diagnostics/consumer.hh>
+#include <swift/diagnostics/engine.hh>
+#include <swift/lexer/lexer.hh>
+#include <swift/parser/parser.hh>
+#include <swift/semantic/analyzer.hh>
+#include <swift/syntax/context.hh>
+
+#include <sys/resource.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+
+namespace {
+/// Generates a program of `scale` units, each of which mixes the constructs
+/// that the parser sees in practice: nominal types with members, closures,
+/// switches, loops, and long binary operator sequences.
+class generator {
+  std::mt19937 random_;
+  std::ostringstream os_;
+
+  unsigned pick(unsigned limit) {
+    return std::uniform_int_distribution<unsigned>(0, limit - 1)(random_);
+  }
+
+  void structure(unsigned id) {
+    os_ << "struct Point" << id << " {\n"
+        << "  var x: Int = " << pick(100) << "\n"
+        << "  var y: Int = " << pick(100) << "\n"
+        << "  func length() -> Int {\n"
+        << "    return x * x + y * y\n"
+        << "  }\n"
+        << "}\n\n";
+  }
+
+  void klass(unsigned id) {
+    os_ << "class Shape" << id << " {\n"
+        << "  var name: String = \"shape" << id << "\"\n"
+        << "  var sides: Int = " << pick(8) << "\n"
+        << "  init() {\n"
+        << "  }\n"
+        << "  func area(scale: Int) -> Int {\n"
+        << "    let transform = { (value: Int) -> Int in\n"
+        << "      return value * scale + " << pick(10) << "\n"
+        << "    }\n"
+        << "    return transform(sides)\n"
+        << "  }\n"
+        << "}\n\n";
+  }
+
+  void enumeration(unsigned id) {
+    os_ << "enum Direction" << id << " {\n"
+        << "  case north\n"
+        << "  case south, east, west\n"
+        << "}\n\n";
+  }
+
+  void function(unsigned id) {
+    os_ << "func classify" << id << "(value: Int, limit: Int) -> Int {\n"
+        << "  var total = 0\n"
+        << "  switch value {\n";
+    for (unsigned label = 0, labels = 2 + pick(6); label < labels; ++label)
+      os_ << "  case " << label << ":\n"
+          << "    total = total + " << pick(100) << "\n";
+    os_ << "  default:\n"
+        << "    total = value\n"
+        << "  }\n"
+        << "  while total < limit {\n"
+        << "    total = total * 2 + 1\n"
+        << "  }\n"
+        << "  if total > " << pick(1000) << " {\n"
+        << "    return total - limit\n"
+        << "  } else {\n"
+        << "    return total\n"
+        << "  }\n"
+        << "}\n\n";
+  }
+
+  void sequence(unsigned id) {
+    static const char *operators[] = { "+", "-", "*", "/", "%", "&", "|", "^" };
+
+    os_ << "let sequence" << id << " = " << pick(100);
+    for (unsigned term = 0, terms = 16 + pick(48); term < terms; ++term)
+      os_ << ' ' << operators[pick(sizeof(operators) / sizeof(*operators))]
+          << ' ' << 1 + pick(100);
+    os_ << "\n\n";
+  }
+
+public:
+  explicit generator(unsigned seed) : random_(seed) {}
+
+  std::string program(unsigned scale) {
+    os_.str(std::string());
+    for (unsigned id = 0; id < scale; ++id) {
+      structure(id);
+      klass(id);
+      enumeration(id);
+      function(id);
+      sequence(id);
+    }
+    return os_.str();
+  }
+
+  /// Generates a program whose expressions and blocks nest `depth` deep, to
+  /// catch productions which recurse without bound.
+  std::string nested(unsigned depth) {
+    os_.str(std::string());
+
+    os_ << "let parenthesised = ";
+    for (unsigned level = 0; level < depth; ++level)
+      os_ << '(';
+    os_ << 1;
+    for (unsigned level = 0; level < depth; ++level)
+      os_ << ')';
+    os_ << "\n\n";
+
+    os_ << "func nested() {\n";
+    for (unsigned level = 0; level < depth; ++level)
+      os_ << "if true {\n";
+    os_ << "return\n";
+    for (unsigned level = 0; level < depth; ++level)
+      os_ << "}\n";
+    os_ << "}\n\n";
+
+    os_ << "let closures = ";
+    for (unsigned level = 0; level < depth; ++level)
+      os_ << "{ ";
+    os_ << 1;
+    for (unsigned level = 0; level < depth; ++level)
+      os_ << " }";
+    os_ << "\n";
+
+    return os_.str();
+  }
+};
+
+struct measurement {
+  size_t declarations = 0;
+  size_t ast_bytes = 0;
+  unsigned errors = 0;
+  std::chrono::steady_clock::duration time =
+      std::chrono::steady_clock::duration::zero();
+};
+
+measurement parse(const std::u32string &source, unsigned iterations) {
+  measurement result;
+
+  for (unsigned iteration = 0; iteration < iterations; ++iteration) {
+    swift::diagnostics::consumer consumer;
+    swift::diagnostics::engine diagnostics_engine(nullptr, &consumer);
+    swift::ast::context ast_context(diagnostics_engine);
+    swift::lexer lexer(diagnostics_engine, source.data(), source.length());
+    swift::semantic::analyzer semantic_analyzer(ast_context);
+    swift::parser parser(lexer, semantic_analyzer, diagnostics_engine);
+
+    size_t declarations = 0;
+    const auto start = std::chrono::steady_clock::now();
+    while (parser.parse_top_level_declaration())
+      ++declarations;
+    result.time = result.time + (std::chrono::steady_clock::now() - start);
+
+    result.declarations = declarations;
+    result.ast_bytes = ast_context.bytes_allocated();
+    result.errors = consumer.error_count();
+  }
+
+  return result;
+}
+
+void report(const char *name, const std::u32string &source,
+            const measurement &measurement, unsigned iterations) {
+  const double seconds =
+      std::chrono::duration<double>(measurement.time).count() / iterations;
+
+  std::cout << name << ":\n"
+            << "  " << source.length() << " bytes of source, "
+            << measurement.declarations << " top-level declarations";
+  if (measurement.errors)
+    std::cout << ", " << measurement.errors << " errors";
+  std::cout << '\n'
+            << "  " << seconds * 1e3 << " ms per parse, "
+            << measurement.declarations / seconds << " declarations/sec, "
+            << source.length() / seconds / (1 << 20) << " MiB/sec\n"
+            << "  " << measurement.ast_bytes << " bytes of AST, "
+            << static_cast<double>(measurement.ast_bytes) / source.length()
+            << " per source byte\n";
+}
+
+std::u32string widen(const std::string &source) {
+  // NOTE(compnerd) the generated programs are ASCII
+  return std::u32string(source.begin(), source.end());
+}
+
+void usage(const char *program) {
+  std::cerr << "usage: " << program
+            << " [-scale <units>] [-depth <levels>] [-iterations <count>]"
+               " [-seed <seed>] [-dump]\n";
+}
+}
+
+int main(int argc, char **argv) {
+  unsigned scale = 1000;
+  // NOTE(compnerd) a nested closure is both an expression and a statement, so
+  // this remains within the default maximum nesting depth of the parser
+  unsigned depth = 100;
+  unsigned iterations = 5;
+  unsigned seed = 0;
+  bool dump = false;
+
+  for (int index = 1; index < argc; ++index) {
+    if (std::strcmp(argv[index], "-scale") == 0 and index + 1 < argc) {
+      scale = std::strtoul(argv[++index], nullptr, 10);
+    } else if (std::strcmp(argv[index], "-depth") == 0 and index + 1 < argc) {
+      depth = std::strtoul(argv[++index], nullptr, 10);
+    } else if (std::strcmp(argv[index], "-iterations") == 0 and
+               index + 1 < argc) {
+      iterations = std::strtoul(argv[++index], nullptr, 10);
+    } else if (std::strcmp(argv[index], "-seed") == 0 and index + 1 < argc) {
+      seed = std::strtoul(argv[++index], nullptr, 10);
+    } else if (std::strcmp(argv[index], "-dump") == 0) {
+      dump = true;
+    } else {
+      usage(argv[0]);
+      return EXIT_FAILURE;
+    }
+  }
+
+  if (iterations == 0) {
+    usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  generator generate(seed);
+
+  const std::string program = generate.program(scale);
+  const std::string nested = generate.nested(depth);
+  if (dump) {
+    std::cout << program << nested;
+    return EXIT_SUCCESS;
+  }
+
+  const std::u32string program_source = widen(program);
+  const measurement program_measurement = parse(program_source, iterations);
+  report("program", program_source, program_measurement, iterations);
+
+  const std::u32string nested_source = widen(nested);
+  const measurement nested_measurement = parse(nested_source, iterations);
+  report("nested", nested_source, nested_measurement, iterations);
+
+  struct rusage resources;
+  if (getrusage(RUSAGE_SELF, &resources) == 0)
+    std::cout << "peak rss: " << resources.ru_maxrss << " KiB\n";
+
+  return program_measurement.errors or nested_measurement.errors
+             ? EXIT_FAILURE
+             : EXIT_SUCCESS;
+}
@@ -0,0 +1,146 @@
+/**
+ * Copyright © 2014 Saleem Abdulrasool <compnerd@compnerd.org>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+
+
+
+#include <swift/diagnostics/consumer.hh>
+#include <swift/diagnostics/engine.hh>
+#include <swift/lexer/lexer.hh>
+#include <swift/parser/parser.hh>
+#include <swift/semantic/analyzer.hh>
+#include <swift/support/thread-pool.hh>
+#include <swift/syntax/context.hh>
+#include <swift/syntax/function-declaration.hh>
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+// NOTE(compnerd) each body declares locals, which are allocated from the
+// context in which the body is analysed but belong to the function, whose
+// context adopts the former once the bodies are complete.
+const char program[] = R"(
+func square(value: Int) -> Int {
+  let result = value * value
+  return result
+}
+
+func sum(limit: Int) -> Int {
+  var total = 0
+  var index = 0
+  while index < limit {
+    let next = index + 1
+    total = total + next
+    index = next
+  }
+  return total
+}
+
+func outer(value: Int) -> Int {
+  func inner(value: Int) -> Int {
+    return value + 1
+  }
+  let (first, second) = (value, inner(value))
+  return first + second
+}
+)";
+}
+
+int main() {
+  swift::diagnostics::consumer consumer;
+  swift::diagnostics::engine diagnostics_engine(nullptr, &consumer);
+
+  swift::ast::context ast_context(diagnostics_engine);
+  const std::u32string source(std::begin(program), std::end(program) - 1);
+  swift::lexer lexer(diagnostics_engine, source.data(), source.length());
+  swift::semantic::analyzer semantic_analyzer(ast_context);
+  semantic_analyzer.type_check(swift::semantic::type_checker::limits());
+  swift::parser parser(lexer, semantic_analyzer, diagnostics_engine);
+  parser.delay_function_bodies(true);
+
+  std::vector<swift::ast::function_declaration *> functions;
+  while (auto declaration = parser.parse_top_level_declaration())
+    if ((*declaration)->kind() == swift::ast::node_kind::function_declaration)
+      functions.push_back(
+          static_cast<swift::ast::function_declaration *>(*declaration));
+  if (functions.size() != 3) {
+    std::cerr << "unable to parse the program\n";
+    return EXIT_FAILURE;
+  }
+
+  {
+    swift::thread_pool pool;
+    semantic_analyzer.analyze_function_bodies(
+        pool, [&source](const swift::ast::function_declaration &function,
+                        swift::semantic::analyzer &semantic_analyzer) {
+          auto &diagnostics_engine =
+              semantic_analyzer.ast_context().diagnostics_engine();
+          swift::lexer lexer(diagnostics_engine, source.data(),
+                             source.length());
+          swift::parser parser(lexer, semantic_analyzer, diagnostics_engine);
+          return parser.parse_function_body(function);
+        });
+    pool.wait();
+  }
+  semantic_analyzer.complete_function_bodies();
+
+  if (consumer.error_count()) {
+    std::cerr << consumer.error_count() << " errors analysing the bodies\n";
+    return EXIT_FAILURE;
+  }
+
+  unsigned locals = 0;
+  for (auto *function : functions) {
+    if (function->has_unparsed_body() or not function->body()) {
+      std::cerr << "function body was not analysed\n";
+      return EXIT_FAILURE;
+    }
+
+    auto *context = static_cast<swift::ast::declaration_context *>(function);
+    for (const auto *declaration : *context) {
+      if (declaration->declaration_context() != context) {
+        std::cerr << "local is not declared in its function\n";
+        return EXIT_FAILURE;
+      }
+      ++locals;
+    }
+  }
+
+  // result, total, index, next, inner, and the tuple of first and second
+  if (locals != 6) {
+    std::cerr << locals << " locals declared in the functions, expected 6\n";
+    return EXIT_FAILURE;
+  }
+
+  std::cout << functions.size() << " function bodies, " << locals
+            << " locals analysed\n";
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,266 @@
+/**
+ * Copyright © 2014 Saleem Abdulrasool <compnerd@compnerd.org>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+
+
+
+#include <swift/diagnostics/consumer.hh>
+#include <swift/diagnostics/engine.hh>
+#include <swift/lexer/lexer.hh>
+#include <swift/parser/parser.hh>
+#include <swift/semantic/analyzer.hh>
+#include <swift/syntax/ast-reader.hh>
+#include <swift/syntax/ast-writer.hh>
+#include <swift/syntax/context.hh>
+#include <swift/syntax/visitor.hh>
+
+#include <unistd.h>
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+// NOTE(compnerd) the program exercises every node which the parser currently
+// produces without error; the remaining nodes are synthesised by `unparsed`
+// below.
+const char program[] = R"(
+import Swift
+typealias Index = Int
+infix operator <> { associativity left precedence 140 }
+let limit: Int = 10
+var (first, second) = (1, 2.5)
+
+enum Direction {
+  case north
+  case south, east, west
+}
+
+protocol Shape {
+}
+
+struct Point {
+  var x: Int = 0
+  var y: Int = 0
+  func length() -> Int {
+    return x * x + y * y
+  }
+}
+
+class Polygon {
+  var name: String = "polygon"
+  var sides: Int = 3
+  init() {
+  }
+  deinit {
+  }
+}
+
+extension Polygon : Shape {
+}
+
+func classify(value: Int, inout total: Int) -> Int {
+  defer {
+    total = 0
+  }
+  outer: for item in [1, 2, 3] {
+    if item == 2 {
+      continue outer
+    } else {
+      break
+    }
+  }
+  while total < value {
+    total = total * 2 + 1
+  }
+  repeat {
+    total = total - 1
+  } while total > value
+  switch value {
+  case 0:
+    fallthrough
+  case 1, 2:
+    total = -value
+  default:
+    total = value
+  }
+  let transform = { (value: Int) -> Int in
+    return value + 1
+  }
+  let point = Point()
+  let table = [1: "one", 2: "two"]
+  let name = __FILE__ + __FUNCTION__
+  let line = __LINE__
+  let flag = value > 0 ? true : false
+  let dynamic = point.dynamicType
+  let kind = Point.self
+  let any = nil
+  let member = .north
+  let forced = first!
+  let cast = value as Int
+  let check = value is Int
+  let attempt = value as? Int
+  _ = Point.init
+  return transform(point.length())
+}
+)";
+
+std::vector<swift::ast::statement *> unparsed(swift::ast::context &context) {
+  using namespace swift;
+
+  ast::declaration_context *declaration_context =
+      context.source_file()->declaration_context();
+
+  std::vector<ast::statement *> empty;
+  std::vector<ast::statement *> conditions = {
+    new (context) ast::boolean_literal_expression(true),
+  };
+  std::vector<std::tuple<ast::pattern *, ast::statement *>> catch_clauses = {
+    std::make_tuple(nullptr, new (context) ast::statements(empty)),
+  };
+
+  return {
+    new (context) ast::for_statement(
+        nullptr, new (context) ast::boolean_literal_expression(false), nullptr,
+        new (context) ast::statements(empty)),
+    new (context, declaration_context) ast::subscript_declaration(
+        declaration_context, new (context) ast::pattern_named(U"index", false),
+        new (context) ast::type_identifier({ U"Int" }), nullptr, nullptr),
+    new (context) ast::do_statement(new (context) ast::statements(empty),
+                                    catch_clauses),
+    new (context) ast::guard_statement(conditions,
+                                       new (context) ast::statements(empty)),
+    new (context) ast::throw_statement(
+        new (context) ast::nil_literal_expression()),
+    new (context) ast::build_configuration_statement(
+        new (context) ast::boolean_literal_expression(false),
+        new (context) ast::statements(empty), nullptr),
+    new (context) ast::line_control_statement(U"file.swift", 1),
+  };
+}
+
+std::string image(const swift::ast::writer &writer) {
+  std::ostringstream os;
+  writer.emit(os);
+  return os.str();
+}
+}
+
+int main() {
+  swift::diagnostics::consumer consumer;
+  swift::diagnostics::engine diagnostics_engine(nullptr, &consumer);
+
+  swift::ast::context ast_context(diagnostics_engine);
+  const std::u32string source(std::begin(program), std::end(program) - 1);
+  swift::lexer lexer(diagnostics_engine, source.data(), source.length());
+  swift::semantic::analyzer semantic_analyzer(ast_context);
+  swift::parser parser(lexer, semantic_analyzer, diagnostics_engine);
+
+  std::vector<swift::ast::statement *> statements;
+  while (auto declaration = parser.parse_top_level_declaration())
+    statements.push_back(*declaration);
+  if (consumer.error_count() or
+      not lexer.head().is<swift::token::type::eof>()) {
+    std::cerr << "unable to parse the program\n";
+    return EXIT_FAILURE;
+  }
+
+  for (auto *statement : unparsed(ast_context))
+    statements.push_back(statement);
+
+  swift::ast::writer writer;
+  for (const auto *statement : statements) {
+    if (not writer.add(statement)) {
+      std::cerr << "unable to serialise statement " << writer.size() << '\n';
+      return EXIT_FAILURE;
+    }
+  }
+
+  char path[] = "/tmp/ast-format-XXXXXX";
+  const int fd = mkstemp(path);
+  if (fd < 0) {
+    std::cerr << "unable to create temporary file\n";
+    return EXIT_FAILURE;
+  }
+  close(fd);
+
+  const std::string original = image(writer);
+  std::ofstream(path, std::ios::binary) << original;
+
+  // NOTE(compnerd) the records carry no semantic state, so re-serialising the
+  // materialised tree must reproduce the original image exactly.
+  swift::ast::context round_trip_context(diagnostics_engine);
+  auto reader = swift::ast::reader::open(round_trip_context, path);
+  unlink(path);
+  if (not reader or reader->size() != statements.size()) {
+    std::cerr << "unable to read serialised AST\n";
+    return EXIT_FAILURE;
+  }
+
+  swift::ast::writer round_trip;
+  for (unsigned index = 0; index < reader->size(); ++index) {
+    const swift::ast::statement *statement = reader->statement(index);
+    if (not statement or not round_trip.add(statement)) {
+      std::cerr << "unable to round-trip statement " << index << '\n';
+      return EXIT_FAILURE;
+    }
+  }
+
+  if (image(round_trip) != original) {
+    std::cerr << "round-tripped AST differs from the original\n";
+    return EXIT_FAILURE;
+  }
+
+  // the members and locals are declared within their type and function
+  const swift::ast::declaration_context *file =
+      round_trip_context.source_file()->declaration_context();
+  const auto types = file->lookup(U"Point");
+  const auto functions = file->lookup(U"classify");
+  if (types.size() != 1 or functions.size() != 1) {
+    std::cerr << "missing top-level declaration\n";
+    return EXIT_FAILURE;
+  }
+
+  const auto *type = static_cast<const swift::ast::struct_declaration *>(
+      types.front());
+  const auto *function = static_cast<const swift::ast::function_declaration *>(
+      functions.front());
+  if (not file->lookup(U"x").empty() or type->lookup(U"x").size() != 1 or
+      not file->lookup(U"point").empty() or
+      function->lookup(U"point").size() != 1) {
+    std::cerr << "declarations read outside of their context\n";
+    return EXIT_FAILURE;
+  }
+
+  std::cout << statements.size() << " statements, " << original.size()
+            << " bytes round-tripped\n";
+  return EXIT_SUCCESS;
+}